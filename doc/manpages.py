@@ -143,6 +143,7 @@ man_pages = [
     ('man3/flux_kvs_getroot', 'flux_kvs_getroot_cancel', 'look up KVS root hash', [author], 3),
     ('man3/flux_kvs_getroot', 'flux_kvs_getroot', 'look up KVS root hash', [author], 3),
     ('man3/flux_kvs_lookup', 'flux_kvs_lookupat', 'look up KVS key', [author], 3),
+    ('man3/flux_kvs_lookup', 'flux_kvs_lookup_multi', 'look up KVS key', [author], 3),
     ('man3/flux_kvs_lookup', 'flux_kvs_lookup_get', 'look up KVS key', [author], 3),
     ('man3/flux_kvs_lookup', 'flux_kvs_lookup_get_unpack', 'look up KVS key', [author], 3),
     ('man3/flux_kvs_lookup', 'flux_kvs_lookup_get_raw', 'look up KVS key', [author], 3),
@@ -20,9 +20,38 @@ from flux.rpc import RPC
 
 
 class JobListRPC(RPC):
+    def __init__(self, *args, **kwargs):
+        super().__init__(*args, **kwargs)
+        flags = kwargs.get("flags", 0)
+        self.streaming = bool(flags & flux.constants.FLUX_RPC_STREAMING)
+        self.cursor = None
+
     def get_jobs(self):
-        """Returns all jobs in the RPC."""
-        return self.get()["jobs"]
+        """Returns all jobs in the RPC.
+
+        For a streaming RPC, collects jobs from all responses.  The cursor
+        of the last job returned, if any, is saved in ``self.cursor``.
+        A job-list module without streaming support sends one response
+        with no cursor and no ENODATA, so that response ends the stream.
+        """
+        if not self.streaming:
+            resp = self.get()
+            self.cursor = resp.get("cursor", self.cursor)
+            return resp["jobs"]
+        jobs = []
+        while True:
+            try:
+                resp = self.get()
+            except OSError as exc:
+                if exc.errno == errno.ENODATA:
+                    break
+                raise
+            jobs.extend(resp["jobs"])
+            if "cursor" not in resp:
+                break
+            self.cursor = resp["cursor"]
+            self.reset()
+        return jobs
 
     def get_jobinfos(self):
         """Yields a JobInfo object for each job in its current state.
@@ -52,7 +81,16 @@ def job_list(
     name=None,
     queue=None,
     constraint=None,
+    chunk_size=0,
+    cursor=None,
 ):
+    """Send a job-list.list request.
+
+    If ``chunk_size`` is nonzero, jobs are streamed from the job-list
+    module in responses of at most ``chunk_size`` jobs.  ``cursor`` is
+    a cursor returned by a previous query (or an empty dict) and resumes
+    the listing after the last job seen.
+    """
     if constraint is None:
         # N.B. an "and" operation with no values returns everything
         constraint = {"and": []}
@@ -85,7 +123,13 @@ def job_list(
         "since": since,
         "constraint": constraint,
     }
-    return JobListRPC(flux_handle, "job-list.list", payload)
+    flags = 0
+    if chunk_size:
+        payload["chunk_size"] = int(chunk_size)
+        flags = flux.constants.FLUX_RPC_STREAMING
+    if cursor is not None:
+        payload["cursor"] = cursor
+    return JobListRPC(flux_handle, "job-list.list", payload, flags=flags)
 
 
 def job_list_inactive(
@@ -111,6 +155,30 @@ def job_list_inactive(
     )
 
 
+class JobListAggregateRPC(RPC):
+    def get_groups(self):
+        """Returns a list of groups, each a dict with keys "value",
+        "count", and "sum".
+        """
+        return self.get()["groups"]
+
+
+def job_list_aggregate(flux_handle, group_by, sums=None, since=0.0, constraint=None):
+    """Count jobs grouped by attribute ``group_by``.
+
+    Sends a job-list.aggregate request.  Jobs matching ``constraint`` are
+    counted in groups by the value of ``group_by``, e.g. "userid", "queue",
+    "state", or "result".  ``sums`` is an optional list of numeric attributes,
+    e.g. "nnodes" or "runtime", to sum in each group.
+    """
+    payload = {"group_by": group_by, "since": since}
+    if sums is not None:
+        payload["sum"] = list(sums)
+    if constraint is not None:
+        payload["constraint"] = constraint
+    return JobListAggregateRPC(flux_handle, "job-list.aggregate", payload)
+
+
 class JobListIdRPC(RPC):
     def __init__(self, *args, **kwargs):
         super().__init__(*args, **kwargs)
@@ -224,6 +292,8 @@ class JobList:
         as documented in RFC 43 Constraint Operators section. This constraint
         may then be joined with other constraints provided by above parameters
         via the ``and`` operator.
+    :chunk_size: If nonzero, stream jobs from the job-list module in chunks
+        of at most this many jobs.
     """
 
     # pylint: disable=too-many-instance-attributes
@@ -258,6 +328,7 @@ class JobList:
         name=None,
         queue=None,
         constraint=None,
+        chunk_size=0,
     ):
         self.handle = flux_handle
         self.attrs = list(attrs)
@@ -274,6 +345,7 @@ class JobList:
                 self.add_filter(x)
         self.set_user(user)
         self.constraint = constraint
+        self.chunk_size = chunk_size
 
     def set_user(self, user):
         """Only return jobs for user (may be a username, userid, or "all")"""
@@ -326,6 +398,7 @@ class JobList:
             name=self.name,
             queue=self.queue,
             constraint=self.constraint,
+            chunk_size=self.chunk_size,
         )
 
     def jobs(self):
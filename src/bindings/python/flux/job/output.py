@@ -12,7 +12,9 @@ import base64
 import errno
 from typing import NamedTuple
 
-from flux.future import FutureExt
+import flux.constants
+from flux.core.inner import ffi, raw
+from flux.future import Future, FutureExt
 from flux.idset import IDset
 from flux.job import (
     EventLogEvent,
@@ -270,6 +272,121 @@ class JobOutput(NamedTuple):
     log: str
 
 
+def _lz4_block_decompress(src, size):
+    """
+    Decompress a single LZ4 block ``src`` (bytes) whose uncompressed
+    size is ``size``. Raises ValueError if the block is malformed.
+    """
+    dst = bytearray()
+    i = 0
+    end = len(src)
+    try:
+        while i < end:
+            token = src[i]
+            i += 1
+            length = token >> 4
+            if length == 15:
+                while True:
+                    byte = src[i]
+                    i += 1
+                    length += byte
+                    if byte != 255:
+                        break
+            dst += src[i : i + length]
+            i += length
+            if i >= end:
+                break
+            offset = src[i] | (src[i + 1] << 8)
+            i += 2
+            if offset == 0 or offset > len(dst):
+                raise ValueError("invalid LZ4 match offset")
+            length = token & 15
+            if length == 15:
+                while True:
+                    byte = src[i]
+                    i += 1
+                    length += byte
+                    if byte != 255:
+                        break
+            length += 4
+            start = len(dst) - offset
+            if length <= offset:
+                dst += dst[start : start + length]
+            else:
+                #  Overlapping match repeats the last 'offset' bytes
+                pattern = dst[start:]
+                dst += (pattern * (length // offset + 1))[:length]
+    except IndexError:
+        raise ValueError("truncated LZ4 block") from None
+    if len(dst) != size:
+        raise ValueError(f"LZ4 block size {len(dst)} != expected {size}")
+    return bytes(dst)
+
+
+class _ContentLoadRPC(Future):
+    """
+    Load a blob from the content store by blobref. The content store
+    is restricted to the instance owner.
+    """
+
+    def __init__(self, flux_handle, blobref):
+        try:
+            digest = bytes.fromhex(blobref.split("-", 1)[1])
+        except (IndexError, ValueError):
+            raise ValueError(f"invalid blobref {blobref}") from None
+        # keep the flux_handle alive for the lifetime of the RPC
+        self.flux_handle = flux_handle
+        handle = raw.flux_rpc_raw(
+            flux_handle.handle,
+            b"content.load",
+            digest,
+            len(digest),
+            flux.constants.FLUX_NODEID_ANY,
+            0,
+        )
+        super().__init__(handle, prefixes=["flux_rpc_", "flux_future_"])
+
+    def get_raw(self):
+        data = ffi.new("void *[1]")
+        length = ffi.new("int *")
+        self.pimpl.flux_rpc_get_raw(data, length)
+        return bytes(ffi.buffer(data[0], length[0]))
+
+
+def _output_chunk_decode(event, data):
+    """
+    Decode the compressed chunk ``data`` referenced by output eventlog
+    "chunk" event ``event`` (see output.storage=blob in flux-shell(1)).
+    Returns a list of EventLogEvent objects.
+    """
+    context = event.context
+    if context.get("encoding") != "lz4":
+        raise ValueError(f"unsupported chunk encoding {context.get('encoding')}")
+    data = _lz4_block_decompress(data, context["size"])
+    return [EventLogEvent(line) for line in data.decode("utf-8").splitlines()]
+
+
+def _output_chunk_load(flux_handle, event):
+    """
+    Synchronously load and decode the entries of output eventlog
+    "chunk" event ``event``.
+    """
+    data = _ContentLoadRPC(flux_handle, event.context["blobref"]).get_raw()
+    return _output_chunk_decode(event, data)
+
+
+def _output_eventlog_entries(flux_handle, entry):
+    """
+    Return a list of output eventlog entries for ``entry``, which is
+    expanded into the entries it references if it is a "chunk" event.
+    """
+    if not isinstance(entry, EventLogEvent):
+        entry = EventLogEvent(entry)
+    if entry.name == "chunk":
+        return _output_chunk_load(flux_handle, entry)
+    return [entry]
+
+
 def _parse_output_eventlog_entry(entry, labelio=False):
     """
     Parse a single output eventlog entry, returning an object of the
@@ -334,19 +451,25 @@ def _output_eventlog_entry_decode(
 
 
 def _parse_output_eventlog(
-    eventlog, tasks="*", labelio=False, log_stderr_level=LOG_TRACE
+    eventlog,
+    tasks="*",
+    labelio=False,
+    log_stderr_level=LOG_TRACE,
+    flux_handle=None,
 ):
     """
     Given an eventlog, return a JobOutput tuple with stdout, stderr,
-    and log streams broken out.
+    and log streams broken out. ``flux_handle`` is required to load
+    the entries of "chunk" events.
     """
     stream_dict = {"stdout": [], "stderr": [], "log": []}
     tasks = Taskset(tasks)
 
     for line in eventlog.splitlines():
-        _output_eventlog_entry_decode(
-            line, stream_dict, tasks, labelio, log_stderr_level
-        )
+        for entry in _output_eventlog_entries(flux_handle, line):
+            _output_eventlog_entry_decode(
+                entry, stream_dict, tasks, labelio, log_stderr_level
+            )
 
     # Join lines and return result
     results = ["".join(stream_dict.get(k)) for k in ("stdout", "stderr", "log")]
@@ -407,7 +530,11 @@ def job_output(
             msg = f"job {jobid} does not exist or output not ready"
             raise FileNotFoundError(msg)
         return _parse_output_eventlog(
-            eventlog["guest.output"], tasks, labelio, log_stderr_level
+            eventlog["guest.output"],
+            tasks,
+            labelio,
+            log_stderr_level,
+            flux_handle=flux_handle,
         )
 
     stream_dict = {"stdout": [], "stderr": [], "log": []}
@@ -428,9 +555,10 @@ def job_output(
 
     #  Output eventlog is ready, synchronously gather all output
     for event in event_watch(flux_handle, jobid, "guest.output"):
-        _output_eventlog_entry_decode(
-            event, stream_dict, tasks, labelio, log_stderr_level
-        )
+        for entry in _output_eventlog_entries(flux_handle, event):
+            _output_eventlog_entry_decode(
+                entry, stream_dict, tasks, labelio, log_stderr_level
+            )
 
     #  Join lines and return JobOutput result
     results = ["".join(stream_dict.get(k)) for k in ("stdout", "stderr", "log")]
@@ -456,6 +584,12 @@ class JobOutputEventWatch(FutureExt):
         #  Capture when the end of the output eventlog has been reached
         #  (indicated by None returned from watching the eventlog)
         self.closed = False
+
+        #  Output events waiting to be delivered. Events queue behind a
+        #  "chunk" event while its entries are loaded, so that order is
+        #  preserved. None marks the end of the output eventlog.
+        self.queue = []
+        self.chunk_future = None
         super().__init__(self._watch_init, JobID(jobid), flux_handle=flux_handle)
 
     def get_event(self, autoreset=True):
@@ -475,28 +609,72 @@ class JobOutputEventWatch(FutureExt):
         event = None
         try:
             event = future.get_event(autoreset=False)
-            if event is None:
-                self.closed = True
-                #  Fulfill this future with None (indicating no more data)
-                #  if the 'finish' event is also posted in the main eventlog.
-                #  This is done to ensure any exception has been captured.
-                #
-                #  If nowait is enabled, then the main eventlog may not be
-                #  monitored, so assume job is finished. This may miss logging
-                #  job exceptions in some cases, but it is assumed that users
-                #  of the `nowait` option are using it because the main
-                #  eventlog is already being monitored.
-                #
-                if self.nowait or self.finished:
-                    self.fulfill()
-                return
-            self.fulfill(event)
         except OSError as exc:
             self.fulfill_error(exc.errno, exc.strerror)
+            return
+
+        self.queue.append(event)
+        self._process_queue(future.get_flux())
 
         if event is not None:
             future.reset()
 
+    def _output_closed(self):
+        self.closed = True
+        #  Fulfill this future with None (indicating no more data)
+        #  if the 'finish' event is also posted in the main eventlog.
+        #  This is done to ensure any exception has been captured.
+        #
+        #  If nowait is enabled, then the main eventlog may not be
+        #  monitored, so assume job is finished. This may miss logging
+        #  job exceptions in some cases, but it is assumed that users
+        #  of the `nowait` option are using it because the main
+        #  eventlog is already being monitored.
+        #
+        if self.nowait or self.finished:
+            self.fulfill()
+
+    def _process_queue(self, flux_handle):
+        #  Deliver queued output events in order, stopping at a "chunk"
+        #  event until its entries have been loaded (see _chunk_loaded()).
+        #
+        while self.queue and self.chunk_future is None:
+            event = self.queue[0]
+            if event is not None and event.name == "chunk":
+                try:
+                    self.chunk_future = _ContentLoadRPC(
+                        flux_handle, event.context["blobref"]
+                    ).then(self._chunk_loaded, event)
+                except (OSError, ValueError, KeyError) as exc:
+                    self.fulfill_error(errno.EPROTO, f"output chunk: {exc}")
+                    self.queue.clear()
+                return
+            self.queue.pop(0)
+            if event is None:
+                self._output_closed()
+            else:
+                self.fulfill(event)
+
+    def _chunk_loaded(self, future, event):
+        #  Note: handle and propagate errors here instead of raising them,
+        #  for the reasons noted in _wait_for_start_event() below.
+        #
+        self.chunk_future = None
+        try:
+            entries = _output_chunk_decode(event, future.get_raw())
+        except OSError as exc:
+            self.fulfill_error(exc.errno, f"output chunk: {exc.strerror}")
+            self.queue.clear()
+            return
+        except (ValueError, KeyError) as exc:
+            self.fulfill_error(errno.EPROTO, f"output chunk: {exc}")
+            self.queue.clear()
+            return
+        for entry in entries:
+            self.fulfill(entry)
+        self.queue.pop(0)
+        self._process_queue(future.get_flux())
+
     def _wait_for_shell_init(self, future, jobid):
         #  Wait for the 'shell.init' event, then the output eventlog
         #  should be available.
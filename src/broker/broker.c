@@ -455,7 +455,7 @@ int main (int argc, char *argv[])
         log_err ("heaptrace_initialize");
         goto cleanup;
     }
-    if (exec_initialize (ctx.h, ctx.rank, ctx.attrs) < 0) {
+    if (exec_initialize (ctx.h, ctx.overlay, ctx.rank, ctx.attrs) < 0) {
         log_err ("exec_initialize");
         goto cleanup;
     }
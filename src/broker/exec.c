@@ -23,6 +23,9 @@
 
 #include "src/common/libsubprocess/server.h"
 #include "src/common/libutil/errprintf.h"
+#include "src/common/libutil/fsd.h"
+#include "src/common/libutil/parse_size.h"
+#include "src/common/libutil/log.h"
 
 #include "attr.h"
 #include "exec.h"
@@ -55,7 +58,41 @@ static int reject_nonlocal (const flux_msg_t *msg,
     return 0;
 }
 
-int exec_initialize (flux_t *h, uint32_t rank, attr_t *attrs)
+static int configure_batch (subprocess_server_t *s, attr_t *attrs)
+{
+    const char *name;
+    const char *val;
+    uint64_t size = SUBPROCESS_SERVER_BATCH_SIZE;
+    double timeout = SUBPROCESS_SERVER_BATCH_TIMEOUT;
+
+    name = "broker.rexec-batch-size";
+    if (attr_get (attrs, name, &val, NULL) == 0
+        && parse_size (val, &size) < 0) {
+        log_msg ("Error parsing %s attribute", name);
+        return -1;
+    }
+    name = "broker.rexec-batch-timeout";
+    if (attr_get (attrs, name, &val, NULL) == 0
+        && fsd_parse_duration (val, &timeout) < 0) {
+        log_msg ("Error parsing %s attribute", name);
+        return -1;
+    }
+    subprocess_server_set_batch (s, size, timeout);
+    return 0;
+}
+
+/* Route rexec.tree-exec requests along the overlay network.
+ */
+static int route_tbon (uint32_t rank, void *arg)
+{
+    struct overlay *ov = arg;
+    return overlay_get_child_route (ov, rank);
+}
+
+int exec_initialize (flux_t *h,
+                     struct overlay *ov,
+                     uint32_t rank,
+                     attr_t *attrs)
 {
     subprocess_server_t *s = NULL;
     const char *local_uri;
@@ -66,6 +103,9 @@ int exec_initialize (flux_t *h, uint32_t rank, attr_t *attrs)
         goto cleanup;
     if (rank == 0)
         subprocess_server_set_auth_cb (s, reject_nonlocal, h);
+    subprocess_server_set_route_cb (s, route_tbon, ov);
+    if (configure_batch (s, attrs) < 0)
+        goto cleanup;
     if (flux_aux_set (h,
                       "flux::exec",
                       s,
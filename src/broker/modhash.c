@@ -32,11 +32,46 @@ struct modhash {
     zhash_t *zh_byuuid;
     flux_msg_handler_t **handlers;
     struct broker *ctx;
+    zlist_t *bulk_loads;
+};
+
+enum bulk_state {
+    BULK_PENDING,
+    BULK_LOADING,
+    BULK_RUNNING,
+};
+
+/* One module of a module.load-bulk request.
+ * 'key' is the explicit module name if provided, otherwise the path as
+ * given by the requestor, and is what other entries name in 'after'.
+ */
+struct bulk_entry {
+    const char *key;
+    const char *name;
+    const char *path;
+    json_t *args;
+    json_t *after;
+    char *uuid;
+    enum bulk_state state;
+    double t_start;
+    double t_running;
+};
+
+struct bulk_load {
+    modhash_t *mh;
+    const flux_msg_t *request;
+    json_t *modules;
+    struct bulk_entry *entries;
+    int count;
+    int nloading;
+    int nrunning;
+    double t_request;
 };
 
 static json_t *modhash_get_modlist (modhash_t *mh,
                                     double now,
                                     struct service_switch *sw);
+static void bulk_load_notify (modhash_t *mh, module_t *p);
 
 int modhash_response_sendmsg_new (modhash_t *mh, flux_msg_t **msg)
 {
@@ -207,6 +242,10 @@ static void module_status_cb (module_t *p, int prev_status, void *arg)
     int status = module_get_status (p);
     const char *name = module_get_name (p);
 
+    /* Advance any module.load-bulk request this module is part of.
+     */
+    bulk_load_notify (ctx->modhash, p);
+
     /* Transition from INIT
      * If module started normally, i.e. INIT->RUNNING, then
      * respond to insmod requests now. O/w, delay responses until
@@ -246,12 +285,12 @@ static int mod_svc_cb (flux_msg_t **msg, void *arg)
  * 'name' is the name to use for the module (NULL = use dso basename minus ext)
  * 'path' is either a dso path or a dso basename (e.g. "kvs" or "/a/b/kvs.so".
  */
-int modhash_load (modhash_t *mh,
-                  const char *name,
-                  const char *path,
-                  json_t *args,
-                  const flux_msg_t *request,
-                  flux_error_t *error)
+static module_t *load_module (modhash_t *mh,
+                              const char *name,
+                              const char *path,
+                              json_t *args,
+                              const flux_msg_t *request,
+                              flux_error_t *error)
 {
     const char *searchpath;
     char *pattern = NULL;
@@ -262,11 +301,11 @@ int modhash_load (modhash_t *mh,
         if (!(searchpath = getenv ("FLUX_MODULE_PATH"))) {
             errprintf (error, "FLUX_MODULE_PATH is not set in the environment");
             errno = EINVAL;
-            return -1;
+            return NULL;
         }
         if (asprintf (&pattern, "%s.so*", path) < 0) {
             errprintf (error, "out of memory");
-            return -1;
+            return NULL;
         }
         if (!(files = dirwalk_find (searchpath,
                                     DIRWALK_REALPATH | DIRWALK_NORECURSE,
@@ -311,7 +350,7 @@ int modhash_load (modhash_t *mh,
     flux_log (mh->ctx->h, LOG_DEBUG, "insmod %s", module_get_name (p));
     zlist_destroy (&files);
     free (pattern);
-    return 0;
+    return p;
 service_remove:
     service_remove_byuuid (mh->ctx->services, module_get_uuid (p));
 module_remove:
@@ -319,7 +358,19 @@ module_remove:
 error:
     ERRNO_SAFE_WRAP (zlist_destroy, &files);
     ERRNO_SAFE_WRAP (free, pattern);
-    return -1;
+    return NULL;
+}
+
+int modhash_load (modhash_t *mh,
+                  const char *name,
+                  const char *path,
+                  json_t *args,
+                  const flux_msg_t *request,
+                  flux_error_t *error)
+{
+    if (!load_module (mh, name, path, args, request, error))
+        return -1;
+    return 0;
 }
 
 /* Load a module, asynchronously.
@@ -354,6 +405,286 @@ error:
         flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
 }
 
+/* Bulk module load.
+ * Modules are started as soon as all modules named in their 'after' array
+ * are running.  Each module runs in its own thread, so modules with no
+ * dependency relationship initialize concurrently.  The response contains
+ * the start time (relative to receipt of the request) and the time taken
+ * to reach the running state for each module.  On the first failure, an
+ * error response is sent and no further modules are started, but modules
+ * already loaded are left in place.
+ */
+static void bulk_load_destroy (struct bulk_load *bl)
+{
+    if (bl) {
+        int saved_errno = errno;
+        if (bl->entries) {
+            for (int i = 0; i < bl->count; i++)
+                free (bl->entries[i].uuid);
+            free (bl->entries);
+        }
+        json_decref (bl->modules);
+        flux_msg_decref (bl->request);
+        free (bl);
+        errno = saved_errno;
+    }
+}
+
+static json_t *bulk_load_timings (struct bulk_load *bl)
+{
+    json_t *a;
+
+    if (!(a = json_array ()))
+        goto nomem;
+    for (int i = 0; i < bl->count; i++) {
+        struct bulk_entry *e = &bl->entries[i];
+        json_t *o;
+
+        if (!(o = json_pack ("{s:s s:f s:f}",
+                             "name", e->key,
+                             "start", e->t_start - bl->t_request,
+                             "duration", e->t_running - e->t_start))
+            || json_array_append_new (a, o) < 0) {
+            json_decref (o);
+            goto nomem;
+        }
+        flux_log (bl->mh->ctx->h,
+                  LOG_DEBUG,
+                  "load-bulk: %s started at +%.3fs, running after %.3fs",
+                  e->key,
+                  e->t_start - bl->t_request,
+                  e->t_running - e->t_start);
+    }
+    return a;
+nomem:
+    json_decref (a);
+    errno = ENOMEM;
+    return NULL;
+}
+
+/* Respond to the request (success if errnum == 0) and retire it.
+ */
+static void bulk_load_finish (struct bulk_load *bl,
+                              int errnum,
+                              const char *errmsg)
+{
+    flux_t *h = bl->mh->ctx->h;
+    json_t *timings = NULL;
+
+    if (errnum == 0 && !(timings = bulk_load_timings (bl))) {
+        errnum = errno;
+        errmsg = NULL;
+    }
+    if (errnum == 0) {
+        if (flux_respond_pack (h, bl->request, "{s:O}", "modules", timings) < 0)
+            flux_log_error (h, "error responding to module.load-bulk");
+    }
+    else {
+        if (flux_respond_error (h, bl->request, errnum, errmsg) < 0)
+            flux_log_error (h, "error responding to module.load-bulk");
+    }
+    json_decref (timings);
+    zlist_remove (bl->mh->bulk_loads, bl);
+    bulk_load_destroy (bl);
+}
+
+static struct bulk_entry *bulk_entry_lookup (struct bulk_load *bl,
+                                             const char *key)
+{
+    for (int i = 0; i < bl->count; i++) {
+        if (bl->entries[i].key && streq (bl->entries[i].key, key))
+            return &bl->entries[i];
+    }
+    return NULL;
+}
+
+/* Return true if all modules this entry depends on are running.
+ * Dependencies outside of the request were verified to be loaded
+ * when the request was received.
+ */
+static bool bulk_entry_ready (struct bulk_load *bl, struct bulk_entry *e)
+{
+    size_t index;
+    json_t *o;
+
+    json_array_foreach (e->after, index, o) {
+        struct bulk_entry *dep = bulk_entry_lookup (bl, json_string_value (o));
+        if (dep && dep->state != BULK_RUNNING)
+            return false;
+    }
+    return true;
+}
+
+/* Start all pending modules whose dependencies are satisfied, then
+ * finish the request if all modules are running, or if nothing is
+ * loading and pending modules remain (a dependency cycle).
+ * N.B. bl may be destroyed on return.
+ */
+static void bulk_load_continue (struct bulk_load *bl)
+{
+    flux_t *h = bl->mh->ctx->h;
+    double now = flux_reactor_now (flux_get_reactor (h));
+
+    for (int i = 0; i < bl->count; i++) {
+        struct bulk_entry *e = &bl->entries[i];
+        flux_error_t error;
+        flux_error_t load_error;
+        module_t *p;
+
+        if (e->state != BULK_PENDING || !bulk_entry_ready (bl, e))
+            continue;
+        if (!(p = load_module (bl->mh,
+                               e->name,
+                               e->path,
+                               e->args,
+                               NULL,
+                               &load_error))
+            || !(e->uuid = strdup (module_get_uuid (p)))) {
+            if (p)
+                errprintf (&load_error, "out of memory");
+            errprintf (&error, "%s: %s", e->key, load_error.text);
+            bulk_load_finish (bl, errno, error.text);
+            return;
+        }
+        e->state = BULK_LOADING;
+        e->t_start = now;
+        bl->nloading++;
+    }
+    if (bl->nrunning == bl->count)
+        bulk_load_finish (bl, 0, NULL);
+    else if (bl->nloading == 0)
+        bulk_load_finish (bl, ELOOP, "module dependencies contain a cycle");
+}
+
+/* Called on each module status change.  If the module belongs to a
+ * pending bulk load request, update that request.
+ */
+static void bulk_load_notify (modhash_t *mh, module_t *p)
+{
+    const char *uuid = module_get_uuid (p);
+    int status = module_get_status (p);
+    struct bulk_load *bl;
+
+    if (!mh->bulk_loads)
+        return;
+    bl = zlist_first (mh->bulk_loads);
+    while (bl) {
+        for (int i = 0; i < bl->count; i++) {
+            struct bulk_entry *e = &bl->entries[i];
+            int errnum;
+
+            if (e->state != BULK_LOADING || !streq (e->uuid, uuid))
+                continue;
+            /* As with module.load, a module that exits without error
+             * before reaching the running state is considered loaded.
+             */
+            errnum = status == FLUX_MODSTATE_EXITED ? module_get_errnum (p) : 0;
+            if (errnum != 0) {
+                flux_error_t error;
+                errprintf (&error, "%s: %s", e->key, strerror (errnum));
+                bulk_load_finish (bl, errnum, error.text);
+            }
+            else if (status == FLUX_MODSTATE_RUNNING
+                     || status == FLUX_MODSTATE_EXITED) {
+                e->state = BULK_RUNNING;
+                e->t_running = flux_reactor_now (flux_get_reactor (mh->ctx->h));
+                bl->nloading--;
+                bl->nrunning++;
+                bulk_load_continue (bl);
+            }
+            return;
+        }
+        bl = zlist_next (mh->bulk_loads);
+    }
+}
+
+/* Load a set of modules, asynchronously.
+ * N.B. bulk_load_continue() handles the response once the request
+ * has been validated.
+ */
+static void load_bulk_cb (flux_t *h,
+                          flux_msg_handler_t *mh,
+                          const flux_msg_t *msg,
+                          void *arg)
+{
+    broker_ctx_t *ctx = arg;
+    struct bulk_load *bl = NULL;
+    json_t *modules;
+    json_t *entry;
+    size_t index;
+    flux_error_t error;
+    const char *errmsg = NULL;
+
+    if (flux_request_unpack (msg, NULL, "{s:o}", "modules", &modules) < 0)
+        goto error;
+    if (!json_is_array (modules) || json_array_size (modules) == 0) {
+        errno = EPROTO;
+        goto error;
+    }
+    if (!(bl = calloc (1, sizeof (*bl)))
+        || !(bl->entries = calloc (json_array_size (modules),
+                                   sizeof (bl->entries[0]))))
+        goto nomem;
+    bl->mh = ctx->modhash;
+    bl->request = flux_msg_incref (msg);
+    bl->modules = json_incref (modules);
+    bl->count = json_array_size (modules);
+    bl->t_request = flux_reactor_now (flux_get_reactor (h));
+
+    json_array_foreach (modules, index, entry) {
+        struct bulk_entry *e = &bl->entries[index];
+        const char *key;
+
+        if (json_unpack (entry,
+                         "{s?s s:s s:o s?o}",
+                         "name", &e->name,
+                         "path", &e->path,
+                         "args", &e->args,
+                         "after", &e->after) < 0
+            || (e->after && !json_is_array (e->after))) {
+            errno = EPROTO;
+            goto error;
+        }
+        key = e->name ? e->name : e->path;
+        if (bulk_entry_lookup (bl, key)) {
+            errprintf (&error, "%s: module appears more than once", key);
+            errmsg = error.text;
+            errno = EEXIST;
+            goto error;
+        }
+        e->key = key;
+    }
+    for (int i = 0; i < bl->count; i++) {
+        struct bulk_entry *e = &bl->entries[i];
+        json_t *o;
+
+        json_array_foreach (e->after, index, o) {
+            const char *dep = json_string_value (o);
+            if (!dep) {
+                errno = EPROTO;
+                goto error;
+            }
+            if (!bulk_entry_lookup (bl, dep)
+                && !modhash_lookup_byname (ctx->modhash, dep)) {
+                errprintf (&error, "%s: unknown dependency %s", e->key, dep);
+                errmsg = error.text;
+                errno = ENOENT;
+                goto error;
+            }
+        }
+    }
+    if (zlist_append (ctx->modhash->bulk_loads, bl) < 0)
+        goto nomem;
+    bulk_load_continue (bl);
+    return;
+nomem:
+    errno = ENOMEM;
+error:
+    if (flux_respond_error (h, msg, errno, errmsg) < 0)
+        flux_log_error (h, "error responding to module.load-bulk");
+    bulk_load_destroy (bl);
+}
+
 
 static int unload_module (broker_ctx_t *ctx,
                           const char *name,
@@ -579,6 +910,12 @@ static const struct flux_msg_handler_spec htab[] = {
         load_cb,
         0,
     },
+    {
+        FLUX_MSGTYPE_REQUEST,
+        "module.load-bulk",
+        load_bulk_cb,
+        0,
+    },
     {
         FLUX_MSGTYPE_REQUEST,
         "module.remove",
@@ -626,7 +963,8 @@ modhash_t *modhash_create (struct broker *ctx)
     mh->ctx = ctx;
     if (flux_msg_handler_addvec (ctx->h, htab, ctx, &mh->handlers) < 0)
         goto error;
-    if (!(mh->zh_byuuid = zhash_new ())) {
+    if (!(mh->zh_byuuid = zhash_new ())
+        || !(mh->bulk_loads = zlist_new ())) {
         errno = ENOMEM;
         goto error;
     }
@@ -644,6 +982,12 @@ int modhash_destroy (modhash_t *mh)
     int count = 0;
 
     if (mh) {
+        if (mh->bulk_loads) {
+            struct bulk_load *bl;
+            while ((bl = zlist_pop (mh->bulk_loads)))
+                bulk_load_destroy (bl);
+            zlist_destroy (&mh->bulk_loads);
+        }
         if (mh->zh_byuuid) {
             FOREACH_ZHASH (mh->zh_byuuid, uuid, p) {
                 log_msg ("broker module '%s' was not properly shut down",
@@ -480,6 +480,13 @@ static struct child *child_lookup_route (struct overlay *ov, uint32_t rank)
     return child_lookup_byrank (ov, child_rank);
 }
 
+int overlay_get_child_route (struct overlay *ov, uint32_t rank)
+{
+    if (!ov || !ov->topo)
+        return -1;
+    return topology_get_child_route (ov->topo, rank);
+}
+
 bool overlay_uuid_is_child (struct overlay *ov, const char *uuid)
 {
     if (child_lookup_online (ov, uuid) != NULL)
@@ -101,6 +101,11 @@ int overlay_set_tbon_interface_hint (struct overlay *ov, const char *val);
  */
 struct idset *overlay_get_default_critical_ranks (struct overlay *ov);
 
+/* Return the rank of the direct child of this broker whose subtree
+ * contains 'rank', or -1 if 'rank' is not a descendant.
+ */
+int overlay_get_child_route (struct overlay *ov, uint32_t rank);
+
 /* Fetch TBON subtree topo at 'rank'.  The returned topology object has the
  * following recursive structure, where "children" is an array of topology
  * objects:
@@ -25,23 +25,18 @@
 #include "src/common/libeventlog/eventlog.h"
 #include "src/common/libkvs/treeobj.h"
 #include "src/common/libkvs/kvs_checkpoint.h"
+#include "src/common/libkvs/kvs_snapshot.h"
 #include "src/common/libutil/fsd.h"
 #include "src/common/libutil/blobref.h"
-#include "src/common/libcontent/content.h"
 #include "ccan/str/str.h"
 
 #include "builtin.h"
 
-static void dump_treeobj (struct archive *ar,
-                          flux_t *h,
-                          const char *path,
-                          json_t *treeobj);
-
 static bool sd_notify_flag;
 static bool verbose;
 static bool quiet;
 static bool ignore_failed_read;
-static int content_flags;
+static int snapshot_flags = KVS_SNAPSHOT_PREFETCH_VALUES;
 static time_t dump_time;
 static gid_t dump_gid;
 static uid_t dump_uid;
@@ -144,55 +139,26 @@ static void dump_write_data (struct archive *ar, const void *data, int size)
 }
 
 static void dump_valref (struct archive *ar,
-                         flux_t *h,
+                         struct kvs_snapshot *snap,
                          const char *path,
-                         json_t *treeobj)
+                         const json_t *treeobj)
 {
-    int count = treeobj_get_count (treeobj);
-    struct flux_msglist *l;
-    const flux_msg_t *msg;
-    int total_size = 0;
     struct archive_entry *entry;
-    const void *data;
+    void *data;
     int len;
+    flux_error_t error;
 
-    /* We need the total size before we start writing archive data,
-     * so make a first pass, saving the data for writing later.
-     */
-    /* N.B. first attempt was to save the futures in an array, but ran into:
-     *   flux: ev_epoll.c:134: epoll_modify: Assertion `("libev: I/O watcher
-     *    with invalid fd found in epoll_ctl", errno != EBADF && errno != ELOOP
-     *    && errno != EINVAL)' failed.
-     * while archiving a resource.eventlog with 781 entries.  Instead of
-     * retaining the futures for a second pass, just retain references to the
-     * content.load response messages.
+    /* N.B. the snapshot loads valref blobs in parallel and concatenates
+     * them, since we need the total size before writing archive data.
      */
-    if (!(l = flux_msglist_create ()))
-        log_err_exit ("could not create message list");
-    for (int i = 0; i < count; i++) {
-        flux_future_t *f;
-        if (!(f = content_load_byblobref (h,
-                                          treeobj_get_blobref (treeobj, i),
-                                          content_flags))
-            || flux_future_get (f, (const void **)&msg) < 0
-            || flux_response_decode_raw (msg, NULL, &data, &len) < 0) {
-            read_error ("%s: missing blobref %d: %s",
-                        path,
-                        i,
-                        future_strerror (f, errno));
-            flux_future_destroy (f);
-            flux_msglist_destroy (l);
-            return;
-        }
-        if (flux_msglist_append (l, msg) < 0)
-            log_err_exit ("could not stash load response message");
-        total_size += len;
-        flux_future_destroy (f);
+    if (kvs_snapshot_get_value (snap, treeobj, &data, &len, &error) < 0) {
+        read_error ("%s: %s", path, error.text);
+        return;
     }
     if (!(entry = archive_entry_new ()))
         log_msg_exit ("error creating archive entry");
     archive_entry_set_pathname (entry, path);
-    archive_entry_set_size (entry, total_size);
+    archive_entry_set_size (entry, len);
     archive_entry_set_perm (entry, 0644);
     archive_entry_set_filetype (entry, AE_IFREG);
     archive_entry_set_mtime (entry, dump_time, 0);
@@ -201,22 +167,16 @@ static void dump_valref (struct archive *ar,
 
     if (archive_write_header (ar, entry) != ARCHIVE_OK)
         log_msg_exit ("%s", archive_error_string (ar));
-    while ((msg = flux_msglist_pop (l))) {
-        if (flux_response_decode_raw (msg, NULL, &data, &len) < 0)
-            log_err_exit ("error processing stashed valref responses");
-        if (len > 0)
-            dump_write_data (ar, data, len);
-        flux_msg_decref (msg);
-    }
+    if (len > 0)
+        dump_write_data (ar, data, len);
     archive_entry_free (entry);
     progress (1);
-    flux_msglist_destroy (l);
+    free (data);
 }
 
 static void dump_val (struct archive *ar,
-                      flux_t *h,
                       const char *path,
-                      json_t *treeobj)
+                      const json_t *treeobj)
 {
     struct archive_entry *entry;
     void *data;
@@ -241,9 +201,8 @@ static void dump_val (struct archive *ar,
 }
 
 static void dump_symlink (struct archive *ar,
-                          flux_t *h,
                           const char *path,
-                          json_t *treeobj)
+                          const json_t *treeobj)
 {
     struct archive_entry *entry;
     const char *ns;
@@ -271,117 +230,70 @@ static void dump_symlink (struct archive *ar,
     archive_entry_free (entry);
 }
 
-static void dump_dir (struct archive *ar,
-                      flux_t *h,
-                      const char *path,
-                      json_t *treeobj)
-{
-    json_t *dict = treeobj_get_data (treeobj);
-    const char *name;
-    json_t *entry;
-
-    json_object_foreach (dict, name, entry) {
-        char *newpath;
-        if (asprintf (&newpath, "%s/%s", path, name) < 0)
-            log_msg_exit ("out of memory");
-        dump_treeobj (ar, h, newpath, entry); // recurse
-        free (newpath);
-    }
-}
-
-static void dump_dirref (struct archive *ar,
-                         flux_t *h,
-                         const char *path,
-                         json_t *treeobj)
-{
-    flux_future_t *f;
-    const void *buf;
-    int buflen;
-    json_t *treeobj_deref = NULL;
-
-    if (treeobj_get_count (treeobj) != 1)
-        log_msg_exit ("%s: blobref count is not 1", path);
-    if (!(f = content_load_byblobref (h,
-                                      treeobj_get_blobref (treeobj, 0),
-                                      content_flags))
-        || content_load_get (f, &buf, &buflen) < 0) {
-        read_error ("%s: missing blobref: %s",
-                    path,
-                    future_strerror (f, errno));
-        flux_future_destroy (f);
-        return;
-    }
-    if (!(treeobj_deref = treeobj_decodeb (buf, buflen)))
-        log_err_exit ("%s: could not decode directory", path);
-    if (!treeobj_is_dir (treeobj_deref))
-        log_msg_exit ("%s: dirref references non-directory", path);
-    dump_dir (ar, h, path, treeobj_deref); // recurse
-    json_decref (treeobj_deref);
-    flux_future_destroy (f);
-}
-
 static void dump_treeobj (struct archive *ar,
-                          flux_t *h,
+                          struct kvs_snapshot *snap,
                           const char *path,
-                          json_t *treeobj)
+                          const json_t *treeobj)
 {
     if (treeobj_validate (treeobj) < 0)
         log_msg_exit ("%s: invalid tree object", path);
-    if (treeobj_is_symlink (treeobj)) {
-        if (verbose)
-            fprintf (stderr, "%s\n", path);
-        dump_symlink (ar, h, path, treeobj);
-    }
-    else if (treeobj_is_val (treeobj)) {
-        if (verbose)
-            fprintf (stderr, "%s\n", path);
-        dump_val (ar, h, path, treeobj);
-    }
-    else if (treeobj_is_valref (treeobj)) {
-        if (verbose)
-            fprintf (stderr, "%s\n", path);
-        dump_valref (ar, h, path, treeobj);
-    }
-    else if (treeobj_is_dirref (treeobj)) {
-        dump_dirref (ar, h, path, treeobj); // recurse
-    }
-    else if (treeobj_is_dir (treeobj)) {
-        dump_dir (ar, h, path, treeobj); // recurse
-    }
+    if (verbose)
+        fprintf (stderr, "%s\n", path);
+    if (treeobj_is_symlink (treeobj))
+        dump_symlink (ar, path, treeobj);
+    else if (treeobj_is_val (treeobj))
+        dump_val (ar, path, treeobj);
+    else if (treeobj_is_valref (treeobj))
+        dump_valref (ar, snap, path, treeobj);
 }
 
+/* Walk the KVS snapshot rooted at 'blobref' depth-first.  The snapshot
+ * iterator loads directories (and values) from the content store ahead
+ * of the traversal, so dump isn't bound by one content.load round trip
+ * per directory.
+ */
 static void dump_blobref (struct archive *ar,
                           flux_t *h,
                           const char *blobref)
 {
-    flux_future_t *f;
-    const void *buf;
-    int buflen;
-    json_t *treeobj;
-    json_t *dict;
+    struct kvs_snapshot *snap;
+    struct kvs_snapshot_itr *itr;
     const char *key;
-    json_t *entry;
-
-    if (!(f = content_load_byblobref (h, blobref, content_flags))
-        || content_load_get (f, &buf, &buflen) < 0) {
-        read_error ("cannot load root tree object: %s",
-                    future_strerror (f, errno));
-        flux_future_destroy (f);
+    const json_t *treeobj;
+    flux_error_t error;
+    int rc;
+
+    if (!(snap = kvs_snapshot_openat (h, blobref, snapshot_flags)))
+        log_err_exit ("could not create KVS snapshot");
+    if (!(itr = kvs_snapshot_itr_create (snap, NULL))) {
+        read_error ("cannot load root tree object: %s", strerror (errno));
+        kvs_snapshot_close (snap);
         return;
     }
-    if (!(treeobj = treeobj_decodeb (buf, buflen)))
-        log_err_exit ("cannot decode root tree object");
-    if (treeobj_validate (treeobj) < 0)
-        log_msg_exit ("invalid root tree object");
-    if (!treeobj_is_dir (treeobj))
-        log_msg_exit ("root tree object is not a directory");
-
-    dict = treeobj_get_data (treeobj);
-    json_object_foreach (dict, key, entry) {
-        dump_treeobj (ar, h, key, entry);
+    while ((rc = kvs_snapshot_itr_next (itr, &key, &treeobj, &error))) {
+        char *path;
+
+        if (rc < 0) {
+            /* A corrupt directory is fatal, a missing one is a read error.
+             */
+            if (errno == EPROTO || errno == ENOTDIR)
+                log_msg_exit ("%s", error.text);
+            read_error ("%s", error.text);
+            continue;
+        }
+        /* KVS path separator is '.', archive path separator is '/'
+         */
+        if (!(path = strdup (key)))
+            log_msg_exit ("out of memory");
+        for (char *cp = path; *cp != '\0'; cp++) {
+            if (*cp == '.')
+                *cp = '/';
+        }
+        dump_treeobj (ar, snap, path, treeobj);
+        free (path);
     }
-    json_decref (treeobj);
-    flux_future_destroy (f);
+    kvs_snapshot_itr_destroy (itr);
+    kvs_snapshot_close (snap);
 }
 
 static int cmd_dump (optparse_t *p, int ac, char *av[])
@@ -406,7 +318,7 @@ static int cmd_dump (optparse_t *p, int ac, char *av[])
     if (optparse_hasopt (p, "ignore-failed-read"))
         ignore_failed_read = true;
     if (optparse_hasopt (p, "no-cache")) {
-        content_flags |= CONTENT_FLAG_CACHE_BYPASS;
+        snapshot_flags |= KVS_SNAPSHOT_CACHE_BYPASS;
         kvs_checkpoint_flags |= KVS_CHECKPOINT_FLAG_CACHE_BYPASS;
     }
 
@@ -168,6 +168,8 @@ def fetch_jobs_flux(args, fields, flux_handle=None):
             except ValueError:
                 raise ValueError(f"-i/--include: invalid targets: {args.include}")
 
+    #  Stream unlimited listings so the job-list module does not need to
+    #  build the entire result in a single response
     jobs_rpc = JobList(
         flux_handle,
         ids=args.jobids,
@@ -179,6 +181,7 @@ def fetch_jobs_flux(args, fields, flux_handle=None):
         name=args.name,
         queue=args.queue,
         constraint=constraint,
+        chunk_size=1000 if args.count == 0 else 0,
     )
 
     jobs = jobs_rpc.jobs()
@@ -44,6 +44,7 @@ const int max_idle = 99;
 int cmd_list (optparse_t *p, int argc, char **argv);
 int cmd_remove (optparse_t *p, int argc, char **argv);
 int cmd_load (optparse_t *p, int argc, char **argv);
+int cmd_load_bulk (optparse_t *p, int argc, char **argv);
 int cmd_reload (optparse_t *p, int argc, char **argv);
 int cmd_stats (optparse_t *p, int argc, char **argv);
 int cmd_debug (optparse_t *p, int argc, char **argv);
@@ -79,6 +80,13 @@ static struct optparse_option load_opts[] =  {
     OPTPARSE_TABLE_END,
 };
 
+static struct optparse_option load_bulk_opts[] =  {
+    { .name = "verbose", .key = 'v', .has_arg = 0,
+      .usage = "Show per-module load timing",
+    },
+    OPTPARSE_TABLE_END,
+};
+
 static struct optparse_option stats_opts[] =  {
     { .name = "parse", .key = 'p', .has_arg = 1, .arginfo = "OBJNAME",
       .usage = "Parse object period-delimited object name",
@@ -166,6 +174,13 @@ static struct optparse_subcommand subcommands[] = {
       0,
       load_opts,
     },
+    { "load-bulk",
+      "[OPTIONS] [FILE]",
+      "Load modules listed in FILE (default stdin) concurrently",
+      cmd_load_bulk,
+      0,
+      load_bulk_opts,
+    },
     { "reload",
       "[OPTIONS] module",
       "Reload module",
@@ -351,6 +366,143 @@ int cmd_load (optparse_t *p, int argc, char **argv)
     return 0;
 }
 
+/* Parse one line of 'flux module load-bulk' input of the form:
+ *   MODULE [--name=NAME] [--after=MODULE[,MODULE...]] [ARG...]
+ * and return a module.load-bulk entry.  Return NULL for a blank line
+ * or comment.
+ */
+static json_t *bulk_entry_create (char *line, const char *file, int lineno)
+{
+    const char *delim = " \t\r\n";
+    char *saveptr = NULL;
+    char *tok;
+    char *fullpath = NULL;
+    json_t *args;
+    json_t *entry;
+
+    if (!(tok = strtok_r (line, delim, &saveptr)) || tok[0] == '#')
+        return NULL;
+    if (canonicalize_if_path (tok, &fullpath) < 0)
+        log_err_exit ("%s:%d: could not canonicalize module path '%s'",
+                      file,
+                      lineno,
+                      tok);
+    if (!(args = json_array ())
+        || !(entry = json_pack ("{s:s s:o}",
+                                "path", fullpath ? fullpath : tok,
+                                "args", args)))
+        log_msg_exit ("failed to create module.load-bulk entry");
+    free (fullpath);
+
+    while ((tok = strtok_r (NULL, delim, &saveptr))) {
+        json_t *o = NULL;
+
+        /* Options are only recognized before the first module argument.
+         */
+        if (json_array_size (args) == 0 && strstarts (tok, "--name=")) {
+            if (set_string (entry, "name", tok + 7) < 0)
+                log_msg_exit ("failed to set module name");
+        }
+        else if (json_array_size (args) == 0 && strstarts (tok, "--after=")) {
+            char *dep;
+            char *depsave = NULL;
+
+            if (!(o = json_array ())
+                || json_object_set_new (entry, "after", o) < 0)
+                log_msg_exit ("failed to create module dependency list");
+            dep = strtok_r (tok + 8, ",", &depsave);
+            while (dep) {
+                json_t *s = json_string (dep);
+                if (!s || json_array_append_new (o, s) < 0)
+                    log_msg_exit ("failed to append module dependency");
+                dep = strtok_r (NULL, ",", &depsave);
+            }
+        }
+        else {
+            if (!(o = json_string (tok))
+                || json_array_append_new (args, o) < 0)
+                log_msg_exit ("failed to append module argument");
+        }
+    }
+    return entry;
+}
+
+int cmd_load_bulk (optparse_t *p, int argc, char **argv)
+{
+    int n = optparse_option_index (p);
+    const char *file = "stdin";
+    FILE *fp = stdin;
+    char *line = NULL;
+    size_t size = 0;
+    int lineno = 0;
+    json_t *modules;
+    json_t *timings;
+    json_t *entry;
+    size_t index;
+    flux_future_t *f;
+    flux_t *h;
+
+    if (n < argc - 1) {
+        optparse_print_usage (p);
+        exit (1);
+    }
+    if (n == argc - 1 && !streq (argv[n], "-")) {
+        file = argv[n];
+        if (!(fp = fopen (file, "r")))
+            log_err_exit ("%s", file);
+    }
+    if (!(modules = json_array ()))
+        log_msg_exit ("out of memory");
+    while (getline (&line, &size, fp) >= 0) {
+        lineno++;
+        if ((entry = bulk_entry_create (line, file, lineno))
+            && json_array_append_new (modules, entry) < 0)
+            log_msg_exit ("out of memory");
+    }
+    if (ferror (fp))
+        log_err_exit ("error reading %s", file);
+    if (fp != stdin)
+        fclose (fp);
+    free (line);
+
+    if (json_array_size (modules) == 0) {
+        json_decref (modules);
+        return 0;
+    }
+    if (!(h = flux_open (NULL, 0)))
+        log_err_exit ("flux_open");
+    if (!(f = flux_rpc_pack (h,
+                             "module.load-bulk",
+                             FLUX_NODEID_ANY,
+                             0,
+                             "{s:O}",
+                             "modules", modules))
+        || flux_rpc_get_unpack (f, "{s:o}", "modules", &timings) < 0)
+        log_msg_exit ("load-bulk: %s", future_strerror (f, errno));
+    if (optparse_hasopt (p, "verbose")) {
+        json_array_foreach (timings, index, entry) {
+            const char *name;
+            double start;
+            double duration;
+
+            if (json_unpack (entry,
+                             "{s:s s:F s:F}",
+                             "name", &name,
+                             "start", &start,
+                             "duration", &duration) < 0)
+                log_msg_exit ("error decoding module.load-bulk response");
+            printf ("%s: started at +%.3fs, loaded in %.3fs\n",
+                    name,
+                    start,
+                    duration);
+        }
+    }
+    flux_future_destroy (f);
+    json_decref (modules);
+    flux_close (h);
+    return 0;
+}
+
 static void module_remove (flux_t *h, optparse_t *p, const char *path)
 {
     char *fullpath = NULL;
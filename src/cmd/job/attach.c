@@ -18,6 +18,7 @@
 #include <jansson.h>
 #include <sys/ioctl.h>
 #include <signal.h>
+#include <lz4.h>
 
 #include <flux/core.h>
 #include <flux/optparse.h>
@@ -30,6 +31,7 @@
 #include "src/common/libeventlog/eventlog.h"
 #include "src/common/libeventlog/formatter.h"
 #include "src/common/libioencode/ioencode.h"
+#include "src/common/libcontent/content.h"
 #include "src/common/libutil/fdutils.h"
 #include "src/common/libsubprocess/fbuf.h"
 #include "src/common/libsubprocess/fbuf_watcher.h"
@@ -282,11 +284,64 @@ static void handle_output_log (struct attach_ctx *ctx,
     }
 }
 
+/* Handle a chunk index event in the guest.output eventlog, written when
+ * the job was run with output.storage=blob.  The chunk is an LZ4
+ * compressed RFC 18 eventlog of data events, stored as a content blob.
+ * Load it, and handle each data event as if it were in guest.output.
+ */
+static void handle_output_chunk (struct attach_ctx *ctx, json_t *context)
+{
+    const char *blobref;
+    const char *encoding;
+    json_int_t size;
+    flux_future_t *f;
+    const void *data;
+    int len;
+    char *buf;
+    json_t *entries;
+    json_t *entry;
+    size_t index;
+
+    if (!ctx->output_header_parsed)
+        log_msg_exit ("stream chunk read before header");
+    if (json_unpack (context,
+                     "{s:s s:s s:I}",
+                     "blobref", &blobref,
+                     "encoding", &encoding,
+                     "size", &size) < 0
+        || !streq (encoding, "lz4")
+        || size < 0
+        || size > LZ4_MAX_INPUT_SIZE)
+        log_msg_exit ("malformed chunk context");
+    if (!(f = content_load_byblobref (ctx->h, blobref, 0)))
+        log_err_exit ("content_load_byblobref");
+    if (content_load_get (f, &data, &len) < 0)
+        log_msg_exit ("error loading output chunk %s: %s",
+                      blobref,
+                      future_strerror (f, errno));
+    buf = xzmalloc (size + 1);
+    if (LZ4_decompress_safe (data, buf, len, size) != size)
+        log_msg_exit ("error decompressing output chunk %s", blobref);
+    if (!(entries = eventlog_decode (buf)))
+        log_err_exit ("error decoding output chunk %s", blobref);
+    json_array_foreach (entries, index, entry) {
+        const char *name;
+        json_t *o;
+        if (eventlog_entry_parse (entry, NULL, &name, &o) < 0)
+            log_err_exit ("eventlog_entry_parse");
+        if (streq (name, "data"))
+            handle_output_data (ctx, o);
+    }
+    json_decref (entries);
+    free (buf);
+    flux_future_destroy (f);
+}
+
 /* Handle an event in the guest.output eventlog.
  * This is a stream of responses, one response per event, terminated with
  * an ENODATA error response (or another error if something went wrong).
  * The first eventlog entry is a header; remaining entries are data,
- * redirect, or log messages.  Print each data entry to stdout/stderr,
+ * chunk, redirect, or log messages.  Print each data entry to stdout/stderr,
  * with task/rank prefix if --label-io was specified.  For each redirect entry, print
  * information on paths to redirected locations if --quiet is not
  * specified.
@@ -322,6 +377,9 @@ void attach_output_continuation (flux_future_t *f, void *arg)
     else if (streq (name, "data")) {
         handle_output_data (ctx, context);
     }
+    else if (streq (name, "chunk")) {
+        handle_output_chunk (ctx, context);
+    }
     else if (streq (name, "redirect")) {
         handle_output_redirect (ctx, context);
     }
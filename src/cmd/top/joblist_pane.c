@@ -33,6 +33,11 @@ struct joblist_pane {
     json_t *jobs;
     struct ucache *ucache;
 
+    /*  job-list.watch stream, or NULL if job-list does not support
+     *   it and the pane falls back to polling with job-list.list.
+     */
+    flux_future_t *f_watch;
+
     bool show_queue;
 
     /*  Currently selected jobid. Ironically FLUX_JOBID_ANY means
@@ -153,6 +158,9 @@ void joblist_pane_draw (struct joblist_pane *joblist)
                              "uri", &uri) < 0)
             continue;
 
+        if (job_output_count == win_dim.y_length - 1)
+            break;
+
         idstr = idf58 (id);
         (void)fsd_format_duration_ex (run, sizeof (run), fabs (now - t_run), 2);
         if (!(username = ucache_lookup (joblist->ucache, userid)))
@@ -279,6 +287,126 @@ static void joblist_continuation (flux_future_t *f, void *arg)
     flux_future_destroy (f);
 }
 
+/* Insert 'job' into jobs_all, keeping the array sorted by t_run with
+ *  the most recently started job first, as job-list.list returns it.
+ */
+static void joblist_insert_job (struct joblist_pane *joblist, json_t *job)
+{
+    double t_run = 0.;
+    size_t index;
+    json_t *entry;
+
+    (void)json_unpack (job, "{s:f}", "t_run", &t_run);
+    json_array_foreach (joblist->jobs_all, index, entry) {
+        double t = 0.;
+        (void)json_unpack (entry, "{s:f}", "t_run", &t);
+        if (t < t_run)
+            break;
+    }
+    if (json_array_insert (joblist->jobs_all, index, job) < 0)
+        fatal (ENOMEM, "error inserting job into joblist");
+}
+
+static void joblist_remove_job (struct joblist_pane *joblist, json_t *job)
+{
+    flux_jobid_t id;
+    int index;
+
+    if (json_unpack (job, "{s:I}", "id", &id) < 0)
+        return;
+    if ((index = lookup_jobid_index (joblist->jobs_all, id)) >= 0)
+        json_array_remove (joblist->jobs_all, index);
+}
+
+static void joblist_watch_continuation (flux_future_t *f, void *arg)
+{
+    struct joblist_pane *joblist = arg;
+    const char *type;
+    json_t *jobs;
+    size_t index;
+    json_t *job;
+
+    if (flux_rpc_get_unpack (f, "{s:s s:o}", "type", &type, "jobs", &jobs) < 0) {
+        if (errno != ENOSYS)
+            fatal (errno, "error decoding job-list.watch RPC response");
+        /*  job-list does not support job-list.watch (or was unloaded),
+         *   fall back to polling on job activity.
+         */
+        flux_future_destroy (f);
+        joblist->f_watch = NULL;
+        joblist_pane_query (joblist);
+        return;
+    }
+    if (!joblist->jobs_all && !(joblist->jobs_all = json_array ()))
+        fatal (ENOMEM, "error creating joblist");
+
+    /*  Snapshot jobs arrive in job-list's running list order, which is
+     *   already sorted by t_run, so they may simply be appended.
+     */
+    if (streq (type, "snapshot")) {
+        if (json_array_extend (joblist->jobs_all, jobs) < 0)
+            fatal (ENOMEM, "error appending jobs to joblist");
+        flux_future_reset (f);
+        return;
+    }
+    json_array_foreach (jobs, index, job) {
+        joblist_remove_job (joblist, job);
+        if (!streq (type, "remove"))
+            joblist_insert_job (joblist, job);
+    }
+    joblist_filter_jobs (joblist);
+    joblist_pane_draw (joblist);
+    if (streq (type, "sync") && joblist->top->test_exit) {
+        /* Ensure joblist window is refreshed before exiting */
+        wrefresh (joblist->win);
+        test_exit_check (joblist->top);
+    }
+    flux_future_reset (f);
+}
+
+static void joblist_pane_watch (struct joblist_pane *joblist)
+{
+    if (!(joblist->f_watch = flux_rpc_pack (joblist->top->h,
+                                            "job-list.watch",
+                                            0,
+                                            FLUX_RPC_STREAMING,
+                                            "{s:{s:[i]} s:[s,s,s,s,s,s,s,s]}",
+                                            "constraint",
+                                            "states", FLUX_JOB_STATE_RUNNING,
+                                            "attrs",
+                                              "annotations",
+                                              "userid",
+                                              "state",
+                                              "name",
+                                              "queue",
+                                              "nnodes",
+                                              "ntasks",
+                                              "t_run"))
+        || flux_future_then (joblist->f_watch,
+                             -1,
+                             joblist_watch_continuation,
+                             joblist) < 0)
+        fatal (errno, "error sending job-list.watch RPC request");
+}
+
+static void joblist_pane_watch_cancel (struct joblist_pane *joblist)
+{
+    flux_future_t *f;
+
+    if (!joblist->f_watch)
+        return;
+    if ((f = flux_rpc_pack (joblist->top->h,
+                            "job-list.watch-cancel",
+                            0,
+                            FLUX_RPC_NORESPONSE,
+                            "{s:i}",
+                            "matchtag",
+                            (int)flux_rpc_get_matchtag (joblist->f_watch))))
+        flux_future_destroy (f);
+    flux_future_destroy (joblist->f_watch);
+    joblist->f_watch = NULL;
+}
+
 
 /* Attempt to create a popup box over the joblist pane to
  *  display one or more errors. The box will stay open until
@@ -362,6 +490,10 @@ void joblist_pane_query (struct joblist_pane *joblist)
 {
     flux_future_t *f;
 
+    /*  Changes are pushed to the pane while job-list.watch is active.
+     */
+    if (joblist->f_watch)
+        return;
     if (!(f = flux_rpc_pack (joblist->top->h,
                              "job-list.list",
                              0,
@@ -459,7 +591,7 @@ struct joblist_pane *joblist_pane_create (struct top *top)
                                  win_dim.y_begin,
                                  win_dim.x_begin)))
         fatal (0, "error creating joblist curses window");
-    joblist_pane_query (joblist);
+    joblist_pane_watch (joblist);
     joblist_pane_draw (joblist);
     joblist_pane_refresh (joblist);
     return joblist;
@@ -469,6 +601,7 @@ void joblist_pane_destroy (struct joblist_pane *joblist)
 {
     if (joblist) {
         int saved_errno = errno;
+        joblist_pane_watch_cancel (joblist);
         delwin (joblist->win);
         ucache_destroy (joblist->ucache);
         json_decref (joblist->jobs_all);
@@ -37,6 +37,7 @@ struct eventlogger {
     struct eventlog_batch *current;
     struct eventlogger_ops ops;
     void *arg;
+    struct eventlogger_stats stats;
 };
 
 static void eventlogger_decref (struct eventlogger *ev)
@@ -80,6 +81,17 @@ int eventlogger_set_commit_timeout (struct eventlogger *ev, double timeout)
     return 0;
 }
 
+int eventlogger_get_stats (struct eventlogger *ev,
+                           struct eventlogger_stats *stats)
+{
+    if (!ev || !stats) {
+        errno = EINVAL;
+        return -1;
+    }
+    *stats = ev->stats;
+    return 0;
+}
+
 static void eventlog_batch_destroy (struct eventlog_batch *batch)
 {
     if (batch) {
@@ -173,6 +185,7 @@ static flux_future_t *eventlogger_commit_batch (struct eventlogger *ev,
         flux_watcher_stop (batch->timer);
         if (!(fc = flux_kvs_commit (ev->h, ev->ns, flags, batch->txn)))
             return NULL;
+        ev->stats.commits++;
         if (!(f = flux_future_and_then (fc, commit_cb, batch)))
             flux_future_destroy (fc);
     }
@@ -284,6 +297,7 @@ static int append_wait (struct eventlogger *ev,
                           FLUX_KVS_APPEND,
                           path, entrystr) < 0)
         return -1;
+    ev->stats.entries++;
 
     return eventlogger_flush (ev);
 }
@@ -303,6 +317,8 @@ static int append_async (struct eventlogger *ev,
                           entrystr) < 0)
             return -1;
 
+    ev->stats.entries++;
+
     if (zlist_append (batch->entries, entry) < 0)
         return -1;
     json_incref (entry);
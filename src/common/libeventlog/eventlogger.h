@@ -33,6 +33,11 @@ struct eventlogger_ops {
     eventlogger_err_f  err;   /* Called on error, once per failed entry     */
 };
 
+struct eventlogger_stats {
+    unsigned long entries;  /* Entries appended to eventlogs               */
+    unsigned long commits;  /* KVS commits used to append them             */
+};
+
 enum {
     EVENTLOGGER_FLAG_ASYNC = 0,  /* Append entry to eventlog asynchronously */
     EVENTLOGGER_FLAG_WAIT =  1,  /* Append entry to eventlog synchronously  */
@@ -79,6 +84,12 @@ int eventlogger_append_pack (struct eventlogger *ev,
 
 int eventlogger_set_commit_timeout (struct eventlogger *ev, double timeout);
 
+/*  Get counts of appended entries and KVS commits.  The ratio of the two
+ *   is the effective batching ratio of this eventlogger.
+ */
+int eventlogger_get_stats (struct eventlogger *ev,
+                           struct eventlogger_stats *stats);
+
 int eventlogger_flush (struct eventlogger *ev);
 
 flux_future_t *eventlogger_commit (struct eventlogger *ev);
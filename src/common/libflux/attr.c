@@ -34,6 +34,7 @@ struct attr_cache {
 
     zlistx_t *cache_iter;
     struct hostlist *hostlist;
+    struct hostlist_index *hostindex;
 };
 
 static void attr_cache_destroy (struct attr_cache *c)
@@ -44,6 +45,7 @@ static void attr_cache_destroy (struct attr_cache *c)
         zhashx_destroy (&c->cache);
         zhashx_destroy (&c->temp);
         hostlist_destroy (c->hostlist);
+        hostlist_index_destroy (c->hostindex);
         free (c);
         errno = saved_errno;
     }
@@ -276,6 +278,21 @@ static struct hostlist * get_hostlist (flux_t *h)
     return c->hostlist;
 }
 
+/* Hostname to rank lookups use an index of the hostlist attribute,
+ * since hostlist_find() is a linear search.
+ */
+static struct hostlist_index *get_hostindex (flux_t *h)
+{
+    struct attr_cache *c;
+    struct hostlist *hl;
+
+    if (!(c = get_attr_cache (h)) || !(hl = get_hostlist (h)))
+        return NULL;
+    if (!c->hostindex)
+        c->hostindex = hostlist_index_create (hl);
+    return c->hostindex;
+}
+
 const char *flux_get_hostbyrank (flux_t *h, uint32_t rank)
 {
     struct hostlist *hl;
@@ -296,11 +313,11 @@ error:
 
 int flux_get_rankbyhost (flux_t *h, const char *host)
 {
-    struct hostlist *hl;
+    struct hostlist_index *idx;
 
-    if (!(hl = get_hostlist (h)))
+    if (!(idx = get_hostindex (h)))
         return -1;
-    return hostlist_find (hl, host);
+    return hostlist_index_find (idx, host);
 }
 
 char *flux_hostmap_lookup (flux_t *h,
@@ -308,6 +325,7 @@ char *flux_hostmap_lookup (flux_t *h,
                            flux_error_t *errp)
 {
     struct hostlist *hostmap;
+    struct hostlist_index *hostindex;
     struct hostlist *hosts = NULL;
     struct idset *ranks = NULL;
     char *s = NULL;
@@ -349,13 +367,17 @@ char *flux_hostmap_lookup (flux_t *h,
     else if ((hosts = hostlist_decode (targets))) {
         const char *host;
         int rank = 0;
+        if (!(hostindex = get_hostindex (h))) {
+            errprintf (errp, "%s", strerror (errno));
+            goto err;
+        }
         if (!(ranks = idset_create (0, IDSET_FLAG_AUTOGROW))) {
             errprintf (errp, "Out of memory");
             goto err;
         }
         host = hostlist_first (hosts);
         while (host) {
-            if ((rank = hostlist_find (hostmap, host)) < 0) {
+            if ((rank = hostlist_index_find (hostindex, host)) < 0) {
                 errprintf (errp, "host %s not found in host map", host);
                 goto err;
             }
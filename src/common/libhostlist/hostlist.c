@@ -1183,6 +1183,126 @@ int hostlist_remove_current (struct hostlist *hl)
     return hostlist_remove_at (hl, &hl->current);
 }
 
+/* Hostlist index - an open addressing hash of hostname to position
+ */
+struct hostlist_index_entry {
+    char *host;
+    int pos;
+};
+
+struct hostlist_index {
+    int nhosts;             /* number of hosts in indexed hostlist */
+    size_t size;            /* number of slots, a power of 2 */
+    struct hostlist_index_entry *slots;
+};
+
+/* FNV-1a hash
+ */
+static size_t hostname_hash (const char *s)
+{
+    size_t h = 2166136261u;
+    while (*s) {
+        h ^= (unsigned char) *s++;
+        h *= 16777619;
+    }
+    return h;
+}
+
+static struct hostlist_index_entry *
+hostlist_index_slot (const struct hostlist_index *idx, const char *host)
+{
+    size_t i = hostname_hash (host) & (idx->size - 1);
+
+    /*  Linear probe: the table is never more than half full, so an
+     *   empty slot is always found.
+     */
+    while (idx->slots[i].host && strcmp (idx->slots[i].host, host) != 0)
+        i = (i + 1) & (idx->size - 1);
+    return &idx->slots[i];
+}
+
+void hostlist_index_destroy (struct hostlist_index *idx)
+{
+    if (idx) {
+        int saved_errno = errno;
+        if (idx->slots) {
+            for (size_t i = 0; i < idx->size; i++)
+                free (idx->slots[i].host);
+            free (idx->slots);
+        }
+        free (idx);
+        errno = saved_errno;
+    }
+}
+
+struct hostlist_index *hostlist_index_create (struct hostlist *hl)
+{
+    struct hostlist_index *idx;
+    int pos = 0;
+
+    if (!hl) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(idx = calloc (1, sizeof (*idx))))
+        return NULL;
+    idx->nhosts = hl->nhosts;
+    idx->size = 16;
+    while (idx->size < (size_t) hl->nhosts * 2)
+        idx->size <<= 1;
+    if (!(idx->slots = calloc (idx->size, sizeof (idx->slots[0]))))
+        goto error;
+
+    for (int i = 0; i < hl->nranges; i++) {
+        struct hostrange *hr = hl->hr[i];
+        int n = hostrange_count (hr);
+
+        for (int depth = 0; depth < n; depth++, pos++) {
+            struct hostlist_index_entry *e;
+            char *host;
+
+            if (!(host = hostrange_host_tostring (hr, depth)))
+                goto error;
+            /*  Keep the first position of a duplicate host, as
+             *   hostlist_find() would return.
+             */
+            e = hostlist_index_slot (idx, host);
+            if (e->host) {
+                free (host);
+                continue;
+            }
+            e->host = host;
+            e->pos = pos;
+        }
+    }
+    return idx;
+error:
+    hostlist_index_destroy (idx);
+    return NULL;
+}
+
+int hostlist_index_find (const struct hostlist_index *idx,
+                         const char *hostname)
+{
+    struct hostlist_index_entry *e;
+
+    if (!idx || !hostname) {
+        errno = EINVAL;
+        return -1;
+    }
+    e = hostlist_index_slot (idx, hostname);
+    if (!e->host) {
+        errno = ENOENT;
+        return -1;
+    }
+    return e->pos;
+}
+
+int hostlist_index_count (const struct hostlist_index *idx)
+{
+    return idx ? idx->nhosts : 0;
+}
+
 /*
  * vi: tabstop=4 shiftwidth=4 expandtab
  */
@@ -96,6 +96,39 @@ void hostlist_hostname_destroy (struct hostlist_hostname *hn);
  */
 int hostlist_find_hostname (struct hostlist *hl, struct hostlist_hostname *hn);
 
+/*
+ *  Create an immutable index of the hosts in hostlist hl, for use with
+ *   hostlist_index_find() below. The index is a hash of hostname to
+ *   position and does not refer to hl, so hl may be modified or destroyed
+ *   afterwards (the index is not updated). This interface should be used
+ *   when looking up many hostnames in the same large hostlist, since each
+ *   hostlist_find() call is a linear search.
+ *
+ *  Returns NULL on error.
+ */
+struct hostlist_index *hostlist_index_create (struct hostlist *hl);
+
+/*
+ *  Free resources associated with hostlist index idx.
+ */
+void hostlist_index_destroy (struct hostlist_index *idx);
+
+/*
+ *  Return the position of the first host in the indexed hostlist that
+ *   matches hostname. Unlike hostlist_find(), hostname must match a host
+ *   exactly as it appears when the hostlist is expanded, e.g. by
+ *   hostlist_nth(). The hostlist cursor is not used.
+ *
+ *  Returns -1 with errno set to ENOENT if host is not found.
+ */
+int hostlist_index_find (const struct hostlist_index *idx,
+                         const char *hostname);
+
+/*
+ *  Return the number of hosts in the hostlist used to create idx.
+ */
+int hostlist_index_count (const struct hostlist_index *idx);
+
 /*
  *  Delete all hosts in the list represented by `hosts'
  *
@@ -371,6 +371,59 @@ void test_find_hostname ()
     }
 }
 
+void test_index ()
+{
+    struct find_test *t = find_tests;
+    struct hostlist_index *idx;
+    struct hostlist *hl;
+
+    ok (hostlist_index_create (NULL) == NULL && errno == EINVAL,
+        "hostlist_index_create (NULL) returns EINVAL");
+    ok (hostlist_index_find (NULL, "foo") == -1 && errno == EINVAL,
+        "hostlist_index_find (NULL, foo) returns EINVAL");
+    ok (hostlist_index_count (NULL) == 0,
+        "hostlist_index_count (NULL) returns 0");
+    lives_ok ({hostlist_index_destroy (NULL);},
+        "hostlist_index_destroy (NULL) doesn't crash");
+
+    while (t && t->input) {
+        int rc;
+        if (!(hl = hostlist_decode (t->input)))
+            BAIL_OUT ("hostlist_decode (%s) failed!", t->input);
+        if (!(idx = hostlist_index_create (hl)))
+            BAIL_OUT ("hostlist_index_create (%s) failed!", t->input);
+        rc = hostlist_index_find (idx, t->arg);
+        ok (rc == t->rc,
+            "hostlist_index_find ('%s', '%s') returned %d",
+            t->input, t->arg, rc);
+        hostlist_index_destroy (idx);
+        hostlist_destroy (hl);
+        t++;
+    }
+
+    if (!(hl = hostlist_decode ("foo[0-4095],bar,foo7")))
+        BAIL_OUT ("hostlist_decode failed");
+    if (!hostlist_nth (hl, 2))
+        BAIL_OUT ("hostlist_nth failed");
+    if (!(idx = hostlist_index_create (hl)))
+        BAIL_OUT ("hostlist_index_create failed");
+    ok (hostlist_index_count (idx) == 4098,
+        "hostlist_index_count returns 4098");
+    ok (hostlist_index_find (idx, "foo4000") == 4000,
+        "hostlist_index_find works on a large hostlist");
+    ok (hostlist_index_find (idx, "bar") == 4096,
+        "hostlist_index_find works for host after range");
+    ok (hostlist_index_find (idx, "foo7") == 7,
+        "hostlist_index_find returns first position of duplicate host");
+    ok (hostlist_index_find (idx, "foo4096") == -1 && errno == ENOENT,
+        "hostlist_index_find returns ENOENT for missing host");
+    is (hostlist_current (hl), "foo2",
+        "hostlist cursor is not moved by index functions");
+    hostlist_destroy (hl);
+    ok (hostlist_index_find (idx, "foo100") == 100,
+        "index remains valid after hostlist is destroyed");
+    hostlist_index_destroy (idx);
+}
 
 struct delete_test {
     char *input;
@@ -646,6 +699,7 @@ int main (int argc, char *argv[])
     test_nth ();
     test_find ();
     test_find_hostname ();
+    test_index ();
     test_delete ();
     test_sortuniq ();
     test_iteration ();
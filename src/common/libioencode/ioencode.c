@@ -13,6 +13,9 @@
 #endif
 
 #include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <limits.h>
 #include <string.h>
 #include <stdbool.h>
 #include <errno.h>
@@ -191,6 +194,103 @@ int iodecode (json_t *o,
     return 0;
 }
 
+int ioencode_raw (const char *stream,
+                  const char *rank,
+                  const char *data,
+                  int len,
+                  bool eof,
+                  void **bufp,
+                  size_t *sizep)
+{
+    size_t stream_size;
+    size_t rank_size;
+    size_t size;
+    uint8_t *buf;
+    uint8_t *cp;
+
+    if (!stream
+        || !rank
+        || !bufp
+        || !sizep
+        || (data && len <= 0)
+        || (!data && len != 0)
+        || (!data && !len && !eof)) {
+        errno = EINVAL;
+        return -1;
+    }
+    stream_size = strlen (stream) + 1;
+    rank_size = strlen (rank) + 1;
+    size = 2 + stream_size + rank_size + len;
+    if (!(buf = malloc (size)))
+        return -1;
+    cp = buf;
+    *cp++ = IOENCODE_RAW_MAGIC;
+    *cp++ = eof ? IOENCODE_RAW_EOF : 0;
+    memcpy (cp, stream, stream_size);
+    cp += stream_size;
+    memcpy (cp, rank, rank_size);
+    cp += rank_size;
+    if (len > 0)
+        memcpy (cp, data, len);
+    *bufp = buf;
+    *sizep = size;
+    return 0;
+}
+
+bool ioencode_is_raw (const void *buf, size_t size)
+{
+    return buf && size >= 2 && *(const uint8_t *)buf == IOENCODE_RAW_MAGIC;
+}
+
+int iodecode_raw (const void *buf,
+                  size_t size,
+                  const char **streamp,
+                  const char **rankp,
+                  const char **datap,
+                  int *lenp,
+                  bool *eofp)
+{
+    const char *cp = buf;
+    const char *end = cp + size;
+    const char *stream;
+    const char *rank;
+    uint8_t flags;
+    size_t len;
+
+    if (!ioencode_is_raw (buf, size)) {
+        errno = EINVAL;
+        return -1;
+    }
+    flags = (uint8_t)cp[1];
+    stream = cp + 2;
+    if (!(cp = memchr (stream, '\0', end - stream))) {
+        errno = EPROTO;
+        return -1;
+    }
+    rank = cp + 1;
+    if (rank >= end || !(cp = memchr (rank, '\0', end - rank))) {
+        errno = EPROTO;
+        return -1;
+    }
+    cp++;
+    len = end - cp;
+    if (len > INT_MAX || (len == 0 && !(flags & IOENCODE_RAW_EOF))) {
+        errno = EPROTO;
+        return -1;
+    }
+    if (streamp)
+        *streamp = stream;
+    if (rankp)
+        *rankp = rank;
+    if (datap)
+        *datap = len > 0 ? cp : NULL;
+    if (lenp)
+        *lenp = len;
+    if (eofp)
+        *eofp = (flags & IOENCODE_RAW_EOF) ? true : false;
+    return 0;
+}
+
 /*
  * vi: ts=4 sw=4 expandtab
  */
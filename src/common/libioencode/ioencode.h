@@ -40,4 +40,48 @@ int iodecode (json_t *o,
               int *len,
               bool *eof);
 
+/* Raw io encoding, an alternative to RFC24 data event objects for
+ * message payloads that carry bulk output.  The encoded buffer is:
+ *
+ *   uint8_t magic (IOENCODE_RAW_MAGIC)
+ *   uint8_t flags (IOENCODE_RAW_EOF)
+ *   stream, NUL terminated
+ *   rank, NUL terminated
+ *   data (remainder of buffer)
+ *
+ * The magic byte never appears in UTF-8 text, so a raw buffer can be
+ * distinguished from a JSON payload with ioencode_is_raw().
+ */
+#define IOENCODE_RAW_MAGIC  0xf5
+#define IOENCODE_RAW_EOF    0x01
+
+/* encode io data and/or EOF into a raw buffer
+ * - same input rules as ioencode()
+ * - returns 0 on success with buffer in bufp and size in sizep,
+ *   -1 on error with errno set
+ * - returned buffer should be free()'d after use
+ */
+int ioencode_raw (const char *stream,
+                  const char *rank,
+                  const char *data,
+                  int len,
+                  bool eof,
+                  void **bufp,
+                  size_t *sizep);
+
+bool ioencode_is_raw (const void *buf, size_t size);
+
+/* decode raw buffer
+ * - stream, rank, and data point into 'buf' and are not copied
+ * - if no data available, data set to NULL and len to 0
+ * - returns 0 on success, -1 on error with errno set
+ */
+int iodecode_raw (const void *buf,
+                  size_t size,
+                  const char **stream,
+                  const char **rank,
+                  const char **data,
+                  int *len,
+                  bool *eof);
+
 #endif /* !_IOENCODE_H */
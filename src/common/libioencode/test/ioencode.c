@@ -135,6 +135,65 @@ static void binary_data (void)
     json_decref (o);
 }
 
+static void raw (void)
+{
+    void *buf;
+    size_t size;
+    const char *stream;
+    const char *rank;
+    const char *data;
+    int len;
+    bool eof;
+    const char buffer[15] = "\xed\xbf\xbf\x4\x5\x6\x7\x8\x9\xa\xb\xc\xd\xe\xf";
+
+    ok (ioencode_raw ("stdout", "1", buffer, sizeof (buffer), false,
+                      &buf, &size) == 0,
+        "ioencode_raw of binary data works");
+    ok (size == 2 + 7 + 2 + sizeof (buffer),
+        "ioencode_raw size is correct");
+    ok (ioencode_is_raw (buf, size),
+        "ioencode_is_raw returns true on raw buffer");
+    ok (iodecode_raw (buf, size, &stream, &rank, &data, &len, &eof) == 0,
+        "iodecode_raw success");
+    ok (streq (stream, "stdout")
+        && streq (rank, "1")
+        && len == sizeof (buffer)
+        && memcmp (data, buffer, len) == 0
+        && eof == false,
+        "iodecode_raw returned correct info");
+    ok (iodecode_raw (buf, size - sizeof (buffer), NULL, NULL, NULL, NULL,
+                      NULL) < 0
+        && errno == EPROTO,
+        "iodecode_raw fails with EPROTO on data-less buffer without eof");
+    ok (iodecode_raw (buf, 5, NULL, NULL, NULL, NULL, NULL) < 0
+        && errno == EPROTO,
+        "iodecode_raw fails with EPROTO on truncated buffer");
+    free (buf);
+
+    ok (ioencode_raw ("stderr", "[0-8]", NULL, 0, true, &buf, &size) == 0,
+        "ioencode_raw success (no data, eof = true)");
+    ok (iodecode_raw (buf, size, &stream, &rank, &data, &len, &eof) == 0,
+        "iodecode_raw success");
+    ok (streq (stream, "stderr")
+        && streq (rank, "[0-8]")
+        && data == NULL
+        && len == 0
+        && eof == true,
+        "iodecode_raw returned correct info");
+    free (buf);
+
+    ok (!ioencode_is_raw ("{}", 2),
+        "ioencode_is_raw returns false on JSON");
+    errno = 0;
+    ok (ioencode_raw ("stdout", "0", NULL, 0, false, &buf, &size) < 0
+        && errno == EINVAL,
+        "ioencode_raw returns EINVAL with no data and eof = false");
+    errno = 0;
+    ok (iodecode_raw ("{}", 2, NULL, NULL, NULL, NULL, NULL) < 0
+        && errno == EINVAL,
+        "iodecode_raw returns EINVAL on non-raw buffer");
+}
+
 int main (int argc, char *argv[])
 {
     plan (NO_PLAN);
@@ -142,6 +201,7 @@ int main (int argc, char *argv[])
     basic_corner_case ();
     basic ();
     binary_data ();
+    raw ();
 
     done_testing ();
 
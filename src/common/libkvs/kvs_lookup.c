@@ -17,6 +17,9 @@
 #include <jansson.h>
 #include <flux/core.h>
 
+#include "src/common/libutil/errno_safe.h"
+#include "ccan/str/str.h"
+
 #include "kvs_dir_private.h"
 #include "kvs_lookup.h"
 #include "kvs_util_private.h"
@@ -27,6 +30,7 @@ struct lookup_ctx {
     char *key;
     char *atref;
     int flags;
+    bool multi;        // kvs.lookup-multi: key is set from each response
 
     json_t *treeobj;
     char *treeobj_str; // json_dumps of tree object returned from lookup
@@ -201,6 +205,96 @@ flux_future_t *flux_kvs_lookupat (flux_t *h,
     return f;
 }
 
+flux_future_t *flux_kvs_lookup_multi (flux_t *h,
+                                      const char *ns,
+                                      int flags,
+                                      const char *treeobj,
+                                      const char **keys,
+                                      int nkeys)
+{
+    struct lookup_ctx *ctx;
+    flux_future_t *f;
+    json_t *o = NULL;
+    json_t *rootdir = NULL;
+
+    /* N.B. FLUX_KVS_WATCH is not valid for multi-key lookups.
+     */
+    if (!h
+        || !keys
+        || nkeys <= 0
+        || validate_lookup_flags (flags, false) < 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!treeobj && !ns) {
+        if (!(ns = kvs_get_namespace ()))
+            return NULL;
+    }
+    if (!(o = json_array ()))
+        goto nomem;
+    for (int i = 0; i < nkeys; i++) {
+        json_t *key;
+        if (!keys[i] || strlen (keys[i]) == 0) {
+            json_decref (o);
+            errno = EINVAL;
+            return NULL;
+        }
+        if (!(key = json_string (keys[i]))
+            || json_array_append_new (o, key) < 0) {
+            json_decref (key);
+            goto nomem;
+        }
+    }
+    if (treeobj && !(rootdir = json_loads (treeobj, 0, NULL))) {
+        json_decref (o);
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(ctx = alloc_ctx (h, flags, keys[0])))
+        goto error;
+    ctx->multi = true;
+    if (treeobj && !(ctx->atref = strdup (treeobj))) {
+        free_ctx (ctx);
+        goto nomem;
+    }
+    if (rootdir)
+        f = flux_rpc_pack (h,
+                           "kvs.lookup-multi",
+                           FLUX_NODEID_ANY,
+                           FLUX_RPC_STREAMING,
+                           "{s:O s:i s:O}",
+                           "keys", o,
+                           "flags", flags,
+                           "rootdir", rootdir);
+    else
+        f = flux_rpc_pack (h,
+                           "kvs.lookup-multi",
+                           FLUX_NODEID_ANY,
+                           FLUX_RPC_STREAMING,
+                           "{s:O s:i s:s}",
+                           "keys", o,
+                           "flags", flags,
+                           "namespace", ns);
+    if (!f) {
+        free_ctx (ctx);
+        goto error;
+    }
+    if (flux_future_aux_set (f, auxkey, ctx, (flux_free_f)free_ctx) < 0) {
+        free_ctx (ctx);
+        flux_future_destroy (f);
+        goto error;
+    }
+    json_decref (o);
+    json_decref (rootdir);
+    return f;
+nomem:
+    errno = ENOMEM;
+error:
+    ERRNO_SAFE_WRAP (json_decref, o);
+    ERRNO_SAFE_WRAP (json_decref, rootdir);
+    return NULL;
+}
+
 static int decode_treeobj (flux_future_t *f, json_t **treeobj)
 {
     json_t *obj;
@@ -226,6 +320,35 @@ static struct lookup_ctx *get_lookup_ctx (flux_future_t *f)
     return ctx;
 }
 
+/* kvs.lookup-multi responses carry the key name, and carry an errno
+ * instead of a value if lookup of that key failed.  Update ctx->key
+ * and set 'changed' if the key differs from the last response.
+ */
+static int parse_multi_key (flux_future_t *f,
+                            struct lookup_ctx *ctx,
+                            bool *changed)
+{
+    const char *key;
+    int errnum = 0;
+
+    *changed = false;
+    if (flux_rpc_get_unpack (f, "{s:s s?i}", "key", &key, "errno", &errnum) < 0)
+        return -1;
+    if (!streq (ctx->key, key)) {
+        char *cpy;
+        if (!(cpy = strdup (key)))
+            return -1;
+        free (ctx->key);
+        ctx->key = cpy;
+        *changed = true;
+    }
+    if (errnum != 0) {
+        errno = errnum;
+        return -1;
+    }
+    return 0;
+}
+
 /* Parse the lookup response message, extracting the 'val' treeobj.
  * If decoded results were previously cached and the response has
  * changed (e.g. future has been reset and another response has arrived),
@@ -234,10 +357,15 @@ static struct lookup_ctx *get_lookup_ctx (flux_future_t *f)
 static int parse_response (flux_future_t *f, struct lookup_ctx *ctx)
 {
     json_t *treeobj2;
+    bool key_changed = false;
 
+    if (ctx->multi && parse_multi_key (f, ctx, &key_changed) < 0)
+        return -1;
     if (decode_treeobj (f, &treeobj2) < 0)
         return -1;
-    if (!ctx->treeobj || !json_equal (ctx->treeobj, treeobj2)) {
+    if (key_changed
+        || !ctx->treeobj
+        || !json_equal (ctx->treeobj, treeobj2)) {
         json_decref (ctx->treeobj);
         ctx->treeobj = json_incref (treeobj2);
         if (ctx->treeobj_str) {
@@ -405,6 +533,16 @@ const char *flux_kvs_lookup_get_key (flux_future_t *f)
 
     if (!(ctx = get_lookup_ctx (f)))
         return NULL;
+    if (ctx->multi) {
+        bool changed;
+        /* Key is valid even if lookup of that key failed, but an error
+         * response, such as the ENODATA that ends the stream, has no key.
+         */
+        if (flux_future_get (f, NULL) < 0)
+            return NULL;
+        if (parse_multi_key (f, ctx, &changed) < 0 && errno == EPROTO)
+            return NULL;
+    }
     return ctx->key;
 }
 
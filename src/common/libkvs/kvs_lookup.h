@@ -24,6 +24,20 @@ flux_future_t *flux_kvs_lookupat (flux_t *h,
                                   const char *key,
                                   const char *treeobj);
 
+/* Look up 'nkeys' keys against a single root: the current root of
+ * namespace 'ns', or the snapshot 'treeobj' if non-NULL.  The future is
+ * fulfilled once per key, in completion order.  Use the accessors below
+ * (including flux_kvs_lookup_get_key()) on each result, then
+ * flux_future_reset() to wait for the next.  After the last key,
+ * all accessors fail with ENODATA.  FLUX_KVS_WATCH flags are not allowed.
+ */
+flux_future_t *flux_kvs_lookup_multi (flux_t *h,
+                                      const char *ns,
+                                      int flags,
+                                      const char *treeobj,
+                                      const char **keys,
+                                      int nkeys);
+
 int flux_kvs_lookup_get (flux_future_t *f, const char **value);
 int flux_kvs_lookup_get_unpack (flux_future_t *f, const char *fmt, ...);
 int flux_kvs_lookup_get_raw (flux_future_t *f, const void **data, int *len);
@@ -0,0 +1,536 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <jansson.h>
+#include <flux/core.h>
+
+#include "src/common/libczmqcontainers/czmq_containers.h"
+#include "src/common/libcontent/content.h"
+#include "src/common/libutil/errprintf.h"
+#include "src/common/libutil/errno_safe.h"
+#include "ccan/str/str.h"
+
+#include "kvs_snapshot.h"
+#include "kvs_util_private.h"
+#include "treeobj.h"
+
+struct kvs_snapshot {
+    flux_t *h;
+    int flags;
+    char *blobref;
+    int prefetch_max;
+    zhashx_t *prefetch;     // blobref => content.load future (not owned)
+};
+
+struct entry {
+    char *path;
+    json_t *treeobj;
+};
+
+struct kvs_snapshot_itr {
+    struct kvs_snapshot *snap;
+    zlistx_t *stack;        // entries not yet visited, next at head
+    struct entry *cur;      // entry last returned by itr_next
+};
+
+static int snapshot_flags_valid (int flags)
+{
+    int valid_flags = KVS_SNAPSHOT_CACHE_BYPASS
+                    | KVS_SNAPSHOT_PREFETCH_VALUES;
+    return (flags & ~valid_flags) ? -1 : 0;
+}
+
+void kvs_snapshot_close (struct kvs_snapshot *snap)
+{
+    if (snap) {
+        int saved_errno = errno;
+        if (snap->prefetch) {
+            flux_future_t *f = zhashx_first (snap->prefetch);
+            while (f) {
+                flux_future_destroy (f);
+                f = zhashx_next (snap->prefetch);
+            }
+            zhashx_destroy (&snap->prefetch);
+        }
+        free (snap->blobref);
+        free (snap);
+        errno = saved_errno;
+    }
+}
+
+struct kvs_snapshot *kvs_snapshot_openat (flux_t *h,
+                                          const char *blobref,
+                                          int flags)
+{
+    struct kvs_snapshot *snap;
+
+    if (!h || !blobref || snapshot_flags_valid (flags) < 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(snap = calloc (1, sizeof (*snap))))
+        return NULL;
+    snap->h = h;
+    snap->flags = flags;
+    snap->prefetch_max = KVS_SNAPSHOT_DEFAULT_PREFETCH;
+    if (!(snap->blobref = strdup (blobref))
+        || !(snap->prefetch = zhashx_new ()))
+        goto nomem;
+    return snap;
+nomem:
+    kvs_snapshot_close (snap);
+    errno = ENOMEM;
+    return NULL;
+}
+
+struct kvs_snapshot *kvs_snapshot_open (flux_t *h, const char *ns, int flags)
+{
+    flux_future_t *f;
+    const char *blobref;
+    struct kvs_snapshot *snap;
+
+    if (!(f = flux_kvs_getroot (h, ns, 0))
+        || flux_kvs_getroot_get_blobref (f, &blobref) < 0) {
+        flux_future_destroy (f);
+        return NULL;
+    }
+    snap = kvs_snapshot_openat (h, blobref, flags);
+    ERRNO_SAFE_WRAP (flux_future_destroy, f);
+    return snap;
+}
+
+const char *kvs_snapshot_get_blobref (struct kvs_snapshot *snap)
+{
+    if (!snap) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return snap->blobref;
+}
+
+int kvs_snapshot_set_prefetch (struct kvs_snapshot *snap, int count)
+{
+    if (!snap || count < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    snap->prefetch_max = count;
+    return 0;
+}
+
+static int content_flags (struct kvs_snapshot *snap)
+{
+    if ((snap->flags & KVS_SNAPSHOT_CACHE_BYPASS))
+        return CONTENT_FLAG_CACHE_BYPASS;
+    return 0;
+}
+
+/* Start loading 'blobref' unless it is already in flight.
+ */
+static void prefetch_blob (struct kvs_snapshot *snap, const char *blobref)
+{
+    flux_future_t *f;
+
+    if (!blobref || zhashx_lookup (snap->prefetch, blobref))
+        return;
+    if (!(f = content_load_byblobref (snap->h, blobref, content_flags (snap))))
+        return; // not fatal - blob will be loaded on demand
+    if (zhashx_insert (snap->prefetch, blobref, f) < 0)
+        flux_future_destroy (f);
+}
+
+/* Return a content.load future for 'blobref', claiming a prefetched
+ * one if available.  Caller must destroy the future.
+ */
+static flux_future_t *load_blob (struct kvs_snapshot *snap,
+                                 const char *blobref)
+{
+    flux_future_t *f;
+
+    if ((f = zhashx_lookup (snap->prefetch, blobref))) {
+        zhashx_delete (snap->prefetch, blobref);
+        return f;
+    }
+    return content_load_byblobref (snap->h, blobref, content_flags (snap));
+}
+
+static json_t *load_dir (struct kvs_snapshot *snap, const char *blobref)
+{
+    flux_future_t *f;
+    const void *buf;
+    int len;
+    json_t *dir;
+
+    if (!(f = load_blob (snap, blobref))
+        || content_load_get (f, &buf, &len) < 0) {
+        ERRNO_SAFE_WRAP (flux_future_destroy, f);
+        return NULL;
+    }
+    if (!(dir = treeobj_decodeb (buf, len))) {
+        flux_future_destroy (f);
+        errno = EPROTO;
+        return NULL;
+    }
+    if (!treeobj_is_dir (dir)) {
+        json_decref (dir);
+        flux_future_destroy (f);
+        errno = ENOTDIR;
+        return NULL;
+    }
+    flux_future_destroy (f);
+    return dir;
+}
+
+/* Replace a dirref with the dir it references, or return a new
+ * reference on any other tree object.
+ */
+static json_t *deref (struct kvs_snapshot *snap, json_t *treeobj)
+{
+    if (treeobj_is_dirref (treeobj)) {
+        if (treeobj_get_count (treeobj) != 1) {
+            errno = EPROTO;
+            return NULL;
+        }
+        return load_dir (snap, treeobj_get_blobref (treeobj, 0));
+    }
+    return json_incref (treeobj);
+}
+
+int kvs_snapshot_lookup (struct kvs_snapshot *snap,
+                         const char *key,
+                         json_t **treeobjp)
+{
+    char *cpy;
+    char *name;
+    char *saveptr = NULL;
+    json_t *dir;
+
+    if (!snap || !key || !treeobjp) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!(cpy = kvs_util_normalize_key (key, NULL)))
+        return -1;
+    if (!(dir = load_dir (snap, snap->blobref)))
+        goto error;
+    name = strtok_r (streq (cpy, ".") ? NULL : cpy, ".", &saveptr);
+    while (name) {
+        json_t *entry;
+        json_t *next;
+
+        if (!treeobj_is_dir (dir)) {
+            errno = ENOTDIR;
+            goto error;
+        }
+        if (!(entry = treeobj_get_entry (dir, name))) {
+            errno = ENOENT;
+            goto error;
+        }
+        if (!(next = deref (snap, entry)))
+            goto error;
+        json_decref (dir);
+        dir = next;
+        name = strtok_r (NULL, ".", &saveptr);
+    }
+    free (cpy);
+    *treeobjp = dir;
+    return 0;
+error:
+    ERRNO_SAFE_WRAP (json_decref, dir);
+    ERRNO_SAFE_WRAP (free, cpy);
+    return -1;
+}
+
+int kvs_snapshot_get_value (struct kvs_snapshot *snap,
+                            const json_t *treeobj,
+                            void **datap,
+                            int *lenp,
+                            flux_error_t *error)
+{
+    int count;
+    char *data = NULL;
+    int len = 0;
+
+    if (!snap || !treeobj || !datap || !lenp) {
+        errno = EINVAL;
+        return errprintf (error, "invalid argument");
+    }
+    if (treeobj_is_val (treeobj)) {
+        if (treeobj_decode_val (treeobj, datap, lenp) < 0)
+            return errprintf (error, "%s", strerror (errno));
+        return 0;
+    }
+    if (!treeobj_is_valref (treeobj)
+        || (count = treeobj_get_count (treeobj)) < 0) {
+        errno = EINVAL;
+        return errprintf (error, "invalid value object");
+    }
+    for (int i = 0; i < count; i++) {
+        flux_future_t *f;
+        const void *buf;
+        int buflen;
+        char *ndata;
+
+        /* Keep up to prefetch_max loads of a multi-blob value in flight.
+         */
+        for (int j = i + 1; j < count && j <= i + snap->prefetch_max; j++)
+            prefetch_blob (snap, treeobj_get_blobref (treeobj, j));
+        if (!(f = load_blob (snap, treeobj_get_blobref (treeobj, i)))
+            || content_load_get (f, &buf, &buflen) < 0) {
+            errprintf (error, "missing blobref %d: %s", i, strerror (errno));
+            ERRNO_SAFE_WRAP (flux_future_destroy, f);
+            goto error;
+        }
+        if (buflen > 0) {
+            if (!(ndata = realloc (data, len + buflen + 1))) {
+                flux_future_destroy (f);
+                errno = ENOMEM;
+                errprintf (error, "out of memory");
+                goto error;
+            }
+            data = ndata;
+            memcpy (data + len, buf, buflen);
+            len += buflen;
+            data[len] = '\0';
+        }
+        flux_future_destroy (f);
+    }
+    *datap = data;
+    *lenp = len;
+    return 0;
+error:
+    ERRNO_SAFE_WRAP (free, data);
+    return -1;
+}
+
+static void entry_destroy (struct entry *e)
+{
+    if (e) {
+        int saved_errno = errno;
+        json_decref (e->treeobj);
+        free (e->path);
+        free (e);
+        errno = saved_errno;
+    }
+}
+
+static void entry_destructor (void **item)
+{
+    if (item) {
+        entry_destroy (*item);
+        *item = NULL;
+    }
+}
+
+static struct entry *entry_create (const char *dirpath,
+                                   const char *name,
+                                   json_t *treeobj)
+{
+    struct entry *e;
+    int rc;
+
+    if (!(e = calloc (1, sizeof (*e))))
+        return NULL;
+    if (dirpath)
+        rc = asprintf (&e->path, "%s.%s", dirpath, name);
+    else
+        rc = asprintf (&e->path, "%s", name);
+    if (rc < 0) {
+        free (e);
+        return NULL;
+    }
+    e->treeobj = json_incref (treeobj);
+    return e;
+}
+
+/* Push the entries of 'dir' onto the head of the stack, preserving
+ * directory order.
+ */
+static int push_dir (struct kvs_snapshot_itr *itr,
+                     const char *dirpath,
+                     json_t *dir)
+{
+    json_t *dict = treeobj_get_data (dir);
+    struct entry **entries;
+    const char *name;
+    json_t *treeobj;
+    int count = 0;
+    int rc = -1;
+
+    if (!(entries = calloc (json_object_size (dict) + 1, sizeof (*entries))))
+        return -1;
+    json_object_foreach (dict, name, treeobj) {
+        if (!(entries[count] = entry_create (dirpath, name, treeobj)))
+            goto done;
+        count++;
+    }
+    while (count > 0) {
+        if (!zlistx_add_start (itr->stack, entries[count - 1])) {
+            errno = ENOMEM;
+            goto done;
+        }
+        entries[--count] = NULL;
+    }
+    rc = 0;
+done:
+    for (int i = 0; i < count; i++)
+        entry_destroy (entries[i]);
+    free (entries);
+    return rc;
+}
+
+/* Start loading blobs the traversal will need soon, keeping at most
+ * prefetch_max requests outstanding.  Only look a bounded distance
+ * ahead so that a large directory of values doesn't make this O(n).
+ */
+static void prefetch (struct kvs_snapshot_itr *itr)
+{
+    struct kvs_snapshot *snap = itr->snap;
+    bool values = (snap->flags & KVS_SNAPSHOT_PREFETCH_VALUES);
+    int lookahead = snap->prefetch_max * 4;
+    struct entry *e;
+
+    e = zlistx_first (itr->stack);
+    while (e && lookahead-- > 0) {
+        if (zhashx_size (snap->prefetch) >= snap->prefetch_max)
+            break;
+        if (treeobj_is_dirref (e->treeobj)
+            || (values && treeobj_is_valref (e->treeobj))) {
+            int count = treeobj_get_count (e->treeobj);
+            for (int i = 0;
+                 i < count && zhashx_size (snap->prefetch) < snap->prefetch_max;
+                 i++)
+                prefetch_blob (snap, treeobj_get_blobref (e->treeobj, i));
+        }
+        e = zlistx_next (itr->stack);
+    }
+}
+
+void kvs_snapshot_itr_destroy (struct kvs_snapshot_itr *itr)
+{
+    if (itr) {
+        int saved_errno = errno;
+        zlistx_destroy (&itr->stack);
+        entry_destroy (itr->cur);
+        free (itr);
+        errno = saved_errno;
+    }
+}
+
+struct kvs_snapshot_itr *kvs_snapshot_itr_create (struct kvs_snapshot *snap,
+                                                  const char *key)
+{
+    struct kvs_snapshot_itr *itr;
+    json_t *dir = NULL;
+    char *dirpath = NULL;
+
+    if (!snap) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!key)
+        key = ".";
+    if (!(itr = calloc (1, sizeof (*itr))))
+        return NULL;
+    itr->snap = snap;
+    if (!(itr->stack = zlistx_new ()))
+        goto nomem;
+    zlistx_set_destructor (itr->stack, entry_destructor);
+    if (kvs_snapshot_lookup (snap, key, &dir) < 0)
+        goto error;
+    if (!treeobj_is_dir (dir)) {
+        errno = ENOTDIR;
+        goto error;
+    }
+    if (!(dirpath = kvs_util_normalize_key (key, NULL)))
+        goto error;
+    if (push_dir (itr, streq (dirpath, ".") ? NULL : dirpath, dir) < 0)
+        goto error;
+    prefetch (itr);
+    free (dirpath);
+    json_decref (dir);
+    return itr;
+nomem:
+    errno = ENOMEM;
+error:
+    ERRNO_SAFE_WRAP (free, dirpath);
+    ERRNO_SAFE_WRAP (json_decref, dir);
+    kvs_snapshot_itr_destroy (itr);
+    return NULL;
+}
+
+int kvs_snapshot_itr_next (struct kvs_snapshot_itr *itr,
+                           const char **path,
+                           const json_t **treeobj,
+                           flux_error_t *error)
+{
+    struct entry *e;
+
+    if (!itr || !path || !treeobj) {
+        errno = EINVAL;
+        return errprintf (error, "invalid argument");
+    }
+    entry_destroy (itr->cur);
+    itr->cur = NULL;
+    while ((e = zlistx_first (itr->stack))) {
+        zlistx_detach_cur (itr->stack);
+        if (treeobj_is_dir (e->treeobj) || treeobj_is_dirref (e->treeobj)) {
+            json_t *dir;
+
+            if (!(dir = deref (itr->snap, e->treeobj))) {
+                if (treeobj_is_dirref (e->treeobj)
+                    && treeobj_get_count (e->treeobj) != 1)
+                    errprintf (error, "%s: blobref count is not 1", e->path);
+                else if (errno == EPROTO)
+                    errprintf (error,
+                               "%s: could not decode directory",
+                               e->path);
+                else if (errno == ENOTDIR)
+                    errprintf (error,
+                               "%s: dirref references non-directory",
+                               e->path);
+                else
+                    errprintf (error,
+                               "%s: missing blobref: %s",
+                               e->path,
+                               strerror (errno));
+                entry_destroy (e);
+                prefetch (itr);
+                return -1;
+            }
+            if (push_dir (itr, e->path, dir) < 0) {
+                errprintf (error, "%s: %s", e->path, strerror (errno));
+                json_decref (dir);
+                entry_destroy (e);
+                return -1;
+            }
+            json_decref (dir);
+            entry_destroy (e);
+            prefetch (itr);
+            continue;
+        }
+        prefetch (itr);
+        itr->cur = e;
+        *path = e->path;
+        *treeobj = e->treeobj;
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,102 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _KVS_SNAPSHOT_H
+#define _KVS_SNAPSHOT_H
+
+#include <jansson.h>
+#include <flux/core.h>
+
+/* A KVS snapshot pins a root blobref and reads tree objects directly
+ * from the content store with content.load, bypassing the kvs module.
+ * Every key read through a snapshot is resolved against the same root,
+ * so a bulk scan sees a consistent view of the KVS no matter how many
+ * commits occur while it runs.
+ *
+ * Iterators issue content.load requests for directories and (optionally)
+ * values ahead of the traversal, keeping up to a configurable number
+ * of requests in flight to hide RPC latency.
+ */
+
+/* flags */
+enum {
+    KVS_SNAPSHOT_CACHE_BYPASS = 1,    /* load direct from backing store */
+    KVS_SNAPSHOT_PREFETCH_VALUES = 2, /* prefetch valref blobs as well */
+};
+
+#define KVS_SNAPSHOT_DEFAULT_PREFETCH 16
+
+struct kvs_snapshot;
+struct kvs_snapshot_itr;
+
+/* Pin the current root of namespace 'ns' (NULL = default namespace).
+ * This makes a synchronous kvs.getroot RPC.
+ */
+struct kvs_snapshot *kvs_snapshot_open (flux_t *h, const char *ns, int flags);
+
+/* Create a snapshot from an existing root blobref, e.g. a checkpoint.
+ */
+struct kvs_snapshot *kvs_snapshot_openat (flux_t *h,
+                                          const char *blobref,
+                                          int flags);
+
+void kvs_snapshot_close (struct kvs_snapshot *snap);
+
+const char *kvs_snapshot_get_blobref (struct kvs_snapshot *snap);
+
+/* Set the maximum number of content.load requests kept in flight
+ * by prefetch.  Zero disables prefetch.
+ */
+int kvs_snapshot_set_prefetch (struct kvs_snapshot *snap, int count);
+
+/* Look up 'key' relative to the snapshot root.  A "dirref" result is
+ * replaced with the "dir" it references.  Other tree objects, including
+ * "valref" and "symlink", are returned unchanged.  Symlinks are not
+ * followed.  Caller must json_decref() the result.
+ */
+int kvs_snapshot_lookup (struct kvs_snapshot *snap,
+                         const char *key,
+                         json_t **treeobj);
+
+/* Read the value of a "val" or "valref" tree object, concatenating
+ * valref blobs.  Caller must free 'data'.  On failure, 'error' names
+ * the index of the valref blob that could not be loaded.
+ */
+int kvs_snapshot_get_value (struct kvs_snapshot *snap,
+                            const json_t *treeobj,
+                            void **data,
+                            int *len,
+                            flux_error_t *error);
+
+/* Iterate over all non-directory entries below directory 'key'
+ * (NULL or "." for the root) in depth-first order.
+ */
+struct kvs_snapshot_itr *kvs_snapshot_itr_create (struct kvs_snapshot *snap,
+                                                  const char *key);
+void kvs_snapshot_itr_destroy (struct kvs_snapshot_itr *itr);
+
+/* Get the next entry.  'path' is the full key and 'treeobj' is a "val",
+ * "valref", or "symlink" object; both are valid until the next call.
+ * Returns 1 if an entry was returned, 0 at end of iteration, or -1 with
+ * 'error' set if a directory could not be read.  errno is EPROTO if a
+ * directory object is invalid or could not be decoded, ENOTDIR if a dirref
+ * references a non-directory, otherwise the content.load error.  A failed
+ * directory is skipped, so iteration may continue after an error.
+ */
+int kvs_snapshot_itr_next (struct kvs_snapshot_itr *itr,
+                           const char **path,
+                           const json_t **treeobj,
+                           flux_error_t *error);
+
+#endif /* !_KVS_SNAPSHOT_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
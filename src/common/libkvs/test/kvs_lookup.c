@@ -23,6 +23,7 @@
 void errors (void)
 {
     flux_future_t *f;
+    const char *keys[] = { "a", "b" };
     /* check simple error cases */
 
     errno = 0;
@@ -33,6 +34,21 @@ void errors (void)
     ok (flux_kvs_lookupat (NULL, 0, NULL, NULL) == NULL && errno == EINVAL,
         "flux_kvs_lookupat fails on bad input");
 
+    errno = 0;
+    ok (flux_kvs_lookup_multi (NULL, NULL, 0, NULL, keys, 2) == NULL
+        && errno == EINVAL,
+        "flux_kvs_lookup_multi h=NULL fails with EINVAL");
+
+    errno = 0;
+    ok (flux_kvs_lookup_multi (NULL, NULL, 0, NULL, NULL, 2) == NULL
+        && errno == EINVAL,
+        "flux_kvs_lookup_multi keys=NULL fails with EINVAL");
+
+    errno = 0;
+    ok (flux_kvs_lookup_multi (NULL, NULL, 0, NULL, keys, 0) == NULL
+        && errno == EINVAL,
+        "flux_kvs_lookup_multi nkeys=0 fails with EINVAL");
+
     errno = 0;
     ok (flux_kvs_lookup_get (NULL, NULL) < 0 && errno == EINVAL,
         "flux_kvs_lookup_get fails on bad input");
@@ -0,0 +1,432 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <errno.h>
+#include <jansson.h>
+#include <flux/core.h>
+
+#include "src/common/libczmqcontainers/czmq_containers.h"
+#include "src/common/libutil/blobref.h"
+#include "src/common/libtestutil/util.h"
+#include "kvs_snapshot.h"
+#include "treeobj.h"
+#include "src/common/libtap/tap.h"
+
+/* Blobs served by the fake content service, keyed by blobref.
+ * Populated before the server thread starts and read-only thereafter.
+ */
+static zhashx_t *store;
+
+#define BADREF "sha1-0000000000000000000000000000000000000000"
+
+static void content_load_cb (flux_t *h,
+                             flux_msg_handler_t *mh,
+                             const flux_msg_t *msg,
+                             void *arg)
+{
+    const void *hash;
+    int hash_size;
+    char blobref[BLOBREF_MAX_STRING_SIZE];
+    const char *blob;
+
+    if (flux_request_decode_raw (msg, NULL, &hash, &hash_size) < 0
+        || blobref_hashtostr ("sha1",
+                              hash,
+                              hash_size,
+                              blobref,
+                              sizeof (blobref)) < 0)
+        goto error;
+    if (!(blob = zhashx_lookup (store, blobref))) {
+        errno = ENOENT;
+        goto error;
+    }
+    if (flux_respond_raw (h, msg, blob, strlen (blob)) < 0)
+        diag ("flux_respond_raw failed");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        diag ("flux_respond_error failed");
+}
+
+static const struct flux_msg_handler_spec htab[] = {
+    { FLUX_MSGTYPE_REQUEST, "content.load", content_load_cb, 0 },
+    FLUX_MSGHANDLER_TABLE_END,
+};
+
+static int test_server (flux_t *h, void *arg)
+{
+    flux_msg_handler_t **handlers = NULL;
+
+    if (flux_msg_handler_addvec (h, htab, NULL, &handlers) < 0) {
+        diag ("flux_msg_handler_addvec failed");
+        return -1;
+    }
+    if (flux_reactor_run (flux_get_reactor (h), 0) < 0) {
+        diag ("flux_reactor_run failed");
+        flux_msg_handler_delvec (handlers);
+        return -1;
+    }
+    flux_msg_handler_delvec (handlers);
+    return 0;
+}
+
+/* Store 'blob' and return its blobref in static storage.
+ */
+static const char *store_blob (const char *blob)
+{
+    static char blobref[BLOBREF_MAX_STRING_SIZE];
+
+    if (blobref_hash ("sha1",
+                      blob,
+                      strlen (blob),
+                      blobref,
+                      sizeof (blobref)) < 0)
+        BAIL_OUT ("blobref_hash failed");
+    if (zhashx_insert (store, blobref, strdup (blob)) < 0)
+        BAIL_OUT ("zhashx_insert failed");
+    return blobref;
+}
+
+static const char *store_dir (json_t *dir)
+{
+    char *s;
+    const char *blobref;
+
+    if (!(s = treeobj_encode (dir)))
+        BAIL_OUT ("treeobj_encode failed");
+    blobref = store_blob (s);
+    free (s);
+    json_decref (dir);
+    return blobref;
+}
+
+static void insert_entry (json_t *dir, const char *name, json_t *obj)
+{
+    if (!obj || treeobj_insert_entry (dir, name, obj) < 0)
+        BAIL_OUT ("treeobj_insert_entry %s failed", name);
+    json_decref (obj);
+}
+
+/* Build this tree and return the root blobref:
+ *   a = "1"
+ *   b.c = "2"
+ *   b.d = "hello world" (valref, two blobs)
+ *   b.e.f = "3"
+ *   g -> a (symlink)
+ */
+static char *create_tree (void)
+{
+    json_t *root, *b, *e, *valref;
+
+    if (!(root = treeobj_create_dir ())
+        || !(b = treeobj_create_dir ())
+        || !(e = treeobj_create_dir ())
+        || !(valref = treeobj_create_valref (NULL)))
+        BAIL_OUT ("treeobj_create failed");
+
+    insert_entry (e, "f", treeobj_create_val ("3", 1));
+
+    if (treeobj_append_blobref (valref, store_blob ("hello ")) < 0
+        || treeobj_append_blobref (valref, store_blob ("world")) < 0)
+        BAIL_OUT ("treeobj_append_blobref failed");
+    insert_entry (b, "c", treeobj_create_val ("2", 1));
+    insert_entry (b, "d", valref);
+    insert_entry (b, "e", treeobj_create_dirref (store_dir (e)));
+
+    insert_entry (root, "a", treeobj_create_val ("1", 1));
+    insert_entry (root, "b", treeobj_create_dirref (store_dir (b)));
+    insert_entry (root, "g", treeobj_create_symlink (NULL, "a"));
+
+    return strdup (store_dir (root));
+}
+
+static void test_errors (flux_t *h)
+{
+    struct kvs_snapshot *snap;
+    json_t *o;
+    void *data;
+    int len;
+    const char *path;
+    const json_t *treeobj;
+
+    errno = 0;
+    ok (kvs_snapshot_open (NULL, NULL, 0) == NULL && errno == EINVAL,
+        "kvs_snapshot_open h=NULL fails with EINVAL");
+    errno = 0;
+    ok (kvs_snapshot_openat (NULL, "sha1-123", 0) == NULL && errno == EINVAL,
+        "kvs_snapshot_openat h=NULL fails with EINVAL");
+    errno = 0;
+    ok (kvs_snapshot_openat (h, NULL, 0) == NULL && errno == EINVAL,
+        "kvs_snapshot_openat blobref=NULL fails with EINVAL");
+    errno = 0;
+    ok (kvs_snapshot_openat (h, "sha1-123", 0xff) == NULL && errno == EINVAL,
+        "kvs_snapshot_openat flags=0xff fails with EINVAL");
+    errno = 0;
+    ok (kvs_snapshot_get_blobref (NULL) == NULL && errno == EINVAL,
+        "kvs_snapshot_get_blobref snap=NULL fails with EINVAL");
+    errno = 0;
+    ok (kvs_snapshot_set_prefetch (NULL, 1) < 0 && errno == EINVAL,
+        "kvs_snapshot_set_prefetch snap=NULL fails with EINVAL");
+    errno = 0;
+    ok (kvs_snapshot_lookup (NULL, "a", &o) < 0 && errno == EINVAL,
+        "kvs_snapshot_lookup snap=NULL fails with EINVAL");
+    errno = 0;
+    ok (kvs_snapshot_get_value (NULL, NULL, &data, &len, NULL) < 0
+        && errno == EINVAL,
+        "kvs_snapshot_get_value snap=NULL fails with EINVAL");
+    errno = 0;
+    ok (kvs_snapshot_itr_create (NULL, NULL) == NULL && errno == EINVAL,
+        "kvs_snapshot_itr_create snap=NULL fails with EINVAL");
+    errno = 0;
+    ok (kvs_snapshot_itr_next (NULL, &path, &treeobj, NULL) < 0
+        && errno == EINVAL,
+        "kvs_snapshot_itr_next itr=NULL fails with EINVAL");
+
+    if (!(snap = kvs_snapshot_openat (h, "sha1-123", 0)))
+        BAIL_OUT ("kvs_snapshot_openat failed");
+    errno = 0;
+    ok (kvs_snapshot_set_prefetch (snap, -1) < 0 && errno == EINVAL,
+        "kvs_snapshot_set_prefetch count=-1 fails with EINVAL");
+    errno = 0;
+    ok (kvs_snapshot_lookup (snap, NULL, &o) < 0 && errno == EINVAL,
+        "kvs_snapshot_lookup key=NULL fails with EINVAL");
+    kvs_snapshot_close (snap);
+}
+
+static void test_lookup (flux_t *h, const char *rootref)
+{
+    struct kvs_snapshot *snap;
+    json_t *o = NULL;
+    void *data;
+    int len;
+
+    snap = kvs_snapshot_openat (h, rootref, 0);
+    ok (snap != NULL,
+        "kvs_snapshot_openat works");
+    ok (kvs_snapshot_get_blobref (snap) != NULL
+        && !strcmp (kvs_snapshot_get_blobref (snap), rootref),
+        "kvs_snapshot_get_blobref returns root blobref");
+
+    ok (kvs_snapshot_lookup (snap, ".", &o) == 0
+        && treeobj_is_dir (o)
+        && treeobj_get_count (o) == 3,
+        "kvs_snapshot_lookup . returns root dir");
+    json_decref (o);
+    o = NULL;
+
+    ok (kvs_snapshot_lookup (snap, "b.e", &o) == 0
+        && treeobj_is_dir (o)
+        && treeobj_get_count (o) == 1,
+        "kvs_snapshot_lookup b.e returns dereferenced dir");
+    json_decref (o);
+    o = NULL;
+
+    data = NULL;
+    ok (kvs_snapshot_lookup (snap, "b.e.f", &o) == 0
+        && kvs_snapshot_get_value (snap, o, &data, &len, NULL) == 0
+        && len == 1
+        && !strcmp (data, "3"),
+        "kvs_snapshot_lookup b.e.f returns val");
+    json_decref (o);
+    o = NULL;
+    free (data);
+
+    data = NULL;
+    ok (kvs_snapshot_lookup (snap, "b.d", &o) == 0
+        && treeobj_is_valref (o)
+        && kvs_snapshot_get_value (snap, o, &data, &len, NULL) == 0
+        && len == 11
+        && !strcmp (data, "hello world"),
+        "kvs_snapshot_get_value concatenates valref blobs");
+    json_decref (o);
+    o = NULL;
+    free (data);
+
+    ok (kvs_snapshot_lookup (snap, "g", &o) == 0
+        && treeobj_is_symlink (o),
+        "kvs_snapshot_lookup does not follow symlinks");
+    json_decref (o);
+    o = NULL;
+
+    errno = 0;
+    ok (kvs_snapshot_lookup (snap, "b.nokey", &o) < 0 && errno == ENOENT,
+        "kvs_snapshot_lookup of missing key fails with ENOENT");
+    errno = 0;
+    ok (kvs_snapshot_lookup (snap, "a.b", &o) < 0 && errno == ENOTDIR,
+        "kvs_snapshot_lookup through a value fails with ENOTDIR");
+    errno = 0;
+    ok (kvs_snapshot_itr_create (snap, "a") == NULL && errno == ENOTDIR,
+        "kvs_snapshot_itr_create on a value fails with ENOTDIR");
+
+    kvs_snapshot_close (snap);
+
+    snap = kvs_snapshot_openat (h, BADREF, 0);
+    errno = 0;
+    ok (snap != NULL
+        && kvs_snapshot_lookup (snap, ".", &o) < 0
+        && errno == ENOENT,
+        "kvs_snapshot_lookup fails with ENOENT on missing root blob");
+    kvs_snapshot_close (snap);
+}
+
+/* Build a tree with bad entries and return the root blobref:
+ *   a = dirref to undecodable blob
+ *   b = dirref to val
+ *   c = dirref to missing blob
+ *   d = valref whose second blob is missing
+ */
+static char *create_bad_tree (void)
+{
+    json_t *root, *val, *valref;
+
+    if (!(root = treeobj_create_dir ())
+        || !(val = treeobj_create_val ("x", 1))
+        || !(valref = treeobj_create_valref (store_blob ("ok"))))
+        BAIL_OUT ("treeobj_create failed");
+    if (treeobj_append_blobref (valref, BADREF) < 0)
+        BAIL_OUT ("treeobj_append_blobref failed");
+    insert_entry (root, "a", treeobj_create_dirref (store_blob ("notjson")));
+    insert_entry (root, "b", treeobj_create_dirref (store_dir (val)));
+    insert_entry (root, "c", treeobj_create_dirref (BADREF));
+    insert_entry (root, "d", valref);
+
+    return strdup (store_dir (root));
+}
+
+static void test_bad_tree (flux_t *h, const char *rootref)
+{
+    struct kvs_snapshot *snap;
+    struct kvs_snapshot_itr *itr;
+    const char *path;
+    const json_t *treeobj;
+    flux_error_t error;
+    void *data;
+    int len;
+
+    if (!(snap = kvs_snapshot_openat (h, rootref, 0))
+        || !(itr = kvs_snapshot_itr_create (snap, NULL)))
+        BAIL_OUT ("could not create snapshot iterator");
+    errno = 0;
+    ok (kvs_snapshot_itr_next (itr, &path, &treeobj, &error) < 0
+        && errno == EPROTO
+        && strstr (error.text, "could not decode directory"),
+        "kvs_snapshot_itr_next fails with EPROTO on undecodable dir");
+    errno = 0;
+    ok (kvs_snapshot_itr_next (itr, &path, &treeobj, &error) < 0
+        && errno == ENOTDIR
+        && strstr (error.text, "dirref references non-directory"),
+        "kvs_snapshot_itr_next fails with ENOTDIR on dirref to non-dir");
+    errno = 0;
+    ok (kvs_snapshot_itr_next (itr, &path, &treeobj, &error) < 0
+        && errno == ENOENT
+        && strstr (error.text, "missing blobref"),
+        "kvs_snapshot_itr_next fails with ENOENT on missing dir blob");
+    ok (kvs_snapshot_itr_next (itr, &path, &treeobj, &error) == 1
+        && !strcmp (path, "d"),
+        "kvs_snapshot_itr_next continues after errors");
+    errno = 0;
+    ok (kvs_snapshot_get_value (snap, treeobj, &data, &len, &error) < 0
+        && errno == ENOENT
+        && strstr (error.text, "missing blobref 1"),
+        "kvs_snapshot_get_value reports index of missing valref blob");
+    ok (kvs_snapshot_itr_next (itr, &path, &treeobj, &error) == 0,
+        "kvs_snapshot_itr_next returns 0 at end");
+
+    kvs_snapshot_itr_destroy (itr);
+    kvs_snapshot_close (snap);
+}
+
+static void test_itr (flux_t *h, const char *rootref, int prefetch, int flags)
+{
+    struct kvs_snapshot *snap;
+    struct kvs_snapshot_itr *itr;
+    const char *path;
+    const json_t *treeobj;
+    const char *expected[] = { "a", "b.c", "b.d", "b.e.f", "g" };
+    int count = 0;
+    int errors = 0;
+    int rc;
+
+    if (!(snap = kvs_snapshot_openat (h, rootref, flags)))
+        BAIL_OUT ("kvs_snapshot_openat failed");
+    ok (kvs_snapshot_set_prefetch (snap, prefetch) == 0,
+        "kvs_snapshot_set_prefetch %d works", prefetch);
+    itr = kvs_snapshot_itr_create (snap, NULL);
+    ok (itr != NULL,
+        "kvs_snapshot_itr_create works");
+    while ((rc = kvs_snapshot_itr_next (itr, &path, &treeobj, NULL)) > 0) {
+        if (count >= 5 || strcmp (path, expected[count]) != 0) {
+            diag ("unexpected path %s", path);
+            errors++;
+        }
+        if (treeobj_is_dir (treeobj) || treeobj_is_dirref (treeobj))
+            errors++;
+        count++;
+    }
+    ok (rc == 0 && count == 5 && errors == 0,
+        "iterator visited all entries in depth-first order");
+    kvs_snapshot_itr_destroy (itr);
+
+    itr = kvs_snapshot_itr_create (snap, "b.e");
+    ok (itr != NULL
+        && kvs_snapshot_itr_next (itr, &path, &treeobj, NULL) == 1
+        && !strcmp (path, "b.e.f")
+        && kvs_snapshot_itr_next (itr, &path, &treeobj, NULL) == 0,
+        "iterator on subdirectory returns full key paths");
+    kvs_snapshot_itr_destroy (itr);
+
+    kvs_snapshot_close (snap);
+}
+
+int main (int argc, char *argv[])
+{
+    flux_t *h;
+    char *rootref;
+    char *badref;
+
+    plan (NO_PLAN);
+
+    if (!(store = zhashx_new ()))
+        BAIL_OUT ("zhashx_new failed");
+    zhashx_set_destructor (store, (zhashx_destructor_fn *)free);
+    rootref = create_tree ();
+    badref = create_bad_tree ();
+
+    if (!(h = test_server_create (0, test_server, NULL)))
+        BAIL_OUT ("test_server_create failed");
+
+    test_errors (h);
+
+    test_lookup (h, rootref);
+    test_itr (h, rootref, 0, 0);
+    test_itr (h, rootref, KVS_SNAPSHOT_DEFAULT_PREFETCH, 0);
+    test_itr (h, rootref, 1, KVS_SNAPSHOT_PREFETCH_VALUES);
+    test_bad_tree (h, badref);
+
+    ok (test_server_stop (h) == 0,
+        "test_server_stop works");
+    flux_close (h);
+
+    free (rootref);
+    free (badref);
+    zhashx_destroy (&store);
+
+    done_testing ();
+    return (0);
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -148,10 +148,10 @@ error:
     return NULL;
 }
 
-static void destruct_hostlist (void **item)
+static void destruct_hostlist_index (void **item)
 {
     if (item) {
-        hostlist_destroy (*item);
+        hostlist_index_destroy (*item);
         *item = NULL;
     }
 }
@@ -159,26 +159,36 @@ static void destruct_hostlist (void **item)
 static bool match_hostlist (struct job_constraint *c,
                             const struct rnode *n)
 {
-    struct hostlist *hl = zlistx_first (c->values);
-    if (!hl || hostlist_find (hl, n->hostname) < 0)
+    struct hostlist_index *idx = zlistx_first (c->values);
+    if (!idx || hostlist_index_find (idx, n->hostname) < 0)
         return false;
     return true;
 }
 
+/*  The hostlist is indexed once at creation so that matching each rnode
+ *  is a hash lookup rather than a linear search of the hostlist.
+ */
 static struct job_constraint *create_hostlist_constraint (json_t *values,
                                                           flux_error_t *errp)
 {
     struct job_constraint *c;
+    struct hostlist_index *idx;
     struct hostlist *hl = array_to_hostlist (values, errp);
     if (!hl)
         return NULL;
+    idx = hostlist_index_create (hl);
+    hostlist_destroy (hl);
+    if (!idx) {
+        errprintf (errp, "failed to index hostlist: %s", strerror (errno));
+        return NULL;
+    }
     if (!(c = job_constraint_new (errp))
-        || !zlistx_add_end (c->values, hl)) {
+        || !zlistx_add_end (c->values, idx)) {
         job_constraint_destroy (c);
-        hostlist_destroy (hl);
+        hostlist_index_destroy (idx);
         return NULL;
     }
-    zlistx_set_destructor (c->values, destruct_hostlist);
+    zlistx_set_destructor (c->values, destruct_hostlist_index);
     c->match = match_hostlist;
     return c;
 }
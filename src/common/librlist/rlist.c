@@ -24,6 +24,7 @@
 #include "src/common/libczmqcontainers/czmq_containers.h"
 #include "src/common/libutil/errprintf.h"
 #include "ccan/str/str.h"
+#include "ccan/ptrint/ptrint.h"
 
 #include "rnode.h"
 #include "match.h"
@@ -2441,7 +2442,7 @@ out:
 /*  Process one entry from the resource.config array
  */
 static int rlist_config_add_entry (struct rlist *rl,
-                                   struct hostlist *hostmap,
+                                   zhashx_t *hostmap,
                                    flux_error_t *errp,
                                    int index,
                                    const char *hosts,
@@ -2479,17 +2480,20 @@ static int rlist_config_add_entry (struct rlist *rl,
     host = hostlist_first (hl);
     while (host) {
         struct rnode *n;
-        int rank = hostlist_find (hostmap, host);
+        /*  Host map values are stored as rank + 1 so that a NULL
+         *   lookup result means the host has not been seen.
+         */
+        int rank = ptr2int (zhashx_lookup (hostmap, host)) - 1;
         if (rank < 0) {
             /*
-             *  First time encountering this host. Append to host map
-             *   hostlist and assign a rank.
+             *  First time encountering this host. Add to host map
+             *   and assign the next rank.
              */
-            if (hostlist_append (hostmap, host) < 0) {
-                errprintf (errp, "failed to append %s to host map", host);
+            rank = zhashx_size (hostmap);
+            if (zhashx_insert (hostmap, host, int2ptr (rank + 1)) < 0) {
+                errprintf (errp, "failed to add %s to host map", host);
                 goto error;
             }
-            rank = hostlist_count (hostmap) - 1;
         }
         if (idset_set (ranks, rank) < 0) {
             errprintf (errp, "idset_set(ranks, %d): %s",
@@ -2554,14 +2558,17 @@ struct rlist *rlist_from_config (json_t *conf, flux_error_t *errp)
     size_t index;
     json_t *entry;
     struct rlist *rl = NULL;
-    struct hostlist *hl = NULL;
+    zhashx_t *hostmap = NULL;
 
     if (!conf || !json_is_array (conf)) {
         errprintf (errp, "resource config must be an array");
         return NULL;
     }
 
-    if (!(hl = hostlist_create ())
+    /*  Map hostname to rank + 1 for O(1) lookup of hosts already
+     *   assigned a rank by a previous config entry.
+     */
+    if (!(hostmap = zhashx_new ())
         || !(rl = rlist_create ())) {
         errprintf (errp, "Out of memory");
         goto error;
@@ -2591,7 +2598,7 @@ struct rlist *rlist_from_config (json_t *conf, flux_error_t *errp)
             goto error;
         }
         if (rlist_config_add_entry (rl,
-                                    hl,
+                                    hostmap,
                                     errp,
                                     index,
                                     hosts,
@@ -2604,10 +2611,10 @@ struct rlist *rlist_from_config (json_t *conf, flux_error_t *errp)
     if (rlist_config_check (rl, errp) < 0)
         goto error;
 
-    hostlist_destroy (hl);
+    zhashx_destroy (&hostmap);
     return rl;
 error:
-    hostlist_destroy (hl);
+    zhashx_destroy (&hostmap);
     rlist_destroy (rl);
     return NULL;
 }
@@ -21,8 +21,12 @@
 
 #include "src/common/libczmqcontainers/czmq_containers.h"
 #include "src/common/libutil/aux.h"
+#include "src/common/libutil/errno_safe.h"
 #include "src/common/libjob/idf58.h"
 #include "ccan/str/str.h"
+#include "subprocess_private.h"
+#include "client.h"
+#include "remote.h"
 #include "bulk-exec.h"
 
 struct exec_cmd {
@@ -49,6 +53,7 @@ struct bulk_exec {
     int exit_status;         /* Largest wait status of all complete procs */
 
     unsigned int active:1;
+    unsigned int tree_launch:1; /* Launch with one rexec.tree-exec request */
 
     flux_watcher_t *prep;
     flux_watcher_t *check;
@@ -62,6 +67,7 @@ struct bulk_exec {
 
     zlist_t *commands;
     zlist_t *processes;
+    zlist_t *trees;          /* Outstanding rexec.tree-exec futures */
 
     struct bulk_exec_ops *handlers;
     void *arg;
@@ -363,12 +369,164 @@ static int subprocess_destroy (flux_t *h, flux_subprocess_t *p)
     return 0;
 }
 
+static int exec_add_process (struct bulk_exec *exec, flux_subprocess_t *p)
+{
+    if (flux_subprocess_aux_set (p, "job-exec::exec", exec, NULL) < 0
+       || zlist_append (exec->processes, p) < 0) {
+        if (subprocess_destroy (exec->h, p) < 0)
+            flux_log_error (exec->h, "Unable to destroy pid %ju",
+                    (uintmax_t) flux_subprocess_pid (p));
+        return -1;
+    }
+    zlist_freefn (exec->processes, p,
+                 (zlist_free_fn *) flux_subprocess_destroy,
+                 true);
+    return 0;
+}
+
+/*  Fail the processes of a tree launch that have not yet completed.
+ */
+static void exec_tree_fail (zhashx_t *procs, int errnum, const char *errmsg)
+{
+    flux_future_t *f = zhashx_first (procs);
+    while (f) {
+        flux_future_fulfill_error (f, errnum, errmsg);
+        f = zhashx_next (procs);
+    }
+    zhashx_purge (procs);
+}
+
+/*  Dispatch a rexec.tree-exec response to the subprocess for its rank.
+ */
+static void exec_tree_continuation (flux_future_t *f, void *arg)
+{
+    struct bulk_exec *exec = arg;
+    zhashx_t *procs = flux_future_aux_get (f, "bulk_exec::procs");
+    flux_future_t *proxy;
+    uint32_t rank;
+    char key[16];
+    int rc;
+
+    if (subprocess_rexec_tree_rank (f, &rank) < 0) {
+        /*  Every process reports completion or failure before the stream
+         *   ends, so any process left at this point is lost.
+         */
+        if (errno == ENODATA)
+            exec_tree_fail (procs, EPROTO, NULL);
+        else
+            exec_tree_fail (procs, errno, future_strerror (f, errno));
+        return;
+    }
+    snprintf (key, sizeof (key), "%u", rank);
+    if ((proxy = zhashx_lookup (procs, key))) {
+        if ((rc = subprocess_rexec_proxy_fulfill (proxy, f)) < 0)
+            flux_log_error (exec->h, "rank %u: tree-exec response", rank);
+        else if (rc == 1)
+            zhashx_delete (procs, key);
+    }
+    flux_future_reset (f);
+}
+
+/*  Launch cmd on all of its ranks with a single rexec.tree-exec request
+ *   to the local broker, which fans the launch out over the TBON.
+ *   A subprocess is created for each rank, driven by the responses
+ *   relayed for that rank.
+ */
+static int exec_start_tree (struct bulk_exec *exec, struct exec_cmd *cmd)
+{
+    flux_future_t *f = NULL;
+    zhashx_t *procs = NULL;
+    char *ranks = NULL;
+    uint32_t self;
+    uint32_t rank;
+    int flags = remote_exec_flags (cmd->cmd, &exec->ops);
+    int count = 0;
+
+    if (flux_get_rank (exec->h, &self) < 0
+        || !(ranks = idset_encode (cmd->ranks, IDSET_FLAG_RANGE)))
+        return -1;
+    if (!(procs = zhashx_new ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (!(f = subprocess_rexec_tree (exec->h,
+                                     exec->service,
+                                     self,
+                                     ranks,
+                                     cmd->cmd,
+                                     flags))
+        || flux_future_aux_set (f,
+                                "bulk_exec::procs",
+                                procs,
+                                (flux_free_f) zhashx_destroy) < 0)
+        goto error;
+    procs = NULL;
+    if (zlist_append (exec->trees, f) < 0) {
+        errno = ENOMEM;
+        goto error;
+    }
+    zlist_freefn (exec->trees, f, (zlist_free_fn *) flux_future_destroy, true);
+    procs = flux_future_aux_get (f, "bulk_exec::procs");
+
+    rank = idset_first (cmd->ranks);
+    while (rank != IDSET_INVALID_ID) {
+        flux_subprocess_t *p;
+        flux_future_t *proxy;
+        char key[16];
+
+        if (!(proxy = subprocess_rexec_proxy (f, rank)))
+            goto out;
+        if (!(p = subprocess_rexec_attach (exec->h,
+                                           exec->service,
+                                           rank,
+                                           cmd->flags,
+                                           cmd->cmd,
+                                           &exec->ops,
+                                           proxy,
+                                           flux_llog,
+                                           exec->h))) {
+            flux_future_destroy (proxy);
+            goto out;
+        }
+        if (exec_add_process (exec, p) < 0)
+            goto out;
+        snprintf (key, sizeof (key), "%u", rank);
+        (void) zhashx_insert (procs, key, proxy);
+
+        idset_clear (cmd->ranks, rank);
+        rank = idset_next (cmd->ranks, rank);
+        count++;
+    }
+    if (flux_future_then (f, -1., exec_tree_continuation, exec) < 0)
+        goto out;
+    free (ranks);
+    return count;
+out:
+    /*  The request has been sent, so leave the future on exec->trees
+     *   and let the caller fail the job.
+     */
+    ERRNO_SAFE_WRAP (free, ranks);
+    return -1;
+error:
+    ERRNO_SAFE_WRAP (zhashx_destroy, &procs);
+    ERRNO_SAFE_WRAP (flux_future_destroy, f);
+    ERRNO_SAFE_WRAP (free, ranks);
+    return -1;
+}
+
 static int exec_start_cmd (struct bulk_exec *exec,
                            struct exec_cmd *cmd,
                            int max)
 {
     int count = 0;
     uint32_t rank;
+
+    /*  A tree launch starts all ranks at once.  sdexec sets a unit
+     *   name per rank below, so it always uses per-rank rexec.
+     */
+    if (exec->tree_launch && streq (exec->service, "rexec"))
+        return exec_start_tree (exec, cmd);
+
     rank = idset_first (cmd->ranks);
     while (rank != IDSET_INVALID_ID && (max < 0 || count < max)) {
         /* Set the unit name for the "sdexec" service.  This is done here
@@ -407,18 +565,8 @@ static int exec_start_cmd (struct bulk_exec *exec,
                                               &exec->ops,
                                               flux_llog,
                                               exec->h);
-        if (!p)
-            return -1;
-        if (flux_subprocess_aux_set (p, "job-exec::exec", exec, NULL) < 0
-           || zlist_append (exec->processes, p) < 0) {
-            if (subprocess_destroy (exec->h, p) < 0)
-                flux_log_error (exec->h, "Unable to destroy pid %ju",
-                        (uintmax_t) flux_subprocess_pid (p));
+        if (!p || exec_add_process (exec, p) < 0)
             return -1;
-        }
-        zlist_freefn (exec->processes, p,
-                     (zlist_free_fn *) flux_subprocess_destroy,
-                     true);
 
         idset_clear (cmd->ranks, rank);
         rank = idset_next (cmd->ranks, rank);
@@ -445,7 +593,7 @@ static int exec_start_cmds (struct bulk_exec *exec, int max)
         if (idset_count (cmd->ranks) == 0)
             zlist_remove (exec->commands, cmd);
         if (max > 0)
-            max -= rc;
+            max = rc < max ? max - rc : 0;
 
     }
     return 0;
@@ -487,6 +635,7 @@ void bulk_exec_destroy (struct bulk_exec *exec)
 {
     if (exec) {
         int saved_errno = errno;
+        zlist_destroy (&exec->trees);
         zlist_destroy (&exec->processes);
         zlist_destroy (&exec->commands);
         idset_destroy (exec->exit_batch);
@@ -527,6 +676,7 @@ struct bulk_exec * bulk_exec_create (struct bulk_exec_ops *ops,
     exec->arg = arg;
     exec->processes = zlist_new ();
     exec->commands = zlist_new ();
+    exec->trees = zlist_new ();
     exec->exit_batch = idset_create (0, IDSET_FLAG_AUTOGROW);
     exec->max_start_per_loop = 1;
 
@@ -546,6 +696,16 @@ int bulk_exec_set_max_per_loop (struct bulk_exec *exec, int max)
     return 0;
 }
 
+int bulk_exec_set_tree_launch (struct bulk_exec *exec, bool enable)
+{
+    if (!exec) {
+        errno = EINVAL;
+        return -1;
+    }
+    exec->tree_launch = enable;
+    return 0;
+}
+
 int bulk_exec_set_imp_path (struct bulk_exec *exec,
                             const char *imp_path)
 {
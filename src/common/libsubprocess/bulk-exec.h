@@ -60,6 +60,13 @@ int bulk_exec_aux_set (struct bulk_exec *exec,
  */
 int bulk_exec_set_max_per_loop (struct bulk_exec *exec, int max);
 
+/*  Launch each command with a single rexec.tree-exec request that is
+ *   forwarded down the TBON, instead of one request per rank.  All ranks
+ *   of a command then start in one event loop iteration, regardless of
+ *   bulk_exec_set_max_per_loop().  Ignored unless the service is "rexec".
+ */
+int bulk_exec_set_tree_launch (struct bulk_exec *exec, bool enable);
+
 /*  Set path to an IMP to use for bulk_exec_kill().
  */
 int bulk_exec_set_imp_path (struct bulk_exec *exec,
@@ -14,6 +14,9 @@
 
 #include <unistd.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <arpa/inet.h>
 #include <flux/core.h>
 
 #include "ccan/str/str.h"
@@ -28,16 +31,25 @@
 struct rexec_io {
     json_t *obj;
     const char *stream;
-    char *data;
+    const char *data;
+    char *buf;
     int len;
     bool eof;
 };
 
+/* Remaining records of a batched output response.
+ */
+struct rexec_batch {
+    const char *cursor;
+    const char *end;
+};
+
 struct rexec_response {
     const char *type;
     pid_t pid;
     int status;
     struct rexec_io io;
+    struct rexec_batch batch;
 };
 
 struct rexec_ctx {
@@ -52,7 +64,7 @@ struct rexec_ctx {
 static void rexec_response_clear (struct rexec_response *resp)
 {
     json_decref (resp->io.obj);
-    free (resp->io.data);
+    free (resp->io.buf);
 
     memset (resp, 0, sizeof (*resp));
 
@@ -79,7 +91,9 @@ static struct rexec_ctx *rexec_ctx_create (flux_cmd_t *cmd,
     struct rexec_ctx *ctx;
     int valid_flags = SUBPROCESS_REXEC_STDOUT
         | SUBPROCESS_REXEC_STDERR
-        | SUBPROCESS_REXEC_CHANNEL;
+        | SUBPROCESS_REXEC_CHANNEL
+        | SUBPROCESS_REXEC_RAWIO
+        | SUBPROCESS_REXEC_BATCH;
 
     if ((flags & ~valid_flags)) {
         errno = EINVAL;
@@ -140,6 +154,234 @@ error:
     return NULL;
 }
 
+flux_future_t *subprocess_rexec_tree (flux_t *h,
+                                      const char *service_name,
+                                      uint32_t rank,
+                                      const char *ranks,
+                                      flux_cmd_t *cmd,
+                                      int flags)
+{
+    flux_future_t *f = NULL;
+    struct rexec_ctx *ctx;
+    char *topic;
+
+    if (!h || !cmd || !service_name || !ranks) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (asprintf (&topic, "%s.tree-exec", service_name) < 0)
+        return NULL;
+    if (!(ctx = rexec_ctx_create (cmd, service_name, rank, flags)))
+        goto error;
+    if (!(f = flux_rpc_pack (h,
+                             topic,
+                             rank,
+                             FLUX_RPC_STREAMING,
+                             "{s:O s:i s:s}",
+                             "cmd", ctx->cmd,
+                             "flags", ctx->flags,
+                             "ranks", ranks))
+        || flux_future_aux_set (f,
+                                "flux::rexec",
+                                ctx,
+                                (flux_free_f)rexec_ctx_destroy) < 0) {
+        rexec_ctx_destroy (ctx);
+        goto error;
+    }
+    ctx->matchtag = flux_rpc_get_matchtag (f);
+    free (topic);
+    return f;
+error:
+    ERRNO_SAFE_WRAP (free, topic);
+    flux_future_destroy (f);
+    return NULL;
+}
+
+static int parse_rank (const char *s, uint32_t *rank)
+{
+    char *endptr;
+    unsigned long val;
+
+    errno = 0;
+    val = strtoul (s, &endptr, 10);
+    if (errno != 0 || *endptr != '\0' || endptr == s || val > UINT32_MAX) {
+        errno = EPROTO;
+        return -1;
+    }
+    *rank = val;
+    return 0;
+}
+
+int subprocess_rexec_tree_rank (flux_future_t *f, uint32_t *rank)
+{
+    const flux_msg_t *msg;
+    const void *buf;
+    int size;
+    const char *rankstr;
+    int i;
+
+    if (!rank) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (flux_future_get (f, (const void **)&msg) < 0
+        || flux_response_decode_raw (msg, NULL, &buf, &size) < 0)
+        return -1;
+    if (ioencode_is_raw (buf, size)) {
+        if (iodecode_raw (buf, size, NULL, &rankstr, NULL, NULL, NULL) < 0)
+            return -1;
+        return parse_rank (rankstr, rank);
+    }
+    /* All records in a batch are from the same process, so the first
+     * record's rank applies to the whole response.
+     */
+    if (size > 0 && *(const uint8_t *)buf == SUBPROCESS_REXEC_BATCH_MAGIC) {
+        const char *cursor = (const char *)buf + 1;
+        uint32_t hdr;
+
+        if ((size_t)size < 1 + sizeof (hdr)) {
+            errno = EPROTO;
+            return -1;
+        }
+        memcpy (&hdr, cursor, sizeof (hdr));
+        if (ntohl (hdr) > (size_t)size - 1 - sizeof (hdr)
+            || iodecode_raw (cursor + sizeof (hdr),
+                             ntohl (hdr),
+                             NULL,
+                             &rankstr,
+                             NULL,
+                             NULL,
+                             NULL) < 0) {
+            errno = EPROTO;
+            return -1;
+        }
+        return parse_rank (rankstr, rank);
+    }
+    if (flux_msg_unpack (msg, "{s:i}", "rank", &i) < 0 || i < 0) {
+        errno = EPROTO;
+        return -1;
+    }
+    *rank = i;
+    return 0;
+}
+
+flux_future_t *subprocess_rexec_proxy (flux_future_t *f_tree, uint32_t rank)
+{
+    struct rexec_ctx *tctx;
+    struct rexec_ctx *ctx;
+    flux_future_t *f;
+
+    if (!(tctx = flux_future_aux_get (f_tree, "flux::rexec"))) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(ctx = calloc (1, sizeof (*ctx))))
+        return NULL;
+    if (!(ctx->service_name = strdup (tctx->service_name)))
+        goto error;
+    ctx->flags = tctx->flags;
+    ctx->response.pid = -1;
+    ctx->matchtag = tctx->matchtag;
+    ctx->rank = rank;
+    if (!(f = flux_future_create (NULL, NULL)))
+        goto error;
+    flux_future_set_flux (f, flux_future_get_flux (f_tree));
+    if (flux_future_aux_set (f,
+                             "flux::rexec",
+                             ctx,
+                             (flux_free_f)rexec_ctx_destroy) < 0) {
+        ERRNO_SAFE_WRAP (flux_future_destroy, f);
+        goto error;
+    }
+    return f;
+error:
+    rexec_ctx_destroy (ctx);
+    return NULL;
+}
+
+int subprocess_rexec_proxy_fulfill (flux_future_t *f, flux_future_t *f_tree)
+{
+    const flux_msg_t *msg;
+    const char *type;
+
+    if (!f || !f_tree) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (flux_future_get (f_tree, (const void **)&msg) < 0)
+        return -1;
+    /* Raw output payloads fail to unpack, and are passed through.
+     */
+    if (flux_msg_unpack (msg, "{s:s}", "type", &type) == 0) {
+        if (streq (type, "complete")) {
+            flux_future_fulfill_error (f, ENODATA, NULL);
+            return 1;
+        }
+        if (streq (type, "failed")) {
+            int errnum = EPROTO;
+            const char *errmsg = NULL;
+
+            (void)flux_msg_unpack (msg,
+                                   "{s:i s?s}",
+                                   "errnum", &errnum,
+                                   "errmsg", &errmsg);
+            flux_future_fulfill_error (f, errnum, errmsg);
+            return 1;
+        }
+    }
+    flux_future_fulfill (f,
+                         (void *)flux_msg_incref (msg),
+                         (flux_free_f)flux_msg_decref);
+    return 0;
+}
+
+/* Decode the record at the batch cursor into 'io' and advance.
+ */
+static int batch_next (struct rexec_batch *batch, struct rexec_io *io)
+{
+    uint32_t hdr;
+    size_t len;
+
+    if ((size_t)(batch->end - batch->cursor) < sizeof (hdr)) {
+        errno = EPROTO;
+        return -1;
+    }
+    memcpy (&hdr, batch->cursor, sizeof (hdr));
+    len = ntohl (hdr);
+    batch->cursor += sizeof (hdr);
+    if ((size_t)(batch->end - batch->cursor) < len
+        || iodecode_raw (batch->cursor,
+                         len,
+                         &io->stream,
+                         NULL,
+                         &io->data,
+                         &io->len,
+                         &io->eof) < 0) {
+        errno = EPROTO;
+        return -1;
+    }
+    batch->cursor += len;
+    return 0;
+}
+
+/* Check that all records in a batch can be decoded, so that
+ * subprocess_rexec_next_output() cannot fail.
+ */
+static int batch_validate (struct rexec_batch batch)
+{
+    struct rexec_io io;
+
+    if (batch.cursor == batch.end) {
+        errno = EPROTO;
+        return -1;
+    }
+    while (batch.cursor < batch.end) {
+        if (batch_next (&batch, &io) < 0)
+            return -1;
+    }
+    return 0;
+}
+
 int subprocess_rexec_get (flux_future_t *f)
 {
     struct rexec_ctx *ctx;
@@ -149,6 +391,42 @@ int subprocess_rexec_get (flux_future_t *f)
         return -1;
     }
     rexec_response_clear (&ctx->response);
+
+    /* With SUBPROCESS_REXEC_RAWIO, a server that supports it sends
+     * output as an ioencode_raw() payload.  Data is not copied and
+     * remains valid until the future is reset.
+     */
+    if ((ctx->flags & SUBPROCESS_REXEC_RAWIO)) {
+        const void *buf;
+        int size;
+
+        if (flux_rpc_get_raw (f, &buf, &size) == 0
+            && ioencode_is_raw (buf, size)) {
+            if (iodecode_raw (buf,
+                              size,
+                              &ctx->response.io.stream,
+                              NULL,
+                              &ctx->response.io.data,
+                              &ctx->response.io.len,
+                              &ctx->response.io.eof) < 0)
+                return -1;
+            ctx->response.type = "output";
+            return 0;
+        }
+        if ((ctx->flags & SUBPROCESS_REXEC_BATCH)
+            && size > 0
+            && *(const uint8_t *)buf == SUBPROCESS_REXEC_BATCH_MAGIC) {
+            struct rexec_batch *batch = &ctx->response.batch;
+
+            batch->cursor = (const char *)buf + 1;
+            batch->end = (const char *)buf + size;
+            if (batch_validate (*batch) < 0
+                || batch_next (batch, &ctx->response.io) < 0)
+                return -1;
+            ctx->response.type = "output";
+            return 0;
+        }
+    }
     if (flux_rpc_get_unpack (f,
                              "{s:s s?i s?i s?O}",
                              "type", &ctx->response.type,
@@ -160,10 +438,11 @@ int subprocess_rexec_get (flux_future_t *f)
         if (iodecode (ctx->response.io.obj,
                       &ctx->response.io.stream,
                       NULL,
-                      &ctx->response.io.data,
+                      &ctx->response.io.buf,
                       &ctx->response.io.len,
                       &ctx->response.io.eof) < 0)
             return -1;
+        ctx->response.io.data = ctx->response.io.buf;
     }
     else if (!streq (ctx->response.type, "started")
         && !streq (ctx->response.type, "stopped")
@@ -233,6 +512,22 @@ bool subprocess_rexec_is_output (flux_future_t *f,
     return false;
 }
 
+bool subprocess_rexec_next_output (flux_future_t *f,
+                                   const char **stream,
+                                   const char **data,
+                                   int *len,
+                                   bool *eof)
+{
+    struct rexec_ctx *ctx;
+
+    if (!(ctx = flux_future_aux_get (f, "flux::rexec"))
+        || !ctx->response.batch.cursor
+        || ctx->response.batch.cursor >= ctx->response.batch.end
+        || batch_next (&ctx->response.batch, &ctx->response.io) < 0)
+        return false;
+    return subprocess_rexec_is_output (f, stream, data, len, eof);
+}
+
 int subprocess_write (flux_future_t *f_exec,
                       const char *stream,
                       const char *data,
@@ -22,8 +22,19 @@ enum {
     SUBPROCESS_REXEC_STDOUT = 1,
     SUBPROCESS_REXEC_STDERR = 2,
     SUBPROCESS_REXEC_CHANNEL = 4,
+    SUBPROCESS_REXEC_RAWIO = 8,     // output may be sent in ioencode_raw()
+                                    //  format instead of RFC 24 JSON
+    SUBPROCESS_REXEC_BATCH = 16,    // with RAWIO, output may be coalesced
+                                    //  into batches (see below)
 };
 
+/* A batched output response payload is SUBPROCESS_REXEC_BATCH_MAGIC
+ * followed by one or more ioencode_raw() records, each prefixed by its
+ * size as a 32-bit integer in network byte order.  Records are in the
+ * order the output was read, across all streams.
+ */
+#define SUBPROCESS_REXEC_BATCH_MAGIC 0xf6
+
 flux_future_t *subprocess_rexec (flux_t *h,
                                  const char *service_name,
                                  uint32_t rank,
@@ -40,6 +51,50 @@ bool subprocess_rexec_is_output (flux_future_t *f,
                                  int *len,
                                  bool *eof);
 
+/* If the current response is a batch of output, advance to the next
+ * output chunk and return true.  Otherwise, return false.
+ */
+bool subprocess_rexec_next_output (flux_future_t *f,
+                                   const char **stream,
+                                   const char **buf,
+                                   int *len,
+                                   bool *eof);
+
+/* Launch 'cmd' on each rank in 'ranks' (an RFC 22 idset string) with a
+ * single <service>.tree-exec request sent to 'rank'.  The server there
+ * starts its local process if it is in 'ranks', and forwards the
+ * remaining ranks down the overlay network, one request per child
+ * subtree.  Responses from all processes are relayed back on the
+ * returned future.  Each carries the rank of the process it refers to,
+ * and per-rank completion or failure is reported with "complete" and
+ * "failed" responses instead of ending the stream, which ends with
+ * ENODATA once all processes are done.
+ */
+flux_future_t *subprocess_rexec_tree (flux_t *h,
+                                      const char *service_name,
+                                      uint32_t rank,
+                                      const char *ranks,
+                                      flux_cmd_t *cmd,
+                                      int flags);
+
+/* Get the rank that the current subprocess_rexec_tree() response
+ * refers to.  Returns -1 with errno set on error, including ENODATA
+ * at the end of the stream.
+ */
+int subprocess_rexec_tree_rank (flux_future_t *f, uint32_t *rank);
+
+/* Create a future that stands in for a subprocess_rexec() future for
+ * one rank of a subprocess_rexec_tree() launch.  The subprocess_rexec_*()
+ * accessors and subprocess_write() may be used on it.
+ */
+flux_future_t *subprocess_rexec_proxy (flux_future_t *f_tree, uint32_t rank);
+
+/* Deliver the current response of 'f_tree' to proxy future 'f'.
+ * Returns 1 if the response ends the stream of the proxy, 0 if not,
+ * or -1 on error.
+ */
+int subprocess_rexec_proxy_fulfill (flux_future_t *f, flux_future_t *f_tree);
+
 int subprocess_write (flux_future_t *f,
                       const char *stream,
                       const char *data,
@@ -519,14 +519,18 @@ static void rexec_continuation (flux_future_t *f, void *arg)
         process_new_state (p, FLUX_SUBPROCESS_EXITED);
     }
     else if (subprocess_rexec_is_output (f, &stream, &data, &len, &eof)) {
-        if (p->flags & FLUX_SUBPROCESS_FLAGS_LOCAL_UNBUF) {
-            if (remote_output_local_unbuf (p, stream, data, len, eof) < 0)
-                goto error;
-        }
-        else {
-            if (remote_output_buffered (p, stream, data, len, eof) < 0)
-                goto error;
-        }
+        /* A batched response may carry several chunks of output.
+         */
+        do {
+            if (p->flags & FLUX_SUBPROCESS_FLAGS_LOCAL_UNBUF) {
+                if (remote_output_local_unbuf (p, stream, data, len, eof) < 0)
+                    goto error;
+            }
+            else {
+                if (remote_output_buffered (p, stream, data, len, eof) < 0)
+                    goto error;
+            }
+        } while (subprocess_rexec_next_output (f, &stream, &data, &len, &eof));
     }
     flux_future_reset (f);
     return;
@@ -539,17 +543,23 @@ error:
     remote_kill_nowait (p, SIGKILL);
 }
 
-int remote_exec (flux_subprocess_t *p)
+int remote_exec_flags (flux_cmd_t *cmd, const flux_subprocess_ops_t *ops)
 {
-    flux_future_t *f;
-    int flags = 0;
+    int flags = SUBPROCESS_REXEC_RAWIO | SUBPROCESS_REXEC_BATCH;
 
-    if (zlist_size (cmd_channel_list (p->cmd)) > 0)
+    if (zlist_size (cmd_channel_list (cmd)) > 0)
         flags |= SUBPROCESS_REXEC_CHANNEL;
-    if (p->ops.on_stdout)
+    if (ops->on_stdout)
         flags |= SUBPROCESS_REXEC_STDOUT;
-    if (p->ops.on_stderr)
+    if (ops->on_stderr)
         flags |= SUBPROCESS_REXEC_STDERR;
+    return flags;
+}
+
+int remote_exec (flux_subprocess_t *p)
+{
+    flux_future_t *f;
+    int flags = remote_exec_flags (p->cmd, &p->ops);
 
     if (!(f = subprocess_rexec (p->h, p->service_name, p->rank, p->cmd, flags))
         || flux_future_then (f, -1., rexec_continuation, p) < 0) {
@@ -563,6 +573,18 @@ int remote_exec (flux_subprocess_t *p)
     return 0;
 }
 
+int remote_attach (flux_subprocess_t *p, flux_future_t *f)
+{
+    if (flux_future_then (f, -1., rexec_continuation, p) < 0) {
+        llog_debug (p,
+                    "error registering rexec continuation: %s",
+                    strerror (errno));
+        return -1;
+    }
+    p->f = f;
+    return 0;
+}
+
 flux_future_t *remote_kill (flux_subprocess_t *p, int signum)
 {
     return subprocess_kill (p->h, p->service_name, p->rank, p->pid, signum);
@@ -17,6 +17,16 @@ int subprocess_remote_setup (flux_subprocess_t *p, const char *service_name);
 
 int remote_exec (flux_subprocess_t *p);
 
+/* Return the subprocess_rexec() flags used to run 'cmd' with 'ops'.
+ */
+int remote_exec_flags (flux_cmd_t *cmd, const flux_subprocess_ops_t *ops);
+
+/* Drive remote subprocess 'p' from responses on 'f', which may be a
+ * subprocess_rexec_proxy() future, instead of sending a request.
+ * On success, 'p' takes ownership of 'f'.
+ */
+int remote_attach (flux_subprocess_t *p, flux_future_t *f);
+
 flux_future_t *remote_kill (flux_subprocess_t *p, int signum);
 
 #endif /* !_SUBPROCESS_REMOTE_H */
@@ -15,7 +15,10 @@
 #include <unistd.h> // defines environ
 #include <signal.h>
 #include <errno.h>
+#include <stdint.h>
+#include <arpa/inet.h>
 #include <flux/core.h>
+#include <flux/idset.h>
 
 #include "src/common/libczmqcontainers/czmq_containers.h"
 #include "src/common/libutil/errno_safe.h"
@@ -31,14 +34,21 @@
 #include "client.h"
 
 /* Keys used to store subprocess server, rexec.exec request, and
- * 'subprocesses' zlistx handle in the subprocess object.
+ * 'subprocesses' zlistx handle in the subprocess object.  rawkey is
+ * set if the client requested SUBPROCESS_REXEC_RAWIO.  treekey is set
+ * to the struct tree_exec if the process was started by rexec.tree-exec.
  */
 static const char *srvkey = "flux::server";
 static const char *msgkey = "flux::request";
 static const char *lstkey = "flux::handle";
+static const char *rawkey = "flux::rawio";
+static const char *batchkey = "flux::batch";
+static const char *treekey = "flux::tree";
+
 
 struct subprocess_server {
     flux_t *h;
+    char *service_name;
     char *local_uri;
     uint32_t rank;
     subprocess_log_f llog;
@@ -47,6 +57,11 @@ struct subprocess_server {
     flux_msg_handler_t **handlers;
     subprocess_server_auth_f auth_cb;
     void *arg;
+    subprocess_server_route_f route_cb;
+    void *route_arg;
+    zlistx_t *trees;
+    size_t batch_size;
+    double batch_timeout;
     // The shutdown future is created when user calls shutdown,
     //  and fulfilled once subprocesses list becomes empty.
     flux_future_t *shutdown;
@@ -107,10 +122,40 @@ static flux_subprocess_t *proc_find_bypid (subprocess_server_t *s, pid_t pid)
     return NULL;
 }
 
+/* A rexec.tree-exec request, as received by this server.  'sender' and
+ * 'matchtag' identify the request of the client that started the launch
+ * (the origin), which may have been forwarded here by a parent server.
+ * 'pending' counts the local process and child streams not yet done.
+ */
+struct tree_exec {
+    subprocess_server_t *s;
+    const flux_msg_t *request;
+    char *sender;
+    uint32_t matchtag;
+    zlistx_t *children;
+    int pending;
+    void *handle;
+};
+
+static bool tree_exec_match (struct tree_exec *t, const flux_msg_t *request)
+{
+    const char *sender = flux_msg_route_first (request);
+    int matchtag;
+
+    if (!sender
+        || !streq (sender, t->sender)
+        || flux_msg_unpack (request, "{s:i}", "matchtag", &matchtag) < 0
+        || (uint32_t)matchtag != t->matchtag)
+        return false;
+    return true;
+}
+
 /* Find a <service>.exec message with the same sender as msg and matchtag as
  * specified in the request matchtag field.
  * N.B. flux_cancel_match() happens to be helpful because RFC 42 subprocess
  * write works like RFC 6 cancel.
+ * A process started by <service>.tree-exec is matched against the
+ * origin request instead, since its own request came from a parent server.
  */
 static flux_subprocess_t *proc_find_byclient (subprocess_server_t *s,
                                               const flux_msg_t *request)
@@ -120,8 +165,13 @@ static flux_subprocess_t *proc_find_byclient (subprocess_server_t *s,
     p = zlistx_first (s->subprocesses);
     while (p) {
         const flux_msg_t *msg;
+        struct tree_exec *t;
 
-        if ((msg = flux_subprocess_aux_get (p, msgkey))
+        if ((t = flux_subprocess_aux_get (p, treekey))) {
+            if (tree_exec_match (t, request))
+                return p;
+        }
+        else if ((msg = flux_subprocess_aux_get (p, msgkey))
             && flux_cancel_match (request, msg))
             return p;
         p = zlistx_next (s->subprocesses);
@@ -130,15 +180,261 @@ static flux_subprocess_t *proc_find_byclient (subprocess_server_t *s,
     return NULL;
 }
 
+/* Pending output for a SUBPROCESS_REXEC_BATCH client, stored in the
+ * subprocess aux container.
+ */
+struct output_batch {
+    subprocess_server_t *s;
+    const flux_msg_t *request;
+    flux_watcher_t *timer;
+    bool timer_armed;
+    char *buf;
+    size_t len;
+    size_t size;
+};
+
+static int batch_flush (struct output_batch *b)
+{
+    int rc = 0;
+
+    flux_watcher_stop (b->timer);
+    b->timer_armed = false;
+    if (b->len <= 1)
+        return 0;
+    if (flux_respond_raw (b->s->h, b->request, b->buf, b->len) < 0) {
+        llog_error (b->s,
+                    "error responding to rexec.exec request: %s",
+                    strerror (errno));
+        rc = -1;
+    }
+    b->len = 1;
+    return rc;
+}
+
+static void batch_timer_cb (flux_reactor_t *r,
+                            flux_watcher_t *w,
+                            int revents,
+                            void *arg)
+{
+    struct output_batch *b = arg;
+    (void)batch_flush (b);
+}
+
+static int batch_append (struct output_batch *b,
+                         const char *stream,
+                         const char *rankstr,
+                         const char *data,
+                         int len,
+                         bool eof)
+{
+    void *rec;
+    size_t reclen;
+    uint32_t hdr;
+    int rc = -1;
+
+    if (ioencode_raw (stream, rankstr, data, len, eof, &rec, &reclen) < 0) {
+        llog_error (b->s, "ioencode_raw %s: %s", stream, strerror (errno));
+        return -1;
+    }
+    if (b->len + sizeof (hdr) + reclen > b->size) {
+        size_t size = b->len + sizeof (hdr) + reclen;
+        char *buf;
+
+        if (size < b->size * 2)
+            size = b->size * 2;
+        if (!(buf = realloc (b->buf, size)))
+            goto out;
+        b->buf = buf;
+        b->size = size;
+    }
+    hdr = htonl (reclen);
+    memcpy (b->buf + b->len, &hdr, sizeof (hdr));
+    memcpy (b->buf + b->len + sizeof (hdr), rec, reclen);
+    b->len += sizeof (hdr) + reclen;
+
+    /* Send EOF promptly so the client isn't left waiting for it.
+     */
+    if (eof || b->len >= b->s->batch_size)
+        rc = batch_flush (b);
+    else {
+        if (!b->timer_armed) {
+            flux_timer_watcher_reset (b->timer, b->s->batch_timeout, 0.);
+            flux_watcher_start (b->timer);
+            b->timer_armed = true;
+        }
+        rc = 0;
+    }
+out:
+    free (rec);
+    return rc;
+}
+
+static void batch_destroy (struct output_batch *b)
+{
+    if (b) {
+        int saved_errno = errno;
+        flux_watcher_destroy (b->timer);
+        free (b->buf);
+        free (b);
+        errno = saved_errno;
+    }
+}
+
+static struct output_batch *batch_create (subprocess_server_t *s,
+                                          const flux_msg_t *request)
+{
+    struct output_batch *b;
+
+    if (!(b = calloc (1, sizeof (*b))))
+        return NULL;
+    b->s = s;
+    b->request = request;
+    b->size = 1024;
+    if (!(b->buf = malloc (b->size))
+        || !(b->timer = flux_timer_watcher_create (flux_get_reactor (s->h),
+                                                   0.,
+                                                   0.,
+                                                   batch_timer_cb,
+                                                   b)))
+        goto error;
+    b->buf[0] = (char)SUBPROCESS_REXEC_BATCH_MAGIC;
+    b->len = 1;
+    return b;
+error:
+    batch_destroy (b);
+    return NULL;
+}
+
+/* Send any pending batched output.  This is called before any other
+ * response so that output is not reordered with respect to state
+ * changes.
+ */
+static void proc_output_flush (flux_subprocess_t *p)
+{
+    struct output_batch *b;
+
+    if ((b = flux_subprocess_aux_get (p, batchkey)))
+        (void)batch_flush (b);
+}
+
+static void tree_exec_destroy (struct tree_exec *t)
+{
+    if (t) {
+        int saved_errno = errno;
+        zlistx_destroy (&t->children);
+        flux_msg_decref (t->request);
+        free (t->sender);
+        free (t);
+        errno = saved_errno;
+    }
+}
+
+// zlistx_destructor_fn footprint
+static void tree_exec_destructor (void **item)
+{
+    if (item) {
+        tree_exec_destroy (*item);
+        *item = NULL;
+    }
+}
+
+// zlistx_destructor_fn footprint
+static void future_destructor (void **item)
+{
+    if (item) {
+        flux_future_destroy (*item);
+        *item = NULL;
+    }
+}
+
+static struct tree_exec *tree_exec_create (subprocess_server_t *s,
+                                           const flux_msg_t *request,
+                                           const char *sender,
+                                           uint32_t matchtag)
+{
+    struct tree_exec *t;
+
+    if (!(t = calloc (1, sizeof (*t))))
+        return NULL;
+    t->s = s;
+    t->request = flux_msg_incref (request);
+    t->matchtag = matchtag;
+    if (!(t->sender = strdup (sender))
+        || !(t->children = zlistx_new ()))
+        goto error;
+    zlistx_set_destructor (t->children, future_destructor);
+    return t;
+error:
+    tree_exec_destroy (t);
+    return NULL;
+}
+
+/* Report that the process on 'rank' failed without ending the stream.
+ */
+static void tree_respond_failed (struct tree_exec *t,
+                                 uint32_t rank,
+                                 int errnum,
+                                 const char *errmsg)
+{
+    if (!errmsg)
+        errmsg = strerror (errnum);
+    if (flux_respond_pack (t->s->h,
+                           t->request,
+                           "{s:s s:I s:i s:s}",
+                           "type", "failed",
+                           "rank", (json_int_t)rank,
+                           "errnum", errnum,
+                           "errmsg", errmsg) < 0) {
+        llog_error (t->s,
+                    "error responding to rexec.tree-exec request: %s",
+                    strerror (errno));
+    }
+}
+
+/* End the stream once the local process and all child streams are done.
+ */
+static void tree_exec_check_done (struct tree_exec *t)
+{
+    subprocess_server_t *s = t->s;
+
+    if (t->pending > 0)
+        return;
+    if (flux_respond_error (s->h, t->request, ENODATA, NULL) < 0) {
+        llog_error (s,
+                    "error responding to rexec.tree-exec request: %s",
+                    strerror (errno));
+    }
+    zlistx_delete (s->trees, t->handle);
+}
+
+static void tree_exec_local_done (struct tree_exec *t)
+{
+    t->pending--;
+    tree_exec_check_done (t);
+}
 
 static void proc_completion_cb (flux_subprocess_t *p)
 {
     subprocess_server_t *s = flux_subprocess_aux_get (p, srvkey);
     const flux_msg_t *request = flux_subprocess_aux_get (p, msgkey);
+    struct tree_exec *t = flux_subprocess_aux_get (p, treekey);
+    bool failed = p->state == FLUX_SUBPROCESS_FAILED;
 
-    if (p->state != FLUX_SUBPROCESS_FAILED) {
+    proc_output_flush (p);
+    if (!failed) {
         /* no fallback if this fails */
-        if (flux_respond_error (s->h, request, ENODATA, NULL) < 0) {
+        if (t) {
+            if (flux_respond_pack (s->h,
+                                   request,
+                                   "{s:s s:I}",
+                                   "type", "complete",
+                                   "rank", (json_int_t)s->rank) < 0) {
+                llog_error (s,
+                            "error responding to rexec.tree-exec request: %s",
+                            strerror (errno));
+            }
+        }
+        else if (flux_respond_error (s->h, request, ENODATA, NULL) < 0) {
             llog_error (s,
                         "error responding to rexec.exec request: %s",
                         strerror (errno));
@@ -146,6 +442,8 @@ static void proc_completion_cb (flux_subprocess_t *p)
     }
 
     proc_delete (s, p);
+    if (t && !failed)
+        tree_exec_local_done (t);
 }
 
 static void proc_internal_fatal (flux_subprocess_t *p)
@@ -180,32 +478,46 @@ static void proc_state_change_cb (flux_subprocess_t *p,
 {
     subprocess_server_t *s = flux_subprocess_aux_get (p, srvkey);
     const flux_msg_t *request = flux_subprocess_aux_get (p, msgkey);
+    struct tree_exec *t = flux_subprocess_aux_get (p, treekey);
     int rc = 0;
 
+    /* N.B. "rank" is needed by rexec.tree-exec clients to tell processes
+     * apart, and is ignored by rexec.exec clients.
+     */
+    proc_output_flush (p);
     if (state == FLUX_SUBPROCESS_RUNNING) {
         rc = flux_respond_pack (s->h,
                                 request,
-                                "{s:s s:i}",
+                                "{s:s s:i s:I}",
                                 "type", "started",
-                                "pid", flux_subprocess_pid (p));
+                                "pid", flux_subprocess_pid (p),
+                                "rank", (json_int_t)s->rank);
     }
     else if (state == FLUX_SUBPROCESS_EXITED) {
         rc = flux_respond_pack (s->h,
                                 request,
-                                "{s:s s:i}",
+                                "{s:s s:i s:I}",
                                 "type", "finished",
-                                "status", flux_subprocess_status (p));
+                                "status", flux_subprocess_status (p),
+                                "rank", (json_int_t)s->rank);
     }
     else if (state == FLUX_SUBPROCESS_STOPPED) {
         rc = flux_respond_pack (s->h,
                                 request,
-                                "{s:s}",
-                                "type", "stopped");
+                                "{s:s s:I}",
+                                "type", "stopped",
+                                "rank", (json_int_t)s->rank);
     }
     else if (state == FLUX_SUBPROCESS_FAILED) {
         const char *errmsg = NULL;
         if (p->failed_error.text[0] != '\0')
             errmsg = p->failed_error.text;
+        if (t) {
+            tree_respond_failed (t, s->rank, p->failed_errno, errmsg);
+            proc_delete (s, p);
+            tree_exec_local_done (t);
+            return;
+        }
         rc = flux_respond_error (s->h,
                                  request,
                                  p->failed_errno,
@@ -227,6 +539,36 @@ error:
     proc_internal_fatal (p);
 }
 
+/* Send output as a raw payload, avoiding JSON and base64 encoding.
+ */
+static int proc_output_raw (subprocess_server_t *s,
+                            const flux_msg_t *msg,
+                            const char *stream,
+                            const char *rankstr,
+                            const char *data,
+                            int len,
+                            bool eof)
+{
+    void *buf;
+    size_t size;
+    int rv = -1;
+
+    if (ioencode_raw (stream, rankstr, data, len, eof, &buf, &size) < 0) {
+        llog_error (s, "ioencode_raw %s: %s", stream, strerror (errno));
+        return -1;
+    }
+    if (flux_respond_raw (s->h, msg, buf, size) < 0) {
+        llog_error (s,
+                    "error responding to rexec.exec request: %s",
+                    strerror (errno));
+        goto out;
+    }
+    rv = 0;
+out:
+    free (buf);
+    return rv;
+}
+
 static int proc_output (flux_subprocess_t *p,
                         const char *stream,
                         subprocess_server_t *s,
@@ -237,9 +579,14 @@ static int proc_output (flux_subprocess_t *p,
 {
     json_t *io = NULL;
     char rankstr[64];
+    struct output_batch *b;
     int rv = -1;
 
     snprintf (rankstr, sizeof (rankstr), "%d", s->rank);
+    if ((b = flux_subprocess_aux_get (p, batchkey)))
+        return batch_append (b, stream, rankstr, data, len, eof);
+    if (flux_subprocess_aux_get (p, rawkey))
+        return proc_output_raw (s, msg, stream, rankstr, data, len, eof);
     if (!(io = ioencode (stream, rankstr, data, len, eof))) {
         llog_error (s, "ioencode %s: %s", stream, strerror (errno));
         goto error;
@@ -247,9 +594,10 @@ static int proc_output (flux_subprocess_t *p,
 
     if (flux_respond_pack (s->h,
                            msg,
-                           "{s:s s:i s:O}",
+                           "{s:s s:i s:I s:O}",
                            "type", "output",
                            "pid", flux_subprocess_pid (p),
+                           "rank", (json_int_t)s->rank,
                            "io", io) < 0) {
         llog_error (s,
                     "error responding to rexec.exec request: %s",
@@ -296,13 +644,16 @@ error:
     proc_internal_fatal (p);
 }
 
-static void server_exec_cb (flux_t *h,
-                            flux_msg_handler_t *mh,
-                            const flux_msg_t *msg,
-                            void *arg)
+/* Start a local process for a rexec.exec or rexec.tree-exec request.
+ * On failure, set errno and, if there is a useful message, error->text.
+ */
+static flux_subprocess_t *proc_launch (subprocess_server_t *s,
+                                       const flux_msg_t *msg,
+                                       json_t *cmd_obj,
+                                       int flags,
+                                       struct tree_exec *t,
+                                       flux_error_t *error)
 {
-    subprocess_server_t *s = arg;
-    json_t *cmd_obj;
     flux_cmd_t *cmd = NULL;
     flux_subprocess_t *p = NULL;
     flux_subprocess_ops_t ops = {
@@ -313,26 +664,8 @@ static void server_exec_cb (flux_t *h,
         .on_stderr = proc_output_cb,
     };
     char **env = NULL;
-    const char *errmsg = NULL;
-    flux_error_t error;
-    int flags;
 
-    if (flux_request_unpack (msg,
-                             NULL,
-                             "{s:o s:i}",
-                             "cmd", &cmd_obj,
-                             "flags", &flags) < 0)
-        goto error;
-    if (s->shutdown) {
-        errmsg = "subprocess server is shutting down";
-        errno = ENOSYS;
-        goto error;
-    }
-    if (s->auth_cb && (*s->auth_cb) (msg, s->arg, &error) < 0) {
-        errmsg = error.text;
-        errno = EPERM;
-        goto error;
-    }
+    error->text[0] = '\0';
     if (!(flags & SUBPROCESS_REXEC_CHANNEL))
         ops.on_channel_out = NULL;
     if (!(flags & SUBPROCESS_REXEC_STDOUT))
@@ -341,13 +674,13 @@ static void server_exec_cb (flux_t *h,
         ops.on_stderr = NULL;
 
     if (!(cmd = cmd_fromjson (cmd_obj, NULL))) {
-        errmsg = "error parsing command string";
+        errprintf (error, "error parsing command string");
         goto error;
     }
 
     if (!flux_cmd_argc (cmd)) {
         errno = EPROTO;
-        errmsg = "command string is empty";
+        errprintf (error, "command string is empty");
         goto error;
     }
 
@@ -355,7 +688,7 @@ static void server_exec_cb (flux_t *h,
     if (!(env = cmd_env_expand (cmd))
         || (env[0] == NULL && cmd_set_env (cmd, environ))
         || flux_cmd_setenvf (cmd, 1, "FLUX_URI", "%s", s->local_uri) < 0) {
-        errmsg = "error setting up command environment";
+        errprintf (error, "error setting up command environment");
         goto error;
     }
 
@@ -371,8 +704,7 @@ static void server_exec_cb (flux_t *h,
                                   NULL,
                                   s->llog,
                                   s->llog_data))) {
-        errprintf (&error, "error launching process: %s", strerror (errno));
-        errmsg = error.text;
+        errprintf (error, "error launching process: %s", strerror (errno));
         goto error;
     }
 
@@ -385,11 +717,69 @@ static void server_exec_cb (flux_t *h,
     }
     if (flux_subprocess_aux_set (p, srvkey, s, NULL) < 0)
         goto error;
+    if (t && flux_subprocess_aux_set (p, treekey, t, NULL) < 0)
+        goto error;
+    if ((flags & SUBPROCESS_REXEC_RAWIO)) {
+        if (flux_subprocess_aux_set (p, rawkey, s, NULL) < 0)
+            goto error;
+        if ((flags & SUBPROCESS_REXEC_BATCH) && s->batch_size > 0) {
+            struct output_batch *b;
+            if (!(b = batch_create (s, msg))
+                || flux_subprocess_aux_set (p,
+                                            batchkey,
+                                            b,
+                                            (flux_free_f)batch_destroy) < 0) {
+                batch_destroy (b);
+                goto error;
+            }
+        }
+    }
     if (proc_save (s, p) < 0)
         goto error;
 
     flux_cmd_destroy (cmd);
     free (env);
+    return p;
+
+error:
+    ERRNO_SAFE_WRAP (flux_cmd_destroy, cmd);
+    ERRNO_SAFE_WRAP (free, env);
+    ERRNO_SAFE_WRAP (subprocess_decref, p);
+    return NULL;
+}
+
+static void server_exec_cb (flux_t *h,
+                            flux_msg_handler_t *mh,
+                            const flux_msg_t *msg,
+                            void *arg)
+{
+    subprocess_server_t *s = arg;
+    json_t *cmd_obj;
+    const char *errmsg = NULL;
+    flux_error_t error;
+    int flags;
+
+    if (flux_request_unpack (msg,
+                             NULL,
+                             "{s:o s:i}",
+                             "cmd", &cmd_obj,
+                             "flags", &flags) < 0)
+        goto error;
+    if (s->shutdown) {
+        errmsg = "subprocess server is shutting down";
+        errno = ENOSYS;
+        goto error;
+    }
+    if (s->auth_cb && (*s->auth_cb) (msg, s->arg, &error) < 0) {
+        errmsg = error.text;
+        errno = EPERM;
+        goto error;
+    }
+    if (!proc_launch (s, msg, cmd_obj, flags, NULL, &error)) {
+        if (error.text[0] != '\0')
+            errmsg = error.text;
+        goto error;
+    }
     return;
 
 error:
@@ -398,9 +788,269 @@ error:
                     "error responding to rexec.exec request: %s",
                     strerror (errno));
     }
-    flux_cmd_destroy (cmd);
-    free (env);
-    subprocess_decref (p);
+}
+
+/* Relay responses from a child tree-exec stream to our requester.
+ * If the child stream fails, report each of its ranks as failed.
+ * A rank that already completed may then be reported twice; clients
+ * ignore responses for ranks they have seen complete.
+ */
+static void tree_child_continuation (flux_future_t *f, void *arg)
+{
+    struct tree_exec *t = arg;
+    subprocess_server_t *s = t->s;
+    const void *data;
+    int len;
+
+    if (flux_rpc_get_raw (f, &data, &len) < 0) {
+        if (errno != ENODATA) {
+            int errnum = errno;
+            const char *errmsg = future_strerror (f, errnum);
+            struct idset *ranks = flux_future_aux_get (f, "flux::ranks");
+            unsigned int rank = idset_first (ranks);
+
+            while (rank != IDSET_INVALID_ID) {
+                tree_respond_failed (t, rank, errnum, errmsg);
+                rank = idset_next (ranks, rank);
+            }
+        }
+        zlistx_delete (t->children, flux_future_aux_get (f, "flux::handle"));
+        t->pending--;
+        tree_exec_check_done (t);
+        return;
+    }
+    if (flux_respond_raw (s->h, t->request, data, len) < 0) {
+        llog_error (s,
+                    "error responding to rexec.tree-exec request: %s",
+                    strerror (errno));
+    }
+    flux_future_reset (f);
+}
+
+/* Forward the ranks in 'ranks' to the server on 'child'.
+ */
+static int tree_exec_forward (struct tree_exec *t,
+                              uint32_t child,
+                              const struct idset *ranks,
+                              json_t *cmd_obj,
+                              int flags)
+{
+    subprocess_server_t *s = t->s;
+    flux_future_t *f = NULL;
+    struct idset *cpy = NULL;
+    char *topic = NULL;
+    char *ids = NULL;
+    void *handle;
+
+    if (asprintf (&topic, "%s.tree-exec", s->service_name) < 0
+        || !(ids = idset_encode (ranks, IDSET_FLAG_RANGE))
+        || !(cpy = idset_copy (ranks))
+        || !(f = flux_rpc_pack (s->h,
+                                topic,
+                                child,
+                                FLUX_RPC_STREAMING,
+                                "{s:O s:i s:s s:{s:s s:I}}",
+                                "cmd", cmd_obj,
+                                "flags", flags,
+                                "ranks", ids,
+                                "origin",
+                                  "sender", t->sender,
+                                  "matchtag", (json_int_t)t->matchtag))
+        || flux_future_then (f, -1., tree_child_continuation, t) < 0
+        || flux_future_aux_set (f,
+                                "flux::ranks",
+                                cpy,
+                                (flux_free_f)idset_destroy) < 0)
+        goto error;
+    cpy = NULL;
+    if (!(handle = zlistx_add_end (t->children, f))) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (flux_future_aux_set (f, "flux::handle", handle, NULL) < 0) {
+        ERRNO_SAFE_WRAP (zlistx_delete, t->children, handle);
+        f = NULL;
+        goto error;
+    }
+    t->pending++;
+    free (ids);
+    free (topic);
+    return 0;
+error:
+    ERRNO_SAFE_WRAP (idset_destroy, cpy);
+    ERRNO_SAFE_WRAP (flux_future_destroy, f);
+    ERRNO_SAFE_WRAP (free, ids);
+    ERRNO_SAFE_WRAP (free, topic);
+    return -1;
+}
+
+// zhashx_destructor_fn footprint
+static void idset_destructor (void **item)
+{
+    if (item) {
+        idset_destroy (*item);
+        *item = NULL;
+    }
+}
+
+/* Divide 'ranks' among the children of this rank, according to the
+ * route callback.  Returns a hash of child rank to idset, and sets
+ * 'local' if this rank is included.
+ */
+static zhashx_t *tree_exec_partition (subprocess_server_t *s,
+                                      const struct idset *ranks,
+                                      bool *local)
+{
+    zhashx_t *children;
+    unsigned int rank;
+
+    if (!(children = zhashx_new ())) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    zhashx_set_destructor (children, idset_destructor);
+    *local = false;
+    rank = idset_first (ranks);
+    while (rank != IDSET_INVALID_ID) {
+        if (rank == s->rank)
+            *local = true;
+        else {
+            struct idset *ids;
+            char key[16];
+            int child = -1;
+
+            if (s->route_cb)
+                child = (*s->route_cb) (rank, s->route_arg);
+            if (child < 0)
+                child = rank;
+            snprintf (key, sizeof (key), "%d", child);
+            if (!(ids = zhashx_lookup (children, key))) {
+                if (!(ids = idset_create (0, IDSET_FLAG_AUTOGROW)))
+                    goto error;
+                (void)zhashx_insert (children, key, ids);
+            }
+            if (idset_set (ids, rank) < 0)
+                goto error;
+        }
+        rank = idset_next (ranks, rank);
+    }
+    return children;
+error:
+    ERRNO_SAFE_WRAP (zhashx_destroy, &children);
+    return NULL;
+}
+
+static void server_tree_exec_cb (flux_t *h,
+                                 flux_msg_handler_t *mh,
+                                 const flux_msg_t *msg,
+                                 void *arg)
+{
+    subprocess_server_t *s = arg;
+    json_t *cmd_obj;
+    const char *ranks_str;
+    const char *sender = NULL;
+    json_int_t matchtag = -1;
+    struct idset *ranks = NULL;
+    zhashx_t *children = NULL;
+    struct tree_exec *t = NULL;
+    struct idset *ids;
+    const char *errmsg = NULL;
+    flux_error_t error;
+    bool local;
+    int flags;
+
+    if (flux_request_unpack (msg,
+                             NULL,
+                             "{s:o s:i s:s s?{s:s s:I}}",
+                             "cmd", &cmd_obj,
+                             "flags", &flags,
+                             "ranks", &ranks_str,
+                             "origin",
+                               "sender", &sender,
+                               "matchtag", &matchtag) < 0)
+        goto error;
+    if (s->shutdown) {
+        errmsg = "subprocess server is shutting down";
+        errno = ENOSYS;
+        goto error;
+    }
+    if (s->auth_cb && (*s->auth_cb) (msg, s->arg, &error) < 0) {
+        errmsg = error.text;
+        errno = EPERM;
+        goto error;
+    }
+    if (!(ranks = idset_decode (ranks_str))) {
+        errmsg = "error decoding ranks";
+        errno = EPROTO;
+        goto error;
+    }
+    /* The server that receives the request from the client is the root
+     * of the launch, and the client request is the origin.
+     */
+    if (!sender) {
+        uint32_t tag;
+        if (!(sender = flux_msg_route_first (msg))
+            || flux_msg_get_matchtag (msg, &tag) < 0) {
+            errno = EPROTO;
+            goto error;
+        }
+        matchtag = tag;
+    }
+    if (!(children = tree_exec_partition (s, ranks, &local))
+        || !(t = tree_exec_create (s, msg, sender, matchtag)))
+        goto error;
+    if (!(t->handle = zlistx_add_end (s->trees, t))) {
+        errno = ENOMEM;
+        goto error;
+    }
+
+    /* Hold the stream open until all requests are sent.  Forward to
+     * children first, so their subtrees start in parallel with the
+     * local process.
+     */
+    t->pending = 1;
+    ids = zhashx_first (children);
+    while (ids) {
+        uint32_t child = strtoul (zhashx_cursor (children), NULL, 10);
+
+        if (tree_exec_forward (t, child, ids, cmd_obj, flags) < 0) {
+            int errnum = errno;
+            unsigned int rank = idset_first (ids);
+
+            while (rank != IDSET_INVALID_ID) {
+                tree_respond_failed (t, rank, errnum, NULL);
+                rank = idset_next (ids, rank);
+            }
+        }
+        ids = zhashx_next (children);
+    }
+    if (local) {
+        if (proc_launch (s, msg, cmd_obj, flags, t, &error))
+            t->pending++;
+        else {
+            tree_respond_failed (t,
+                                 s->rank,
+                                 errno,
+                                 error.text[0] ? error.text : NULL);
+        }
+    }
+    zhashx_destroy (&children);
+    idset_destroy (ranks);
+    t->pending--;
+    tree_exec_check_done (t);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errmsg) < 0) {
+        llog_error (s,
+                    "error responding to rexec.tree-exec request: %s",
+                    strerror (errno));
+    }
+    if (t && t->handle)
+        zlistx_delete (s->trees, t->handle);
+    else
+        tree_exec_destroy (t);
+    zhashx_destroy (&children);
+    idset_destroy (ranks);
 }
 
 static void server_write_cb (flux_t *h,
@@ -581,6 +1231,52 @@ error:
     json_decref (procs);
 }
 
+/* Kill processes started by tree-exec requests that originated from
+ * 'sender', and forward the disconnect to children they were sent to.
+ */
+static void tree_disconnect (subprocess_server_t *s, const char *sender)
+{
+    struct tree_exec *t;
+    flux_subprocess_t *p;
+    char *topic;
+
+    if (asprintf (&topic, "%s.tree-disconnect", s->service_name) < 0) {
+        llog_error (s, "tree-disconnect: %s", strerror (errno));
+        return;
+    }
+    t = zlistx_first (s->trees);
+    while (t) {
+        if (streq (t->sender, sender)) {
+            flux_future_t *f = zlistx_first (t->children);
+            while (f) {
+                flux_future_t *f2;
+                if (!(f2 = flux_rpc_pack (s->h,
+                                          topic,
+                                          flux_rpc_get_nodeid (f),
+                                          FLUX_RPC_NORESPONSE,
+                                          "{s:s}",
+                                          "sender", sender))) {
+                    llog_error (s,
+                                "error sending %s: %s",
+                                topic,
+                                strerror (errno));
+                }
+                flux_future_destroy (f2);
+                f = zlistx_next (t->children);
+            }
+        }
+        t = zlistx_next (s->trees);
+    }
+    p = zlistx_first (s->subprocesses);
+    while (p) {
+        if ((t = flux_subprocess_aux_get (p, treekey))
+            && streq (t->sender, sender))
+            server_kill (p, SIGKILL);
+        p = zlistx_next (s->subprocesses);
+    }
+    free (topic);
+}
+
 static void server_disconnect_cb (flux_t *h,
                                   flux_msg_handler_t *mh,
                                   const flux_msg_t *msg,
@@ -594,19 +1290,49 @@ static void server_disconnect_cb (flux_t *h,
         p = zlistx_first (s->subprocesses);
         while (p) {
             const char *uuid = subprocess_sender (p);
-            if (sender && streq (uuid, sender))
+            if (sender
+                && streq (uuid, sender)
+                && !flux_subprocess_aux_get (p, treekey))
                 server_kill (p, SIGKILL);
             p = zlistx_next (s->subprocesses);
         }
+        tree_disconnect (s, sender);
     }
 }
 
+static void server_tree_disconnect_cb (flux_t *h,
+                                       flux_msg_handler_t *mh,
+                                       const flux_msg_t *msg,
+                                       void *arg)
+{
+    subprocess_server_t *s = arg;
+    const char *sender;
+    flux_error_t error;
+
+    if (flux_request_unpack (msg, NULL, "{s:s}", "sender", &sender) < 0) {
+        llog_error (s,
+                    "Error decoding rexec.tree-disconnect request: %s",
+                    strerror (errno));
+        return;
+    }
+    if (s->auth_cb && (*s->auth_cb) (msg, s->arg, &error) < 0) {
+        llog_error (s, "rexec.tree-disconnect: %s", error.text);
+        return;
+    }
+    tree_disconnect (s, sender);
+}
+
 static struct flux_msg_handler_spec htab[] = {
     { FLUX_MSGTYPE_REQUEST,
       "exec",
       server_exec_cb,
       0
     },
+    { FLUX_MSGTYPE_REQUEST,
+      "tree-exec",
+      server_tree_exec_cb,
+      0
+    },
     { FLUX_MSGTYPE_REQUEST,
       "write",
       server_write_cb,
@@ -627,6 +1353,11 @@ static struct flux_msg_handler_spec htab[] = {
       server_disconnect_cb,
       0
     },
+    { FLUX_MSGTYPE_REQUEST,
+      "tree-disconnect",
+      server_tree_disconnect_cb,
+      0
+    },
     FLUX_MSGHANDLER_TABLE_END,
 };
 
@@ -665,7 +1396,9 @@ void subprocess_server_destroy (subprocess_server_t *s)
         flux_msg_handler_delvec (s->handlers);
         server_killall (s, SIGKILL);
         zlistx_destroy (&s->subprocesses);
+        zlistx_destroy (&s->trees);
         flux_future_destroy (s->shutdown);
+        free (s->service_name);
         free (s->local_uri);
         free (s);
         errno = saved_errno;
@@ -691,11 +1424,17 @@ subprocess_server_t *subprocess_server_create (flux_t *h,
 
     s->llog = log_fn;
     s->llog_data = log_data;
+    s->batch_size = SUBPROCESS_SERVER_BATCH_SIZE;
+    s->batch_timeout = SUBPROCESS_SERVER_BATCH_TIMEOUT;
 
     if (!(s->subprocesses = zlistx_new ()))
         goto error;
     zlistx_set_destructor (s->subprocesses, proc_destructor);
-    if (!(s->local_uri = strdup (local_uri)))
+    if (!(s->trees = zlistx_new ()))
+        goto error;
+    zlistx_set_destructor (s->trees, tree_exec_destructor);
+    if (!(s->local_uri = strdup (local_uri))
+        || !(s->service_name = strdup (service_name)))
         goto error;
     if (flux_get_rank (h, &s->rank) < 0)
         goto error;
@@ -721,6 +1460,26 @@ void subprocess_server_set_auth_cb (subprocess_server_t *s,
     s->arg = arg;
 }
 
+void subprocess_server_set_route_cb (subprocess_server_t *s,
+                                     subprocess_server_route_f fn,
+                                     void *arg)
+{
+    if (s) {
+        s->route_cb = fn;
+        s->route_arg = arg;
+    }
+}
+
+void subprocess_server_set_batch (subprocess_server_t *s,
+                                  size_t size,
+                                  double timeout)
+{
+    if (s) {
+        s->batch_size = size;
+        s->batch_timeout = timeout;
+    }
+}
+
 flux_future_t *subprocess_server_shutdown (subprocess_server_t *s, int signum)
 {
     flux_future_t *f;
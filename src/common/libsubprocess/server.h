@@ -39,6 +39,30 @@ void subprocess_server_set_auth_cb (subprocess_server_t *s,
                                     subprocess_server_auth_f fn,
                                     void *arg);
 
+/* Coalesce output for clients that request SUBPROCESS_REXEC_BATCH.
+ * Output is held until 'size' bytes are pending or 'timeout' seconds
+ * have elapsed since the oldest pending output, then sent in a single
+ * response.  A 'size' of 0 disables batching.
+ */
+#define SUBPROCESS_SERVER_BATCH_SIZE    16384
+#define SUBPROCESS_SERVER_BATCH_TIMEOUT 0.005
+
+void subprocess_server_set_batch (subprocess_server_t *s,
+                                  size_t size,
+                                  double timeout);
+
+/* Register a callback used to forward rexec.tree-exec requests down the
+ * overlay network.  The callback should return the rank of the child of
+ * this server's rank through which 'rank' is reached, or -1 if 'rank'
+ * is not a descendant.  Without a callback, or for ranks that are not
+ * descendants, requests are sent directly to each rank.
+ */
+typedef int (*subprocess_server_route_f) (uint32_t rank, void *arg);
+
+void subprocess_server_set_route_cb (subprocess_server_t *s,
+                                     subprocess_server_route_f fn,
+                                     void *arg);
+
 /* Destroy a subprocess server.  This sends a SIGKILL to any remaining
  * subprocesses, then destroys them.
  */
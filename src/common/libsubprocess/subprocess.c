@@ -520,14 +520,15 @@ flux_subprocess_t * flux_local_exec (flux_reactor_t *r,
     return flux_local_exec_ex (r, flags, cmd, ops, NULL, NULL, NULL);
 }
 
-flux_subprocess_t *flux_rexec_ex (flux_t *h,
-                                  const char *service_name,
-                                  int rank,
-                                  int flags,
-                                  const flux_cmd_t *cmd,
-                                  const flux_subprocess_ops_t *ops,
-                                  subprocess_log_f log_fn,
-                                  void *log_data)
+static flux_subprocess_t *rexec_create (flux_t *h,
+                                        const char *service_name,
+                                        int rank,
+                                        int flags,
+                                        const flux_cmd_t *cmd,
+                                        const flux_subprocess_ops_t *ops,
+                                        flux_future_t *f,
+                                        subprocess_log_f log_fn,
+                                        void *log_data)
 {
     flux_subprocess_t *p = NULL;
     flux_reactor_t *r;
@@ -578,7 +579,11 @@ flux_subprocess_t *flux_rexec_ex (flux_t *h,
     if (subprocess_setup_completed (p) < 0)
         goto error;
 
-    if (remote_exec (p) < 0)
+    if (f) {
+        if (remote_attach (p, f) < 0)
+            goto error;
+    }
+    else if (remote_exec (p) < 0)
         goto error;
 
     return p;
@@ -588,6 +593,51 @@ error:
     return NULL;
 }
 
+flux_subprocess_t *flux_rexec_ex (flux_t *h,
+                                  const char *service_name,
+                                  int rank,
+                                  int flags,
+                                  const flux_cmd_t *cmd,
+                                  const flux_subprocess_ops_t *ops,
+                                  subprocess_log_f log_fn,
+                                  void *log_data)
+{
+    return rexec_create (h,
+                         service_name,
+                         rank,
+                         flags,
+                         cmd,
+                         ops,
+                         NULL,
+                         log_fn,
+                         log_data);
+}
+
+flux_subprocess_t *subprocess_rexec_attach (flux_t *h,
+                                            const char *service_name,
+                                            int rank,
+                                            int flags,
+                                            const flux_cmd_t *cmd,
+                                            const flux_subprocess_ops_t *ops,
+                                            flux_future_t *f,
+                                            subprocess_log_f log_fn,
+                                            void *log_data)
+{
+    if (!f) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return rexec_create (h,
+                         service_name,
+                         rank,
+                         flags,
+                         cmd,
+                         ops,
+                         f,
+                         log_fn,
+                         log_data);
+}
+
 flux_subprocess_t *flux_rexec (flux_t *h,
                                int rank,
                                int flags,
@@ -126,6 +126,20 @@ struct subprocess_channel *channel_create (flux_subprocess_t *p,
 
 struct idset * subprocess_childfds (flux_subprocess_t *p);
 
+/* Like flux_rexec_ex(), but responses for the remote process are taken
+ * from 'f' (see subprocess_rexec_proxy()) instead of a request sent by
+ * the subprocess.  On success, the subprocess takes ownership of 'f'.
+ */
+flux_subprocess_t *subprocess_rexec_attach (flux_t *h,
+                                            const char *service_name,
+                                            int rank,
+                                            int flags,
+                                            const flux_cmd_t *cmd,
+                                            const flux_subprocess_ops_t *ops,
+                                            flux_future_t *f,
+                                            subprocess_log_f log_fn,
+                                            void *log_data);
+
 void subprocess_incref (flux_subprocess_t *p);
 void subprocess_decref (flux_subprocess_t *p);
 
@@ -16,6 +16,8 @@
 #include "config.h"
 #endif
 #include <unistd.h>
+#include <string.h>
+#include <errno.h>
 #include <assert.h>
 #include <signal.h>
 
@@ -29,10 +31,18 @@
 
 extern char **environ;
 static int cancel_after = 0;
+static const char *stdin_data = NULL;
 
 void started (struct bulk_exec *exec, void *arg)
 {
     log_msg ("started");
+    if (stdin_data) {
+        int len = strlen (stdin_data);
+        if (bulk_exec_write (exec, "stdin", stdin_data, len) < 0
+            || bulk_exec_write (exec, "stdin", "\n", 1) < 0
+            || bulk_exec_close (exec, "stdin") < 0)
+            log_err ("error writing to stdin");
+    }
 }
 
 void complete (struct bulk_exec *exec, void *arg)
@@ -53,13 +63,23 @@ void on_error (struct bulk_exec *exec, flux_subprocess_t *p, void *arg)
 {
     if (p) {
         flux_subprocess_state_t state = flux_subprocess_state (p);
-        log_msg ("%d: pid %ju: %s", flux_subprocess_rank (p),
-                (uintmax_t) flux_subprocess_pid (p),
-                flux_subprocess_state_string (state));
+        if (state == FLUX_SUBPROCESS_FAILED)
+            log_msg ("%d: %s: %s", flux_subprocess_rank (p),
+                    flux_subprocess_state_string (state),
+                    flux_subprocess_fail_error (p));
+        else
+            log_msg ("%d: pid %ju: %s", flux_subprocess_rank (p),
+                    (uintmax_t) flux_subprocess_pid (p),
+                    flux_subprocess_state_string (state));
     }
+    /*  There may be nothing left to kill if all processes failed.
+     */
     flux_future_t *f = bulk_exec_kill (exec, NULL, 9);
+    if (!f && errno == ENOENT)
+        return;
     if (flux_future_get (f, NULL) < 0)
         log_err_exit ("bulk_exec_kill");
+    flux_future_destroy (f);
 }
 
 void on_output (struct bulk_exec *exec, flux_subprocess_t *p,
@@ -193,6 +213,18 @@ int main (int ac, char **av)
           .arginfo = "NCMDS",
           .usage = "Cancel after NCMDS cmds have been launched"
         },
+        { .name = "tree",
+          .key  = 't',
+          .has_arg = 0,
+          .usage = "Launch with rexec.tree-exec over the TBON"
+        },
+        { .name = "stdin",
+          .key  = 'i',
+          .has_arg = 1,
+          .arginfo = "DATA",
+          .usage = "Write DATA and a newline to stdin of all processes once "
+                   "started, then close stdin"
+        },
         OPTPARSE_TABLE_END
     };
 
@@ -242,7 +274,12 @@ int main (int ac, char **av)
     if (bulk_exec_set_max_per_loop (exec, optparse_get_int (p, "mpl", -1)) < 0)
         log_err_exit ("bulk_exec_set_max_per_loop");
 
+    if (optparse_hasopt (p, "tree")
+        && bulk_exec_set_tree_launch (exec, true) < 0)
+        log_err_exit ("bulk_exec_set_tree_launch");
+
     ncmds = optparse_get_int (p, "ncmds", 1);
+    stdin_data = optparse_get_str (p, "stdin", NULL);
 
     push_commands (exec, idset, ncmds, ac, av);
 
@@ -20,6 +20,7 @@
 #include "src/common/libtap/tap.h"
 #include "src/common/libtestutil/util.h"
 #include "src/common/libsubprocess/server.h"
+#include "src/common/libsubprocess/client.h"
 #include "src/common/libioencode/ioencode.h"
 #include "src/common/libutil/stdlog.h"
 
@@ -742,6 +743,64 @@ void sigstop_test (flux_t *h)
     flux_cmd_destroy (cmd);
 }
 
+/* Run test_echo with the rexec client directly, with and without
+ * SUBPROCESS_REXEC_RAWIO and SUBPROCESS_REXEC_BATCH, and check that
+ * output is the same.
+ */
+void rexec_output_test (flux_t *h, int flags)
+{
+    char *av[] = { TEST_SUBPROCESS_DIR "test_echo",
+                   "-O",
+                   "hello",
+                   "world",
+                   NULL };
+    flux_cmd_t *cmd;
+    flux_future_t *f;
+    char output[64] = "";
+    bool eof = false;
+    int status = -1;
+
+    if (!(cmd = flux_cmd_create (ARRAY_SIZE (av) - 1, av, environ)))
+        BAIL_OUT ("flux_cmd_create failed");
+    f = subprocess_rexec (h,
+                          SERVER_NAME,
+                          FLUX_NODEID_ANY,
+                          cmd,
+                          SUBPROCESS_REXEC_STDOUT | flags);
+    ok (f != NULL,
+        "subprocess_rexec flags=0x%x works", flags);
+    while (subprocess_rexec_get (f) == 0) {
+        const char *stream;
+        const char *data;
+        int len;
+        bool is_eof;
+
+        if (subprocess_rexec_is_output (f, &stream, &data, &len, &is_eof)) {
+            do {
+                if (data && streq (stream, "stdout"))
+                    strncat (output, data, len);
+                if (is_eof)
+                    eof = true;
+            } while (subprocess_rexec_next_output (f,
+                                                   &stream,
+                                                   &data,
+                                                   &len,
+                                                   &is_eof));
+        }
+        else if (subprocess_rexec_is_finished (f, &status))
+            break;
+        flux_future_reset (f);
+    }
+    is (output, "hello\nworld\n",
+        "received expected output");
+    ok (eof == true,
+        "received EOF");
+    ok (status == 0,
+        "process exited with status 0");
+    flux_future_destroy (f);
+    flux_cmd_destroy (cmd);
+}
+
 int main (int argc, char *argv[])
 {
     flux_t *h;
@@ -764,6 +823,10 @@ int main (int argc, char *argv[])
     local_unbuf_multiline_test (h);
     diag ("sigstop_test");
     sigstop_test (h);
+    diag ("rexec_output_test");
+    rexec_output_test (h, 0);
+    rexec_output_test (h, SUBPROCESS_REXEC_RAWIO);
+    rexec_output_test (h, SUBPROCESS_REXEC_RAWIO | SUBPROCESS_REXEC_BATCH);
 
     test_server_stop (h);
     flux_close (h);
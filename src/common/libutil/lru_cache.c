@@ -241,6 +241,16 @@ int lru_cache_remove (lru_cache_t *lru, const char *key)
     return (0);
 }
 
+int lru_cache_evict (lru_cache_t *lru)
+{
+    if (lru->last == NULL) {
+        errno = ENOENT;
+        return (-1);
+    }
+    lru_purge_last (lru);
+    return (0);
+}
+
 int lru_cache_size (lru_cache_t *lru)
 {
     return (lru->count);
@@ -57,6 +57,13 @@ bool lru_cache_check (lru_cache_t *lru, const char *key);
  */
 int lru_cache_remove (lru_cache_t *lru, const char *key);
 
+/*
+ *  Remove the least recently used item from the LRU cache, e.g. to
+ *   enforce a limit other than the number of items.
+ *  Returns -1 with errno set to ENOENT if the cache is empty.
+ */
+int lru_cache_evict (lru_cache_t *lru);
+
 /*
  *   Run lru cache self checks on object `lru`. Used in testing.
  *    Returns < 0 if any one of several consistency checks fails.
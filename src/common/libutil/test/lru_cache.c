@@ -114,6 +114,33 @@ void test_corruption ()
     lru_cache_destroy (lru);
 }
 
+void test_evict ()
+{
+    int a = 1, b = 2, c = 3;
+    lru_cache_t *lru = lru_cache_create (3);
+    lru_cache_set_free_f (lru, (lru_cache_free_f) fake_int_free);
+
+    ok (lru_cache_evict (lru) < 0 && errno == ENOENT,
+        "lru_cache_evict on empty cache fails with ENOENT");
+
+    ok (lru_cache_put (lru, "a", &a) == 0, "lru_cache_put (a)");
+    ok (lru_cache_put (lru, "b", &b) == 0, "lru_cache_put (b)");
+    ok (lru_cache_put (lru, "c", &c) == 0, "lru_cache_put (c)");
+    ok (lru_cache_get (lru, "a") != NULL, "move a to front of list");
+
+    ok (lru_cache_evict (lru) == 0, "lru_cache_evict works");
+    ok (b == -1 && !lru_cache_check (lru, "b"),
+        "least recently used item b was evicted");
+    ok (lru_cache_size (lru) == 2, "lru_cache_size == 2");
+    ok (lru_cache_evict (lru) == 0 && c == -1,
+        "lru_cache_evict evicted c");
+    ok (lru_cache_evict (lru) == 0 && a == -1,
+        "lru_cache_evict evicted a");
+    ok (lru_cache_size (lru) == 0, "lru_cache_size == 0");
+    ok (lru_cache_selfcheck (lru) == 0, "lru_cache_selfcheck ()");
+
+    lru_cache_destroy (lru);
+}
 
 int main (int argc, char *argv[])
 {
@@ -121,6 +148,7 @@ int main (int argc, char *argv[])
     test_basic ();
     test_free_fn ();
     test_corruption ();
+    test_evict ();
     done_testing ();
     return (0);
 }
@@ -29,10 +29,28 @@
 #include "src/common/libutil/tstat.h"
 #include "src/common/libutil/monotime.h"
 #include "src/common/libjob/idf58.h"
+#include "src/common/libczmqcontainers/czmq_containers.h"
+#include "ccan/str/str.h"
+
+#include "watermark.h"
 
 #define BUSY_TIMEOUT_DEFAULT 50
 #define BUFSIZE              1024
 
+/* Max job-info.lookup RPCs in flight.
+ */
+#define LOOKUP_WINDOW        64
+
+/* Max jobs stored per sqlite transaction.
+ */
+#define TXN_MAX_JOBS         1024
+
+// e.g. flux module debug --setbit 0x1 job-archive
+// e.g. flux module debug --clearbit 0x1 job-archive
+enum module_debug_flags {
+    DEBUG_FAIL_COMMIT = 1, // while set, transaction commits fail
+};
+
 const char *sql_create_table = "CREATE TABLE if not exists jobs("
                                "  id CHAR(16) PRIMARY KEY,"
                                "  userid INT,"
@@ -64,10 +82,19 @@ struct job_archive_ctx {
     char *dbpath;
     unsigned int busy_timeout;
     flux_watcher_t *w;
+    flux_watcher_t *retry_w;
+    bool retry_wait;
+    flux_future_t *f_watch;
+    bool watch_unsupported;
     sqlite3 *db;
     sqlite3_stmt *store_stmt;
     double since;
     int kvs_lookup_count;
+    zlistx_t *lookup_queue;
+    bool txn_open;
+    int txn_count;
+    json_t *txn_jobs;       /* jobs stored in open txn */
+    struct watermark *wm;
     tstat_t sqlstore;
 };
 
@@ -93,11 +120,111 @@ static void log_sqlite_error (struct job_archive_ctx *ctx, const char *fmt, ...)
         flux_log (ctx->h, LOG_ERR, "%s: unknown error, no sqlite3 handle", buf);
 }
 
+/* Execute 'sql', spinning on SQLITE_BUSY as for the store statement.
+ */
+static int job_archive_exec (struct job_archive_ctx *ctx, const char *sql)
+{
+    int rc;
+
+    while ((rc = sqlite3_exec (ctx->db, sql, NULL, NULL, NULL)) == SQLITE_BUSY) {
+        flux_log (ctx->h, LOG_DEBUG, "%s: BUSY", __FUNCTION__);
+        usleep (1000);
+    }
+    if (rc != SQLITE_OK) {
+        log_sqlite_error (ctx, "%s", sql);
+        return -1;
+    }
+    return 0;
+}
+
+/* Jobs are stored in a transaction that spans a batch of lookups, so
+ * the cost of a commit (fsync) is paid once per batch instead of once
+ * per job.  Lookups complete out of order, so a batch may be committed
+ * while jobs that became inactive earlier are still being looked up.
+ * ctx->since only advances past a job once it and all earlier jobs
+ * are committed (see watermark.h).  If a commit fails, its jobs stay
+ * pending in the watermark and are queued to be looked up again.
+ */
+static int txn_begin (struct job_archive_ctx *ctx)
+{
+    if (ctx->txn_open)
+        return 0;
+    if (job_archive_exec (ctx, "BEGIN") < 0)
+        return -1;
+    ctx->txn_open = true;
+    ctx->txn_count = 0;
+    return 0;
+}
+
+static void txn_requeue (struct job_archive_ctx *ctx)
+{
+    size_t index;
+    json_t *job;
+
+    json_array_foreach (ctx->txn_jobs, index, job) {
+        double t_inactive;
+        if (!zlistx_add_end (ctx->lookup_queue, json_incref (job))) {
+            flux_log_error (ctx->h, "%s: zlistx_add_end", __FUNCTION__);
+            if (json_unpack (job, "{s:f}", "t_inactive", &t_inactive) == 0)
+                (void)watermark_remove (ctx->wm, t_inactive, false);
+            json_decref (job);
+        }
+    }
+}
+
+static int txn_commit (struct job_archive_ctx *ctx)
+{
+    size_t index;
+    json_t *job;
+    int rc = -1;
+
+    if (!ctx->txn_open)
+        return 0;
+    ctx->txn_open = false;
+    if (flux_module_debug_test (ctx->h, DEBUG_FAIL_COMMIT, false))
+        flux_log (ctx->h, LOG_ERR, "COMMIT: failed by debug flag");
+    else if (job_archive_exec (ctx, "COMMIT") == 0)
+        rc = 0;
+    if (rc < 0) {
+        (void)job_archive_exec (ctx, "ROLLBACK");
+        flux_log (ctx->h,
+                  LOG_ERR,
+                  "failed to archive %d jobs, will retry",
+                  ctx->txn_count);
+        txn_requeue (ctx);
+    }
+    else {
+        json_array_foreach (ctx->txn_jobs, index, job) {
+            double t_inactive;
+            if (json_unpack (job, "{s:f}", "t_inactive", &t_inactive) == 0)
+                (void)watermark_remove (ctx->wm, t_inactive, true);
+        }
+        flux_log (ctx->h, LOG_DEBUG, "archived %d jobs", ctx->txn_count);
+    }
+    json_array_clear (ctx->txn_jobs);
+    ctx->since = watermark_advance (ctx->wm, ctx->since);
+    return rc;
+}
+
+/* zlistx_destructor_fn */
+static void job_destructor (void **item)
+{
+    if (item) {
+        json_decref (*item);
+        *item = NULL;
+    }
+}
+
 static void job_archive_ctx_destroy (struct job_archive_ctx *ctx)
 {
     if (ctx) {
         free (ctx->dbpath);
+        flux_future_destroy (ctx->f_watch);
         flux_watcher_destroy (ctx->w);
+        flux_watcher_destroy (ctx->retry_w);
+        if (ctx->txn_open)
+            (void)txn_commit (ctx);
+        zlistx_destroy (&ctx->lookup_queue);
         if (ctx->store_stmt) {
             if (sqlite3_finalize (ctx->store_stmt) != SQLITE_OK)
                 log_sqlite_error (ctx, "sqlite_finalize store_stmt");
@@ -106,6 +233,8 @@ static void job_archive_ctx_destroy (struct job_archive_ctx *ctx)
             if (sqlite3_close (ctx->db) != SQLITE_OK)
                 log_sqlite_error (ctx, "sqlite3_close");
         }
+        json_decref (ctx->txn_jobs);
+        watermark_destroy (ctx->wm);
         free (ctx);
     }
 }
@@ -122,6 +251,16 @@ static struct job_archive_ctx * job_archive_ctx_create (flux_t *h)
     ctx->h = h;
     ctx->period = 0.0;
     ctx->busy_timeout = BUSY_TIMEOUT_DEFAULT;
+    if (!(ctx->lookup_queue = zlistx_new ())) {
+        flux_log_error (h, "zlistx_new");
+        goto error;
+    }
+    zlistx_set_destructor (ctx->lookup_queue, job_destructor);
+    if (!(ctx->txn_jobs = json_array ())
+        || !(ctx->wm = watermark_create ())) {
+        flux_log_error (h, "job_archive_ctx_create");
+        goto error;
+    }
 
     return ctx;
  error:
@@ -252,6 +391,8 @@ void json_decref_wrapper (void *arg)
     json_decref ((json_t *)arg);
 }
 
+static void lookup_continue (struct job_archive_ctx *ctx);
+
 void job_info_lookup_continuation (flux_future_t *f, void *arg)
 {
     struct job_archive_ctx *ctx = arg;
@@ -269,9 +410,18 @@ void job_info_lookup_continuation (flux_future_t *f, void *arg)
     char idbuf[64];
     struct timespec t0;
     json_error_t error;
+    bool tracked = false;
 
     monotime (&t0);
 
+    /* t_inactive was validated by lookup_enqueue() */
+    if (!(job = flux_future_aux_get (f, "job"))
+        || json_unpack (job, "{s:f}", "t_inactive", &t_inactive) < 0) {
+        flux_log_error (ctx->h, "%s: flux_future_aux_get", __FUNCTION__);
+        goto out;
+    }
+    tracked = true;
+
     if (flux_rpc_get_unpack (f, "{s:s s:s s?s}",
                              "eventlog", &eventlog,
                              "jobspec", &jobspec,
@@ -280,11 +430,6 @@ void job_info_lookup_continuation (flux_future_t *f, void *arg)
         goto out;
     }
 
-    if (!(job = flux_future_aux_get (f, "job"))) {
-        flux_log_error (ctx->h, "%s: flux_future_aux_get", __FUNCTION__);
-        goto out;
-    }
-
     if (json_unpack_ex (job, &error, 0, "{s:I}", "id", &id) < 0) {
         flux_log (ctx->h, LOG_ERR, "%s: can't parse job id: %s",
                   __FUNCTION__, error.text);
@@ -304,6 +449,9 @@ void job_info_lookup_continuation (flux_future_t *f, void *arg)
         goto out;
     }
 
+    if (txn_begin (ctx) < 0)
+        goto out;
+
     snprintf (idbuf, 64, "%llu", (unsigned long long)id);
     if (sqlite3_bind_text (ctx->store_stmt,
                            1,
@@ -397,21 +545,33 @@ void job_info_lookup_continuation (flux_future_t *f, void *arg)
         }
     }
 
-    if (t_inactive > ctx->since)
-        ctx->since = t_inactive;
+    /* The job is no longer tracked separately once it is in the
+     * transaction, and is removed from the watermark on commit.
+     */
+    if (json_array_append (ctx->txn_jobs, job) == 0)
+        tracked = false;
+    ctx->txn_count++;
 
     tstat_push (&ctx->sqlstore, monotime_since (t0));
 
 out:
+    if (tracked)
+        (void)watermark_remove (ctx->wm, t_inactive, false);
     sqlite3_reset (ctx->store_stmt);
     flux_future_destroy (f);
-    if (ctx->kvs_lookup_count
-        && (--(ctx->kvs_lookup_count)) == 0) {
-        flux_timer_watcher_reset (ctx->w, ctx->period, 0.);
-        flux_watcher_start (ctx->w);
-    }
+    if (ctx->kvs_lookup_count)
+        ctx->kvs_lookup_count--;
+    if (ctx->txn_count >= TXN_MAX_JOBS)
+        (void)txn_commit (ctx);
+    lookup_continue (ctx);
 }
 
+/* N.B. Jobs are fetched with job-info.lookup rather than a KVS snapshot
+ * scan (see libkvs/kvs_snapshot.h).  Only the newly inactive jobs that
+ * job-list reports are needed, not a walk of the job directory, and
+ * snapshot reads block on content.load, which would stall the reactor
+ * that keeps LOOKUP_WINDOW asynchronous lookups in flight.
+ */
 int job_info_lookup (struct job_archive_ctx *ctx, json_t *job)
 {
     const char *topic = "job-info.lookup";
@@ -471,35 +631,96 @@ error:
     return -1;
 }
 
-void job_list_inactive_continuation (flux_future_t *f, void *arg)
+/* Start lookups for queued jobs, keeping at most LOOKUP_WINDOW in
+ * flight.  Once the queue has drained and all lookups have completed,
+ * commit the batch, and if polling, restart the timer.  If the commit
+ * failed, its jobs were requeued, and lookups resume after 'period'.
+ */
+static void lookup_continue (struct job_archive_ctx *ctx)
+{
+    json_t *job;
+
+    if (ctx->retry_wait)
+        return;
+    while (ctx->kvs_lookup_count < LOOKUP_WINDOW
+           && (job = zlistx_first (ctx->lookup_queue))) {
+        double t_inactive;
+        if (job_info_lookup (ctx, job) < 0
+            && json_unpack (job, "{s:f}", "t_inactive", &t_inactive) == 0)
+            (void)watermark_remove (ctx->wm, t_inactive, false);
+        zlistx_delete (ctx->lookup_queue, NULL);
+    }
+    if (ctx->kvs_lookup_count == 0) {
+        if (txn_commit (ctx) < 0 && zlistx_size (ctx->lookup_queue) > 0) {
+            ctx->retry_wait = true;
+            flux_timer_watcher_reset (ctx->retry_w, ctx->period, 0.);
+            flux_watcher_start (ctx->retry_w);
+            return;
+        }
+        ctx->since = watermark_advance (ctx->wm, ctx->since);
+        if (!ctx->f_watch) {
+            flux_timer_watcher_reset (ctx->w, ctx->period, 0.);
+            flux_watcher_start (ctx->w);
+        }
+    }
+}
+
+static void retry_cb (flux_reactor_t *r,
+                      flux_watcher_t *w,
+                      int revents,
+                      void *arg)
 {
     struct job_archive_ctx *ctx = arg;
-    json_t *jobs;
+
+    ctx->retry_wait = false;
+    lookup_continue (ctx);
+}
+
+static void lookup_enqueue (struct job_archive_ctx *ctx, json_t *jobs)
+{
     size_t index;
     json_t *value;
 
-    if (flux_rpc_get_unpack (f, "{s:o}", "jobs", &jobs) < 0) {
-        flux_log_error (ctx->h, "%s: flux_rpc_get_unpack", __FUNCTION__);
-        return;
-    }
     json_array_foreach (jobs, index, value) {
-        if (job_info_lookup (ctx, value) < 0)
+        double t_inactive;
+
+        if (json_unpack (value, "{s:f}", "t_inactive", &t_inactive) < 0) {
+            flux_log (ctx->h, LOG_ERR, "%s: parse t_inactive", __FUNCTION__);
+            continue;
+        }
+        if (watermark_add (ctx->wm, t_inactive) < 0) {
+            flux_log_error (ctx->h, "%s: watermark_add", __FUNCTION__);
+            break;
+        }
+        if (!zlistx_add_end (ctx->lookup_queue, json_incref (value))) {
+            flux_log_error (ctx->h, "%s: zlistx_add_end", __FUNCTION__);
+            json_decref (value);
+            (void)watermark_remove (ctx->wm, t_inactive, false);
             break;
+        }
     }
-    /* If no new inactive jobs, still need to reset timer */
-    if (!ctx->kvs_lookup_count) {
+    lookup_continue (ctx);
+}
+
+void job_list_inactive_continuation (flux_future_t *f, void *arg)
+{
+    struct job_archive_ctx *ctx = arg;
+    json_t *jobs;
+
+    if (flux_rpc_get_unpack (f, "{s:o}", "jobs", &jobs) < 0) {
+        flux_log_error (ctx->h, "%s: flux_rpc_get_unpack", __FUNCTION__);
+        flux_future_destroy (f);
         flux_timer_watcher_reset (ctx->w, ctx->period, 0.);
         flux_watcher_start (ctx->w);
+        return;
     }
+    /* If no new inactive jobs, this still resets the timer */
+    lookup_enqueue (ctx, jobs);
     flux_future_destroy (f);
 }
 
-void job_archive_cb (flux_reactor_t *r,
-                     flux_watcher_t *w,
-                     int revents,
-                     void *arg)
+static int job_list_poll (struct job_archive_ctx *ctx)
 {
-    struct job_archive_ctx *ctx = arg;
     flux_future_t *f;
 
     if (!(f = flux_rpc_pack (ctx->h,
@@ -519,12 +740,115 @@ void job_archive_cb (flux_reactor_t *r,
                              "constraint",
                                "states", FLUX_JOB_STATE_INACTIVE))) {
         flux_log_error (ctx->h, "%s: flux_rpc_pack", __FUNCTION__);
-        return;
+        return -1;
     }
     if (flux_future_then (f, -1, job_list_inactive_continuation, ctx) < 0) {
         flux_log_error (ctx->h, "%s: flux_future_then", __FUNCTION__);
+        flux_future_destroy (f);
+        return -1;
+    }
+    return 0;
+}
+
+void job_list_watch_continuation (flux_future_t *f, void *arg)
+{
+    struct job_archive_ctx *ctx = arg;
+    const char *type;
+    json_t *jobs;
+
+    if (flux_rpc_get_unpack (f, "{s:s s:o}", "type", &type, "jobs", &jobs) < 0) {
+        /* An older job-list without job-list.watch fails the request
+         * immediately.  Otherwise, the stream was terminated (e.g. the
+         * job-list module was reloaded) and the watch is retried from
+         * ctx->since after 'period'.
+         */
+        if (errno == ENOSYS && !flux_future_aux_get (f, "started")) {
+            if (!ctx->watch_unsupported)
+                flux_log (ctx->h,
+                          LOG_DEBUG,
+                          "job-list.watch unsupported, polling job-list.list");
+            ctx->watch_unsupported = true;
+            flux_future_destroy (f);
+            ctx->f_watch = NULL;
+            if (job_list_poll (ctx) < 0) {
+                flux_timer_watcher_reset (ctx->w, ctx->period, 0.);
+                flux_watcher_start (ctx->w);
+            }
+            return;
+        }
+        flux_log_error (ctx->h, "%s: flux_rpc_get_unpack", __FUNCTION__);
+        flux_future_destroy (f);
+        ctx->f_watch = NULL;
+        flux_timer_watcher_reset (ctx->w, ctx->period, 0.);
+        flux_watcher_start (ctx->w);
         return;
     }
+    if (!flux_future_aux_get (f, "started")) {
+        if (ctx->watch_unsupported)
+            flux_log (ctx->h, LOG_DEBUG, "job-list.watch is now supported");
+        ctx->watch_unsupported = false;
+        (void)flux_future_aux_set (f, "started", ctx, NULL);
+    }
+
+    /* Inactive jobs are only ever added, and "remove" is sent when
+     * job-list purges a job, which is of no interest here.
+     */
+    if (streq (type, "snapshot") || streq (type, "add"))
+        lookup_enqueue (ctx, jobs);
+    flux_future_reset (f);
+}
+
+static int job_list_watch (struct job_archive_ctx *ctx)
+{
+    if (!(ctx->f_watch = flux_rpc_pack (ctx->h,
+                                        "job-list.watch",
+                                        FLUX_NODEID_ANY,
+                                        FLUX_RPC_STREAMING,
+                                        "{s:f s:[ssssss] s:{s:[i]}}",
+                                        "since", ctx->since,
+                                        "attrs",
+                                          "userid",
+                                          "ranks",
+                                          "t_submit",
+                                          "t_run",
+                                          "t_cleanup",
+                                          "t_inactive",
+                                        "constraint",
+                                          "states",
+                                          FLUX_JOB_STATE_INACTIVE))) {
+        flux_log_error (ctx->h, "%s: flux_rpc_pack", __FUNCTION__);
+        return -1;
+    }
+    if (flux_future_then (ctx->f_watch,
+                          -1,
+                          job_list_watch_continuation,
+                          ctx) < 0) {
+        flux_log_error (ctx->h, "%s: flux_future_then", __FUNCTION__);
+        flux_future_destroy (ctx->f_watch);
+        ctx->f_watch = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+/* Archive inactive jobs as job-list reports them via job-list.watch.
+ * A watch is attempted each time the timer fires.  If job-list does not
+ * support job-list.watch, job-list.list is polled instead, and the watch
+ * is retried after the next 'period', e.g. in case job-list is reloaded
+ * with watch support.  The timer is restarted after each poll completes,
+ * or to retry a failed watch.
+ */
+void job_archive_cb (flux_reactor_t *r,
+                     flux_watcher_t *w,
+                     int revents,
+                     void *arg)
+{
+    struct job_archive_ctx *ctx = arg;
+
+    if (job_list_watch (ctx) < 0) {
+        flux_timer_watcher_reset (ctx->w, ctx->period, 0.);
+        flux_watcher_start (ctx->w);
+    }
 }
 
 void stats_get_cb (flux_t *h,
@@ -536,12 +860,15 @@ void stats_get_cb (flux_t *h,
 
     if (flux_respond_pack (h,
                            msg,
-                           "{s:i s:f s:f s:f s:f}",
+                           "{s:i s:f s:f s:f s:f s:f s:i s:i}",
                            "count", tstat_count (&ctx->sqlstore),
                            "min", tstat_min (&ctx->sqlstore),
                            "max", tstat_max (&ctx->sqlstore),
                            "mean", tstat_mean (&ctx->sqlstore),
-                           "stddev", tstat_stddev (&ctx->sqlstore)) < 0)
+                           "stddev", tstat_stddev (&ctx->sqlstore),
+                           "since", ctx->since,
+                           "queued", (int)zlistx_size (ctx->lookup_queue),
+                           "lookups", ctx->kvs_lookup_count) < 0)
         flux_log_error (h, "error responding to stats-get request");
     return;
 }
@@ -634,6 +961,15 @@ int mod_main (flux_t *h, int ac, char **av)
 
     flux_watcher_start (ctx->w);
 
+    if (!(ctx->retry_w = flux_timer_watcher_create (flux_get_reactor (h),
+                                                    ctx->period,
+                                                    0.,
+                                                    retry_cb,
+                                                    ctx))) {
+        flux_log_error (h, "flux_timer_watcher_create");
+        goto done;
+    }
+
     if (flux_msg_handler_addvec (h, htab, ctx, &handlers) < 0) {
         flux_log_error (h, "flux_msg_handler_addvec");
         goto done;
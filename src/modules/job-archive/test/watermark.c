@@ -0,0 +1,161 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <errno.h>
+
+#include "src/common/libtap/tap.h"
+#include "src/modules/job-archive/watermark.h"
+
+static void test_basic (void)
+{
+    struct watermark *wm;
+
+    ok ((wm = watermark_create ()) != NULL,
+        "watermark_create works");
+    ok (watermark_advance (wm, 1.) == 1.,
+        "watermark_advance with nothing tracked returns since");
+    ok (watermark_add (wm, 2.) == 0 && watermark_add (wm, 3.) == 0,
+        "watermark_add works");
+    ok (watermark_pending (wm) == 2,
+        "watermark_pending returns 2");
+    ok (watermark_remove (wm, 2., true) == 0
+        && watermark_remove (wm, 3., true) == 0,
+        "watermark_remove works");
+    ok (watermark_advance (wm, 1.) == 3.,
+        "watermark advances to last committed job");
+    ok (watermark_advance (wm, 3.) == 3.,
+        "watermark_advance again does not change it");
+    watermark_destroy (wm);
+}
+
+/* Jobs committed while an earlier job is still being looked up,
+ * e.g. a full transaction committed with lookups in flight.
+ */
+static void test_out_of_order (void)
+{
+    struct watermark *wm;
+    double since = 0.;
+
+    if (!(wm = watermark_create ()))
+        BAIL_OUT ("watermark_create failed");
+    for (int i = 1; i <= 5; i++) {
+        if (watermark_add (wm, i) < 0)
+            BAIL_OUT ("watermark_add failed");
+    }
+    ok (watermark_remove (wm, 4., true) == 0
+        && watermark_remove (wm, 5., true) == 0
+        && watermark_remove (wm, 2., true) == 0,
+        "jobs 2, 4, and 5 committed before jobs 1 and 3");
+    since = watermark_advance (wm, since);
+    ok (since == 0.,
+        "watermark does not advance past pending job 1");
+    ok (watermark_remove (wm, 1., true) == 0,
+        "job 1 committed");
+    since = watermark_advance (wm, since);
+    ok (since == 2.,
+        "watermark advances to job 2, but not past pending job 3");
+    ok (watermark_remove (wm, 3., true) == 0,
+        "job 3 committed");
+    since = watermark_advance (wm, since);
+    ok (since == 5.,
+        "watermark advances to job 5 once all jobs are committed");
+    ok (watermark_pending (wm) == 0,
+        "no jobs pending");
+    watermark_destroy (wm);
+}
+
+static void test_dropped (void)
+{
+    struct watermark *wm;
+    double since = 0.;
+
+    if (!(wm = watermark_create ()))
+        BAIL_OUT ("watermark_create failed");
+    if (watermark_add (wm, 1.) < 0
+        || watermark_add (wm, 2.) < 0
+        || watermark_add (wm, 3.) < 0)
+        BAIL_OUT ("watermark_add failed");
+    ok (watermark_remove (wm, 3., true) == 0,
+        "job 3 committed");
+    since = watermark_advance (wm, since);
+    ok (since == 0.,
+        "watermark does not advance past pending jobs");
+    ok (watermark_remove (wm, 1., false) == 0,
+        "job 1 dropped");
+    ok (watermark_remove (wm, 2., true) == 0,
+        "job 2 committed");
+    since = watermark_advance (wm, since);
+    ok (since == 3.,
+        "dropped job does not hold back the watermark");
+    watermark_destroy (wm);
+}
+
+static void test_duplicate (void)
+{
+    struct watermark *wm;
+
+    if (!(wm = watermark_create ()))
+        BAIL_OUT ("watermark_create failed");
+    if (watermark_add (wm, 1.) < 0 || watermark_add (wm, 1.) < 0)
+        BAIL_OUT ("watermark_add failed");
+    ok (watermark_remove (wm, 1., true) == 0,
+        "first of two jobs with the same t_inactive committed");
+    ok (watermark_advance (wm, 0.) == 0.,
+        "watermark does not advance while the other is pending");
+    ok (watermark_remove (wm, 1., true) == 0,
+        "second job committed");
+    ok (watermark_advance (wm, 0.) == 1.,
+        "watermark advances");
+    watermark_destroy (wm);
+}
+
+static void test_inval (void)
+{
+    struct watermark *wm;
+
+    if (!(wm = watermark_create ()))
+        BAIL_OUT ("watermark_create failed");
+    errno = 0;
+    ok (watermark_add (NULL, 1.) < 0 && errno == EINVAL,
+        "watermark_add wm=NULL fails with EINVAL");
+    errno = 0;
+    ok (watermark_remove (NULL, 1., true) < 0 && errno == EINVAL,
+        "watermark_remove wm=NULL fails with EINVAL");
+    errno = 0;
+    ok (watermark_remove (wm, 1., true) < 0 && errno == ENOENT,
+        "watermark_remove of untracked job fails with ENOENT");
+    ok (watermark_advance (NULL, 1.) == 1.,
+        "watermark_advance wm=NULL returns since");
+    errno = 0;
+    ok (watermark_pending (NULL) < 0 && errno == EINVAL,
+        "watermark_pending wm=NULL fails with EINVAL");
+    watermark_destroy (wm);
+}
+
+int main (int argc, char *argv[])
+{
+    plan (NO_PLAN);
+
+    test_basic ();
+    test_out_of_order ();
+    test_dropped ();
+    test_duplicate ();
+    test_inval ();
+
+    done_testing ();
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
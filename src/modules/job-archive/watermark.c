@@ -0,0 +1,161 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* watermark.c - track the archive "since" watermark
+ *
+ * 'pending' holds the t_inactive of jobs queued, in flight, or stored
+ * in an open transaction.  'committed' holds the t_inactive of
+ * committed jobs that the watermark could not yet advance past because
+ * an earlier job was still pending.  Both are small in practice: at
+ * most the lookup queue plus one transaction.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdlib.h>
+#include <errno.h>
+
+#include "src/common/libczmqcontainers/czmq_containers.h"
+
+#include "watermark.h"
+
+struct watermark {
+    zlistx_t *pending;
+    zlistx_t *committed;
+};
+
+/* zlistx_destructor_fn */
+static void time_destructor (void **item)
+{
+    if (item) {
+        free (*item);
+        *item = NULL;
+    }
+}
+
+static int time_append (zlistx_t *l, double t)
+{
+    double *tp;
+
+    if (!(tp = malloc (sizeof (*tp))))
+        return -1;
+    *tp = t;
+    if (!zlistx_add_end (l, tp)) {
+        free (tp);
+        errno = ENOMEM;
+        return -1;
+    }
+    return 0;
+}
+
+void watermark_destroy (struct watermark *wm)
+{
+    if (wm) {
+        int saved_errno = errno;
+        zlistx_destroy (&wm->pending);
+        zlistx_destroy (&wm->committed);
+        free (wm);
+        errno = saved_errno;
+    }
+}
+
+struct watermark *watermark_create (void)
+{
+    struct watermark *wm;
+
+    if (!(wm = calloc (1, sizeof (*wm))))
+        return NULL;
+    if (!(wm->pending = zlistx_new ())
+        || !(wm->committed = zlistx_new ())) {
+        watermark_destroy (wm);
+        errno = ENOMEM;
+        return NULL;
+    }
+    zlistx_set_destructor (wm->pending, time_destructor);
+    zlistx_set_destructor (wm->committed, time_destructor);
+    return wm;
+}
+
+int watermark_add (struct watermark *wm, double t)
+{
+    if (!wm) {
+        errno = EINVAL;
+        return -1;
+    }
+    return time_append (wm->pending, t);
+}
+
+int watermark_remove (struct watermark *wm, double t, bool committed)
+{
+    double *tp;
+
+    if (!wm) {
+        errno = EINVAL;
+        return -1;
+    }
+    tp = zlistx_first (wm->pending);
+    while (tp) {
+        if (*tp == t)
+            break;
+        tp = zlistx_next (wm->pending);
+    }
+    if (!tp) {
+        errno = ENOENT;
+        return -1;
+    }
+    if (committed && time_append (wm->committed, t) < 0)
+        return -1;
+    zlistx_delete (wm->pending, zlistx_cursor (wm->pending));
+    return 0;
+}
+
+double watermark_advance (struct watermark *wm, double since)
+{
+    double *tp;
+    double min = 0.;
+    bool have_min = false;
+
+    if (!wm)
+        return since;
+    tp = zlistx_first (wm->pending);
+    while (tp) {
+        if (!have_min || *tp < min) {
+            min = *tp;
+            have_min = true;
+        }
+        tp = zlistx_next (wm->pending);
+    }
+    tp = zlistx_first (wm->committed);
+    while (tp) {
+        if (!have_min || *tp < min) {
+            if (*tp > since)
+                since = *tp;
+            zlistx_delete (wm->committed, zlistx_cursor (wm->committed));
+            tp = zlistx_first (wm->committed);
+        }
+        else
+            tp = zlistx_next (wm->committed);
+    }
+    return since;
+}
+
+int watermark_pending (struct watermark *wm)
+{
+    if (!wm) {
+        errno = EINVAL;
+        return -1;
+    }
+    return zlistx_size (wm->pending);
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,50 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _JOB_ARCHIVE_WATERMARK_H
+#define _JOB_ARCHIVE_WATERMARK_H
+
+#include <stdbool.h>
+
+/* Track the t_inactive of jobs being archived, so that the "since"
+ * watermark only advances past a job once it and all jobs that became
+ * inactive before it have been committed.  Jobs are looked up and
+ * committed in any order.
+ */
+struct watermark *watermark_create (void);
+void watermark_destroy (struct watermark *wm);
+
+/* Start tracking a job with t_inactive 't'.
+ */
+int watermark_add (struct watermark *wm, double t);
+
+/* Stop tracking a job with t_inactive 't'.  If 'committed' is true,
+ * the job was committed to the archive and the watermark may advance
+ * past it.  Otherwise the job was dropped, e.g. its lookup failed, and
+ * it no longer holds back the watermark.
+ * Returns -1 with errno set to ENOENT if 't' is not being tracked.
+ */
+int watermark_remove (struct watermark *wm, double t, bool committed);
+
+/* Return the new watermark given the current one, 'since': the
+ * greatest committed t_inactive that is less than the t_inactive of
+ * every job still being tracked, or 'since' if that is greater.
+ */
+double watermark_advance (struct watermark *wm, double since);
+
+/* Return the number of jobs being tracked.
+ */
+int watermark_pending (struct watermark *wm);
+
+#endif /* !_JOB_ARCHIVE_WATERMARK_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -41,6 +41,7 @@
 #include "ccan/str/str.h"
 #include "src/common/libutil/errprintf.h"
 #include "src/common/libutil/errno_safe.h"
+#include "src/common/libutil/blobref.h"
 #include "src/common/libsubprocess/bulk-exec.h"
 
 #include "job-exec.h"
@@ -64,6 +65,8 @@ struct exec_ctx {
     int exit_count;
 
     flux_watcher_t *shell_barrier_timer;
+
+    flux_future_t *jobinfo_f;      /* content.store of J and R for shells */
 };
 
 static void barrier_timer_cb (flux_reactor_t *r,
@@ -108,6 +111,7 @@ static void exec_ctx_destroy (struct exec_ctx *tc)
         int saved_errno = errno;
         idset_destroy (tc->barrier_pending_ranks);
         flux_watcher_destroy (tc->shell_barrier_timer);
+        flux_future_destroy (tc->jobinfo_f);
         free (tc);
         errno = saved_errno;
     }
@@ -171,6 +175,29 @@ error:
     return NULL;
 }
 
+/*  Pass the blobref of J and R to job shells in FLUX_JOB_INFO_BLOBREF.
+ *   If J was not fetched, shells fall back to job-info.  Multiuser job
+ *   shells cannot use content.load, which is restricted to the instance
+ *   owner, so they always use job-info.
+ */
+static int exec_jobinfo_store (struct exec_ctx *ctx, flux_cmd_t *cmd)
+{
+    char blobref[BLOBREF_MAX_STRING_SIZE];
+
+    if (!ctx->job->J || ctx->job->multiuser)
+        return 0;
+    if (!(ctx->jobinfo_f = jobinfo_store_shell_info (ctx->job,
+                                                     blobref,
+                                                     sizeof (blobref)))
+        || flux_cmd_setenvf (cmd,
+                             1,
+                             "FLUX_JOB_INFO_BLOBREF",
+                             "%s",
+                             blobref) < 0)
+        return -1;
+    return 0;
+}
+
 static const char * exec_mock_exception (struct bulk_exec *exec)
 {
     struct exec_ctx *ctx = bulk_exec_aux_get (exec, "ctx");
@@ -560,6 +587,11 @@ static int exec_init (struct jobinfo *job)
         flux_log_error (job->h, "exec_init: bulk_exec_create");
         goto err;
     }
+    if (config_get_tree_launch ()
+        && bulk_exec_set_tree_launch (exec, true) < 0) {
+        flux_log_error (job->h, "exec_init: bulk_exec_set_tree_launch");
+        goto err;
+    }
     if (job->multiuser && bulk_exec_set_imp_path (exec, imp_path)) {
         flux_log_error (job->h, "exec_ctx_create: bulk_exec_set_imp_path");
         goto err;
@@ -598,6 +630,10 @@ static int exec_init (struct jobinfo *job)
         flux_log_error (job->h, "exec_init: flux_cmd_setenvf");
         goto err;
     }
+    if (exec_jobinfo_store (ctx, cmd) < 0) {
+        flux_log_error (job->h, "exec_init: exec_jobinfo_store");
+        goto err;
+    }
     if (job->multiuser) {
         if (flux_cmd_setenvf (cmd,
                               1,
@@ -37,6 +37,8 @@ struct exec_config {
     int exec_service_override;
     json_t *sdexec_properties;
     double default_barrier_timeout;
+    int tree_launch;
+    int shell_zygote;
 };
 
 /* Global configs initialized in config_init() */
@@ -112,11 +114,21 @@ double config_get_default_barrier_timeout (void)
     return exec_conf.default_barrier_timeout;
 }
 
+bool config_get_tree_launch (void)
+{
+    return exec_conf.tree_launch;
+}
+
+bool config_get_shell_zygote (void)
+{
+    return exec_conf.shell_zygote;
+}
+
 int config_get_stats (json_t **config_stats)
 {
     json_t *o = NULL;
 
-    if (!(o = json_pack ("{s:s? s:s? s:s? s:s? s:i s:f}",
+    if (!(o = json_pack ("{s:s? s:s? s:s? s:s? s:i s:f s:i s:i}",
                          "default_cwd", default_cwd,
                          "default_job_shell", exec_conf.default_job_shell,
                          "flux_imp_path", exec_conf.flux_imp_path,
@@ -124,7 +136,11 @@ int config_get_stats (json_t **config_stats)
                          "exec_service_override",
                          exec_conf.exec_service_override,
                          "default_barrier_timeout",
-                         exec_conf.default_barrier_timeout))) {
+                         exec_conf.default_barrier_timeout,
+                         "tree_launch",
+                         exec_conf.tree_launch,
+                         "shell_zygote",
+                         exec_conf.shell_zygote))) {
         errno = ENOMEM;
         return -1;
     }
@@ -154,6 +170,8 @@ static void exec_config_init (struct exec_config *ec)
     ec->exec_service_override = 0;
     ec->sdexec_properties = NULL;
     ec->default_barrier_timeout = 1800.;
+    ec->tree_launch = 0;
+    ec->shell_zygote = 0;
 }
 
 /*  Initialize configurations for use by job-exec bulk-exec
@@ -269,6 +287,29 @@ int config_setup (flux_t *h,
         return -1;
     }
 
+    /*  Check configuration for exec.tree-launch */
+    if (flux_conf_unpack (conf,
+                          &err,
+                          "{s?{s?b}}",
+                          "exec",
+                            "tree-launch", &tmpconf.tree_launch) < 0) {
+        errprintf (errp,
+                   "error reading config value exec.tree-launch: %s",
+                   err.text);
+        return -1;
+    }
+
+    /*  Check configuration for exec.shell-zygote */
+    if (flux_conf_unpack (conf,
+                          &err,
+                          "{s?{s?b}}",
+                          "exec",
+                            "shell-zygote", &tmpconf.shell_zygote) < 0) {
+        errprintf (errp,
+                   "error reading config value exec.shell-zygote: %s",
+                   err.text);
+        return -1;
+    }
 
     if (argv && argc) {
         /* Finally, override values on cmdline */
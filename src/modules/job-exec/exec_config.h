@@ -36,6 +36,10 @@ bool config_get_exec_service_override (void);
 
 double config_get_default_barrier_timeout (void);
 
+bool config_get_tree_launch (void);
+
+bool config_get_shell_zygote (void);
+
 int config_get_stats (json_t **config_stats);
 
 int config_setup (flux_t *h,
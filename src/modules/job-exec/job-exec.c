@@ -89,6 +89,7 @@
 #endif
 #include <assert.h>
 #include <unistd.h>
+#include <string.h>
 #include <signal.h>
 #include <flux/core.h>
 
@@ -101,6 +102,8 @@
 #include "src/common/libutil/errno_safe.h"
 #include "src/common/libutil/errprintf.h"
 #include "src/common/libutil/sigutil.h"
+#include "src/common/libutil/blobref.h"
+#include "src/common/libcontent/content.h"
 #include "ccan/str/str.h"
 
 #include "job-exec.h"
@@ -108,6 +111,7 @@
 #include "exec_config.h"
 
 static double kill_timeout;
+static double eventlog_batch_timeout;
 static int max_kill_count;
 static int term_signal;
 static int kill_signal;
@@ -115,10 +119,12 @@ static int kill_signal;
 #define DEBUG_FAIL_EXPIRATION 1
 
 extern struct exec_implementation testexec;
+extern struct exec_implementation zygoteexec;
 extern struct exec_implementation bulkexec;
 
 static struct exec_implementation * implementations[] = {
     &testexec,
+    &zygoteexec,
     &bulkexec,
     NULL
 };
@@ -129,6 +135,7 @@ struct job_exec_ctx {
     char **               argv; /* needed for later reparse */
     flux_msg_handler_t ** handlers;
     zhashx_t *            jobs;
+    struct eventlogger_stats evstats;  /* totals for completed jobs */
 };
 
 void jobinfo_incref (struct jobinfo *job)
@@ -141,6 +148,13 @@ void jobinfo_decref (struct jobinfo *job)
     if (job && (--job->refcount == 0)) {
         int saved_errno = errno;
         idset_destroy (job->critical_ranks);
+        if (job->ev && job->ctx) {
+            struct eventlogger_stats stats;
+            if (eventlogger_get_stats (job->ev, &stats) == 0) {
+                job->ctx->evstats.entries += stats.entries;
+                job->ctx->evstats.commits += stats.commits;
+            }
+        }
         eventlogger_destroy (job->ev);
         flux_watcher_destroy (job->kill_timer);
         flux_watcher_destroy (job->kill_shell_timer);
@@ -153,6 +167,7 @@ void jobinfo_decref (struct jobinfo *job)
         job->req = NULL;
         resource_set_destroy (job->R);
         json_decref (job->jobspec);
+        free (job->J);
         free (job->rootref);
         free (job);
         errno = saved_errno;
@@ -195,6 +210,51 @@ out:
     return f;
 }
 
+static void shell_info_store_cb (flux_future_t *f, void *arg)
+{
+    struct jobinfo *job = arg;
+
+    if (flux_future_get (f, NULL) < 0)
+        flux_log_error (job->h,
+                        "%s: error storing job shell info",
+                        idf58 (job->id));
+}
+
+/*  Store J and R as one content blob so that job shells load them through
+ *   the content cache of their local broker instead of sending their own
+ *   job-info RPCs.  The blobref is computed here so that shells need not
+ *   wait for the store response.  The store request is sent before any
+ *   shell is launched, so it reaches the cache on this rank before any load.
+ */
+flux_future_t *jobinfo_store_shell_info (struct jobinfo *job,
+                                         char *blobref,
+                                         int blobref_len)
+{
+    const char *hashtype;
+    json_t *o = NULL;
+    char *s = NULL;
+    flux_future_t *f = NULL;
+
+    if (!job->J) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(hashtype = flux_attr_get (job->h, "content.hash"))
+        || !(o = json_pack ("{s:s s:O}",
+                            "J", job->J,
+                            "R", resource_set_get_json (job->R)))
+        || !(s = json_dumps (o, JSON_COMPACT))
+        || blobref_hash (hashtype, s, strlen (s), blobref, blobref_len) < 0
+        || !(f = content_store (job->h, s, strlen (s), 0))
+        || flux_future_then (f, -1., shell_info_store_cb, job) < 0) {
+        ERRNO_SAFE_WRAP (flux_future_destroy, f);
+        f = NULL;
+    }
+    ERRNO_SAFE_WRAP (json_decref, o);
+    ERRNO_SAFE_WRAP (free, s);
+    return f;
+}
+
 /*  Emit an event to the exec system eventlog and return a future from
  *   flux_kvs_commit().
  */
@@ -970,11 +1030,18 @@ static int jobinfo_load_implementation (struct jobinfo *job)
 static void jobinfo_start_continue (flux_future_t *f, void *arg)
 {
     struct jobinfo *job = arg;
+    const char *J;
 
     if (flux_future_get (flux_future_get_child (f, "ns"), NULL) < 0) {
         jobinfo_fatal_error (job, errno, "failed to create guest ns");
         goto done;
     }
+    /*  J is optional: without it, the implementation leaves job shells
+     *   to fetch J themselves.
+     */
+    if (flux_kvs_lookup_get (flux_future_get_child (f, "J"), &J) < 0
+        || !(job->J = strdup (J)))
+        flux_log_error (job->h, "%s: failed to fetch J", idf58 (job->id));
 
     /*  If an exception was received during startup, no need to continue
      *   with startup
@@ -1139,7 +1206,9 @@ static flux_future_t *jobinfo_start_init (struct jobinfo *job)
 {
     flux_t *h = job->ctx->h;
     flux_future_t *f_kvs = NULL;
+    flux_future_t *f_J = NULL;
     flux_future_t *f = flux_future_wait_all_create ();
+    char key[64];
     flux_future_set_flux (f, job->ctx->h);
 
     if (job->reattach)
@@ -1149,11 +1218,21 @@ static flux_future_t *jobinfo_start_init (struct jobinfo *job)
 
     if (flux_future_push (f, "ns", f_kvs) < 0)
         goto err;
+    f_kvs = NULL;
+
+    /*  Fetch J once here so it can be passed to all job shells with
+     *   the launch (see exec.c), instead of by each shell.
+     */
+    if (flux_job_kvs_key (key, sizeof (key), job->id, "J") < 0
+        || !(f_J = flux_kvs_lookup (h, NULL, 0, key))
+        || flux_future_push (f, "J", f_J) < 0)
+        goto err;
 
     return f;
 err:
     flux_log_error (job->ctx->h, "jobinfo_kvs_lookup/namespace_create");
     flux_future_destroy (f_kvs);
+    flux_future_destroy (f_J);
     flux_future_destroy (f);
     return NULL;
 }
@@ -1244,7 +1323,10 @@ static int job_start (struct job_exec_ctx *ctx, const flux_msg_t *msg)
         flux_log_error (ctx->h, "job_ns_create");
         goto error;
     }
-    job->ev = eventlogger_create (job->h, 0.01, &ev_ops, job);
+    job->ev = eventlogger_create (job->h,
+                                  eventlog_batch_timeout,
+                                  &ev_ops,
+                                  job);
     if (!job->ev || eventlogger_setns (job->ev, job->ns) < 0) {
         flux_log_error (job->h,
                         "eventlogger_create/setns for job %s failed",
@@ -1463,6 +1545,7 @@ static int job_exec_set_config_globals (flux_t *h,
                                         flux_error_t *errp)
 {
     const char *kto = NULL;
+    const char *ebto = NULL;
     const char *tsignal = NULL;
     const char *ksignal = NULL;
     flux_error_t error;
@@ -1476,18 +1559,20 @@ static int job_exec_set_config_globals (flux_t *h,
      * So we must re-initialize globals everytime we reload the module.
      */
     kill_timeout = 5.0;
+    eventlog_batch_timeout = 0.01;
     max_kill_count = 8;
     term_signal = SIGTERM;
     kill_signal = SIGKILL;
 
     if (flux_conf_unpack (conf,
                           &error,
-                          "{s?{s?s s?s s?s s?i}}",
+                          "{s?{s?s s?s s?s s?i s?s}}",
                           "exec",
                             "kill-timeout", &kto,
                             "term-signal", &tsignal,
                             "kill-signal", &ksignal,
-                            "max-kill-count", &max_kill_count) < 0)
+                            "max-kill-count", &max_kill_count,
+                            "eventlog-batch-timeout", &ebto) < 0)
         return errprintf (errp,
                           "Error reading [exec] table: %s",
                           error.text);
@@ -1502,6 +1587,8 @@ static int job_exec_set_config_globals (flux_t *h,
             tsignal = argv[i] + 12;
         else if (strstarts (argv[i], "max-kill-count="))
             max_kill_count = atoi(argv[i] + 15);
+        else if (strstarts (argv[i], "eventlog-batch-timeout="))
+            ebto = argv[i] + 23;
     }
 
     if (kto) {
@@ -1511,6 +1598,13 @@ static int job_exec_set_config_globals (flux_t *h,
             return -1;
         }
     }
+    if (ebto) {
+        if (fsd_parse_duration (ebto, &eventlog_batch_timeout) < 0) {
+            errprintf (errp, "invalid eventlog-batch-timeout: %s", ebto);
+            errno = EINVAL;
+            return -1;
+        }
+    }
     if (ksignal) {
         if ((kill_signal = sigutil_signum (ksignal)) < 0) {
             errprintf (errp, "invalid kill-signal: %s", ksignal);
@@ -1661,6 +1755,33 @@ error:
     return NULL;
 }
 
+/*  Report exec.eventlog entries and commits of the job-exec eventlogger
+ *   for completed and running jobs.  batch-ratio is the average number
+ *   of entries per KVS commit.
+ */
+static json_t *eventlog_stats (struct job_exec_ctx *ctx)
+{
+    struct eventlogger_stats total = ctx->evstats;
+    struct jobinfo *job;
+
+    job = zhashx_first (ctx->jobs);
+    while (job) {
+        struct eventlogger_stats stats;
+        if (job->ev && eventlogger_get_stats (job->ev, &stats) == 0) {
+            total.entries += stats.entries;
+            total.commits += stats.commits;
+        }
+        job = zhashx_next (ctx->jobs);
+    }
+    return json_pack ("{s:f s:I s:I s:f}",
+                      "batch-timeout", eventlog_batch_timeout,
+                      "entries", (json_int_t) total.entries,
+                      "commits", (json_int_t) total.commits,
+                      "batch-ratio", total.commits > 0 ?
+                                     (double) total.entries / total.commits :
+                                     0.);
+}
+
 static void stats_cb (flux_t *h,
                       flux_msg_handler_t *mh,
                       const flux_msg_t *msg,
@@ -1670,6 +1791,7 @@ static void stats_cb (flux_t *h,
     struct exec_implementation *impl;
     json_t *o = NULL;
     json_t *jobs;
+    json_t *evstats;
     int i = 0;
 
     if (!(o = json_pack ("{s:f s:s s:s s:i}",
@@ -1686,6 +1808,12 @@ static void stats_cb (flux_t *h,
         errno = ENOMEM;
         goto error;
     }
+    if (!(evstats = eventlog_stats (ctx))
+        || json_object_set_new (o, "eventlog", evstats)) {
+        json_decref (evstats);
+        errno = ENOMEM;
+        goto error;
+    }
     while ((impl = implementations[i]) && impl->name) {
         json_t *stats = NULL;
         if (impl->stats && (stats = (*impl->stats) (NULL))) {
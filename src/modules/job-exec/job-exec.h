@@ -79,6 +79,7 @@ struct jobinfo {
 
     struct resource_set * R;         /* Fetched and parsed resource set R */
     json_t *              jobspec;   /* Fetched jobspec */
+    char *                J;         /* Signed jobspec, if fetched */
 
     struct idset *        critical_ranks;  /* critical shell ranks */
 
@@ -164,6 +165,15 @@ flux_future_t *jobinfo_shell_rpc_pack (struct jobinfo *job,
                                        const char *fmt,
                                        ...);
 
+/* Store J and R for job shells as one content blob, and write its blobref
+ *  to 'blobref'.  Job shells fetch the blob when FLUX_JOB_INFO_BLOBREF is
+ *  set in their environment.  job->J must be set.  The caller must keep
+ *  the returned future until the job is destroyed.
+ */
+flux_future_t *jobinfo_store_shell_info (struct jobinfo *job,
+                                         char *blobref,
+                                         int blobref_len);
+
 #endif /* !HAVE_JOB_EXEC_EXEC_H */
 
 /* vi: ts=4 sw=4 expandtab
@@ -0,0 +1,625 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* Flux job shell zygote exec implementation
+ *
+ * DESCRIPTION
+ *
+ * When exec.shell-zygote is enabled, single node jobs are launched by a
+ * long running "flux-shell --zygote" process on the target broker rank
+ * instead of a new job shell process per job.  The zygote performs the
+ * job independent part of shell startup once and forks a job shell for
+ * each job, which removes exec(2), dynamic linking, and shell plugin
+ * loading from the startup path of each job.  See src/shell/zygote.c for
+ * the zygote protocol.
+ *
+ * One zygote is started per broker rank with flux_rexec() the first time
+ * a job is assigned to that rank.  Jobs started before the zygote is
+ * running are queued.  If a zygote exits, its active jobs are failed, and
+ * a new zygote is started for the next job on that rank.
+ *
+ * Stderr of each forked shell is relayed by the zygote in "output"
+ * responses and logged to the exec.eventlog of its job, as bulk-exec does
+ * for shell output.  Stderr of the zygote itself goes to the broker log.
+ *
+ * Jobs are passed on to the bulk-exec implementation when:
+ *  - the job spans more than one broker rank, since a forked shell has no
+ *    connection to the job-exec shell barrier
+ *  - the job is a multiuser job, since the zygote runs as the instance
+ *    owner and job shells of other users must be started by the IMP
+ *  - the configured exec service is not "rexec"
+ *  - the jobspec selects a job shell or sets system.exec.bulkexec options
+ */
+
+#if HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include <string.h>
+
+#include "src/common/libczmqcontainers/czmq_containers.h"
+#include "src/common/libjob/job_hash.h"
+#include "src/common/libjob/idf58.h"
+#include "src/common/libutil/errno_safe.h"
+#include "src/common/libutil/blobref.h"
+#include "ccan/str/str.h"
+
+#include "job-exec.h"
+#include "exec_config.h"
+
+#define EXIT_CODE(x) __W_EXITCODE(x,0)
+
+extern char **environ;
+
+struct zygote_ctx {
+    flux_t *h;
+    zhashx_t *zygotes;          /* rank string -> struct zygote */
+};
+
+struct zygote {
+    struct zygote_ctx *ctx;
+    uint32_t rank;
+    char key[16];
+    flux_subprocess_t *p;
+    bool running;
+    zhashx_t *jobs;             /* jobid -> struct zygote_job */
+    zlistx_t *pending;          /* jobs waiting for zygote to start */
+};
+
+struct zygote_job {
+    struct jobinfo *job;
+    struct zygote *z;
+    uint32_t rank;
+    flux_future_t *info_f;      /* content.store of J and R for shells */
+    json_t *env;                /* environment additions for the shell */
+    void *handle;               /* handle in z->pending if queued */
+    bool sent;
+    bool complete;
+};
+
+static struct zygote_ctx *zygote_ctx = NULL;
+
+static void zygote_job_destroy (struct zygote_job *zj)
+{
+    if (zj) {
+        int saved_errno = errno;
+        flux_future_destroy (zj->info_f);
+        json_decref (zj->env);
+        free (zj);
+        errno = saved_errno;
+    }
+}
+
+/*  Detach job from its zygote and report completion to job-exec.
+ */
+static void zygote_job_complete (struct zygote_job *zj, int status)
+{
+    struct zygote *z = zj->z;
+
+    if (zj->complete)
+        return;
+    zj->complete = true;
+    if (z) {
+        if (zj->handle)
+            zlistx_delete (z->pending, zj->handle);
+        zhashx_delete (z->jobs, &zj->job->id);
+        zj->handle = NULL;
+        zj->z = NULL;
+    }
+    jobinfo_tasks_complete (zj->job,
+                            resource_set_ranks (zj->job->R),
+                            status);
+}
+
+static int zygote_write (struct zygote *z, json_t *o)
+{
+    char *s = NULL;
+    int rc = -1;
+
+    if (!o || !(s = json_dumps (o, JSON_COMPACT))) {
+        errno = ENOMEM;
+        goto out;
+    }
+    if (flux_subprocess_write (z->p, "stdin", s, strlen (s)) < 0
+        || flux_subprocess_write (z->p, "stdin", "\n", 1) < 0)
+        goto out;
+    rc = 0;
+out:
+    ERRNO_SAFE_WRAP (free, s);
+    ERRNO_SAFE_WRAP (json_decref, o);
+    return rc;
+}
+
+static int zygote_job_send (struct zygote_job *zj)
+{
+    if (zygote_write (zj->z, json_pack ("{s:s s:I s:O}",
+                                        "type", "run",
+                                        "id", zj->job->id,
+                                        "env", zj->env)) < 0)
+        return -1;
+    zj->sent = true;
+    return 0;
+}
+
+/*  Fail all jobs of a zygote that is no longer usable.
+ */
+static void zygote_fail_jobs (struct zygote *z, const char *reason)
+{
+    struct zygote_job *zj;
+    zlist_t *l;
+
+    if (!(l = zhashx_values (z->jobs))) {
+        flux_log_error (z->ctx->h, "zygote: zhashx_values");
+        return;
+    }
+    zj = zlist_first (l);
+    while (zj) {
+        jobinfo_fatal_error (zj->job,
+                             0,
+                             "job shell zygote on %s (rank %u) %s",
+                             flux_get_hostbyrank (z->ctx->h, z->rank),
+                             z->rank,
+                             reason);
+        zygote_job_complete (zj, EXIT_CODE(1));
+        zj = zlist_next (l);
+    }
+    zlist_destroy (&l);
+}
+
+/*  Detach remaining jobs without failing them.  This only happens at
+ *   module unload, when running jobs are checkpointed instead.
+ */
+static void zygote_destroy (struct zygote *z)
+{
+    if (z) {
+        int saved_errno = errno;
+        struct zygote_job *zj;
+        if (z->jobs) {
+            zj = zhashx_first (z->jobs);
+            while (zj) {
+                zj->z = NULL;
+                zj->handle = NULL;
+                zj = zhashx_next (z->jobs);
+            }
+        }
+        zlistx_destroy (&z->pending);
+        zhashx_destroy (&z->jobs);
+        flux_subprocess_destroy (z->p);
+        free (z);
+        errno = saved_errno;
+    }
+}
+
+static void zygote_destructor (void **item)
+{
+    if (item) {
+        zygote_destroy (*item);
+        *item = NULL;
+    }
+}
+
+/*  Remove the zygote from the context (destroying it), so that the next
+ *   job on this rank starts a new zygote.
+ */
+static void zygote_lost (struct zygote *z, const char *reason)
+{
+    char key[16];
+
+    snprintf (key, sizeof (key), "%s", z->key);
+    flux_log (z->ctx->h,
+              LOG_ERR,
+              "job shell zygote on rank %u %s",
+              z->rank,
+              reason);
+    z->running = false;
+    zygote_fail_jobs (z, reason);
+    zhashx_delete (z->ctx->zygotes, key);
+}
+
+static void zygote_handle_response (struct zygote *z, const char *line)
+{
+    json_t *o;
+    json_error_t error;
+    const char *type;
+    flux_jobid_t id;
+    int pid = -1;
+    int status = 0;
+    int errnum = 0;
+    const char *data = NULL;
+    size_t len = 0;
+    struct zygote_job *zj;
+
+    if (!(o = json_loads (line, 0, &error))
+        || json_unpack_ex (o,
+                           &error,
+                           0,
+                           "{s:s s:I s?i s?i s?i s?s%}",
+                           "type", &type,
+                           "id", &id,
+                           "pid", &pid,
+                           "status", &status,
+                           "errnum", &errnum,
+                           "data", &data, &len) < 0) {
+        flux_log (z->ctx->h,
+                  LOG_ERR,
+                  "zygote rank %u: invalid response: %s",
+                  z->rank,
+                  error.text);
+        goto out;
+    }
+    /*  The job may have been destroyed already, e.g. after a zygote
+     *   "error" response.  Ignore responses for unknown jobs.
+     */
+    if (!(zj = zhashx_lookup (z->jobs, &id)))
+        goto out;
+    if (streq (type, "start")) {
+        flux_log (z->ctx->h,
+                  LOG_DEBUG,
+                  "%s: zygote rank %u started shell pid %d",
+                  idf58 (id),
+                  z->rank,
+                  pid);
+        jobinfo_started (zj->job);
+    }
+    else if (streq (type, "output")) {
+        jobinfo_log_output (zj->job,
+                            z->rank,
+                            basename (config_get_job_shell (NULL)),
+                            "stderr",
+                            data,
+                            len);
+    }
+    else if (streq (type, "exit"))
+        zygote_job_complete (zj, status);
+    else if (streq (type, "error")) {
+        jobinfo_fatal_error (zj->job,
+                             errnum,
+                             "job shell exec error on %s (rank %u)",
+                             flux_get_hostbyrank (z->ctx->h, z->rank),
+                             z->rank);
+        zygote_job_complete (zj, EXIT_CODE(1));
+    }
+out:
+    json_decref (o);
+}
+
+static void zygote_output_cb (flux_subprocess_t *p, const char *stream)
+{
+    struct zygote *z = flux_subprocess_aux_get (p, "zygote");
+    const char *line;
+    int len;
+
+    if ((len = flux_subprocess_getline (p, stream, &line)) < 0) {
+        flux_log_error (z->ctx->h, "zygote rank %u: getline", z->rank);
+        return;
+    }
+    if (len == 0)
+        return;
+    if (streq (stream, "stdout"))
+        zygote_handle_response (z, line);
+    else
+        flux_log (z->ctx->h,
+                  LOG_INFO,
+                  "zygote rank %u: %.*s",
+                  z->rank,
+                  line[len - 1] == '\n' ? len - 1 : len,
+                  line);
+}
+
+static void zygote_state_cb (flux_subprocess_t *p,
+                             flux_subprocess_state_t state)
+{
+    struct zygote *z = flux_subprocess_aux_get (p, "zygote");
+
+    if (state == FLUX_SUBPROCESS_RUNNING) {
+        struct zygote_job *zj;
+
+        z->running = true;
+        while ((zj = zlistx_first (z->pending))) {
+            zlistx_delete (z->pending, zj->handle);
+            zj->handle = NULL;
+            if (zygote_job_send (zj) < 0) {
+                jobinfo_fatal_error (zj->job,
+                                     errno,
+                                     "failed to send job to shell zygote");
+                zygote_job_complete (zj, EXIT_CODE(1));
+            }
+        }
+    }
+    else if (state == FLUX_SUBPROCESS_FAILED)
+        zygote_lost (z, flux_subprocess_fail_error (p));
+}
+
+static void zygote_completion_cb (flux_subprocess_t *p)
+{
+    struct zygote *z = flux_subprocess_aux_get (p, "zygote");
+    zygote_lost (z, "exited");
+}
+
+static flux_subprocess_ops_t zygote_ops = {
+    .on_completion = zygote_completion_cb,
+    .on_state_change = zygote_state_cb,
+    .on_stdout = zygote_output_cb,
+    .on_stderr = zygote_output_cb,
+};
+
+static struct zygote *zygote_create (struct zygote_ctx *ctx, uint32_t rank)
+{
+    struct zygote *z;
+    flux_cmd_t *cmd = NULL;
+
+    if (!(z = calloc (1, sizeof (*z))))
+        return NULL;
+    z->ctx = ctx;
+    z->rank = rank;
+    snprintf (z->key, sizeof (z->key), "%u", rank);
+    if (!(z->jobs = job_hash_create ())
+        || !(z->pending = zlistx_new ())
+        || !(cmd = flux_cmd_create (0, NULL, environ))
+        || flux_cmd_argv_append (cmd, config_get_job_shell (NULL)) < 0
+        || flux_cmd_argv_append (cmd, "--zygote") < 0
+        || !(z->p = flux_rexec_ex (ctx->h,
+                                   "rexec",
+                                   rank,
+                                   0,
+                                   cmd,
+                                   &zygote_ops,
+                                   flux_llog,
+                                   ctx->h))
+        || flux_subprocess_aux_set (z->p, "zygote", z, NULL) < 0)
+        goto error;
+    flux_cmd_destroy (cmd);
+    return z;
+error:
+    ERRNO_SAFE_WRAP (flux_cmd_destroy, cmd);
+    zygote_destroy (z);
+    return NULL;
+}
+
+static struct zygote *zygote_get (struct zygote_ctx *ctx, uint32_t rank)
+{
+    struct zygote *z;
+    char key[16];
+
+    snprintf (key, sizeof (key), "%u", rank);
+    if ((z = zhashx_lookup (ctx->zygotes, key)))
+        return z;
+    if (!(z = zygote_create (ctx, rank)))
+        return NULL;
+    if (zhashx_insert (ctx->zygotes, z->key, z) < 0) {
+        zygote_destroy (z);
+        errno = EEXIST;
+        return NULL;
+    }
+    return z;
+}
+
+static bool jobspec_has_bulkexec (json_t *jobspec)
+{
+    json_t *o = NULL;
+    (void) json_unpack (jobspec,
+                        "{s:{s?{s?{s?o}}}}",
+                        "attributes",
+                          "system",
+                            "exec",
+                              "bulkexec", &o);
+    return o != NULL;
+}
+
+static int zygote_init (struct jobinfo *job)
+{
+    const struct idset *ranks;
+    struct zygote_job *zj;
+    char blobref[BLOBREF_MAX_STRING_SIZE];
+
+    if (!zygote_ctx
+        || !config_get_shell_zygote ()
+        || job->multiuser
+        || !streq (config_get_exec_service (), "rexec")
+        || !(ranks = resource_set_ranks (job->R))
+        || idset_count (ranks) != 1
+        || !streq (config_get_job_shell (job), config_get_job_shell (NULL))
+        || jobspec_has_bulkexec (job->jobspec))
+        return 0;
+
+    if (!(zj = calloc (1, sizeof (*zj)))
+        || !(zj->env = json_pack ("{s:s}", "FLUX_KVS_NAMESPACE", job->ns))) {
+        flux_log_error (job->h, "zygote_init: out of memory");
+        goto error;
+    }
+    zj->job = job;
+    zj->rank = idset_first (ranks);
+
+    /*  If J was not fetched, the shell falls back to job-info.
+     */
+    if (job->J) {
+        if (!(zj->info_f = jobinfo_store_shell_info (job,
+                                                     blobref,
+                                                     sizeof (blobref)))
+            || json_object_set_new (zj->env,
+                                    "FLUX_JOB_INFO_BLOBREF",
+                                    json_string (blobref)) < 0) {
+            flux_log_error (job->h, "zygote_init: jobinfo_store_shell_info");
+            goto error;
+        }
+    }
+    job->data = zj;
+    return 1;
+error:
+    zygote_job_destroy (zj);
+    return -1;
+}
+
+static int zygote_start (struct jobinfo *job)
+{
+    struct zygote_job *zj = job->data;
+    struct zygote *z;
+
+    if (!(z = zygote_get (zygote_ctx, zj->rank))) {
+        jobinfo_fatal_error (job,
+                             errno,
+                             "failed to start job shell zygote on rank %u",
+                             zj->rank);
+        return -1;
+    }
+    if (zhashx_insert (z->jobs, &job->id, zj) < 0) {
+        errno = EEXIST;
+        return -1;
+    }
+    zj->z = z;
+    if (!z->running) {
+        if (!(zj->handle = zlistx_add_end (z->pending, zj))) {
+            zhashx_delete (z->jobs, &job->id);
+            zj->z = NULL;
+            errno = ENOMEM;
+            return -1;
+        }
+        return 0;
+    }
+    if (zygote_job_send (zj) < 0) {
+        zhashx_delete (z->jobs, &job->id);
+        zj->z = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+static int zygote_kill (struct jobinfo *job, int signum)
+{
+    struct zygote_job *zj = job->data;
+
+    if (!zj || !zj->z || !zj->z->running || !zj->sent || zj->complete)
+        return 0;
+    if (zygote_write (zj->z, json_pack ("{s:s s:I s:i}",
+                                        "type", "kill",
+                                        "id", job->id,
+                                        "signal", signum)) < 0) {
+        flux_log_error (job->h, "%s: zygote_kill", idf58 (job->id));
+        return -1;
+    }
+    return 0;
+}
+
+/*  Cancel a job that has not been sent to its zygote yet.
+ */
+static int zygote_cancel (struct jobinfo *job)
+{
+    struct zygote_job *zj = job->data;
+
+    if (zj && zj->z && !zj->sent)
+        zygote_job_complete (zj, 0);
+    return 0;
+}
+
+static void zygote_exit (struct jobinfo *job)
+{
+    struct zygote_job *zj = job->data;
+
+    if (zj && zj->z) {
+        if (zj->handle)
+            zlistx_delete (zj->z->pending, zj->handle);
+        zhashx_delete (zj->z->jobs, &job->id);
+    }
+    zygote_job_destroy (zj);
+    job->data = NULL;
+}
+
+static json_t *zygote_stats (struct jobinfo *job)
+{
+    struct zygote_job *zj;
+    bool active;
+    char rank[16];
+
+    if (!job)
+        return NULL;
+    zj = job->data;
+    active = zj->sent && !zj->complete;
+    snprintf (rank, sizeof (rank), "%u", zj->rank);
+    return json_pack ("{s:i s:i s:s}",
+                      "total_shells", 1,
+                      "active_shells", active ? 1 : 0,
+                      "active_ranks", active ? rank : "");
+}
+
+static struct idset *zygote_active_ranks (struct jobinfo *job)
+{
+    struct zygote_job *zj = job ? job->data : NULL;
+    struct idset *ids;
+
+    if (!zj || !(ids = idset_create (0, IDSET_FLAG_AUTOGROW)))
+        return NULL;
+    if (zj->sent && !zj->complete && idset_set (ids, zj->rank) < 0) {
+        idset_destroy (ids);
+        return NULL;
+    }
+    return ids;
+}
+
+static void zygote_ctx_destroy (struct zygote_ctx *ctx)
+{
+    if (ctx) {
+        int saved_errno = errno;
+        zhashx_destroy (&ctx->zygotes);
+        free (ctx);
+        errno = saved_errno;
+    }
+}
+
+static struct zygote_ctx *zygote_ctx_create (flux_t *h)
+{
+    struct zygote_ctx *ctx;
+
+    if (!(ctx = calloc (1, sizeof (*ctx))))
+        return NULL;
+    ctx->h = h;
+    if (!(ctx->zygotes = zhashx_new ())) {
+        zygote_ctx_destroy (ctx);
+        errno = ENOMEM;
+        return NULL;
+    }
+    zhashx_set_destructor (ctx->zygotes, zygote_destructor);
+    return ctx;
+}
+
+static int zygote_config (flux_t *h,
+                          const flux_conf_t *conf,
+                          int argc,
+                          char **argv,
+                          flux_error_t *errp)
+{
+    if (!zygote_ctx && !(zygote_ctx = zygote_ctx_create (h)))
+        return -1;
+    return 0;
+}
+
+static void zygote_unload (void)
+{
+    zygote_ctx_destroy (zygote_ctx);
+    // Ensure a reload will not re-use a freed value
+    zygote_ctx = NULL;
+}
+
+struct exec_implementation zygoteexec = {
+    .name =     "zygote",
+    .config =   zygote_config,
+    .unload =   zygote_unload,
+    .init =     zygote_init,
+    .exit =     zygote_exit,
+    .start =    zygote_start,
+    .kill =     zygote_kill,
+    .cancel =   zygote_cancel,
+    .stats =    zygote_stats,
+    .active_ranks = zygote_active_ranks,
+};
+
+/* vi: ts=4 sw=4 expandtab
+ */
@@ -11,6 +11,7 @@
 #if HAVE_CONFIG_H
 #include "config.h"
 #endif
+#include <jansson.h>
 #include <flux/core.h>
 
 #include "src/common/libczmqcontainers/czmq_containers.h"
@@ -33,6 +34,24 @@ static void disconnect_cb (flux_t *h,
     update_watchers_cancel (ctx, msg, false);
 }
 
+static void purge_cb (flux_t *h,
+                      flux_msg_handler_t *mh,
+                      const flux_msg_t *msg,
+                      void *arg)
+{
+    struct info_ctx *ctx = arg;
+    json_t *jobs;
+    size_t index;
+    json_t *entry;
+
+    if (flux_event_unpack (msg, NULL, "{s:o}", "jobs", &jobs) < 0) {
+        flux_log_error (h, "job-purge-inactive message");
+        return;
+    }
+    json_array_foreach (jobs, index, entry)
+        lookup_cache_remove (ctx, json_integer_value (entry));
+}
+
 static void stats_cb (flux_t *h,
                       flux_msg_handler_t *mh,
                       const flux_msg_t *msg,
@@ -46,12 +65,16 @@ static void stats_cb (flux_t *h,
     int update_watchers = update_watch_count (ctx);
     if (flux_respond_pack (h,
                            msg,
-                           "{s:i s:i s:i s:i s:i}",
+                           "{s:i s:i s:i s:i s:i s:{s:i s:I s:i}}",
                            "lookups", lookups,
                            "watchers", watchers,
                            "guest_watchers", guest_watchers,
                            "update_lookups", update_lookups,
-                           "update_watchers", update_watchers) < 0) {
+                           "update_watchers", update_watchers,
+                           "lookup_cache",
+                             "size", lru_cache_size (ctx->lookup_lru),
+                             "bytes", (json_int_t)ctx->lookup_cache_bytes,
+                             "hits", ctx->lookup_cache_hits) < 0) {
         flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
         goto error;
     }
@@ -103,6 +126,11 @@ static const struct flux_msg_handler_spec htab[] = {
       .cb           = stats_cb,
       .rolemask     = 0
     },
+    { .typemask     = FLUX_MSGTYPE_EVENT,
+      .topic_glob   = "job-purge-inactive",
+      .cb           = purge_cb,
+      .rolemask     = 0
+    },
     FLUX_MSGHANDLER_TABLE_END,
 };
 
@@ -111,7 +139,10 @@ static void info_ctx_destroy (struct info_ctx *ctx)
     if (ctx) {
         int saved_errno = errno;
         flux_msg_handler_delvec (ctx->handlers);
-        lru_cache_destroy (ctx->owner_lru);
+        if (ctx->owner_lru)
+            lru_cache_destroy (ctx->owner_lru);
+        if (ctx->lookup_lru)
+            lru_cache_destroy (ctx->lookup_lru);
         /* freefn set on lookup entries will destroy list entries */
         if (ctx->lookups)
             zlist_destroy (&ctx->lookups);
@@ -140,11 +171,16 @@ static struct info_ctx *info_ctx_create (flux_t *h)
     if (!ctx)
         return NULL;
     ctx->h = h;
+    if (flux_event_subscribe (h, "job-purge-inactive") < 0)
+        goto error;
     if (flux_msg_handler_addvec (h, htab, ctx, &ctx->handlers) < 0)
         goto error;
     if (!(ctx->owner_lru = lru_cache_create (OWNER_LRU_MAXSIZE)))
         goto error;
     lru_cache_set_free_f (ctx->owner_lru, (lru_cache_free_f)free);
+    if (!(ctx->lookup_lru = lru_cache_create (LOOKUP_LRU_MAXSIZE)))
+        goto error;
+    lru_cache_set_free_f (ctx->lookup_lru, lookup_cache_entry_destroy);
     if (!(ctx->lookups = zlist_new ()))
         goto error;
     if (!(ctx->watchers = zlist_new ()))
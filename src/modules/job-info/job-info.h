@@ -18,11 +18,16 @@
 #include "src/common/libutil/lru_cache.h"
 
 #define OWNER_LRU_MAXSIZE 1000
+#define LOOKUP_LRU_MAXSIZE 1000
+#define LOOKUP_LRU_MAXBYTES (16*1024*1024)
 
 struct info_ctx {
     flux_t *h;
     flux_msg_handler_t **handlers;
     lru_cache_t *owner_lru; /* jobid -> owner LRU */
+    lru_cache_t *lookup_lru; /* jobid -> inactive job lookup results LRU */
+    size_t lookup_cache_bytes; /* total size of values in lookup_lru */
+    int lookup_cache_hits;
     zlist_t *lookups;
     zlist_t *watchers;
     zlist_t *guest_watchers;
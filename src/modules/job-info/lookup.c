@@ -21,6 +21,7 @@
 #include "src/common/libeventlog/eventlog.h"
 #include "src/common/libjob/idf58.h"
 #include "src/common/libutil/errprintf.h"
+#include "src/common/libutil/lru_cache.h"
 #include "ccan/str/str.h"
 
 #include "job-info.h"
@@ -40,8 +41,181 @@ struct lookup_ctx {
     bool allow;
 };
 
+/* Cached lookup results for an inactive job.  Once a job is inactive
+ * its KVS directory no longer changes, so values may be returned
+ * without a KVS lookup until the job is purged.  Each key is cached
+ * as it is looked up.  R and jobspec with updates applied
+ * (FLUX_JOB_LOOKUP_CURRENT) are cached separately from the original
+ * values.  'size' is the total length of the cached values, which is
+ * limited across all entries to LOOKUP_LRU_MAXBYTES.
+ */
+struct lookup_cache_entry {
+    struct info_ctx *ctx;
+    json_t *values;
+    json_t *current;
+    size_t size;
+};
+
 static void info_lookup_continuation (flux_future_t *fall, void *arg);
 
+void lookup_cache_entry_destroy (void *data)
+{
+    struct lookup_cache_entry *entry = data;
+
+    if (entry) {
+        int saved_errno = errno;
+        entry->ctx->lookup_cache_bytes -= entry->size;
+        json_decref (entry->values);
+        json_decref (entry->current);
+        free (entry);
+        errno = saved_errno;
+    }
+}
+
+static struct lookup_cache_entry *lookup_cache_entry_create (
+    struct info_ctx *ctx)
+{
+    struct lookup_cache_entry *entry;
+
+    if (!(entry = calloc (1, sizeof (*entry))))
+        return NULL;
+    entry->ctx = ctx;
+    if (!(entry->values = json_object ())
+        || !(entry->current = json_object ())) {
+        lookup_cache_entry_destroy (entry);
+        errno = ENOMEM;
+        return NULL;
+    }
+    return entry;
+}
+
+static struct lookup_cache_entry *lookup_cache_get (struct info_ctx *ctx,
+                                                    flux_jobid_t id)
+{
+    char key[64];
+
+    snprintf (key, sizeof (key), "%ju", (uintmax_t)id);
+    return lru_cache_get (ctx->lookup_lru, key);
+}
+
+static struct lookup_cache_entry *lookup_cache_add (struct info_ctx *ctx,
+                                                    flux_jobid_t id)
+{
+    struct lookup_cache_entry *entry;
+    char key[64];
+
+    snprintf (key, sizeof (key), "%ju", (uintmax_t)id);
+    if (!(entry = lookup_cache_entry_create (ctx)))
+        return NULL;
+    if (lru_cache_put (ctx->lookup_lru, key, entry) < 0) {
+        lookup_cache_entry_destroy (entry);
+        return NULL;
+    }
+    return entry;
+}
+
+void lookup_cache_remove (struct info_ctx *ctx, flux_jobid_t id)
+{
+    char key[64];
+
+    snprintf (key, sizeof (key), "%ju", (uintmax_t)id);
+    (void)lru_cache_remove (ctx->lookup_lru, key);
+}
+
+/* Return the cache object holding 'key' for a lookup with 'flags'.
+ */
+static json_t *lookup_cache_values (struct lookup_cache_entry *entry,
+                                    int flags,
+                                    const char *key)
+{
+    if ((flags & FLUX_JOB_LOOKUP_CURRENT)
+        && (streq (key, "R") || streq (key, "jobspec")))
+        return entry->current;
+    return entry->values;
+}
+
+/* Cache value 's' of 'key' in 'entry', then evict least recently used
+ * entries until the cache is within LOOKUP_LRU_MAXBYTES.  'entry' was
+ * just used, so it is at the front of the LRU list and is not evicted.
+ */
+static void lookup_cache_store (struct lookup_cache_entry *entry,
+                                int flags,
+                                const char *key,
+                                const char *s)
+{
+    struct info_ctx *ctx = entry->ctx;
+    json_t *values = lookup_cache_values (entry, flags, key);
+    size_t len = strlen (s);
+    json_t *o;
+
+    if (len > LOOKUP_LRU_MAXBYTES || json_object_get (values, key))
+        return;
+    if (!(o = json_string (s)) || json_object_set_new (values, key, o) < 0) {
+        json_decref (o);
+        return;
+    }
+    entry->size += len;
+    ctx->lookup_cache_bytes += len;
+    while (ctx->lookup_cache_bytes > LOOKUP_LRU_MAXBYTES
+           && lru_cache_size (ctx->lookup_lru) > 1) {
+        if (lru_cache_evict (ctx->lookup_lru) < 0)
+            break;
+    }
+}
+
+/* A job is inactive once the "clean" event is posted to its eventlog.
+ */
+static bool eventlog_is_inactive (const char *s)
+{
+    json_t *eventlog;
+    json_t *entry;
+    const char *name;
+    bool inactive = false;
+
+    if (!(eventlog = eventlog_decode (s)))
+        return false;
+    if ((entry = json_array_get (eventlog,
+                                 json_array_size (eventlog) - 1))
+        && eventlog_entry_parse (entry, NULL, &name, NULL) == 0
+        && streq (name, "clean"))
+        inactive = true;
+    json_decref (eventlog);
+    return inactive;
+}
+
+/* Return the cache entry lookup results should be stored in, or NULL
+ * if the job is not known to be inactive.
+ */
+static struct lookup_cache_entry *lookup_cache_prepare (struct lookup_ctx *l,
+                                                        flux_future_t *fall)
+{
+    struct lookup_cache_entry *entry;
+    flux_future_t *f;
+    const char *s;
+
+    if ((entry = lookup_cache_get (l->ctx, l->id)))
+        return entry;
+    if (!(f = flux_future_get_child (fall, "eventlog"))
+        || flux_kvs_lookup_get (f, &s) < 0
+        || !s
+        || !eventlog_is_inactive (s))
+        return NULL;
+    return lookup_cache_add (l->ctx, l->id);
+}
+
+/* Convert value 's' of 'key' for the lookup response.
+ */
+static json_t *lookup_value (int flags, const char *key, const char *s)
+{
+    if ((flags & FLUX_JOB_LOOKUP_JSON_DECODE)
+        && (streq (key, "jobspec") || streq (key, "R"))) {
+        /* We assume if it was stored in the KVS it's valid JSON,
+         * so failure is ENOMEM */
+        return json_loads (s, 0, NULL);
+    }
+    return json_string (s);
+}
+
 static void lookup_ctx_destroy (void *data)
 {
     struct lookup_ctx *ctx = data;
@@ -227,6 +401,7 @@ static void info_lookup_continuation (flux_future_t *fall, void *arg)
     json_t *key;
     json_t *o = NULL;
     json_t *tmp = NULL;
+    struct lookup_cache_entry *entry;
     flux_error_t error;
 
     if (!l->allow) {
@@ -258,6 +433,8 @@ static void info_lookup_continuation (flux_future_t *fall, void *arg)
         l->allow = true;
     }
 
+    entry = lookup_cache_prepare (l, fall);
+
     if (!(o = json_object ())
         || !(tmp = json_integer (l->id))
         || json_object_set_new (o, "id", tmp) < 0) {
@@ -306,16 +483,12 @@ static void info_lookup_continuation (flux_future_t *fall, void *arg)
             s = current_value;
         }
 
+        if (entry)
+            lookup_cache_store (entry, l->flags, keystr, s);
+
         /* check for JSON_DECODE flag last, as changes above could affect
          * desired value */
-        if ((l->flags & FLUX_JOB_LOOKUP_JSON_DECODE)
-            && (streq (keystr, "jobspec") || streq (keystr, "R"))) {
-            /* We assume if it was stored in the KVS it's valid JSON,
-             * so failure is ENOMEM */
-            val = json_loads (s, 0, NULL);
-        }
-        else
-            val = json_string (s);
+        val = lookup_value (l->flags, keystr, s);
         if (!val || json_object_set_new (o, keystr, val) < 0) {
             json_decref (val);
             errprintf (&error, "%s: error adding value to response", keystr);
@@ -352,9 +525,15 @@ done:
 /* If we need the eventlog for an allow check or for update-lookup
  * we need to add it to the key lookup list.
  */
+/* The eventlog is needed to authorize the request, to apply updates to
+ * R and jobspec, or to find out if the job is inactive so that results
+ * may be cached.
+ */
 static void check_to_lookup_eventlog (struct lookup_ctx *l)
 {
-    if (!l->allow || (l->flags & FLUX_JOB_LOOKUP_CURRENT)) {
+    if (!l->allow
+        || (l->flags & FLUX_JOB_LOOKUP_CURRENT)
+        || !lookup_cache_get (l->ctx, l->id)) {
         size_t index;
         json_t *key;
         json_array_foreach (l->keys, index, key) {
@@ -465,6 +644,56 @@ cleanup:
     return rv;
 }
 
+/* returns -1 on error, 1 on cached response returned, 0 on no cache */
+static int lookup_cached_inactive (struct lookup_ctx *l)
+{
+    struct lookup_cache_entry *entry;
+    size_t index;
+    json_t *key;
+    json_t *o = NULL;
+    int rv = -1;
+
+    /* An "allow" KVS lookup is still required if the job owner is not
+     * cached, so the cache is only consulted after authorization.
+     */
+    if (!l->allow || !(entry = lookup_cache_get (l->ctx, l->id)))
+        return 0;
+
+    json_array_foreach (l->keys, index, key) {
+        const char *keystr = json_string_value (key);
+        json_t *values = lookup_cache_values (entry, l->flags, keystr);
+        if (!json_object_get (values, keystr))
+            return 0;
+    }
+
+    if (!(o = json_pack ("{s:I}", "id", l->id)))
+        goto nomem;
+    json_array_foreach (l->keys, index, key) {
+        const char *keystr = json_string_value (key);
+        json_t *values = lookup_cache_values (entry, l->flags, keystr);
+        const char *s = json_string_value (json_object_get (values, keystr));
+        json_t *val;
+
+        if (!(val = lookup_value (l->flags, keystr, s))
+            || json_object_set_new (o, keystr, val) < 0) {
+            json_decref (val);
+            goto nomem;
+        }
+    }
+    if (flux_respond_pack (l->ctx->h, l->msg, "O", o) < 0) {
+        flux_log_error (l->ctx->h, "%s: flux_respond", __FUNCTION__);
+        goto cleanup;
+    }
+    l->ctx->lookup_cache_hits++;
+    rv = 1;
+    goto cleanup;
+nomem:
+    errno = ENOMEM;
+cleanup:
+    json_decref (o);
+    return rv;
+}
+
 static int lookup (flux_t *h,
                    const flux_msg_t *msg,
                    struct info_ctx *ctx,
@@ -501,6 +730,18 @@ static int lookup (flux_t *h,
             break;
     }
 
+    if ((ret = lookup_cached_inactive (l)) < 0) {
+        errprintf (error,
+                   "internal error attempting to use lookup cache: %s",
+                   strerror (errno));
+        goto error;
+    }
+
+    if (ret) {
+        lookup_ctx_destroy (l);
+        return 0;
+    }
+
     if ((ret = lookup_cached (l)) < 0) {
         errprintf (error,
                    "internal error attempting to use update-watch cache: %s",
@@ -13,6 +13,8 @@
 
 #include <flux/core.h>
 
+#include "job-info.h"
+
 void lookup_cb (flux_t *h,
                 flux_msg_handler_t *mh,
                 const flux_msg_t *msg,
@@ -24,6 +26,13 @@ void update_lookup_cb (flux_t *h,
                        const flux_msg_t *msg,
                        void *arg);
 
+/* Lookup results for inactive jobs are immutable and are cached in
+ * ctx->lookup_lru.  Entries must be removed when the job is purged.
+ */
+void lookup_cache_remove (struct info_ctx *ctx, flux_jobid_t id);
+
+void lookup_cache_entry_destroy (void *data);
+
 #endif /* ! _FLUX_JOB_INFO_LOOKUP_H */
 
 /*
@@ -0,0 +1,581 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* aggregate.c - count and sum jobs grouped by attribute */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <jansson.h>
+#include <flux/core.h>
+
+#include "src/common/libutil/errprintf.h"
+#include "src/common/libczmqcontainers/czmq_containers.h"
+#include "ccan/array_size/array_size.h"
+#include "ccan/str/str.h"
+
+#include "job-list.h"
+#include "job_data.h"
+#include "job_index.h"
+#include "match.h"
+#include "state_match.h"
+#include "aggregate.h"
+
+enum group_type {
+    GROUP_INT,
+    GROUP_BOOL,
+    GROUP_STRING,
+};
+
+enum group_attr {
+    GROUP_USERID,
+    GROUP_URGENCY,
+    GROUP_STATE,
+    GROUP_RESULT,
+    GROUP_SUCCESS,
+    GROUP_NAME,
+    GROUP_QUEUE,
+    GROUP_PROJECT,
+    GROUP_BANK,
+    GROUP_EXCEPTION_TYPE,
+};
+
+static const struct {
+    const char *name;
+    enum group_type type;
+} group_attrs[] = {
+    [GROUP_USERID] = { "userid", GROUP_INT },
+    [GROUP_URGENCY] = { "urgency", GROUP_INT },
+    [GROUP_STATE] = { "state", GROUP_INT },
+    [GROUP_RESULT] = { "result", GROUP_INT },
+    [GROUP_SUCCESS] = { "success", GROUP_BOOL },
+    [GROUP_NAME] = { "name", GROUP_STRING },
+    [GROUP_QUEUE] = { "queue", GROUP_STRING },
+    [GROUP_PROJECT] = { "project", GROUP_STRING },
+    [GROUP_BANK] = { "bank", GROUP_STRING },
+    [GROUP_EXCEPTION_TYPE] = { "exception_type", GROUP_STRING },
+};
+
+enum sum_attr {
+    SUM_NNODES,
+    SUM_NCORES,
+    SUM_NTASKS,
+    SUM_DURATION,
+    SUM_RUNTIME,
+    SUM_ATTR_COUNT,
+};
+
+static const struct {
+    const char *name;
+    bool integer;
+} sum_attrs[] = {
+    [SUM_NNODES] = { "nnodes", true },
+    [SUM_NCORES] = { "ncores", true },
+    [SUM_NTASKS] = { "ntasks", true },
+    [SUM_DURATION] = { "duration", false },
+    [SUM_RUNTIME] = { "runtime", false },
+};
+
+struct group {
+    json_t *value;
+    int count;
+    double sum[SUM_ATTR_COUNT];
+};
+
+struct aggregate {
+    enum group_attr group_by;
+    enum sum_attr sums[SUM_ATTR_COUNT];
+    int nsums;
+    double now;
+    zhashx_t *groups;
+    struct group *null_group;   /* jobs without a group_by value */
+};
+
+static void group_destroy (struct group *g)
+{
+    if (g) {
+        int saved_errno = errno;
+        json_decref (g->value);
+        free (g);
+        errno = saved_errno;
+    }
+}
+
+/* zhashx_destructor_fn */
+static void group_destructor (void **item)
+{
+    if (item) {
+        group_destroy (*item);
+        *item = NULL;
+    }
+}
+
+static struct group *group_create (json_t *value)
+{
+    struct group *g;
+
+    if (!value || !(g = calloc (1, sizeof (*g)))) {
+        json_decref (value);
+        errno = ENOMEM;
+        return NULL;
+    }
+    g->value = value;
+    return g;
+}
+
+static int lookup_group_attr (const char *name, enum group_attr *attr)
+{
+    for (size_t i = 0; i < ARRAY_SIZE (group_attrs); i++) {
+        if (streq (name, group_attrs[i].name)) {
+            *attr = i;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static int lookup_sum_attr (const char *name, enum sum_attr *attr)
+{
+    for (size_t i = 0; i < ARRAY_SIZE (sum_attrs); i++) {
+        if (streq (name, sum_attrs[i].name)) {
+            *attr = i;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/* Get the group_by value of 'job' as an integer or string.  Returns
+ * false if the job has no value, e.g. the result of an active job.
+ */
+static bool group_value (enum group_attr attr,
+                         const struct job *job,
+                         json_int_t *ival,
+                         const char **sval)
+{
+    bool inactive = (job->state == FLUX_JOB_STATE_INACTIVE);
+
+    switch (attr) {
+        case GROUP_USERID:
+            *ival = job->userid;
+            return true;
+        case GROUP_URGENCY:
+            *ival = job->urgency;
+            return true;
+        case GROUP_STATE:
+            *ival = job->state;
+            return true;
+        case GROUP_RESULT:
+            *ival = job->result;
+            return inactive;
+        case GROUP_SUCCESS:
+            *ival = job->success;
+            return inactive;
+        case GROUP_NAME:
+            *sval = job->name;
+            break;
+        case GROUP_QUEUE:
+            *sval = job->queue;
+            break;
+        case GROUP_PROJECT:
+            *sval = job->project;
+            break;
+        case GROUP_BANK:
+            *sval = job->bank;
+            break;
+        case GROUP_EXCEPTION_TYPE:
+            if (!job->exception_occurred)
+                return false;
+            *sval = job->exception_type;
+            break;
+    }
+    return *sval != NULL;
+}
+
+/* Find or create the group for 'job'.
+ */
+static struct group *get_group (struct aggregate *agg, const struct job *job)
+{
+    enum group_type type = group_attrs[agg->group_by].type;
+    json_int_t ival = 0;
+    const char *sval = NULL;
+    char buf[32];
+    const char *key;
+    struct group *g;
+
+    if (!group_value (agg->group_by, job, &ival, &sval)) {
+        if (!agg->null_group)
+            agg->null_group = group_create (json_null ());
+        return agg->null_group;
+    }
+    if (type == GROUP_STRING)
+        key = sval;
+    else {
+        snprintf (buf, sizeof (buf), "%jd", (intmax_t)ival);
+        key = buf;
+    }
+    if (!(g = zhashx_lookup (agg->groups, key))) {
+        json_t *value;
+        if (type == GROUP_STRING)
+            value = json_string (sval);
+        else if (type == GROUP_BOOL)
+            value = json_boolean (ival);
+        else
+            value = json_integer (ival);
+        if (!(g = group_create (value)))
+            return NULL;
+        (void)zhashx_insert (agg->groups, key, g);
+    }
+    return g;
+}
+
+/* job_data.c sets attributes that are not yet known to -1, e.g. nnodes
+ * of a job canceled before it was allocated resources.  Count them as 0.
+ */
+static double sum_unset_zero (double value)
+{
+    return value > 0. ? value : 0.;
+}
+
+static double sum_value (enum sum_attr attr,
+                         const struct job *job,
+                         double now)
+{
+    switch (attr) {
+        case SUM_NNODES:
+            return sum_unset_zero (job->nnodes);
+        case SUM_NCORES:
+            return sum_unset_zero (job->ncores);
+        case SUM_NTASKS:
+            return sum_unset_zero (job->ntasks);
+        case SUM_DURATION:
+            return sum_unset_zero (job->duration);
+        case SUM_RUNTIME:
+            /* same as JobInfo.runtime in the python bindings */
+            if (job->t_run > 0.) {
+                if (job->t_cleanup > 0.)
+                    return job->t_cleanup - job->t_run;
+                return now - job->t_run;
+            }
+            return 0.;
+        case SUM_ATTR_COUNT:
+            break;
+    }
+    return 0.;
+}
+
+static int aggregate_job (struct aggregate *agg, const struct job *job)
+{
+    struct group *g;
+
+    if (!(g = get_group (agg, job)))
+        return -1;
+    g->count++;
+    for (int i = 0; i < agg->nsums; i++) {
+        enum sum_attr attr = agg->sums[i];
+        g->sum[attr] += sum_value (attr, job, agg->now);
+    }
+    return 0;
+}
+
+/* Add jobs on 'list' matching 'c' to 'agg'.  As in get_jobs_from_list(),
+ * the inactive list is sorted by t_inactive so the scan stops at the
+ * first job inactive at or before 'since'.
+ */
+static int aggregate_list (struct aggregate *agg,
+                           flux_error_t *errp,
+                           zlistx_t *list,
+                           double since,
+                           struct list_constraint *c)
+{
+    struct job *job;
+
+    job = zlistx_first (list);
+    while (job) {
+        int ret;
+
+        if (job->t_inactive > 0. && job->t_inactive <= since)
+            break;
+        if ((ret = job_match (job, c, errp)) < 0)
+            return -1;
+        if (ret && aggregate_job (agg, job) < 0) {
+            errprintf (errp, "out of memory");
+            return -1;
+        }
+        job = zlistx_next (list);
+    }
+    return 0;
+}
+
+/* list_constraint_estimate_f */
+static size_t index_estimate (enum job_index_type type,
+                              const void *value,
+                              void *arg)
+{
+    struct job_state_ctx *jsctx = arg;
+    return job_index_count (jsctx->indexes[type], value);
+}
+
+static int aggregate_jobs (struct job_state_ctx *jsctx,
+                           flux_error_t *errp,
+                           struct aggregate *agg,
+                           double since,
+                           struct list_constraint *c,
+                           struct state_constraint *statec)
+{
+    struct {
+        int state;
+        enum job_index_list which;
+        zlistx_t *full;
+    } lists[] = {
+        { FLUX_JOB_STATE_PENDING, JOB_INDEX_PENDING, jsctx->pending },
+        { FLUX_JOB_STATE_RUNNING, JOB_INDEX_RUNNING, jsctx->running },
+        { FLUX_JOB_STATE_INACTIVE, JOB_INDEX_INACTIVE, jsctx->inactive },
+    };
+    struct job_index *idx = NULL;
+    enum job_index_type type;
+    const void *value = NULL;
+    int ret;
+
+    /* As in get_jobs(), scan only the jobs in a secondary index if the
+     * constraint selects a single user or queue.
+     */
+    if ((ret = list_constraint_plan (c,
+                                     index_estimate,
+                                     jsctx,
+                                     &type,
+                                     &value)) < 0) {
+        errprintf (errp, "error planning constraint");
+        return -1;
+    }
+    if (ret)
+        idx = jsctx->indexes[type];
+
+    for (size_t i = 0; i < ARRAY_SIZE (lists); i++) {
+        zlistx_t *list;
+
+        if (!state_match (lists[i].state, statec))
+            continue;
+        if (idx)
+            list = job_index_list (idx, value, lists[i].which);
+        else
+            list = lists[i].full;
+        if (list
+            && aggregate_list (agg,
+                               errp,
+                               list,
+                               lists[i].state == FLUX_JOB_STATE_INACTIVE
+                                   ? since : 0.,
+                               c) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+static json_t *group_to_json (struct aggregate *agg, struct group *g)
+{
+    json_t *sum;
+    json_t *o;
+
+    if (!(sum = json_object ()))
+        goto nomem;
+    for (int i = 0; i < agg->nsums; i++) {
+        enum sum_attr attr = agg->sums[i];
+        json_t *val;
+
+        if (sum_attrs[attr].integer)
+            val = json_integer ((json_int_t)g->sum[attr]);
+        else
+            val = json_real (g->sum[attr]);
+        if (!val || json_object_set_new (sum, sum_attrs[attr].name, val) < 0) {
+            json_decref (val);
+            json_decref (sum);
+            goto nomem;
+        }
+    }
+    if (!(o = json_pack ("{s:O s:i s:o}",
+                         "value", g->value,
+                         "count", g->count,
+                         "sum", sum)))
+        goto nomem;
+    return o;
+nomem:
+    errno = ENOMEM;
+    return NULL;
+}
+
+static json_t *aggregate_to_json (struct aggregate *agg)
+{
+    json_t *groups;
+    struct group *g;
+
+    if (!(groups = json_array ()))
+        goto nomem;
+    g = zhashx_first (agg->groups);
+    while (g) {
+        json_t *o;
+        if (!(o = group_to_json (agg, g))
+            || json_array_append_new (groups, o) < 0) {
+            json_decref (o);
+            goto nomem;
+        }
+        g = zhashx_next (agg->groups);
+    }
+    if (agg->null_group) {
+        json_t *o;
+        if (!(o = group_to_json (agg, agg->null_group))
+            || json_array_append_new (groups, o) < 0) {
+            json_decref (o);
+            goto nomem;
+        }
+    }
+    return groups;
+nomem:
+    json_decref (groups);
+    errno = ENOMEM;
+    return NULL;
+}
+
+static int aggregate_parse_sums (struct aggregate *agg,
+                                 json_t *sum,
+                                 flux_error_t *errp)
+{
+    size_t index;
+    json_t *entry;
+
+    if (!sum)
+        return 0;
+    if (!json_is_array (sum)) {
+        errprintf (errp, "invalid payload: sum must be an array");
+        goto inval;
+    }
+    json_array_foreach (sum, index, entry) {
+        const char *name = json_string_value (entry);
+        enum sum_attr attr;
+
+        if (!name || lookup_sum_attr (name, &attr) < 0) {
+            errprintf (errp,
+                       "invalid payload: cannot sum attribute %s",
+                       name ? name : "(non-string)");
+            goto inval;
+        }
+        for (int i = 0; i < agg->nsums; i++) {
+            if (agg->sums[i] == attr) {
+                errprintf (errp,
+                           "invalid payload: duplicate sum attribute %s",
+                           name);
+                goto inval;
+            }
+        }
+        agg->sums[agg->nsums++] = attr;
+    }
+    return 0;
+inval:
+    errno = EPROTO;
+    return -1;
+}
+
+void aggregate_cb (flux_t *h,
+                   flux_msg_handler_t *mh,
+                   const flux_msg_t *msg,
+                   void *arg)
+{
+    struct list_ctx *ctx = arg;
+    flux_error_t err;
+    flux_error_t error;
+    const char *group_by;
+    json_t *sum = NULL;
+    double since = 0.;
+    json_t *constraint = NULL;
+    struct aggregate agg = { .nsums = 0 };
+    struct list_constraint *c = NULL;
+    struct state_constraint *statec = NULL;
+    json_t *groups;
+
+    if (!ctx->jsctx->initialized) {
+        if (flux_msglist_append (ctx->deferred_requests, msg) < 0)
+            goto error;
+        return;
+    }
+    if (flux_request_unpack (msg,
+                             NULL,
+                             "{s:s s?o s?F s?o}",
+                             "group_by", &group_by,
+                             "sum", &sum,
+                             "since", &since,
+                             "constraint", &constraint) < 0) {
+        errprintf (&err, "invalid payload: %s", flux_msg_last_error (msg));
+        errno = EPROTO;
+        goto error;
+    }
+    if (lookup_group_attr (group_by, &agg.group_by) < 0) {
+        errprintf (&err,
+                   "invalid payload: cannot group by attribute %s",
+                   group_by);
+        errno = EPROTO;
+        goto error;
+    }
+    if (aggregate_parse_sums (&agg, sum, &err) < 0)
+        goto error;
+    if (since < 0.) {
+        errprintf (&err, "invalid payload: since < 0.0 not allowed");
+        errno = EPROTO;
+        goto error;
+    }
+    if (!(c = list_constraint_create (ctx->mctx, constraint, &error))) {
+        errprintf (&err,
+                   "invalid payload: constraint object invalid: %s",
+                   error.text);
+        errno = EPROTO;
+        goto error;
+    }
+    if (!(statec = state_constraint_create (constraint, &error))) {
+        errprintf (&err,
+                   "invalid payload: constraint object invalid: %s",
+                   error.text);
+        errno = EPROTO;
+        goto error;
+    }
+    if (!(agg.groups = zhashx_new ())) {
+        errprintf (&err, "out of memory");
+        errno = ENOMEM;
+        goto error;
+    }
+    zhashx_set_destructor (agg.groups, group_destructor);
+    agg.now = flux_reactor_now (flux_get_reactor (h));
+
+    if (aggregate_jobs (ctx->jsctx, &err, &agg, since, c, statec) < 0)
+        goto error;
+    if (!(groups = aggregate_to_json (&agg))) {
+        errprintf (&err, "out of memory");
+        goto error;
+    }
+    if (flux_respond_pack (h, msg, "{s:o}", "groups", groups) < 0)
+        flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+
+    zhashx_destroy (&agg.groups);
+    group_destroy (agg.null_group);
+    list_constraint_destroy (c);
+    state_constraint_destroy (statec);
+    return;
+
+error:
+    if (flux_respond_error (h, msg, errno, err.text) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    zhashx_destroy (&agg.groups);
+    group_destroy (agg.null_group);
+    list_constraint_destroy (c);
+    state_constraint_destroy (statec);
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,40 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _FLUX_JOB_LIST_AGGREGATE_H
+#define _FLUX_JOB_LIST_AGGREGATE_H
+
+#include <flux/core.h>
+
+/* job-list.aggregate - count jobs grouped by an attribute.
+ *
+ * The request takes the same "constraint" and "since" fields as
+ * job-list.list, plus
+ *
+ *   "group_by":s  - attribute to group jobs by
+ *   "sum":[s,...] - optional numeric attributes to sum in each group
+ *
+ * and responds with
+ *
+ *   {"groups":[{"value":o "count":i "sum":{...}}, ...]}
+ *
+ * where "value" is the group_by attribute value, or null for jobs
+ * where it is not set.  Groups are returned in no particular order.
+ */
+void aggregate_cb (flux_t *h,
+                   flux_msg_handler_t *mh,
+                   const flux_msg_t *msg,
+                   void *arg);
+
+#endif /* ! _FLUX_JOB_LIST_AGGREGATE_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
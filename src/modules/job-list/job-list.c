@@ -21,6 +21,7 @@
 #include "list.h"
 #include "idsync.h"
 #include "stats.h"
+#include "aggregate.h"
 
 static const char *attrs[] = {
     "userid", "urgency", "priority", "t_submit",
@@ -58,7 +59,8 @@ static void stats_cb (flux_t *h,
     int idsync_lookups = zlistx_size (ctx->isctx->lookups);
     int idsync_waits = zhashx_size (ctx->isctx->waits);
     int stats_watchers = job_stats_watchers (ctx->jsctx->statsctx);
-    if (flux_respond_pack (h, msg, "{s:{s:i s:i s:i} s:{s:i s:i} s:i}",
+    int strings = strtab_size (ctx->jsctx->strtab);
+    if (flux_respond_pack (h, msg, "{s:{s:i s:i s:i} s:{s:i s:i} s:i s:i}",
                            "jobs",
                            "pending", pending,
                            "running", running,
@@ -66,7 +68,8 @@ static void stats_cb (flux_t *h,
                            "idsync",
                            "lookups", idsync_lookups,
                            "waits", idsync_waits,
-                           "stats_watchers", stats_watchers) < 0)
+                           "stats_watchers", stats_watchers,
+                           "interned_strings", strings) < 0)
         flux_log_error (h, "error responding to stats-get request");
     return;
 error:
@@ -95,6 +98,8 @@ static void purge_cb (flux_t *h,
             if (job->state != FLUX_JOB_STATE_INACTIVE)
                 continue;
             job_stats_purge (ctx->jsctx->statsctx, job);
+            watch_job_removed (ctx->wctx, job);
+            job_state_remove_indexes (ctx->jsctx, job);
             if (job->list_handle)
                 zlistx_delete (ctx->jsctx->inactive, job->list_handle);
             zhashx_delete (ctx->jsctx->index, &id);
@@ -122,6 +127,7 @@ static void disconnect_cb (flux_t *h,
 {
     struct list_ctx *ctx = arg;
     job_stats_disconnect (ctx->jsctx->statsctx, msg);
+    watch_disconnect (ctx->wctx, msg);
 }
 
 static void config_reload_cb (flux_t *h,
@@ -163,6 +169,11 @@ static const struct flux_msg_handler_spec htab[] = {
       .cb           = list_id_cb,
       .rolemask     = FLUX_ROLE_USER
     },
+    { .typemask     = FLUX_MSGTYPE_REQUEST,
+      .topic_glob   = "job-list.aggregate",
+      .cb           = aggregate_cb,
+      .rolemask     = FLUX_ROLE_USER
+    },
     { .typemask     = FLUX_MSGTYPE_REQUEST,
       .topic_glob   = "job-list.list-attrs",
       .cb           = list_attrs_cb,
@@ -207,6 +218,7 @@ static void list_ctx_destroy (struct list_ctx *ctx)
     if (ctx) {
         int saved_errno = errno;
         flux_msg_handler_delvec (ctx->handlers);
+        watch_ctx_destroy (ctx->wctx);
         flux_msglist_destroy (ctx->deferred_requests);
         if (ctx->jsctx)
             job_state_destroy (ctx->jsctx);
@@ -237,6 +249,8 @@ static struct list_ctx *list_ctx_create (flux_t *h)
         goto error;
     if (!(ctx->mctx = match_ctx_create (ctx->h)))
         goto error;
+    if (!(ctx->wctx = watch_ctx_create (ctx)))
+        goto error;
     return ctx;
 error:
     list_ctx_destroy (ctx);
@@ -42,6 +42,13 @@ void job_destroy (void *data)
         json_decref (job->jobspec);
         json_decref (job->R);
         json_decref (job->exception_context);
+        if (job->strtab) {
+            strtab_release (job->strtab, job->name);
+            strtab_release (job->strtab, job->queue);
+            strtab_release (job->strtab, job->cwd);
+            strtab_release (job->strtab, job->project);
+            strtab_release (job->strtab, job->bank);
+        }
         free (job);
         errno = save_errno;
     }
@@ -546,6 +553,59 @@ int job_R_update (struct job *job, json_t *updates)
     return parse_R (job, false);
 }
 
+static int intern (struct strtab *st, const char *s, const char **result)
+{
+    if (!s)
+        *result = NULL;
+    else if (!(*result = strtab_intern (st, s)))
+        return -1;
+    return 0;
+}
+
+int job_compact (struct job *job, struct strtab *st)
+{
+    const char *name = NULL;
+    const char *queue = NULL;
+    const char *cwd = NULL;
+    const char *project = NULL;
+    const char *bank = NULL;
+
+    if (!job || !st) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (job->strtab)
+        return 0;
+    if (intern (st, job->name, &name) < 0
+        || intern (st, job->queue, &queue) < 0
+        || intern (st, job->cwd, &cwd) < 0
+        || intern (st, job->project, &project) < 0
+        || intern (st, job->bank, &bank) < 0)
+        goto error;
+    job->name = name;
+    job->queue = queue;
+    job->cwd = cwd;
+    job->project = project;
+    job->bank = bank;
+    job->strtab = st;
+
+    /* The above fields pointed into jobspec, so it may now be freed.
+     * Fields parsed from R are already copied.
+     */
+    json_decref (job->jobspec);
+    job->jobspec = NULL;
+    json_decref (job->R);
+    job->R = NULL;
+    return 0;
+error:
+    strtab_release (st, name);
+    strtab_release (st, queue);
+    strtab_release (st, cwd);
+    strtab_release (st, project);
+    strtab_release (st, bank);
+    return -1;
+}
+
 /*
  * vi:tabstop=4 shiftwidth=4 expandtab
  */
@@ -19,6 +19,11 @@
 #include "src/common/libutil/grudgeset.h"
 #include "src/common/libczmqcontainers/czmq_containers.h"
 
+#include "strtab.h"
+
+/* number of secondary indexes, see job_index.h */
+#define JOB_INDEX_COUNT 2
+
 /* timestamp of when we enter the state
  *
  * associated eventlog entries when restarting
@@ -82,7 +87,19 @@ struct job {
     unsigned int states_events_mask;
     void *list_handle;
 
+    /* position in job_state_ctx secondary indexes (see job_index.h) */
+    struct job_index_ref {
+        void *bucket;
+        void *handle;
+        int list;
+    } index_refs[JOB_INDEX_COUNT];
+
     int submit_version;         /* version number in submit context */
+
+    /* Set once the job is compacted (see job_compact()).  Strings
+     * parsed from jobspec are then interned in this table.
+     */
+    struct strtab *strtab;
 };
 
 void job_destroy (void *data);
@@ -133,6 +150,14 @@ int job_parse_R_fatal (struct job *job, const char *s, json_t *updates);
  */
 int job_R_update (struct job *job, json_t *updates);
 
+/* Release memory that is no longer needed once a job is inactive.
+ * Strings parsed from jobspec (name, queue, cwd, project, bank) are
+ * interned in 'st', which must outlive the job, and the cached
+ * jobspec and R objects are freed.  Jobspec and R updates may no
+ * longer be applied to a compacted job.
+ */
+int job_compact (struct job *job, struct strtab *st);
+
 #endif /* ! _FLUX_JOB_LIST_JOB_DATA_H */
 
 /*
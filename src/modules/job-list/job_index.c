@@ -0,0 +1,261 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* job_index.c - secondary indexes on job lists */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <flux/core.h>
+
+#include "src/common/libczmqcontainers/czmq_containers.h"
+#include "ccan/str/str.h"
+
+#include "job_index.h"
+
+struct index_bucket {
+    char *key;
+    zlistx_t *lists[JOB_INDEX_NLISTS];
+    size_t count;
+};
+
+struct job_index {
+    enum job_index_type type;
+    zhashx_t *buckets;
+    zlistx_comparator_fn *cmp[JOB_INDEX_NLISTS];
+};
+
+/* Keys are strings, userids are converted to decimal.
+ */
+#define KEY_BUFSIZE 16
+
+static const char *value_to_key (struct job_index *idx,
+                                 const void *value,
+                                 char *buf)
+{
+    if (!value)
+        return NULL;
+    if (idx->type == JOB_INDEX_USERID) {
+        uint32_t userid = *(const uint32_t *)value;
+        if (userid == FLUX_USERID_UNKNOWN)
+            return NULL;
+        snprintf (buf, KEY_BUFSIZE, "%u", (unsigned int)userid);
+        return buf;
+    }
+    return value;
+}
+
+static const char *job_to_key (struct job_index *idx,
+                               const struct job *job,
+                               char *buf)
+{
+    if (idx->type == JOB_INDEX_USERID)
+        return value_to_key (idx, &job->userid, buf);
+    return value_to_key (idx, job->queue, buf);
+}
+
+static void bucket_destroy (struct index_bucket *b)
+{
+    if (b) {
+        int saved_errno = errno;
+        for (int i = 0; i < JOB_INDEX_NLISTS; i++)
+            zlistx_destroy (&b->lists[i]);
+        free (b->key);
+        free (b);
+        errno = saved_errno;
+    }
+}
+
+/* zhashx_destructor_fn */
+static void bucket_destructor (void **item)
+{
+    if (item) {
+        bucket_destroy (*item);
+        *item = NULL;
+    }
+}
+
+static struct index_bucket *bucket_create (struct job_index *idx,
+                                           const char *key)
+{
+    struct index_bucket *b;
+
+    if (!(b = calloc (1, sizeof (*b))))
+        return NULL;
+    if (!(b->key = strdup (key)))
+        goto error;
+    for (int i = 0; i < JOB_INDEX_NLISTS; i++) {
+        if (!(b->lists[i] = zlistx_new ()))
+            goto error;
+        zlistx_set_comparator (b->lists[i], idx->cmp[i]);
+    }
+    return b;
+error:
+    bucket_destroy (b);
+    errno = ENOMEM;
+    return NULL;
+}
+
+int job_index_insert (struct job_index *idx,
+                      struct job *job,
+                      enum job_index_list list,
+                      bool low_value)
+{
+    struct job_index_ref *ref;
+    struct index_bucket *b;
+    char buf[KEY_BUFSIZE];
+    const char *key;
+    void *handle;
+
+    if (!idx || !job || list >= JOB_INDEX_NLISTS) {
+        errno = EINVAL;
+        return -1;
+    }
+    ref = &job->index_refs[idx->type];
+    if (ref->bucket) {
+        errno = EEXIST;
+        return -1;
+    }
+    if (!(key = job_to_key (idx, job, buf)))
+        return 0;
+    if (!(b = zhashx_lookup (idx->buckets, key))) {
+        if (!(b = bucket_create (idx, key)))
+            return -1;
+        (void)zhashx_insert (idx->buckets, key, b);
+    }
+    if (!(handle = zlistx_insert (b->lists[list], job, low_value))) {
+        if (b->count == 0)
+            zhashx_delete (idx->buckets, key);
+        errno = ENOMEM;
+        return -1;
+    }
+    b->count++;
+    ref->bucket = b;
+    ref->handle = handle;
+    ref->list = list;
+    return 0;
+}
+
+void job_index_remove (struct job_index *idx, struct job *job)
+{
+    struct job_index_ref *ref;
+    struct index_bucket *b;
+
+    if (!idx || !job)
+        return;
+    ref = &job->index_refs[idx->type];
+    if (!(b = ref->bucket))
+        return;
+    zlistx_detach (b->lists[ref->list], ref->handle);
+    if (--b->count == 0)
+        zhashx_delete (idx->buckets, b->key);
+    ref->bucket = NULL;
+    ref->handle = NULL;
+}
+
+void job_index_reorder (struct job_index *idx, struct job *job, bool low_value)
+{
+    struct job_index_ref *ref;
+    struct index_bucket *b;
+
+    if (!idx || !job)
+        return;
+    ref = &job->index_refs[idx->type];
+    if ((b = ref->bucket))
+        zlistx_reorder (b->lists[ref->list], ref->handle, low_value);
+}
+
+int job_index_rekey (struct job_index *idx,
+                     struct job *job,
+                     enum job_index_list list,
+                     bool low_value)
+{
+    struct job_index_ref *ref;
+    struct index_bucket *b;
+    char buf[KEY_BUFSIZE];
+    const char *key;
+
+    if (!idx || !job) {
+        errno = EINVAL;
+        return -1;
+    }
+    ref = &job->index_refs[idx->type];
+    key = job_to_key (idx, job, buf);
+    if ((b = ref->bucket) && key && streq (key, b->key))
+        return 0;
+    job_index_remove (idx, job);
+    return job_index_insert (idx, job, list, low_value);
+}
+
+size_t job_index_count (struct job_index *idx, const void *value)
+{
+    struct index_bucket *b;
+    char buf[KEY_BUFSIZE];
+    const char *key;
+
+    if (!idx
+        || !(key = value_to_key (idx, value, buf))
+        || !(b = zhashx_lookup (idx->buckets, key)))
+        return 0;
+    return b->count;
+}
+
+zlistx_t *job_index_list (struct job_index *idx,
+                          const void *value,
+                          enum job_index_list list)
+{
+    struct index_bucket *b;
+    char buf[KEY_BUFSIZE];
+    const char *key;
+
+    if (!idx
+        || list >= JOB_INDEX_NLISTS
+        || !(key = value_to_key (idx, value, buf))
+        || !(b = zhashx_lookup (idx->buckets, key)))
+        return NULL;
+    return b->lists[list];
+}
+
+void job_index_destroy (struct job_index *idx)
+{
+    if (idx) {
+        int saved_errno = errno;
+        zhashx_destroy (&idx->buckets);
+        free (idx);
+        errno = saved_errno;
+    }
+}
+
+struct job_index *job_index_create (enum job_index_type type,
+                                    zlistx_comparator_fn *cmp[])
+{
+    struct job_index *idx;
+
+    if (!(idx = calloc (1, sizeof (*idx))))
+        return NULL;
+    idx->type = type;
+    for (int i = 0; i < JOB_INDEX_NLISTS; i++)
+        idx->cmp[i] = cmp[i];
+    if (!(idx->buckets = zhashx_new ())) {
+        job_index_destroy (idx);
+        errno = ENOMEM;
+        return NULL;
+    }
+    zhashx_set_destructor (idx->buckets, bucket_destructor);
+    return idx;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,84 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef HAVE_JOB_LIST_JOB_INDEX_H
+#define HAVE_JOB_LIST_JOB_INDEX_H 1
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "src/common/libczmqcontainers/czmq_containers.h"
+
+#include "job_data.h"
+
+/* Secondary indexes on the job lists.
+ *
+ * An index partitions jobs by key (userid or queue).  Each key has
+ * its own pending, running, and inactive lists, sorted with the same
+ * comparators as the main lists in job_state_ctx, so that walking an
+ * index list returns jobs in the same order as walking the main list
+ * and skipping non-matching jobs.  job_state.c keeps the indexes in
+ * sync with every insert, reorder, and removal on the main lists.
+ */
+
+enum job_index_type {
+    JOB_INDEX_USERID = 0,
+    JOB_INDEX_QUEUE = 1,
+};
+
+enum job_index_list {
+    JOB_INDEX_PENDING = 0,
+    JOB_INDEX_RUNNING = 1,
+    JOB_INDEX_INACTIVE = 2,
+    JOB_INDEX_NLISTS = 3,
+};
+
+struct job_index *job_index_create (enum job_index_type type,
+                                    zlistx_comparator_fn *cmp[]);
+
+void job_index_destroy (struct job_index *idx);
+
+/* Add 'job' to index list 'list'.  Jobs without a key (e.g. no queue)
+ * are not indexed.  'low_value' is passed to zlistx_insert().
+ */
+int job_index_insert (struct job_index *idx,
+                      struct job *job,
+                      enum job_index_list list,
+                      bool low_value);
+
+void job_index_remove (struct job_index *idx, struct job *job);
+
+void job_index_reorder (struct job_index *idx, struct job *job, bool low_value);
+
+/* Move 'job' to index list 'list' under its current key, if the key
+ * has changed since it was inserted (e.g. queue changed by a
+ * jobspec-update).
+ */
+int job_index_rekey (struct job_index *idx,
+                     struct job *job,
+                     enum job_index_list list,
+                     bool low_value);
+
+/* Look up by key value, which is a uint32_t * for JOB_INDEX_USERID or
+ * a string for JOB_INDEX_QUEUE.  job_index_list() returns NULL if no
+ * jobs have the key.
+ */
+size_t job_index_count (struct job_index *idx, const void *value);
+
+zlistx_t *job_index_list (struct job_index *idx,
+                          const void *value,
+                          enum job_index_list list);
+
+#endif /* !HAVE_JOB_LIST_JOB_INDEX_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -104,12 +104,19 @@ static int job_running_cmp (const void *a1, const void *a2)
     return NUMCMP (j2->t_run, j1->t_run);
 }
 
+/* Inactive jobs are further ordered by job id (lower id first) so that
+ * the order is total and a job-list.list cursor of (t_inactive, id)
+ * identifies a unique position.
+ */
 static int job_inactive_cmp (const void *a1, const void *a2)
 {
     const struct job *j1 = a1;
     const struct job *j2 = a2;
+    int rc;
 
-    return NUMCMP (j2->t_inactive, j1->t_inactive);
+    if ((rc = NUMCMP (j2->t_inactive, j1->t_inactive)) == 0)
+        rc = NUMCMP (j1->id, j2->id);
+    return rc;
 }
 
 static void job_destroy_wrapper (void **data)
@@ -156,6 +163,32 @@ static void update_job_state (struct job_state_ctx *jsctx,
     job->states_mask |= job->state;
 }
 
+static int indexes_insert (struct job_state_ctx *jsctx,
+                           struct job *job,
+                           enum job_index_list list,
+                           bool low_value)
+{
+    for (int i = 0; i < JOB_INDEX_COUNT; i++) {
+        if (job_index_insert (jsctx->indexes[i], job, list, low_value) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+static void indexes_reorder (struct job_state_ctx *jsctx,
+                             struct job *job,
+                             bool low_value)
+{
+    for (int i = 0; i < JOB_INDEX_COUNT; i++)
+        job_index_reorder (jsctx->indexes[i], job, low_value);
+}
+
+void job_state_remove_indexes (struct job_state_ctx *jsctx, struct job *job)
+{
+    for (int i = 0; i < JOB_INDEX_COUNT; i++)
+        job_index_remove (jsctx->indexes[i], job);
+}
+
 static int job_insert_list (struct job_state_ctx *jsctx,
                             struct job *job,
                             flux_job_state_t newstate)
@@ -167,15 +200,24 @@ static int job_insert_list (struct job_state_ctx *jsctx,
                                                 job,
                                                 search_direction (job))))
             goto enomem;
+        if (indexes_insert (jsctx,
+                            job,
+                            JOB_INDEX_PENDING,
+                            search_direction (job)) < 0)
+            return -1;
     }
     else if (newstate == FLUX_JOB_STATE_RUN
              || newstate == FLUX_JOB_STATE_CLEANUP) {
         if (!(job->list_handle = zlistx_insert (jsctx->running, job, true)))
             goto enomem;
+        if (indexes_insert (jsctx, job, JOB_INDEX_RUNNING, true) < 0)
+            return -1;
     }
     else { /* newstate == FLUX_JOB_STATE_INACTIVE */
         if (!(job->list_handle = zlistx_insert (jsctx->inactive, job, true)))
             goto enomem;
+        if (indexes_insert (jsctx, job, JOB_INDEX_INACTIVE, true) < 0)
+            return -1;
     }
 
     return 0;
@@ -198,6 +240,7 @@ static void job_change_list (struct job_state_ctx *jsctx,
                   "%s: zlistx_detach: out of memory",
                   __FUNCTION__);
     job->list_handle = NULL;
+    job_state_remove_indexes (jsctx, job);
 
     if (job_insert_list (jsctx, job, newstate) < 0)
         flux_log_error (jsctx->h,
@@ -242,10 +285,12 @@ static void update_job_state_and_list (struct job_state_ctx *jsctx,
     if (oldlist != newlist)
         job_change_list (jsctx, job, oldlist, newstate);
     else if (oldlist == jsctx->pending
-             && newstate == FLUX_JOB_STATE_SCHED)
+             && newstate == FLUX_JOB_STATE_SCHED) {
         zlistx_reorder (jsctx->pending,
                         job->list_handle,
                         search_direction (job));
+        indexes_reorder (jsctx, job, search_direction (job));
+    }
 
     idsync_check_waiting_id (jsctx->ctx->isctx, job);
 }
@@ -314,6 +359,15 @@ static void process_state_transition_update (struct job_state_ctx *jsctx,
             eventlog_inactive_complete (job);
 
         update_job_state_and_list (jsctx, job, state, timestamp);
+
+        /* Inactive jobs may be retained for a long time, shrink them.
+         */
+        if (state == FLUX_JOB_STATE_INACTIVE
+            && job_compact (job, jsctx->strtab) < 0) {
+            flux_log_error (jsctx->h,
+                            "%s: error compacting inactive job",
+                            idf58 (job->id));
+        }
     }
 }
 
@@ -342,6 +396,18 @@ static void update_jobspec (struct job_state_ctx *jsctx,
 
     if (update_stats)
         job_stats_add_queue (jsctx->statsctx, job);
+
+    /* likewise, move the job to its new queue in the queue index
+     */
+    if (job->state & FLUX_JOB_STATE_PENDING) {
+        if (job_index_rekey (jsctx->indexes[JOB_INDEX_QUEUE],
+                             job,
+                             JOB_INDEX_PENDING,
+                             search_direction (job)) < 0)
+            flux_log_error (jsctx->h,
+                            "%s: error updating queue index",
+                            idf58 (job->id));
+    }
 }
 
 static void update_resource (struct job_state_ctx *jsctx,
@@ -541,10 +607,12 @@ static int journal_priority_event (struct job_state_ctx *jsctx,
         return -1;
 
     if (job->state & FLUX_JOB_STATE_PENDING
-        && job->priority != orig_priority)
+        && job->priority != orig_priority) {
         zlistx_reorder (jsctx->pending,
                         job->list_handle,
                         search_direction (job));
+        indexes_reorder (jsctx, job, search_direction (job));
+    }
 
     return job_transition_state (jsctx,
                                  job,
@@ -1005,6 +1073,7 @@ static int journal_process_events (struct job_state_ctx *jsctx,
     json_t *value;
     json_t *jobspec = NULL;
     json_t *R = NULL;
+    struct job *job;
 
     if (flux_msg_unpack (msg,
                         "{s:I s:o s?o s?o}",
@@ -1022,6 +1091,11 @@ static int journal_process_events (struct job_state_ctx *jsctx,
             return -1;
     }
 
+    /* Notify job-list.watch subscribers once per batch of events.
+     */
+    if ((job = zhashx_lookup (jsctx->index, &id)))
+        watch_job_changed (jsctx->ctx->wctx, job);
+
     return 0;
 }
 
@@ -1114,6 +1188,11 @@ error:
 struct job_state_ctx *job_state_create (struct list_ctx *ctx)
 {
     struct job_state_ctx *jsctx = NULL;
+    zlistx_comparator_fn *cmps[JOB_INDEX_NLISTS] = {
+        job_urgency_cmp,
+        job_running_cmp,
+        job_inactive_cmp,
+    };
 
     if (!(jsctx = calloc (1, sizeof (*jsctx)))) {
         flux_log_error (ctx->h, "calloc");
@@ -1143,9 +1222,20 @@ struct job_state_ctx *job_state_create (struct list_ctx *ctx)
         goto error;
     zlistx_set_comparator (jsctx->inactive, job_inactive_cmp);
 
+    /* Secondary indexes mirror the pending, running, and inactive lists
+     * per userid and per queue, so they share the same comparators.
+     */
+    for (int i = 0; i < JOB_INDEX_COUNT; i++) {
+        if (!(jsctx->indexes[i] = job_index_create (i, cmps)))
+            goto error;
+    }
+
     if (!(jsctx->processing = zlistx_new ()))
         goto error;
 
+    if (!(jsctx->strtab = strtab_create ()))
+        goto error;
+
     if (!(jsctx->statsctx = job_stats_ctx_create (jsctx->h)))
         goto error;
 
@@ -1173,7 +1263,10 @@ void job_state_destroy (void *data)
         zlistx_destroy (&jsctx->inactive);
         zlistx_destroy (&jsctx->running);
         zlistx_destroy (&jsctx->pending);
+        for (int i = 0; i < JOB_INDEX_COUNT; i++)
+            job_index_destroy (jsctx->indexes[i]);
         zhashx_destroy (&jsctx->index);
+        strtab_destroy (jsctx->strtab);
         job_stats_ctx_destroy (jsctx->statsctx);
         flux_msglist_destroy (jsctx->backlog);
         flux_future_destroy (jsctx->events);
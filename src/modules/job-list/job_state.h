@@ -18,6 +18,8 @@
 
 #include "idsync.h"
 #include "stats.h"
+#include "job_index.h"
+#include "strtab.h"
 
 /* To handle the common case of user queries on job state, we will
  * store jobs in three different lists.
@@ -34,6 +36,10 @@
  *
  * There is also an additional list `processing` that stores jobs that
  * cannot yet be stored on one of the lists above.
+ *
+ * The three lists are also partitioned by userid and by queue in
+ * secondary indexes, so that queries constrained to a single user
+ * or queue need not walk every job.
  */
 
 struct job_state_ctx {
@@ -45,6 +51,10 @@ struct job_state_ctx {
     zlistx_t *running;
     zlistx_t *inactive;
     zlistx_t *processing;
+    struct job_index *indexes[JOB_INDEX_COUNT];
+
+    /* strings interned by inactive jobs, see job_compact() */
+    struct strtab *strtab;
 
     /*  Job statistics: */
     struct job_stats_ctx *statsctx;
@@ -69,6 +79,10 @@ void job_state_pause_cb (flux_t *h, flux_msg_handler_t *mh,
 void job_state_unpause_cb (flux_t *h, flux_msg_handler_t *mh,
                            const flux_msg_t *msg, void *arg);
 
+/* Remove 'job' from all secondary indexes, e.g. before it is purged.
+ */
+void job_state_remove_indexes (struct job_state_ctx *jsctx, struct job *job);
+
 int job_state_config_reload (struct job_state_ctx *jsctx,
                              const flux_conf_t *conf,
                              flux_error_t *errp);
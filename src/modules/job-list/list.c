@@ -38,16 +38,94 @@ json_t *get_job_by_id (struct job_state_ctx *jsctx,
                        flux_job_state_t state,
                        bool *stall);
 
+/* Default number of jobs per response in a streaming job-list.list.
+ */
+#define LIST_CHUNK_SIZE_DEFAULT 256
+
+/* Resume point for a job listing.  Inactive jobs are totally ordered
+ * by (t_inactive, id), so a cursor on the inactive list remains valid
+ * as jobs are added or purged.  A cursor on an active job resumes after
+ * that job's current position, if it is still active.
+ */
+struct list_cursor {
+    flux_jobid_t id;
+    double t_inactive;
+};
+
+/* Output state for get_jobs().  In streaming mode, jobs are sent to
+ * the requestor in chunks of 'chunk_size' as they are found, so memory
+ * use is bounded by the chunk size and not the number of jobs listed.
+ */
+struct list_output {
+    flux_t *h;
+    const flux_msg_t *msg;      /* streaming request, or NULL */
+    int chunk_size;
+    int max_entries;
+    int count;                  /* total jobs output */
+    json_t *jobs;               /* current chunk */
+    struct list_cursor last;    /* cursor of last job output */
+};
+
+static json_t *cursor_to_json (const struct list_cursor *cursor)
+{
+    return json_pack ("{s:I s:f}",
+                      "id", (json_int_t)cursor->id,
+                      "t_inactive", cursor->t_inactive);
+}
+
+/* Send the current chunk to the requestor and start a new one.
+ * Every streaming response carries a cursor.  Clients treat a response
+ * without one as the only response of a job-list that does not support
+ * streaming, which never sends ENODATA.
+ */
+static int list_output_flush (struct list_output *out)
+{
+    json_t *cursor;
+    json_t *jobs;
+
+    if (json_array_size (out->jobs) == 0)
+        return 0;
+    if (!(cursor = cursor_to_json (&out->last))
+        || !(jobs = json_array ())) {
+        json_decref (cursor);
+        errno = ENOMEM;
+        return -1;
+    }
+    if (flux_respond_pack (out->h,
+                           out->msg,
+                           "{s:O s:o}",
+                           "jobs", out->jobs,
+                           "cursor", cursor) < 0)
+        flux_log_error (out->h, "%s: flux_respond_pack", __FUNCTION__);
+    json_decref (out->jobs);
+    out->jobs = jobs;
+    return 0;
+}
+
+/* Return true if 'job' is at or before 'cursor' on the inactive list.
+ */
+static bool inactive_before_cursor (const struct job *job,
+                                    const struct list_cursor *cursor)
+{
+    if (job->t_inactive != cursor->t_inactive)
+        return job->t_inactive > cursor->t_inactive;
+    return job->id <= cursor->id;
+}
+
 /* Put jobs from list onto jobs array, breaking if max_entries has
- * been reached. Returns 1 if jobs array is full, 0 if continue, -1
+ * been reached.  If 'after' is non-NULL, start with the job that
+ * follows it.  If 'cursor' is non-NULL, it must be a position on the
+ * inactive list (t_inactive > 0), and inactive jobs at or before it
+ * are skipped.  Returns 1 if jobs array is full, 0 if continue, -1
  * one error with errno set:
  *
  * ENOMEM - out of memory
  */
-int get_jobs_from_list (json_t *jobs,
+int get_jobs_from_list (struct list_output *out,
                         flux_error_t *errp,
                         zlistx_t *list,
-                        int max_entries,
+                        struct job *after,
+                        const struct list_cursor *cursor,
                         json_t *attrs,
                         double since,
                         struct list_constraint *c)
@@ -55,6 +133,12 @@ int get_jobs_from_list (json_t *jobs,
     struct job *job;
 
     job = zlistx_first (list);
+    if (after) {
+        while (job && job != after)
+            job = zlistx_next (list);
+        if (job)
+            job = zlistx_next (list);
+    }
     while (job) {
         int ret;
 
@@ -69,19 +153,34 @@ int get_jobs_from_list (json_t *jobs,
         if (job->t_inactive > 0. && job->t_inactive <= since)
             break;
 
+        if (cursor
+            && job->t_inactive > 0.
+            && inactive_before_cursor (job, cursor)) {
+            job = zlistx_next (list);
+            continue;
+        }
+
         if ((ret = job_match (job, c, errp)) < 0)
             return -1;
         if (ret) {
             json_t *o;
             if (!(o = job_to_json (job, attrs, errp)))
                 return -1;
-            if (json_array_append_new (jobs, o) < 0) {
+            if (json_array_append_new (out->jobs, o) < 0) {
                 json_decref (o);
                 errno = ENOMEM;
                 return -1;
             }
-            if (json_array_size (jobs) == max_entries)
+            out->last.id = job->id;
+            out->last.t_inactive = job->t_inactive;
+            if (++out->count == out->max_entries)
                 return 1;
+            if (out->msg
+                && json_array_size (out->jobs) == out->chunk_size
+                && list_output_flush (out) < 0) {
+                errprintf (errp, "out of memory");
+                return -1;
+            }
         }
         job = zlistx_next (list);
     }
@@ -89,78 +188,169 @@ int get_jobs_from_list (json_t *jobs,
     return 0;
 }
 
-/* Create a JSON array of 'job' objects.  'max_entries' determines the
- * max number of jobs to return, 0=unlimited. 'since' limits jobs returned
- * to those with t_inactive greater than timestamp.  Returns JSON object
- * which the caller must free.  On error, return NULL with errno set:
+/* list_constraint_estimate_f */
+static size_t index_estimate (enum job_index_type type,
+                              const void *value,
+                              void *arg)
+{
+    struct job_state_ctx *jsctx = arg;
+    return job_index_count (jsctx->indexes[type], value);
+}
+
+/* Return the list of jobs to scan for 'which', either the full list or
+ * the subset in secondary index 'idx' with key 'value'.  Returns NULL
+ * if the index has no jobs with that key.
+ */
+static zlistx_t *scan_list (struct job_index *idx,
+                            const void *value,
+                            enum job_index_list which,
+                            zlistx_t *full)
+{
+    if (!idx)
+        return full;
+    return job_index_list (idx, value, which);
+}
+
+/* Determine which list to resume on from 'cursor'.  A cursor with
+ * id 0 (an empty cursor object) has no position, so the listing starts
+ * with pending jobs.  If the cursor refers to a job that is still
+ * pending or running, set 'after' to that job.  Otherwise resume on the
+ * inactive list.  'icursor' is set to the position to resume from on
+ * the inactive list, or NULL if the whole inactive list is scanned.
+ */
+static enum job_index_list cursor_start (struct job_state_ctx *jsctx,
+                                         const struct list_cursor *cursor,
+                                         struct job **after,
+                                         struct list_cursor *icursor_buf,
+                                         const struct list_cursor **icursor)
+{
+    struct job *job;
+
+    *after = NULL;
+    *icursor = NULL;
+    if (!cursor || cursor->id == 0)
+        return JOB_INDEX_PENDING;
+    if (cursor->t_inactive > 0.) {
+        *icursor = cursor;
+        return JOB_INDEX_INACTIVE;
+    }
+    if (!(job = zhashx_lookup (jsctx->index, &cursor->id)))
+        return JOB_INDEX_INACTIVE;
+    if (job->state & FLUX_JOB_STATE_PENDING) {
+        *after = job;
+        return JOB_INDEX_PENDING;
+    }
+    if (job->state & FLUX_JOB_STATE_RUNNING) {
+        *after = job;
+        return JOB_INDEX_RUNNING;
+    }
+    /* The job became inactive since the cursor was issued, resume
+     * from its current position on the inactive list.
+     */
+    if (job->t_inactive > 0.) {
+        icursor_buf->id = job->id;
+        icursor_buf->t_inactive = job->t_inactive;
+        *icursor = icursor_buf;
+    }
+    return JOB_INDEX_INACTIVE;
+}
+
+/* Add jobs to 'out'.  'max_entries' determines the max number of jobs
+ * to return, 0=unlimited. 'since' limits jobs returned to those with
+ * t_inactive greater than timestamp.  'cursor', if non-NULL, resumes
+ * a previous listing after the job it identifies.  On error, return -1
+ * with errno set:
  *
  * EPROTO - malformed or empty attrs array, max_entries out of range
  * ENOMEM - out of memory
  */
-json_t *get_jobs (struct job_state_ctx *jsctx,
-                  flux_error_t *errp,
-                  int max_entries,
-                  double since,
-                  json_t *attrs,
-                  struct list_constraint *c,
-                  struct state_constraint *statec)
+int get_jobs (struct job_state_ctx *jsctx,
+              flux_error_t *errp,
+              struct list_output *out,
+              double since,
+              const struct list_cursor *cursor,
+              json_t *attrs,
+              struct list_constraint *c,
+              struct state_constraint *statec)
 {
-    json_t *jobs = NULL;
-    int saved_errno;
+    struct job_index *idx = NULL;
+    enum job_index_type type;
+    enum job_index_list first;
+    struct job *after;
+    struct list_cursor icursor_buf;
+    const struct list_cursor *icursor;
+    const void *value = NULL;
+    zlistx_t *list;
     int ret = 0;
 
-    if (!(jobs = json_array ()))
-        goto error_nomem;
+    /* If the constraint selects a single user or queue, scan only the
+     * jobs in that secondary index.  Index lists are sorted the same
+     * as the full lists, so results are returned in the same order.
+     */
+    if ((ret = list_constraint_plan (c,
+                                     index_estimate,
+                                     jsctx,
+                                     &type,
+                                     &value)) < 0)
+        return -1;
+    if (ret)
+        idx = jsctx->indexes[type];
+    ret = 0;
+
+    first = cursor_start (jsctx, cursor, &after, &icursor_buf, &icursor);
 
     /* We return jobs in the following order, pending, running,
      * inactive */
 
-    if (state_match (FLUX_JOB_STATE_PENDING, statec)) {
-        if ((ret = get_jobs_from_list (jobs,
-                                       errp,
-                                       jsctx->pending,
-                                       max_entries,
-                                       attrs,
-                                       0.,
-                                       c)) < 0)
-            goto error;
+    if (first == JOB_INDEX_PENDING
+        && state_match (FLUX_JOB_STATE_PENDING, statec)) {
+        list = scan_list (idx, value, JOB_INDEX_PENDING, jsctx->pending);
+        if (list) {
+            if ((ret = get_jobs_from_list (out,
+                                           errp,
+                                           list,
+                                           after,
+                                           NULL,
+                                           attrs,
+                                           0.,
+                                           c)) < 0)
+                return -1;
+        }
     }
 
-    if (state_match (FLUX_JOB_STATE_RUNNING, statec)) {
-        if (!ret) {
-            if ((ret = get_jobs_from_list (jobs,
+    if (first <= JOB_INDEX_RUNNING
+        && state_match (FLUX_JOB_STATE_RUNNING, statec)) {
+        list = scan_list (idx, value, JOB_INDEX_RUNNING, jsctx->running);
+        if (!ret && list) {
+            if ((ret = get_jobs_from_list (out,
                                            errp,
-                                           jsctx->running,
-                                           max_entries,
+                                           list,
+                                           first == JOB_INDEX_RUNNING
+                                               ? after : NULL,
+                                           NULL,
                                            attrs,
                                            0.,
                                            c)) < 0)
-                goto error;
+                return -1;
         }
     }
 
     if (state_match (FLUX_JOB_STATE_INACTIVE, statec)) {
-        if (!ret) {
-            if ((ret = get_jobs_from_list (jobs,
+        list = scan_list (idx, value, JOB_INDEX_INACTIVE, jsctx->inactive);
+        if (!ret && list) {
+            if ((ret = get_jobs_from_list (out,
                                            errp,
-                                           jsctx->inactive,
-                                           max_entries,
+                                           list,
+                                           NULL,
+                                           icursor,
                                            attrs,
                                            since,
                                            c)) < 0)
-                goto error;
+                return -1;
         }
     }
 
-    return jobs;
-
-error_nomem:
-    errno = ENOMEM;
-error:
-    saved_errno = errno;
-    json_decref (jobs);
-    errno = saved_errno;
-    return NULL;
+    return 0;
 }
 
 static int legacy_list_rpc (flux_t *h,
@@ -259,12 +449,15 @@ void list_cb (flux_t *h,
 {
     struct list_ctx *ctx = arg;
     flux_error_t err;
-    json_t *jobs;
     json_t *attrs;
     int max_entries;
     double since = 0.;
     json_t *constraint = NULL;
     json_t *legacy_constraint = NULL;
+    json_t *cursor_obj = NULL;
+    int chunk_size = LIST_CHUNK_SIZE_DEFAULT;
+    struct list_cursor cursor = { .id = 0, .t_inactive = 0. };
+    struct list_output out = { .h = h };
     struct list_constraint *c = NULL;
     struct state_constraint *statec = NULL;
     flux_error_t error;
@@ -276,11 +469,13 @@ void list_cb (flux_t *h,
     }
     if (flux_request_unpack (msg,
                              NULL,
-                             "{s:i s:o s?F s?o}",
+                             "{s:i s:o s?F s?o s?o s?i}",
                              "max_entries", &max_entries,
                              "attrs", &attrs,
                              "since", &since,
-                             "constraint", &constraint) < 0) {
+                             "constraint", &constraint,
+                             "cursor", &cursor_obj,
+                             "chunk_size", &chunk_size) < 0) {
         errprintf (&err, "invalid payload: %s", flux_msg_last_error (msg));
         errno = EPROTO;
         goto error;
@@ -320,6 +515,26 @@ void list_cb (flux_t *h,
         errno = EPROTO;
         goto error;
     }
+    if (chunk_size <= 0) {
+        errprintf (&err, "invalid payload: chunk_size must be > 0");
+        errno = EPROTO;
+        goto error;
+    }
+    /* An empty cursor object starts a new listing that reports a cursor.
+     */
+    if (cursor_obj) {
+        json_int_t id = 0;
+        if (json_unpack (cursor_obj,
+                         "{s?I s?F !}",
+                         "id", &id,
+                         "t_inactive", &cursor.t_inactive) < 0
+            || cursor.t_inactive < 0.) {
+            errprintf (&err, "invalid payload: cursor object invalid");
+            errno = EPROTO;
+            goto error;
+        }
+        cursor.id = id;
+    }
     if (!(c = list_constraint_create (ctx->mctx, constraint, &error))) {
         errprintf (&err,
                    "invalid payload: constraint object invalid: %s",
@@ -335,14 +550,58 @@ void list_cb (flux_t *h,
         goto error;
     }
 
-    if (!(jobs = get_jobs (ctx->jsctx, &err, max_entries, since,
-                           attrs, c, statec)))
+    if (!(out.jobs = json_array ())) {
+        errprintf (&err, "out of memory");
+        errno = ENOMEM;
         goto error;
+    }
+    out.max_entries = max_entries;
+    if (flux_msg_is_streaming (msg)) {
+        out.msg = msg;
+        out.chunk_size = chunk_size;
+    }
 
-    if (flux_respond_pack (h, msg, "{s:O}", "jobs", jobs) < 0)
-        flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+    if (get_jobs (ctx->jsctx,
+                  &err,
+                  &out,
+                  since,
+                  cursor_obj ? &cursor : NULL,
+                  attrs,
+                  c,
+                  statec) < 0)
+        goto error;
+
+    /* In streaming mode, send the final partial chunk and terminate
+     * the stream with ENODATA.
+     */
+    if (out.msg) {
+        if (list_output_flush (&out) < 0) {
+            errprintf (&err, "out of memory");
+            goto error;
+        }
+        if (flux_respond_error (h, msg, ENODATA, NULL) < 0)
+            flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    }
+    else if (cursor_obj && out.count > 0) {
+        json_t *o;
+        if (!(o = cursor_to_json (&out.last))) {
+            errprintf (&err, "out of memory");
+            errno = ENOMEM;
+            goto error;
+        }
+        if (flux_respond_pack (h,
+                               msg,
+                               "{s:O s:o}",
+                               "jobs", out.jobs,
+                               "cursor", o) < 0)
+            flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+    }
+    else {
+        if (flux_respond_pack (h, msg, "{s:O}", "jobs", out.jobs) < 0)
+            flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+    }
 
-    json_decref (jobs);
+    json_decref (out.jobs);
     list_constraint_destroy (c);
     state_constraint_destroy (statec);
     json_decref (legacy_constraint);
@@ -351,6 +610,7 @@ void list_cb (flux_t *h,
 error:
     if (flux_respond_error (h, msg, errno, err.text) < 0)
         flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    json_decref (out.jobs);
     list_constraint_destroy (c);
     state_constraint_destroy (statec);
     json_decref (legacy_constraint);
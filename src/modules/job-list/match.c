@@ -33,9 +33,20 @@ struct list_constraint {
     struct match_ctx *mctx;
     zlistx_t *values;
     match_f match;
+    unsigned int cost;          /* relative evaluation cost, see below */
     unsigned int comparisons;   /* total across multiple calls to job_match() */
 };
 
+/* Relative costs of evaluating constraints, used to order the operands
+ * of "and", "or", and "not" so that cheap tests short-circuit expensive
+ * ones.  Bitmask and timestamp tests cost one comparison, list tests
+ * cost one comparison per value, and string comparisons and set tests
+ * cost more.
+ */
+#define COST_SIMPLE     1
+#define COST_STRING     2
+#define COST_SET        16
+
 typedef enum {
     MATCH_T_SUBMIT = 1,
     MATCH_T_DEPEND = 2,
@@ -171,6 +182,7 @@ static struct list_constraint *list_constraint_new (struct match_ctx *mctx,
     }
     c->mctx = mctx;
     c->match = match_cb;
+    c->cost = COST_SIMPLE;
     if (destructor_cb)
         zlistx_set_destructor (c->values, destructor_cb);
     return c;
@@ -235,6 +247,7 @@ static struct list_constraint *create_userid_constraint (struct match_ctx *mctx,
             goto error;
         }
     }
+    c->cost = COST_SIMPLE * zlistx_size (c->values);
     return c;
  error:
     list_constraint_destroy (c);
@@ -266,6 +279,7 @@ static struct list_constraint *create_string_constraint (struct match_ctx *mctx,
             goto error;
         }
     }
+    c->cost = COST_STRING * zlistx_size (c->values);
     return c;
  error:
     list_constraint_destroy (c);
@@ -430,12 +444,61 @@ static struct list_constraint *create_results_constraint (struct match_ctx *mctx
                                       errp);
 }
 
+/* A hostlist constraint is expanded into a hash of hostnames when it
+ * is created, so a job's nodes can be checked against it without
+ * parsing the constraint hostlist again.
+ */
+struct hostlist_value {
+    struct hostlist *hl;
+    zhashx_t *hosts;
+};
+
+static void hostlist_value_destroy (struct hostlist_value *hv)
+{
+    if (hv) {
+        int save_errno = errno;
+        hostlist_destroy (hv->hl);
+        zhashx_destroy (&hv->hosts);
+        free (hv);
+        errno = save_errno;
+    }
+}
+
+/* zlistx_set_destructor */
+static void wrap_hostlist_value_destroy (void **item)
+{
+    if (item) {
+        hostlist_value_destroy (*item);
+        (*item) = NULL;
+    }
+}
+
+static struct hostlist_value *hostlist_value_create (struct hostlist *hl)
+{
+    struct hostlist_value *hv;
+    const char *host;
+
+    if (!(hv = calloc (1, sizeof (*hv)))
+        || !(hv->hosts = zhashx_new ()))
+        goto error;
+    host = hostlist_first (hl);
+    while (host) {
+        (void)zhashx_insert (hv->hosts, host, (void *)1);
+        host = hostlist_next (hl);
+    }
+    hv->hl = hl;
+    return hv;
+error:
+    hostlist_value_destroy (hv);
+    return NULL;
+}
+
 static int match_hostlist (struct list_constraint *c,
                            const struct job *job,
                            unsigned int *comparisons,
                            flux_error_t *errp)
 {
-    struct hostlist *hl = zlistx_first (c->values);
+    struct hostlist_value *hv = zlistx_first (c->values);
     const char *host;
 
     /* nodelist may not exist if job never ran */
@@ -444,30 +507,26 @@ static int match_hostlist (struct list_constraint *c,
     if (!job->nodelist_hl) {
         /* hack to remove const */
         struct job *jobtmp = (struct job *)job;
-        if (!(jobtmp->nodelist_hl = hostlist_decode (job->nodelist)))
-            return 0;
+        if (!(jobtmp->nodelist_hl = hostlist_decode (job->nodelist))) {
+            errprintf (errp,
+                       "failed to decode nodelist of job: %s",
+                       strerror (errno));
+            return -1;
+        }
     }
-    host = hostlist_first (hl);
+    /* Look up each job host in the pre-expanded constraint hash.
+     */
+    host = hostlist_first (job->nodelist_hl);
     while (host) {
         if (inc_check_comparison (c->mctx, comparisons, errp) < 0)
             return -1;
-        if (hostlist_find (job->nodelist_hl, host) >= 0)
+        if (zhashx_lookup (hv->hosts, host))
             return 1;
-        host = hostlist_next (hl);
+        host = hostlist_next (job->nodelist_hl);
     }
     return 0;
 }
 
-/* zlistx_set_destructor */
-static void wrap_hostlist_destroy (void **item)
-{
-    if (item) {
-        struct hostlist *hl = *item;
-        hostlist_destroy (hl);
-        (*item) = NULL;
-    }
-}
-
 static struct list_constraint *create_hostlist_constraint (
     struct match_ctx *mctx,
     json_t *values,
@@ -475,12 +534,13 @@ static struct list_constraint *create_hostlist_constraint (
 {
     struct list_constraint *c;
     struct hostlist *hl = NULL;
+    struct hostlist_value *hv;
     json_t *entry;
     size_t index;
 
     if (!(c = list_constraint_new (mctx,
                                    match_hostlist,
-                                   wrap_hostlist_destroy,
+                                   wrap_hostlist_value_destroy,
                                    errp)))
         return NULL;
     /* Create a single hostlist if user specifies multiple nodes or
@@ -503,10 +563,17 @@ static struct list_constraint *create_hostlist_constraint (
         errprintf (errp, "too many hosts specified");
         goto error;
     }
-    if (!zlistx_add_end (c->values, hl)) {
+    if (!(hv = hostlist_value_create (hl))) {
+        errprintf (errp, "failed to create hostlist structure");
+        goto error;
+    }
+    hl = NULL;
+    if (!zlistx_add_end (c->values, hv)) {
         errprintf (errp, "failed to append hostlist structure");
+        hostlist_value_destroy (hv);
         goto error;
     }
+    c->cost = COST_SET;
     return c;
  error:
     hostlist_destroy (hl);
@@ -595,6 +662,7 @@ static struct list_constraint *create_ranks_constraint (
         errprintf (errp, "failed to append idset structure");
         goto error;
     }
+    c->cost = COST_SET;
     return c;
  error:
     idset_destroy (idset);
@@ -754,6 +822,15 @@ static int match_not (struct list_constraint *c,
     return ret ? 0 : 1;
 }
 
+/* zlistx_comparator_fn */
+static int constraint_cost_cmp (const void *item1, const void *item2)
+{
+    const struct list_constraint *c1 = item1;
+    const struct list_constraint *c2 = item2;
+
+    return (c1->cost > c2->cost) - (c1->cost < c2->cost);
+}
+
 static struct list_constraint *conditional_constraint (struct match_ctx *mctx,
                                                        const char *type,
                                                        json_t *values,
@@ -777,6 +854,7 @@ static struct list_constraint *conditional_constraint (struct match_ctx *mctx,
                                    errp)))
         return NULL;
 
+    c->cost = 0;
     json_array_foreach (values, index, entry) {
         struct list_constraint *cp = list_constraint_create (mctx, entry, errp);
         if (!cp)
@@ -786,7 +864,15 @@ static struct list_constraint *conditional_constraint (struct match_ctx *mctx,
             list_constraint_destroy (cp);
             goto error;
         }
+        c->cost += cp->cost;
     }
+    /* Operands are free of side effects, so evaluate the cheapest
+     * first to short-circuit more expensive ones.
+     */
+    zlistx_set_comparator (c->values, constraint_cost_cmp);
+    zlistx_sort (c->values);
+    if (c->cost == 0)
+        c->cost = COST_SIMPLE;
     return c;
 
  error:
@@ -794,6 +880,74 @@ static struct list_constraint *conditional_constraint (struct match_ctx *mctx,
     return NULL;
 }
 
+/* Consider 'c' as an index candidate.  Only a userid or queue
+ * constraint with exactly one value can be satisfied by an index
+ * lookup alone.
+ */
+static void plan_candidate (struct list_constraint *c,
+                            list_constraint_estimate_f estimate,
+                            void *arg,
+                            enum job_index_type *typep,
+                            const void **valuep,
+                            size_t *countp)
+{
+    enum job_index_type type;
+    const void *value;
+    size_t count;
+
+    if (zlistx_size (c->values) != 1)
+        return;
+    if (c->match == match_userid) {
+        const uint32_t *userid = zlistx_head (c->values);
+        if (*userid == FLUX_USERID_UNKNOWN)
+            return;
+        type = JOB_INDEX_USERID;
+        value = userid;
+    }
+    else if (c->match == match_queue) {
+        type = JOB_INDEX_QUEUE;
+        value = zlistx_head (c->values);
+    }
+    else
+        return;
+    count = estimate (type, value, arg);
+    if (!*valuep || count < *countp) {
+        *typep = type;
+        *valuep = value;
+        *countp = count;
+    }
+}
+
+int list_constraint_plan (struct list_constraint *c,
+                          list_constraint_estimate_f estimate,
+                          void *arg,
+                          enum job_index_type *typep,
+                          const void **valuep)
+{
+    enum job_index_type type = JOB_INDEX_USERID;
+    const void *value = NULL;
+    size_t count = 0;
+
+    if (!c || !estimate || !typep || !valuep) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (c->match == match_and) {
+        void *cursor = zlistx_first (c->values);
+        while (cursor) {
+            plan_candidate (cursor, estimate, arg, &type, &value, &count);
+            cursor = zlistx_next (c->values);
+        }
+    }
+    else
+        plan_candidate (c, estimate, arg, &type, &value, &count);
+    if (!value)
+        return 0;
+    *typep = type;
+    *valuep = value;
+    return 1;
+}
+
 void list_constraint_destroy (struct list_constraint *constraint)
 {
     if (constraint) {
@@ -872,6 +1026,12 @@ int job_match (const struct job *job,
     return constraint->match (constraint, job, &constraint->comparisons, errp);
 }
 
+void list_constraint_reset_comparisons (struct list_constraint *constraint)
+{
+    if (constraint)
+        constraint->comparisons = 0;
+}
+
 static int config_parse_max_comparisons (struct match_ctx *mctx,
                                          const flux_conf_t *conf,
                                          flux_error_t *errp)
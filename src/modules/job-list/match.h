@@ -19,6 +19,7 @@
 #include <jansson.h>
 
 #include "job_data.h"
+#include "job_index.h"
 
 struct match_ctx {
     flux_t *h;
@@ -50,6 +51,36 @@ int job_match (const struct job *job,
                struct list_constraint *constraint,
                flux_error_t *errp);
 
+/*  Reset the comparison count that job_match() accumulates against
+ *  the configured max_comparisons, for constraints that outlive a
+ *  single request (e.g. job-list.watch).
+ */
+void list_constraint_reset_comparisons (struct list_constraint *constraint);
+
+/*  Return an estimate of the number of jobs with key 'value' in
+ *  secondary index 'type', see job_index_count().
+ */
+typedef size_t (*list_constraint_estimate_f) (enum job_index_type type,
+                                              const void *value,
+                                              void *arg);
+
+/*  Choose a secondary index that can narrow the set of jobs that must
+ *  be checked against 'constraint'.  An index is usable if the
+ *  constraint is, or is an "and" with a top-level operand that is, a
+ *  single valued "userid" or "queue" constraint.  If several are
+ *  usable, the one with the smallest estimate is chosen.  Candidate
+ *  jobs must still be checked with job_match().
+ *
+ *  Returns 1 with 'type' and 'value' set if an index should be used,
+ *  0 if all jobs must be scanned, or -1 on error.  'value' is valid
+ *  for the lifetime of 'constraint'.
+ */
+int list_constraint_plan (struct list_constraint *constraint,
+                          list_constraint_estimate_f estimate,
+                          void *arg,
+                          enum job_index_type *type,
+                          const void **value);
+
 int job_match_config_reload (struct match_ctx *mctx,
                              const flux_conf_t *conf,
                              flux_error_t *errp);
@@ -0,0 +1,112 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* strtab.c - reference counted table of interned strings */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "src/common/libczmqcontainers/czmq_containers.h"
+
+#include "strtab.h"
+
+struct strtab_entry {
+    int refcount;
+    char s[];
+};
+
+struct strtab {
+    zhashx_t *entries;  /* hash key is entry->s, entry owns the key */
+};
+
+/* zhashx_destructor_fn */
+static void entry_destructor (void **item)
+{
+    if (item) {
+        free (*item);
+        *item = NULL;
+    }
+}
+
+void strtab_destroy (struct strtab *st)
+{
+    if (st) {
+        int saved_errno = errno;
+        zhashx_destroy (&st->entries);
+        free (st);
+        errno = saved_errno;
+    }
+}
+
+struct strtab *strtab_create (void)
+{
+    struct strtab *st;
+
+    if (!(st = calloc (1, sizeof (*st))))
+        return NULL;
+    if (!(st->entries = zhashx_new ())) {
+        strtab_destroy (st);
+        errno = ENOMEM;
+        return NULL;
+    }
+    zhashx_set_key_duplicator (st->entries, NULL);
+    zhashx_set_key_destructor (st->entries, NULL);
+    zhashx_set_destructor (st->entries, entry_destructor);
+    return st;
+}
+
+const char *strtab_intern (struct strtab *st, const char *s)
+{
+    struct strtab_entry *e;
+    size_t len;
+
+    if (!st || !s) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if ((e = zhashx_lookup (st->entries, s))) {
+        e->refcount++;
+        return e->s;
+    }
+    len = strlen (s);
+    if (!(e = malloc (sizeof (*e) + len + 1)))
+        return NULL;
+    e->refcount = 1;
+    memcpy (e->s, s, len + 1);
+    if (zhashx_insert (st->entries, e->s, e) < 0) {
+        free (e);
+        errno = EEXIST;
+        return NULL;
+    }
+    return e->s;
+}
+
+void strtab_release (struct strtab *st, const char *s)
+{
+    struct strtab_entry *e;
+
+    if (!st || !s)
+        return;
+    if ((e = zhashx_lookup (st->entries, s)) && --e->refcount == 0)
+        zhashx_delete (st->entries, s);
+}
+
+size_t strtab_size (struct strtab *st)
+{
+    return st ? zhashx_size (st->entries) : 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
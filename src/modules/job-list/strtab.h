@@ -0,0 +1,45 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _FLUX_JOB_LIST_STRTAB_H
+#define _FLUX_JOB_LIST_STRTAB_H
+
+#include <stddef.h>
+
+/* strtab - reference counted table of interned strings
+ *
+ * Job names, queues, and other strings repeat across many jobs.
+ * Interning stores one copy of each distinct string.
+ */
+
+struct strtab *strtab_create (void);
+
+void strtab_destroy (struct strtab *st);
+
+/* Return the interned copy of 's', adding it to the table if needed,
+ * and take a reference on it.  Returns NULL if 's' is NULL or on
+ * failure with errno set.
+ */
+const char *strtab_intern (struct strtab *st, const char *s);
+
+/* Drop a reference on interned string 's', removing it from the
+ * table when the last reference is dropped.  NULL 's' is a no-op.
+ */
+void strtab_release (struct strtab *st, const char *s);
+
+/* Return the number of distinct strings in the table.
+ */
+size_t strtab_size (struct strtab *st);
+
+#endif /* ! _FLUX_JOB_LIST_STRTAB_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -866,6 +866,59 @@ static void test_R_update (void)
     free (data);
 }
 
+static void test_compact (void)
+{
+    const char *jobspec = TEST_SRCDIR "/jobspec/1slot_project_bank.jobspec";
+    struct strtab *st;
+    struct job *job1;
+    struct job *job2;
+
+    if (!(st = strtab_create ()))
+        BAIL_OUT ("strtab_create failed");
+    if (!(job1 = job_create (NULL, FLUX_JOBID_ANY))
+        || !(job2 = job_create (NULL, FLUX_JOBID_ANY)))
+        BAIL_OUT ("job_create failed");
+    if (parse_jobspec (job1, jobspec) < 0
+        || parse_jobspec (job2, jobspec) < 0
+        || parse_R (job1, TEST_SRCDIR "/R/1node_1core.R") < 0)
+        BAIL_OUT ("failed to parse jobspec/R");
+
+    ok (job_compact (job1, st) == 0,
+        "job_compact works");
+    ok (job1->jobspec == NULL && job1->R == NULL,
+        "job_compact freed jobspec and R");
+    ok (streq (job1->name, "hostname")
+        && streq (job1->cwd, "/tmp/job")
+        && streq (job1->project, "myproject")
+        && streq (job1->bank, "mybank")
+        && job1->queue == NULL,
+        "job_compact preserved jobspec strings");
+    ok (job1->nnodes == 1
+        && job1->ncores == 1
+        && job1->ntasks == 1
+        && streq (job1->ranks, "0"),
+        "job_compact preserved values parsed from jobspec and R");
+    ok (job_compact (job1, st) == 0 && strtab_size (st) == 4,
+        "job_compact on compacted job is a no-op");
+    ok (job_compact (job2, st) == 0 && strtab_size (st) == 4
+        && job2->name == job1->name
+        && job2->cwd == job1->cwd,
+        "job_compact shares strings between jobs");
+
+    job_destroy (job1);
+    ok (strtab_size (st) == 4,
+        "strings are retained while another job references them");
+    job_destroy (job2);
+    ok (strtab_size (st) == 0,
+        "strings are released when last job is destroyed");
+
+    errno = 0;
+    ok (job_compact (NULL, st) < 0 && errno == EINVAL,
+        "job_compact job=NULL fails with EINVAL");
+
+    strtab_destroy (st);
+}
+
 int main (int argc, char *argv[])
 {
     plan (NO_PLAN);
@@ -884,6 +937,7 @@ int main (int argc, char *argv[])
     test_ncores ();
     test_jobspec_update ();
     test_R_update ();
+    test_compact ();
 
     done_testing ();
 }
@@ -0,0 +1,235 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <jansson.h>
+#include <flux/core.h>
+
+#include "src/common/libtap/tap.h"
+#include "src/modules/job-list/job_data.h"
+#include "src/modules/job-list/job_index.h"
+#include "ccan/str/str.h"
+
+/* sort by id, lowest first */
+static int id_cmp (const void *a1, const void *a2)
+{
+    const struct job *j1 = a1;
+    const struct job *j2 = a2;
+
+    return (j1->id > j2->id) - (j1->id < j2->id);
+}
+
+static zlistx_comparator_fn *cmps[JOB_INDEX_NLISTS] = {
+    id_cmp,
+    id_cmp,
+    id_cmp,
+};
+
+static struct job *create_job (flux_jobid_t id,
+                               uint32_t userid,
+                               const char *queue)
+{
+    struct job *job;
+    if (!(job = job_create (NULL, id)))
+        BAIL_OUT ("failed to create job");
+    job->userid = userid;
+    job->queue = queue;
+    return job;
+}
+
+static bool list_is (zlistx_t *l, flux_jobid_t *ids, int count)
+{
+    struct job *job;
+    int i = 0;
+
+    if (!l)
+        return count == 0;
+    if (zlistx_size (l) != count)
+        return false;
+    job = zlistx_first (l);
+    while (job) {
+        if (job->id != ids[i++])
+            return false;
+        job = zlistx_next (l);
+    }
+    return true;
+}
+
+static void test_userid (void)
+{
+    struct job_index *idx;
+    struct job *jobs[4];
+    uint32_t userid;
+
+    if (!(idx = job_index_create (JOB_INDEX_USERID, cmps)))
+        BAIL_OUT ("job_index_create failed");
+
+    jobs[0] = create_job (3, 100, NULL);
+    jobs[1] = create_job (1, 100, NULL);
+    jobs[2] = create_job (2, 200, NULL);
+    jobs[3] = create_job (4, FLUX_USERID_UNKNOWN, NULL);
+
+    for (int i = 0; i < 4; i++) {
+        ok (job_index_insert (idx, jobs[i], JOB_INDEX_PENDING, true) == 0,
+            "job_index_insert job %d works", i);
+    }
+    ok (job_index_insert (idx, jobs[0], JOB_INDEX_PENDING, true) < 0
+        && errno == EEXIST,
+        "job_index_insert fails with EEXIST on already indexed job");
+
+    userid = 100;
+    ok (job_index_count (idx, &userid) == 2,
+        "job_index_count userid=100 returns 2");
+    ok (list_is (job_index_list (idx, &userid, JOB_INDEX_PENDING),
+                 (flux_jobid_t[]){ 1, 3 }, 2),
+        "pending list for userid=100 is sorted");
+    ok (zlistx_size (job_index_list (idx, &userid, JOB_INDEX_RUNNING)) == 0,
+        "running list for userid=100 is empty");
+    userid = FLUX_USERID_UNKNOWN;
+    ok (job_index_count (idx, &userid) == 0,
+        "job with unknown userid was not indexed");
+    userid = 300;
+    ok (job_index_count (idx, &userid) == 0
+        && job_index_list (idx, &userid, JOB_INDEX_PENDING) == NULL,
+        "job_index_list returns NULL for userid with no jobs");
+
+    /* move job 3 to running, as job_state.c does on state change */
+    job_index_remove (idx, jobs[0]);
+    ok (job_index_insert (idx, jobs[0], JOB_INDEX_RUNNING, true) == 0,
+        "job 3 moved to running list");
+    userid = 100;
+    ok (job_index_count (idx, &userid) == 2
+        && list_is (job_index_list (idx, &userid, JOB_INDEX_PENDING),
+                    (flux_jobid_t[]){ 1 }, 1)
+        && list_is (job_index_list (idx, &userid, JOB_INDEX_RUNNING),
+                    (flux_jobid_t[]){ 3 }, 1),
+        "userid=100 lists are correct after move");
+
+    /* change sort key and reorder */
+    job_index_remove (idx, jobs[0]);
+    ok (job_index_insert (idx, jobs[0], JOB_INDEX_PENDING, true) == 0,
+        "job 3 moved back to pending list");
+    jobs[1]->id = 10;
+    job_index_reorder (idx, jobs[1], true);
+    ok (list_is (job_index_list (idx, &userid, JOB_INDEX_PENDING),
+                 (flux_jobid_t[]){ 3, 10 }, 2),
+        "job_index_reorder re-sorts pending list");
+
+    /* removing last job drops the key */
+    userid = 200;
+    job_index_remove (idx, jobs[2]);
+    ok (job_index_count (idx, &userid) == 0
+        && job_index_list (idx, &userid, JOB_INDEX_PENDING) == NULL,
+        "removing last job for userid=200 removes key");
+    job_index_remove (idx, jobs[2]);
+    pass ("job_index_remove on unindexed job is a no-op");
+
+    job_index_destroy (idx);
+    for (int i = 0; i < 4; i++)
+        job_destroy (jobs[i]);
+}
+
+static void test_queue (void)
+{
+    struct job_index *idx;
+    struct job *jobs[3];
+
+    if (!(idx = job_index_create (JOB_INDEX_QUEUE, cmps)))
+        BAIL_OUT ("job_index_create failed");
+
+    jobs[0] = create_job (1, 100, "batch");
+    jobs[1] = create_job (2, 100, "debug");
+    jobs[2] = create_job (3, 100, NULL);
+
+    for (int i = 0; i < 3; i++) {
+        ok (job_index_insert (idx, jobs[i], JOB_INDEX_INACTIVE, true) == 0,
+            "job_index_insert job %d works", i);
+    }
+    ok (job_index_count (idx, "batch") == 1
+        && job_index_count (idx, "debug") == 1,
+        "job_index_count works for each queue");
+    ok (list_is (job_index_list (idx, "batch", JOB_INDEX_INACTIVE),
+                 (flux_jobid_t[]){ 1 }, 1),
+        "inactive list for queue=batch is correct");
+
+    /* jobspec-update changes queue */
+    jobs[1]->queue = "batch";
+    ok (job_index_rekey (idx, jobs[1], JOB_INDEX_INACTIVE, true) == 0,
+        "job_index_rekey works");
+    ok (job_index_count (idx, "debug") == 0
+        && job_index_count (idx, "batch") == 2
+        && list_is (job_index_list (idx, "batch", JOB_INDEX_INACTIVE),
+                    (flux_jobid_t[]){ 1, 2 }, 2),
+        "job moved from queue=debug to queue=batch");
+    ok (job_index_rekey (idx, jobs[1], JOB_INDEX_INACTIVE, true) == 0
+        && job_index_count (idx, "batch") == 2,
+        "job_index_rekey with unchanged key is a no-op");
+
+    /* job without queue gains one */
+    jobs[2]->queue = "debug";
+    ok (job_index_rekey (idx, jobs[2], JOB_INDEX_INACTIVE, true) == 0
+        && job_index_count (idx, "debug") == 1,
+        "job_index_rekey indexes job that previously had no queue");
+
+    job_index_destroy (idx);
+    for (int i = 0; i < 3; i++)
+        job_destroy (jobs[i]);
+}
+
+static void test_corner_case (void)
+{
+    struct job_index *idx;
+    struct job *job;
+
+    if (!(idx = job_index_create (JOB_INDEX_QUEUE, cmps)))
+        BAIL_OUT ("job_index_create failed");
+    job = create_job (1, 100, "batch");
+
+    ok (job_index_insert (NULL, job, JOB_INDEX_PENDING, true) < 0
+        && errno == EINVAL,
+        "job_index_insert fails with EINVAL on NULL index");
+    ok (job_index_insert (idx, NULL, JOB_INDEX_PENDING, true) < 0
+        && errno == EINVAL,
+        "job_index_insert fails with EINVAL on NULL job");
+    ok (job_index_insert (idx, job, JOB_INDEX_NLISTS, true) < 0
+        && errno == EINVAL,
+        "job_index_insert fails with EINVAL on invalid list");
+    ok (job_index_rekey (NULL, job, JOB_INDEX_PENDING, true) < 0
+        && errno == EINVAL,
+        "job_index_rekey fails with EINVAL on NULL index");
+    ok (job_index_count (NULL, "batch") == 0,
+        "job_index_count returns 0 on NULL index");
+    ok (job_index_list (idx, NULL, JOB_INDEX_PENDING) == NULL,
+        "job_index_list returns NULL on NULL value");
+    job_index_remove (NULL, job);
+    job_index_reorder (NULL, job, true);
+    job_index_destroy (NULL);
+    pass ("NULL index is handled by remove, reorder, and destroy");
+
+    job_index_destroy (idx);
+    job_destroy (job);
+}
+
+int main (int argc, char *argv[])
+{
+    plan (NO_PLAN);
+
+    test_userid ();
+    test_queue ();
+    test_corner_case ();
+
+    done_testing ();
+}
+
+/*
+ * vi:ts=4 sw=4 expandtab
+ */
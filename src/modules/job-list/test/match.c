@@ -715,6 +715,8 @@ struct basic_hostlist_constraint_test {
             { "foo[1-2]",  true, false, },
             { "foo[2-3]",  true, false, },
             { "foo[3-4]", false, false, },
+            { "foo[2-9]",  true, false, },
+            { "foo[3-9]", false, false, },
             {  NULL,      false,  true, },
         },
     },
@@ -783,6 +785,43 @@ static void test_basic_hostlist (void)
     }
 }
 
+static void test_conditional_order (void)
+{
+    struct list_constraint *c;
+    struct job *job;
+    flux_error_t error;
+    int rv;
+
+    /* The states test is cheaper than the hostlist test, so it should
+     * be evaluated first and short-circuit the "and" before the
+     * hostlist test exceeds max_comparisons.
+     */
+    c = create_list_constraint ("{ \"and\": \
+                                   [ \
+                                     { \"hostlist\": [ \"foo[1-8]\" ] }, \
+                                     { \"states\": [ \"running\" ] } \
+                                   ] \
+                                 }");
+    job = setup_job (0,
+                     NULL,
+                     NULL,
+                     "foo[1-8]",
+                     NULL,
+                     FLUX_JOB_STATE_INACTIVE,
+                     0,
+                     0.0,
+                     0.0,
+                     0.0,
+                     0.0,
+                     0.0);
+    mctx.max_comparisons = 2;
+    rv = job_match (job, c, &error);
+    ok (rv == 0,
+        "and evaluates cheap constraint before hostlist");
+    mctx.max_comparisons = 0;
+    job_destroy (job);
+    list_constraint_destroy (c);
+}
 
 struct basic_ranks_test {
     const char *ranks;
@@ -2092,6 +2131,100 @@ static void test_realworld (void)
     }
 }
 
+/* estimate: userid 1 has 10 jobs, queue "batch" has 5, all else 100 */
+static size_t plan_estimate (enum job_index_type type,
+                             const void *value,
+                             void *arg)
+{
+    int *calls = arg;
+    (*calls)++;
+    if (type == JOB_INDEX_USERID && *(const uint32_t *)value == 1)
+        return 10;
+    if (type == JOB_INDEX_QUEUE && streq (value, "batch"))
+        return 5;
+    return 100;
+}
+
+struct plan_test {
+    const char *constraint;
+    int expected;
+    enum job_index_type type;
+    const char *value;
+};
+
+struct plan_test plan_tests[] = {
+    { "{ \"userid\": [ 1 ] }", 1, JOB_INDEX_USERID, "1" },
+    { "{ \"userid\": [ 1, 2 ] }", 0, 0, NULL },
+    { "{ \"userid\": [ 4294967295 ] }", 0, 0, NULL },
+    { "{ \"queue\": [ \"debug\" ] }", 1, JOB_INDEX_QUEUE, "debug" },
+    { "{ \"queue\": [ \"batch\", \"debug\" ] }", 0, 0, NULL },
+    { "{ \"name\": [ \"foo\" ] }", 0, 0, NULL },
+    {
+        "{ \"and\": [ { \"userid\": [ 1 ] }, { \"queue\": [ \"batch\" ] } ] }",
+        1, JOB_INDEX_QUEUE, "batch",
+    },
+    {
+        "{ \"and\": [ { \"userid\": [ 1 ] }, { \"queue\": [ \"debug\" ] } ] }",
+        1, JOB_INDEX_USERID, "1",
+    },
+    {
+        "{ \"and\": [ { \"name\": [ \"foo\" ] }, { \"userid\": [ 1 ] } ] }",
+        1, JOB_INDEX_USERID, "1",
+    },
+    { "{ \"or\": [ { \"userid\": [ 1 ] } ] }", 0, 0, NULL },
+    { "{ \"not\": [ { \"userid\": [ 1 ] } ] }", 0, 0, NULL },
+    {
+        "{ \"and\": [ { \"or\": [ { \"userid\": [ 1 ] } ] } ] }",
+        0, 0, NULL,
+    },
+    { NULL, 0, 0, NULL },
+};
+
+static void test_plan (void)
+{
+    struct plan_test *t = plan_tests;
+    enum job_index_type type;
+    const void *value;
+    int calls = 0;
+    struct list_constraint *c;
+
+    c = create_list_constraint (NULL);
+    ok (list_constraint_plan (c, NULL, NULL, &type, &value) < 0
+        && errno == EINVAL,
+        "list_constraint_plan fails with EINVAL on NULL estimate");
+    ok (list_constraint_plan (c, plan_estimate, &calls, &type, &value) == 0,
+        "list_constraint_plan returns 0 for empty constraint");
+    list_constraint_destroy (c);
+
+    while (t->constraint) {
+        int ret;
+        c = create_list_constraint (t->constraint);
+        value = NULL;
+        ret = list_constraint_plan (c, plan_estimate, &calls, &type, &value);
+        ok (ret == t->expected,
+            "list_constraint_plan returns %d on %s",
+            t->expected,
+            t->constraint);
+        if (ret == 1 && t->expected == 1) {
+            char buf[16];
+            const char *s = value;
+            if (type == JOB_INDEX_USERID) {
+                snprintf (buf,
+                          sizeof (buf),
+                          "%u",
+                          *(const uint32_t *)value);
+                s = buf;
+            }
+            ok (type == t->type && streq (s, t->value),
+                "list_constraint_plan chose %s=%s",
+                type == JOB_INDEX_USERID ? "userid" : "queue",
+                t->value);
+        }
+        list_constraint_destroy (c);
+        t++;
+    }
+}
+
 int main (int argc, char *argv[])
 {
     plan (NO_PLAN);
@@ -2108,7 +2241,9 @@ int main (int argc, char *argv[])
     test_basic_ranks ();
     test_basic_timestamp ();
     test_basic_conditionals ();
+    test_conditional_order ();
     test_realworld ();
+    test_plan ();
 
     done_testing ();
 }
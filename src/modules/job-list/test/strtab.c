@@ -0,0 +1,98 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <errno.h>
+#include <string.h>
+
+#include "src/common/libtap/tap.h"
+#include "src/modules/job-list/strtab.h"
+#include "ccan/str/str.h"
+
+static void test_basic (void)
+{
+    struct strtab *st;
+    const char *s1, *s2, *s3;
+    char buf[16];
+
+    if (!(st = strtab_create ()))
+        BAIL_OUT ("strtab_create failed");
+    ok (strtab_size (st) == 0,
+        "strtab_size of new table is 0");
+
+    strcpy (buf, "batch");
+    s1 = strtab_intern (st, buf);
+    ok (s1 != NULL && s1 != buf && streq (s1, "batch"),
+        "strtab_intern returns a copy of the string");
+    s2 = strtab_intern (st, "batch");
+    ok (s2 == s1,
+        "strtab_intern returns the same copy for an equal string");
+    s3 = strtab_intern (st, "debug");
+    ok (s3 != NULL && s3 != s1 && streq (s3, "debug"),
+        "strtab_intern returns a new copy for a different string");
+    ok (strtab_size (st) == 2,
+        "strtab_size is 2");
+
+    strtab_release (st, s1);
+    ok (strtab_size (st) == 2,
+        "string is retained while references remain");
+    strtab_release (st, s2);
+    ok (strtab_size (st) == 1,
+        "string is removed when last reference is released");
+    s1 = strtab_intern (st, "batch");
+    ok (s1 != NULL && streq (s1, "batch") && strtab_size (st) == 2,
+        "removed string can be interned again");
+
+    strtab_release (st, NULL);
+    strtab_release (st, "nonexistent");
+    ok (strtab_size (st) == 2,
+        "strtab_release of NULL or unknown string is a no-op");
+
+    /* destroy with outstanding references */
+    strtab_destroy (st);
+}
+
+static void test_corner_case (void)
+{
+    struct strtab *st;
+
+    if (!(st = strtab_create ()))
+        BAIL_OUT ("strtab_create failed");
+
+    errno = 0;
+    ok (strtab_intern (NULL, "foo") == NULL && errno == EINVAL,
+        "strtab_intern st=NULL fails with EINVAL");
+    errno = 0;
+    ok (strtab_intern (st, NULL) == NULL && errno == EINVAL,
+        "strtab_intern s=NULL fails with EINVAL");
+    ok (strtab_size (NULL) == 0,
+        "strtab_size st=NULL returns 0");
+    strtab_release (NULL, "foo");
+    strtab_destroy (NULL);
+    pass ("strtab_release and strtab_destroy accept NULL table");
+
+    strtab_destroy (st);
+}
+
+int main (int argc, char *argv[])
+{
+    plan (NO_PLAN);
+
+    test_basic ();
+    test_corner_case ();
+
+    done_testing ();
+}
+
+/*
+ * vi:ts=4 sw=4 expandtab
+ */
@@ -0,0 +1,472 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* watch.c - push job list changes to subscribers */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <jansson.h>
+#include <flux/core.h>
+
+#include "src/common/libutil/errprintf.h"
+#include "src/common/libjob/job_hash.h"
+#include "src/common/libjob/idf58.h"
+#include "src/common/libczmqcontainers/czmq_containers.h"
+#include "ccan/str/str.h"
+
+#include "job-list.h"
+#include "job_util.h"
+#include "match.h"
+#include "watch.h"
+
+/* Max jobs per "snapshot" response.
+ */
+#define WATCH_SNAPSHOT_CHUNK 256
+
+struct watch_ctx {
+    flux_t *h;
+    struct list_ctx *ctx;
+    struct flux_msglist *watchers;
+    flux_msg_handler_t **handlers;
+};
+
+/* Per-request state, stored in the request message aux container.
+ * 'matched' holds the ids of active jobs the watcher currently sees, so
+ * that a change can be classified as add, update, or remove.  Inactive
+ * jobs do not change again, so they are dropped once reported to keep
+ * the hash bounded by the number of active jobs.
+ */
+struct watcher {
+    json_t *attrs;
+    struct list_constraint *c;
+    zhashx_t *matched;
+};
+
+static void watcher_destroy (struct watcher *w)
+{
+    if (w) {
+        int saved_errno = errno;
+        json_decref (w->attrs);
+        list_constraint_destroy (w->c);
+        zhashx_destroy (&w->matched);
+        free (w);
+        errno = saved_errno;
+    }
+}
+
+static struct watcher *watcher_create (struct watch_ctx *wctx,
+                                       json_t *attrs,
+                                       json_t *constraint,
+                                       flux_error_t *errp)
+{
+    struct watcher *w;
+    flux_error_t error;
+
+    if (!(w = calloc (1, sizeof (*w)))
+        || !(w->matched = job_hash_create ())) {
+        errprintf (errp, "out of memory");
+        goto nomem;
+    }
+    w->attrs = json_incref (attrs);
+    if (!(w->c = list_constraint_create (wctx->ctx->mctx,
+                                         constraint,
+                                         &error))) {
+        errprintf (errp,
+                   "invalid payload: constraint object invalid: %s",
+                   error.text);
+        errno = EPROTO;
+        goto error;
+    }
+    return w;
+nomem:
+    errno = ENOMEM;
+error:
+    watcher_destroy (w);
+    return NULL;
+}
+
+/* Validate 'attrs' up front, since an error converting a job later
+ * could not be reported to the watcher.
+ */
+static int validate_attrs (json_t *attrs, flux_error_t *errp)
+{
+    size_t index;
+    json_t *value;
+
+    if (!json_is_array (attrs)) {
+        errprintf (errp, "invalid payload: attrs must be an array");
+        errno = EPROTO;
+        return -1;
+    }
+    json_array_foreach (attrs, index, value) {
+        const char *attr = json_string_value (value);
+        const char **valid;
+        bool found = false;
+
+        if (!attr) {
+            errprintf (errp, "attr has no string value");
+            errno = EINVAL;
+            return -1;
+        }
+        if (streq (attr, "all"))
+            continue;
+        for (valid = job_attrs (); *valid != NULL; valid++) {
+            if (streq (attr, *valid)) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            errprintf (errp, "%s is not a valid attribute", attr);
+            errno = EINVAL;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int watch_respond (struct watch_ctx *wctx,
+                          const flux_msg_t *msg,
+                          const char *type,
+                          json_t *jobs)
+{
+    if (flux_respond_pack (wctx->h,
+                           msg,
+                           "{s:s s:O}",
+                           "type", type,
+                           "jobs", jobs) < 0) {
+        flux_log_error (wctx->h, "error responding to job-list.watch");
+        return -1;
+    }
+    return 0;
+}
+
+/* Send jobs currently on 'list' matching the watcher's constraint
+ * in chunks.  As with job-list.list, 'since' limits inactive jobs
+ * to those with t_inactive greater than 'since'.
+ */
+static int snapshot_list (struct watch_ctx *wctx,
+                          const flux_msg_t *msg,
+                          struct watcher *w,
+                          zlistx_t *list,
+                          double since,
+                          json_t **jobs,
+                          flux_error_t *errp)
+{
+    struct job *job;
+
+    job = zlistx_first (list);
+    while (job) {
+        int ret;
+        json_t *o;
+
+        if (job->t_inactive > 0. && job->t_inactive <= since)
+            break;
+        if ((ret = job_match (job, w->c, errp)) < 0)
+            return -1;
+        if (ret) {
+            if (!(o = job_to_json (job, w->attrs, errp)))
+                return -1;
+            if (json_array_append_new (*jobs, o) < 0
+                || (job->state != FLUX_JOB_STATE_INACTIVE
+                    && zhashx_insert (w->matched, &job->id, job) < 0)) {
+                errprintf (errp, "out of memory");
+                errno = ENOMEM;
+                return -1;
+            }
+            if (json_array_size (*jobs) == WATCH_SNAPSHOT_CHUNK) {
+                (void)watch_respond (wctx, msg, "snapshot", *jobs);
+                json_decref (*jobs);
+                if (!(*jobs = json_array ())) {
+                    errprintf (errp, "out of memory");
+                    errno = ENOMEM;
+                    return -1;
+                }
+            }
+        }
+        job = zlistx_next (list);
+    }
+    return 0;
+}
+
+static int snapshot (struct watch_ctx *wctx,
+                     const flux_msg_t *msg,
+                     struct watcher *w,
+                     double since,
+                     flux_error_t *errp)
+{
+    struct job_state_ctx *jsctx = wctx->ctx->jsctx;
+    json_t *jobs;
+    int rc = -1;
+
+    if (!(jobs = json_array ())) {
+        errprintf (errp, "out of memory");
+        errno = ENOMEM;
+        return -1;
+    }
+    if (snapshot_list (wctx, msg, w, jsctx->pending, 0., &jobs, errp) < 0
+        || snapshot_list (wctx, msg, w, jsctx->running, 0., &jobs, errp) < 0
+        || snapshot_list (wctx, msg, w, jsctx->inactive, since, &jobs, errp) < 0)
+        goto out;
+    if (json_array_size (jobs) > 0)
+        (void)watch_respond (wctx, msg, "snapshot", jobs);
+    json_array_clear (jobs);
+    (void)watch_respond (wctx, msg, "sync", jobs);
+    rc = 0;
+out:
+    json_decref (jobs);
+    return rc;
+}
+
+static void watch_cb (flux_t *h,
+                      flux_msg_handler_t *mh,
+                      const flux_msg_t *msg,
+                      void *arg)
+{
+    struct watch_ctx *wctx = arg;
+    struct watcher *w = NULL;
+    json_t *attrs;
+    json_t *constraint = NULL;
+    double since = 0.;
+    flux_error_t err;
+
+    if (!wctx->ctx->jsctx->initialized) {
+        if (flux_msglist_append (wctx->ctx->deferred_requests, msg) < 0) {
+            errprintf (&err, "error enqueuing deferred request");
+            goto error;
+        }
+        return;
+    }
+    if (flux_request_unpack (msg,
+                             NULL,
+                             "{s:o s?F s?o}",
+                             "attrs", &attrs,
+                             "since", &since,
+                             "constraint", &constraint) < 0) {
+        errprintf (&err, "invalid payload: %s", flux_msg_last_error (msg));
+        errno = EPROTO;
+        goto error;
+    }
+    if (!flux_msg_is_streaming (msg)) {
+        errprintf (&err, "job-list.watch requires streaming flag");
+        errno = EPROTO;
+        goto error;
+    }
+    if (since < 0.) {
+        errprintf (&err, "invalid payload: since < 0.0 not allowed");
+        errno = EPROTO;
+        goto error;
+    }
+    if (validate_attrs (attrs, &err) < 0)
+        goto error;
+    if (!(w = watcher_create (wctx, attrs, constraint, &err)))
+        goto error;
+    if (flux_msg_aux_set (msg,
+                          "watcher",
+                          w,
+                          (flux_free_f)watcher_destroy) < 0) {
+        errprintf (&err, "out of memory");
+        watcher_destroy (w);
+        goto error;
+    }
+    if (snapshot (wctx, msg, w, since, &err) < 0)
+        goto error;
+    list_constraint_reset_comparisons (w->c);
+    if (flux_msglist_append (wctx->watchers, msg) < 0) {
+        errprintf (&err, "out of memory");
+        goto error;
+    }
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, err.text) < 0)
+        flux_log_error (h, "error responding to job-list.watch");
+}
+
+static void watch_cancel_cb (flux_t *h,
+                             flux_msg_handler_t *mh,
+                             const flux_msg_t *msg,
+                             void *arg)
+{
+    struct watch_ctx *wctx = arg;
+
+    if (flux_msglist_cancel (h, wctx->watchers, msg) < 0)
+        flux_log_error (h, "error handling job-list.watch-cancel");
+}
+
+void watch_disconnect (struct watch_ctx *wctx, const flux_msg_t *msg)
+{
+    if (wctx)
+        flux_msglist_disconnect (wctx->watchers, msg);
+}
+
+/* Send a single job delta of 'type' to watcher 'msg'.
+ */
+static void send_delta (struct watch_ctx *wctx,
+                        const flux_msg_t *msg,
+                        struct watcher *w,
+                        struct job *job,
+                        const char *type)
+{
+    flux_error_t error;
+    json_t *o;
+
+    if (streq (type, "remove"))
+        o = json_pack ("[{s:I}]", "id", (json_int_t)job->id);
+    else {
+        json_t *entry;
+        if (!(entry = job_to_json (job, w->attrs, &error))) {
+            flux_log (wctx->h,
+                      LOG_ERR,
+                      "watch: error converting job %s: %s",
+                      idf58 (job->id),
+                      error.text);
+            return;
+        }
+        if (!(o = json_array ()) || json_array_append_new (o, entry) < 0) {
+            json_decref (entry);
+            json_decref (o);
+            o = NULL;
+        }
+    }
+    if (!o) {
+        flux_log (wctx->h, LOG_ERR, "watch: out of memory");
+        return;
+    }
+    (void)watch_respond (wctx, msg, type, o);
+    json_decref (o);
+}
+
+void watch_job_changed (struct watch_ctx *wctx, struct job *job)
+{
+    const flux_msg_t *msg;
+
+    if (!wctx || flux_msglist_count (wctx->watchers) == 0)
+        return;
+
+    /* Jobs in NEW are not yet on any list and are not visible to
+     * job-list.list, so they are not visible to watchers either.
+     */
+    if (job->state == FLUX_JOB_STATE_NEW)
+        return;
+
+    msg = flux_msglist_first (wctx->watchers);
+    while (msg) {
+        struct watcher *w = flux_msg_aux_get (msg, "watcher");
+        bool was = zhashx_lookup (w->matched, &job->id) != NULL;
+        flux_error_t error;
+        int ret;
+
+        list_constraint_reset_comparisons (w->c);
+        if ((ret = job_match (job, w->c, &error)) < 0) {
+            flux_log (wctx->h,
+                      LOG_ERR,
+                      "watch: error matching job %s: %s",
+                      idf58 (job->id),
+                      error.text);
+        }
+        else if (ret) {
+            if (job->state == FLUX_JOB_STATE_INACTIVE)
+                zhashx_delete (w->matched, &job->id);
+            else if (!was)
+                (void)zhashx_insert (w->matched, &job->id, job);
+            send_delta (wctx, msg, w, job, was ? "update" : "add");
+        }
+        else if (was) {
+            zhashx_delete (w->matched, &job->id);
+            send_delta (wctx, msg, w, job, "remove");
+        }
+        msg = flux_msglist_next (wctx->watchers);
+    }
+}
+
+void watch_job_removed (struct watch_ctx *wctx, struct job *job)
+{
+    const flux_msg_t *msg;
+
+    if (!wctx)
+        return;
+    msg = flux_msglist_first (wctx->watchers);
+    while (msg) {
+        struct watcher *w = flux_msg_aux_get (msg, "watcher");
+        bool was = zhashx_lookup (w->matched, &job->id) != NULL;
+        flux_error_t error;
+
+        /* Inactive jobs are not kept in 'matched', so re-evaluate
+         * the constraint to find out if the watcher saw this one.
+         */
+        if (!was && job->state == FLUX_JOB_STATE_INACTIVE) {
+            list_constraint_reset_comparisons (w->c);
+            was = job_match (job, w->c, &error) > 0;
+        }
+        if (was) {
+            zhashx_delete (w->matched, &job->id);
+            send_delta (wctx, msg, w, job, "remove");
+        }
+        msg = flux_msglist_next (wctx->watchers);
+    }
+}
+
+static const struct flux_msg_handler_spec htab[] = {
+    { .typemask     = FLUX_MSGTYPE_REQUEST,
+      .topic_glob   = "job-list.watch",
+      .cb           = watch_cb,
+      .rolemask     = FLUX_ROLE_USER
+    },
+    { .typemask     = FLUX_MSGTYPE_REQUEST,
+      .topic_glob   = "job-list.watch-cancel",
+      .cb           = watch_cancel_cb,
+      .rolemask     = FLUX_ROLE_USER
+    },
+    FLUX_MSGHANDLER_TABLE_END,
+};
+
+void watch_ctx_destroy (struct watch_ctx *wctx)
+{
+    if (wctx) {
+        int saved_errno = errno;
+        const flux_msg_t *msg;
+
+        flux_msg_handler_delvec (wctx->handlers);
+        if (wctx->watchers) {
+            while ((msg = flux_msglist_pop (wctx->watchers))) {
+                if (flux_respond_error (wctx->h, msg, ENOSYS, NULL) < 0)
+                    flux_log_error (wctx->h,
+                                    "error responding to job-list.watch");
+                flux_msg_decref (msg);
+            }
+            flux_msglist_destroy (wctx->watchers);
+        }
+        free (wctx);
+        errno = saved_errno;
+    }
+}
+
+struct watch_ctx *watch_ctx_create (struct list_ctx *ctx)
+{
+    struct watch_ctx *wctx;
+
+    if (!(wctx = calloc (1, sizeof (*wctx))))
+        return NULL;
+    wctx->h = ctx->h;
+    wctx->ctx = ctx;
+    if (!(wctx->watchers = flux_msglist_create ()))
+        goto error;
+    if (flux_msg_handler_addvec (wctx->h, htab, wctx, &wctx->handlers) < 0)
+        goto error;
+    return wctx;
+error:
+    watch_ctx_destroy (wctx);
+    return NULL;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,52 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _FLUX_JOB_LIST_WATCH_H
+#define _FLUX_JOB_LIST_WATCH_H
+
+#include <flux/core.h>
+
+#include "job_data.h"
+
+/* job-list.watch - push job list changes to subscribers.
+ *
+ * A watch request takes the same "attrs", "constraint", and "since"
+ * fields as job-list.list.  The job-list module responds with the
+ * current matching jobs in one or more "snapshot" responses, then a
+ * "sync" response, then "add", "update", and "remove" responses as
+ * jobs change.  Each response has the form
+ *
+ *   {"type":s "jobs":[...]}
+ *
+ * where "remove" job objects contain only the job "id".
+ */
+
+struct list_ctx;
+
+struct watch_ctx *watch_ctx_create (struct list_ctx *ctx);
+
+void watch_ctx_destroy (struct watch_ctx *wctx);
+
+/* Re-evaluate 'job' for each watcher after it has changed.  Only
+ * watchers whose view of the job changed are sent a response.
+ */
+void watch_job_changed (struct watch_ctx *wctx, struct job *job);
+
+/* Notify watchers that 'job' is about to be purged.
+ */
+void watch_job_removed (struct watch_ctx *wctx, struct job *job);
+
+void watch_disconnect (struct watch_ctx *wctx, const flux_msg_t *msg);
+
+#endif /* ! _FLUX_JOB_LIST_WATCH_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
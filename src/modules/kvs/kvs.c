@@ -398,11 +398,15 @@ error:
     flux_future_destroy (f);
 }
 
+/* If 'aux' is non-NULL, it is attached to the requeued copy of 'msg'
+ * under 'aux_name' so that a stalled request can resume its state.
+ */
 static int getroot_request_send (struct kvs_ctx *ctx,
                                  const char *ns,
                                  flux_msg_handler_t *mh,
                                  const flux_msg_t *msg,
-                                 lookup_t *lh)
+                                 const char *aux_name,
+                                 void *aux)
 {
     flux_future_t *f = NULL;
     flux_msg_t *msgcpy = NULL;
@@ -421,8 +425,8 @@ static int getroot_request_send (struct kvs_ctx *ctx,
         goto error;
     }
 
-    if (lh
-        && flux_msg_aux_set (msgcpy, "lookup_handle", lh, NULL) < 0) {
+    if (aux
+        && flux_msg_aux_set (msgcpy, aux_name, aux, NULL) < 0) {
         flux_log_error (ctx->h, "%s: flux_msg_aux_set", __FUNCTION__);
         goto error;
     }
@@ -462,7 +466,12 @@ static struct kvsroot *getroot (struct kvs_ctx *ctx,
             return NULL;
         }
         else {
-            if (getroot_request_send (ctx, ns, mh, msg, lh) < 0) {
+            if (getroot_request_send (ctx,
+                                      ns,
+                                      mh,
+                                      msg,
+                                      "lookup_handle",
+                                      lh) < 0) {
                 flux_log_error (ctx->h, "getroot_request_send");
                 return NULL;
             }
@@ -1595,6 +1604,265 @@ error:
 }
 
 
+/* kvs.lookup-multi - look up multiple keys against a single root.
+ * Lookups of all keys proceed concurrently: missing references for all
+ * keys are loaded in parallel under one wait_t, and since the cache
+ * tracks in-flight loads, directories shared by the keys are loaded once.
+ * Each key's result is streamed back as it completes, as either
+ * { key:s val:o } or { key:s errno:i }, then the stream is terminated
+ * with ENODATA.
+ */
+struct lookup_multi {
+    lookup_t **lh;      // per-key lookup handle, NULL once responded
+    char **keys;
+    int nkeys;
+    int pending;        // number of keys not yet responded to
+    int errnum;         // error from an asynchronous load
+};
+
+static void lookup_multi_destroy (struct lookup_multi *m)
+{
+    if (m) {
+        int saved_errno = errno;
+        for (int i = 0; i < m->nkeys; i++) {
+            lookup_destroy (m->lh[i]);
+            free (m->keys[i]);
+        }
+        free (m->lh);
+        free (m->keys);
+        free (m);
+        errno = saved_errno;
+    }
+}
+
+static struct lookup_multi *lookup_multi_create (struct kvs_ctx *ctx,
+                                                 flux_msg_handler_t *mh,
+                                                 const flux_msg_t *msg,
+                                                 bool *stall)
+{
+    struct lookup_multi *m = NULL;
+    json_t *keys;
+    int flags;
+    const char *ns = NULL;
+    json_t *root_dirent = NULL;
+    const char *root_ref = NULL;
+    int root_seq = -1;
+    struct flux_msg_cred cred;
+    size_t index;
+    json_t *entry;
+
+    (*stall) = false;
+
+    if (flux_request_unpack (msg,
+                             NULL,
+                             "{ s:o s:i s?s s?o }",
+                             "keys", &keys,
+                             "flags", &flags,
+                             "namespace", &ns,
+                             "rootdir", &root_dirent) < 0)
+        return NULL;
+    if (!json_is_array (keys)
+        || json_array_size (keys) == 0
+        || (!ns && !root_dirent)) {
+        errno = EPROTO;
+        return NULL;
+    }
+    if (flux_msg_get_cred (msg, &cred) < 0)
+        return NULL;
+
+    /* Pin the root so all keys are resolved against the same snapshot.
+     */
+    if (root_dirent) {
+        if (treeobj_validate (root_dirent) < 0
+            || !treeobj_is_dirref (root_dirent)
+            || !(root_ref = treeobj_get_blobref (root_dirent, 0))) {
+            errno = EINVAL;
+            return NULL;
+        }
+    }
+    else {
+        struct kvsroot *root;
+
+        if (!(root = getroot (ctx, ns, mh, msg, NULL, stall)))
+            return NULL;
+        root_ref = root->ref;
+        root_seq = root->seq;
+    }
+
+    if (!(m = calloc (1, sizeof (*m)))
+        || !(m->lh = calloc (json_array_size (keys), sizeof (m->lh[0])))
+        || !(m->keys = calloc (json_array_size (keys), sizeof (m->keys[0]))))
+        goto nomem;
+    json_array_foreach (keys, index, entry) {
+        const char *key = json_string_value (entry);
+
+        if (!key || strlen (key) == 0) {
+            errno = EPROTO;
+            goto error;
+        }
+        if (!(m->keys[index] = strdup (key)))
+            goto nomem;
+        m->nkeys++;
+        if (!(m->lh[index] = lookup_create (ctx->cache,
+                                            ctx->krm,
+                                            ns,
+                                            root_ref,
+                                            root_seq,
+                                            key,
+                                            cred,
+                                            flags,
+                                            ctx->h)))
+            goto error;
+    }
+    m->pending = m->nkeys;
+    return m;
+nomem:
+    errno = ENOMEM;
+error:
+    lookup_multi_destroy (m);
+    return NULL;
+}
+
+static void lookup_multi_wait_error_cb (wait_t *w, int errnum, void *arg)
+{
+    struct lookup_multi *m = arg;
+    m->errnum = errnum;
+}
+
+static void lookup_multi_respond (flux_t *h,
+                                  const flux_msg_t *msg,
+                                  struct lookup_multi *m,
+                                  int i,
+                                  int errnum)
+{
+    json_t *val = NULL;
+    int rc;
+
+    if (errnum == 0 && !(val = lookup_get_value (m->lh[i])))
+        errnum = ENOENT;
+    if (errnum)
+        rc = flux_respond_pack (h,
+                                msg,
+                                "{ s:s s:i }",
+                                "key", m->keys[i],
+                                "errno", errnum);
+    else
+        rc = flux_respond_pack (h,
+                                msg,
+                                "{ s:s s:O }",
+                                "key", m->keys[i],
+                                "val", val);
+    if (rc < 0)
+        flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+    json_decref (val);
+    lookup_destroy (m->lh[i]);
+    m->lh[i] = NULL;
+    m->pending--;
+}
+
+static void lookup_multi_request_cb (flux_t *h,
+                                     flux_msg_handler_t *mh,
+                                     const flux_msg_t *msg,
+                                     void *arg)
+{
+    struct kvs_ctx *ctx = arg;
+    struct lookup_multi *m;
+    struct kvs_cb_data cbd;
+    wait_t *wait = NULL;
+    const char *missing_ns = NULL;
+    bool stall = false;
+
+    /* if lookup_multi exists in msg as aux data, is a replay */
+    if (!(m = flux_msg_aux_get (msg, "lookup_multi"))) {
+        if (!(m = lookup_multi_create (ctx, mh, msg, &stall))) {
+            if (stall) {
+                request_tracking_add (ctx, msg);
+                return;
+            }
+            goto error;
+        }
+    }
+    else if (m->errnum) {
+        /* error in prior load(), waited for in flight rpcs to complete */
+        errno = m->errnum;
+        goto error;
+    }
+
+    if (!(wait = wait_create_msg_handler (h,
+                                          mh,
+                                          msg,
+                                          ctx,
+                                          lookup_multi_request_cb))
+        || wait_set_error_cb (wait, lookup_multi_wait_error_cb, m) < 0
+        || wait_msg_aux_set (wait, "lookup_multi", m, NULL) < 0)
+        goto error;
+    cbd.ctx = ctx;
+    cbd.wait = wait;
+    cbd.errnum = 0;
+
+    for (int i = 0; i < m->nkeys; i++) {
+        lookup_process_t lret;
+
+        if (!m->lh[i])
+            continue;
+        lret = lookup (m->lh[i]);
+        if (lret == LOOKUP_PROCESS_FINISHED)
+            lookup_multi_respond (h, msg, m, i, 0);
+        else if (lret == LOOKUP_PROCESS_ERROR)
+            lookup_multi_respond (h, msg, m, i, lookup_get_errnum (m->lh[i]));
+        else if (lret == LOOKUP_PROCESS_LOAD_MISSING_NAMESPACE) {
+            /* Symlink into a namespace not yet known on this rank.
+             * Fetch one namespace at a time, after loads are done.
+             */
+            if (ctx->rank == 0)
+                lookup_multi_respond (h, msg, m, i, ENOTSUP);
+            else if (!missing_ns)
+                missing_ns = lookup_missing_namespace (m->lh[i]);
+        }
+        else if (lookup_iter_missing_refs (m->lh[i],
+                                           lookup_load_cb,
+                                           &cbd) < 0) {
+            /* rpcs already in flight, stall for them to complete */
+            if (wait_get_usecount (wait) > 0) {
+                m->errnum = cbd.errnum;
+                goto stall;
+            }
+            errno = cbd.errnum;
+            goto error;
+        }
+    }
+    if (wait_get_usecount (wait) > 0)
+        goto stall;
+    wait_destroy (wait);
+    wait = NULL;
+    if (missing_ns) {
+        if (getroot_request_send (ctx,
+                                  missing_ns,
+                                  mh,
+                                  msg,
+                                  "lookup_multi",
+                                  m) < 0)
+            goto error;
+        request_tracking_add (ctx, msg);
+        return;
+    }
+    assert (m->pending == 0);
+    if (flux_respond_error (h, msg, ENODATA, NULL) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    lookup_multi_destroy (m);
+    request_tracking_remove (ctx, msg);
+    return;
+stall:
+    request_tracking_add (ctx, msg);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    wait_destroy (wait);
+    lookup_multi_destroy (m);
+    request_tracking_remove (ctx, msg);
+}
+
 static int finalize_transaction_req (treq_t *tr,
                                      const flux_msg_t *req,
                                      void *data)
@@ -2994,6 +3262,12 @@ static const struct flux_msg_handler_spec htab[] = {
         lookup_plus_request_cb,
         FLUX_ROLE_USER
     },
+    {
+        FLUX_MSGTYPE_REQUEST,
+        "kvs.lookup-multi",
+        lookup_multi_request_cb,
+        FLUX_ROLE_USER
+    },
     {
         FLUX_MSGTYPE_REQUEST,
         "kvs.commit",
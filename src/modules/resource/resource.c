@@ -54,6 +54,9 @@
  * norestrict = false
  *   When generating hwloc topology XML, do not restrict to current cpumask
  *
+ * topo-cache = true
+ *   Cache discovered hwloc topology XML in statedir, if set
+ *
  * no-update-watch = false
  *   For testing purposes, simulate missing job-info.update-watch service
  *   in parent instance by sending to an invalid service name.
@@ -64,6 +67,7 @@ static int parse_config (struct resource_ctx *ctx,
                          json_t **R,
                          bool *noverifyp,
                          bool *norestrictp,
+                         bool *no_topo_cachep,
                          bool *no_update_watchp,
                          flux_error_t *errp)
 {
@@ -73,13 +77,14 @@ static int parse_config (struct resource_ctx *ctx,
     const char *scheduling_path = NULL;
     int noverify = 0;
     int norestrict = 0;
+    int topo_cache = 1;
     int no_update_watch = 0;
     json_t *o = NULL;
     json_t *config = NULL;
 
     if (flux_conf_unpack (conf,
                           &error,
-                          "{s?{s?s s?s s?o s?s s?b s?b s?b !}}",
+                          "{s?{s?s s?s s?o s?s s?b s?b s?b s?b !}}",
                           "resource",
                             "path", &path,
                             "scheduling", &scheduling_path,
@@ -87,6 +92,7 @@ static int parse_config (struct resource_ctx *ctx,
                             "exclude", &exclude,
                             "norestrict", &norestrict,
                             "noverify", &noverify,
+                            "topo-cache", &topo_cache,
                             "no-update-watch", &no_update_watch) < 0) {
         errprintf (errp,
                    "error parsing [resource] configuration: %s",
@@ -146,6 +152,8 @@ static int parse_config (struct resource_ctx *ctx,
         *noverifyp = noverify ? true : false;
     if (norestrictp)
         *norestrictp = norestrict ? true : false;
+    if (no_topo_cachep)
+        *no_topo_cachep = topo_cache ? false : true;
     if (no_update_watchp)
         *no_update_watchp = no_update_watch ? true : false;
     if (R)
@@ -171,7 +179,15 @@ static void config_reload_cb (flux_t *h,
 
     if (flux_conf_reload_decode (msg, &conf) < 0)
         goto error;
-    if (parse_config (ctx, conf, NULL, NULL, NULL, NULL, NULL, &error) < 0) {
+    if (parse_config (ctx,
+                      conf,
+                      NULL,
+                      NULL,
+                      NULL,
+                      NULL,
+                      NULL,
+                      NULL,
+                      &error) < 0) {
         errstr = error.text;
         goto error;
     }
@@ -337,6 +353,7 @@ int mod_main (flux_t *h, int argc, char **argv)
     bool monitor_force_up = false;
     bool noverify = false;
     bool norestrict = false;
+    bool no_topo_cache = false;
     bool no_update_watch = false;
     json_t *R_from_config;
 
@@ -352,6 +369,7 @@ int mod_main (flux_t *h, int argc, char **argv)
                       &R_from_config,
                       &noverify,
                       &norestrict,
+                      &no_topo_cache,
                       &no_update_watch,
                       &error) < 0) {
         flux_log (h, LOG_ERR, "%s", error.text);
@@ -408,7 +426,10 @@ int mod_main (flux_t *h, int argc, char **argv)
     /*  topology is initialized after exclude/drain etc since this
      *  rank may attempt to drain itself due to a topology mismatch.
      */
-    if (!(ctx->topology = topo_create (ctx, noverify, norestrict)))
+    if (!(ctx->topology = topo_create (ctx,
+                                         noverify,
+                                         norestrict,
+                                         no_topo_cache)))
         goto error;
     if (!(ctx->monitor = monitor_create (ctx,
                                          inventory_get_size (ctx->inventory),
@@ -15,11 +15,21 @@
  *
  * Reduce r_local from each rank, leaving the result in topo->reduce->rl
  * on rank 0.  If resources are not known, then this R is set in inventory.
+ *
+ * When the topology must be discovered locally and 'statedir' is set, the
+ * unrestricted topology XML is cached in statedir along with a fingerprint
+ * of the machine (DMI strings, kernel, CPU, NUMA, and PCI device counts).
+ * On restart, the cached XML is reused if the fingerprint matches, avoiding
+ * a full hwloc discovery, which may take seconds on large nodes.
  */
 
 #if HAVE_CONFIG_H
 #include "config.h"
 #endif
+#include <stdio.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/utsname.h>
 #include <jansson.h>
 #include <flux/core.h>
 
@@ -275,7 +285,194 @@ void topo_destroy (struct topo *topo)
     }
 }
 
-static char *topo_get_local_xml (struct resource_ctx *ctx, bool no_restrict)
+/* Read the first line of 'path' into buf, or set buf to "" on failure.
+ */
+static const char *read_line (const char *path, char *buf, size_t len)
+{
+    FILE *fp;
+
+    buf[0] = '\0';
+    if ((fp = fopen (path, "r"))) {
+        if (fgets (buf, len, fp))
+            buf[strcspn (buf, "\n")] = '\0';
+        else
+            buf[0] = '\0';
+        fclose (fp);
+    }
+    return buf;
+}
+
+static int count_dir_entries (const char *path)
+{
+    DIR *dir;
+    struct dirent *dent;
+    int count = 0;
+
+    if (!(dir = opendir (path)))
+        return -1;
+    while ((dent = readdir (dir))) {
+        if (!streq (dent->d_name, ".") && !streq (dent->d_name, ".."))
+            count++;
+    }
+    closedir (dir);
+    return count;
+}
+
+/* Build a cheap fingerprint of the local machine.  Any change in hardware
+ * that would affect the discovered topology is expected to change at least
+ * one of these values.
+ */
+static json_t *topo_fingerprint (void)
+{
+    struct utsname u;
+    char dmi[5][256];
+    char cpus[256];
+    char nodes[256];
+    json_t *o;
+
+    if (uname (&u) < 0)
+        return NULL;
+    if (!(o = json_pack ("{s:i s:{s:s s:s s:s s:s} s:[sssss] s:s s:s s:i}",
+                         "hwloc", (int)hwloc_get_api_version (),
+                         "uname",
+                           "nodename", u.nodename,
+                           "release", u.release,
+                           "version", u.version,
+                           "machine", u.machine,
+                         "dmi",
+                           read_line ("/sys/class/dmi/id/sys_vendor",
+                                      dmi[0], sizeof (dmi[0])),
+                           read_line ("/sys/class/dmi/id/product_name",
+                                      dmi[1], sizeof (dmi[1])),
+                           read_line ("/sys/class/dmi/id/board_name",
+                                      dmi[2], sizeof (dmi[2])),
+                           read_line ("/sys/class/dmi/id/bios_version",
+                                      dmi[3], sizeof (dmi[3])),
+                           read_line ("/sys/class/dmi/id/bios_date",
+                                      dmi[4], sizeof (dmi[4])),
+                         "cpus",
+                           read_line ("/sys/devices/system/cpu/present",
+                                      cpus, sizeof (cpus)),
+                         "nodes",
+                           read_line ("/sys/devices/system/node/online",
+                                      nodes, sizeof (nodes)),
+                         "pci", count_dir_entries ("/sys/bus/pci/devices"))))
+        errno = ENOMEM;
+    return o;
+}
+
+/* Return cached XML from 'path' if its fingerprint matches 'fp'.
+ */
+static char *topo_cache_load (const char *path, json_t *fp)
+{
+    json_t *o;
+    json_t *cached_fp;
+    const char *xml;
+    char *result = NULL;
+
+    if (!(o = json_load_file (path, 0, NULL)))
+        return NULL;
+    if (json_unpack (o,
+                     "{s:o s:s}",
+                     "fingerprint", &cached_fp,
+                     "xml", &xml) == 0
+        && json_equal (fp, cached_fp))
+        result = strdup (xml);
+    json_decref (o);
+    return result;
+}
+
+/* Atomically replace the cache file at 'path'.
+ */
+static int topo_cache_store (const char *path, json_t *fp, const char *xml)
+{
+    char tmp[1024];
+    json_t *o;
+    int rc = -1;
+
+    if (snprintf (tmp, sizeof (tmp), "%s.tmp", path) >= sizeof (tmp)) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+    if (!(o = json_pack ("{s:O s:s}", "fingerprint", fp, "xml", xml))) {
+        errno = ENOMEM;
+        return -1;
+    }
+    if (json_dump_file (o, tmp, JSON_COMPACT) < 0) {
+        errno = EIO;
+        goto out;
+    }
+    if (rename (tmp, path) < 0) {
+        ERRNO_SAFE_WRAP (unlink, tmp);
+        goto out;
+    }
+    rc = 0;
+out:
+    ERRNO_SAFE_WRAP (json_decref, o);
+    return rc;
+}
+
+/* Restrict unrestricted topology XML as requested.  As a side effect,
+ * this validates XML read from the cache.
+ */
+static char *topo_xml_finalize (const char *xml, bool no_restrict)
+{
+    hwloc_topology_t topo;
+
+    if (!no_restrict)
+        return rhwloc_topology_xml_restrict (xml);
+    if (!(topo = rhwloc_xml_topology_load (xml, RHWLOC_NO_RESTRICT)))
+        return NULL;
+    hwloc_topology_destroy (topo);
+    return strdup (xml);
+}
+
+/* Discover the local topology, using the statedir cache if possible.
+ * FLUX_HWLOC_XMLFILE is a test override and bypasses the cache.
+ */
+static char *topo_discover_local_xml (struct resource_ctx *ctx,
+                                      bool no_restrict,
+                                      bool no_cache)
+{
+    const char *statedir;
+    char path[1024];
+    json_t *fp = NULL;
+    char *xml = NULL;
+    char *result = NULL;
+
+    if (no_cache
+        || getenv ("FLUX_HWLOC_XMLFILE")
+        || !(statedir = flux_attr_get (ctx->h, "statedir"))
+        || snprintf (path,
+                     sizeof (path),
+                     "%s/hwloc-topology.json",
+                     statedir) >= sizeof (path)
+        || !(fp = topo_fingerprint ())) {
+        rhwloc_flags_t flags = no_restrict ? RHWLOC_NO_RESTRICT : 0;
+        return rhwloc_local_topology_xml (flags);
+    }
+    if ((xml = topo_cache_load (path, fp))) {
+        if ((result = topo_xml_finalize (xml, no_restrict))) {
+            flux_log (ctx->h, LOG_INFO, "loaded hwloc XML from %s", path);
+            goto out;
+        }
+        flux_log (ctx->h, LOG_ERR, "discarding invalid hwloc cache %s", path);
+        free (xml);
+    }
+    if (!(xml = rhwloc_local_topology_xml (RHWLOC_NO_RESTRICT)))
+        goto out;
+    if (topo_cache_store (path, fp, xml) < 0)
+        flux_log_error (ctx->h, "error writing hwloc cache %s", path);
+    result = topo_xml_finalize (xml, no_restrict);
+out:
+    ERRNO_SAFE_WRAP (free, xml);
+    ERRNO_SAFE_WRAP (json_decref, fp);
+    return result;
+}
+
+static char *topo_get_local_xml (struct resource_ctx *ctx,
+                                 bool no_restrict,
+                                 bool no_cache)
 {
     flux_t *parent_h;
     flux_future_t *f = NULL;
@@ -290,7 +487,6 @@ static char *topo_get_local_xml (struct resource_ctx *ctx, bool no_restrict)
                            FLUX_NODEID_ANY,
                            0))
         || flux_rpc_get (f, &xml) < 0) {
-        rhwloc_flags_t flags = no_restrict ? RHWLOC_NO_RESTRICT : 0;
         /*  ENOENT just means there is no parent instance.
          *  No need for an error.
          */
@@ -299,7 +495,7 @@ static char *topo_get_local_xml (struct resource_ctx *ctx, bool no_restrict)
                       LOG_DEBUG,
                       "resource.topo-get to parent failed: %s",
                       strerror (errno));
-        result = rhwloc_local_topology_xml (flags);
+        result = topo_discover_local_xml (ctx, no_restrict, no_cache);
         goto out;
     }
     flux_log (ctx->h,
@@ -321,7 +517,8 @@ out:
 
 struct topo *topo_create (struct resource_ctx *ctx,
                           bool no_verify,
-                          bool no_restrict)
+                          bool no_restrict,
+                          bool no_cache)
 {
     struct topo *topo;
     json_t *R;
@@ -329,7 +526,7 @@ struct topo *topo_create (struct resource_ctx *ctx,
     if (!(topo = calloc (1, sizeof (*topo))))
         return NULL;
     topo->ctx = ctx;
-    if (!(topo->xml = topo_get_local_xml (ctx, no_restrict))) {
+    if (!(topo->xml = topo_get_local_xml (ctx, no_restrict, no_cache))) {
         flux_log (ctx->h, LOG_ERR, "error loading hwloc topology");
         goto error;
     }
@@ -13,7 +13,8 @@
 
 struct topo *topo_create (struct resource_ctx *ctx,
                           bool no_verify,
-                          bool no_restrict);
+                          bool no_restrict,
+                          bool no_cache);
 void topo_destroy (struct topo *topo);
 
 
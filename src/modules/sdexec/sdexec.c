@@ -579,9 +579,15 @@ static struct sdproc *sdproc_create (struct sdexec_ctx *ctx,
                                      int flags)
 {
     struct sdproc *proc;
+    /* SUBPROCESS_REXEC_RAWIO and SUBPROCESS_REXEC_BATCH are accepted,
+     * but output is always sent as RFC 24 JSON, which the client also
+     * handles.
+     */
     const int valid_flags = SUBPROCESS_REXEC_STDOUT
         | SUBPROCESS_REXEC_STDERR
-        | SUBPROCESS_REXEC_CHANNEL;
+        | SUBPROCESS_REXEC_CHANNEL
+        | SUBPROCESS_REXEC_RAWIO
+        | SUBPROCESS_REXEC_BATCH;
     const char *name;
     char *tmp = NULL;
 
@@ -17,6 +17,7 @@
 #include "config.h"
 #endif
 
+#include <errno.h>
 #include <jansson.h>
 #include <assert.h>
 
@@ -107,6 +108,7 @@ static void shell_eventlogger_unref (struct eventlogger *ev, void *arg)
 
 static int emit_event (struct shell_eventlogger *shev,
                        const char *event,
+                       int flags,
                        bool save_to_emitted_events)
 {
     int rc = -1;
@@ -115,7 +117,7 @@ static int emit_event (struct shell_eventlogger *shev,
     if (o != NULL)
         context = json_dumps (o, JSON_COMPACT);
     if (eventlogger_append (shev->ev,
-                            EVENTLOGGER_FLAG_WAIT,
+                            flags,
                             "exec.eventlog",
                             event,
                             context) < 0)
@@ -154,7 +156,10 @@ static int shell_eventlogger_compare_eventlog (struct shell_eventlogger *shev)
             if ((ret = eventlog_contains_event (s, e->event)) < 0)
                 goto error;
             if (ret == 1) {
-                if (emit_event (shev, e->event, false) < 0)
+                if (emit_event (shev,
+                                e->event,
+                                EVENTLOGGER_FLAG_WAIT,
+                                false) < 0)
                     goto error;
                 e->confirmed_logged = true;
             }
@@ -223,7 +228,22 @@ struct shell_eventlogger *shell_eventlogger_create (flux_shell_t *shell)
 int shell_eventlogger_emit_event (struct shell_eventlogger *shev,
                                   const char *event)
 {
-    return emit_event (shev, event, true);
+    return emit_event (shev, event, EVENTLOGGER_FLAG_WAIT, true);
+}
+
+int shell_eventlogger_emit_event_nowait (struct shell_eventlogger *shev,
+                                         const char *event)
+{
+    return emit_event (shev, event, EVENTLOGGER_FLAG_ASYNC, true);
+}
+
+int shell_eventlogger_flush (struct shell_eventlogger *shev)
+{
+    if (!shev) {
+        errno = EINVAL;
+        return -1;
+    }
+    return eventlogger_flush (shev->ev);
 }
 
 static int context_set (struct shell_eventlogger *shev,
@@ -19,6 +19,18 @@ struct shell_eventlogger *shell_eventlogger_create (flux_shell_t *shell);
 int shell_eventlogger_emit_event (struct shell_eventlogger *shev,
                                   const char *event);
 
+/*  Append event to the batch of pending exec.eventlog entries, so it
+ *   may be committed together with the next event (or after the batch
+ *   timeout) instead of in a commit of its own.
+ */
+int shell_eventlogger_emit_event_nowait (struct shell_eventlogger *shev,
+                                         const char *event);
+
+/*  Commit any pending exec.eventlog entries and wait for the result,
+ *   e.g. before the shell exits on a fatal error.
+ */
+int shell_eventlogger_flush (struct shell_eventlogger *shev);
+
 int shell_eventlogger_context_vpack (struct shell_eventlogger *shev,
                                      const char *event,
                                      int flags,
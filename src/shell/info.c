@@ -15,6 +15,8 @@
 #include "config.h"
 #endif
 #include <unistd.h>
+#include <string.h>
+#include <errno.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -23,30 +25,34 @@
 
 #include "src/common/libutil/read_all.h"
 #include "src/common/librlist/rhwloc.h"
+#include "src/common/libcontent/content.h"
 #include "ccan/str/str.h"
 
 #include "internal.h"
 #include "info.h"
 #include "jobspec.h"
 
+static int unwrap_jobspec (const char *J, char **jobspec)
+{
+    flux_error_t error;
+    if (!(*jobspec = flux_unwrap_string (J, true, NULL, &error))) {
+        shell_log_error ("failed to unwrap J: %s", error.text);
+        return -1;
+    }
+    return 0;
+}
+
 /* Get jobspec from job-info.lookup future and assign.
  * Return 0 on success, -1 on failure (and log error).
- * N.B. assigned values remain valid until future is destroyed.
  */
 static int lookup_jobspec_get (flux_future_t *f, char **jobspec)
 {
-    flux_error_t error;
     const char *J;
-    if (flux_rpc_get_unpack (f, "{s:s}", "J", &J) < 0)
-        goto error;
-    if (!(*jobspec = flux_unwrap_string (J, true, NULL, &error))) {
-        shell_log_error ("failed to unwrap J: %s", error.text);
+    if (flux_rpc_get_unpack (f, "{s:s}", "J", &J) < 0) {
+        shell_log_error ("job-info: %s", future_strerror (f, errno));
         return -1;
     }
-    return 0;
-error:
-    shell_log_error ("job-info: %s", future_strerror (f, errno));
-    return -1;
+    return unwrap_jobspec (J, jobspec);
 }
 
 /* Fetch J from the job-info service.
@@ -68,32 +74,48 @@ static flux_future_t *lookup_jobspec (flux_t *h, flux_jobid_t jobid)
     return f;
 }
 
+/*  Replace the shell's internal info->R and info->rcalc with R.
+ */
+static int shell_info_set_R (struct shell_info *info, json_t *R)
+{
+    rcalc_t *rcalc;
+
+    if (!(rcalc = rcalc_create_json (R))) {
+        shell_log_error ("error decoding R");
+        return -1;
+    }
+    /*  Swap previous and updated R, rcalc:
+     */
+    json_decref (info->R);
+    info->R = json_incref (R);
+    rcalc_destroy (info->rcalc);
+    info->rcalc = rcalc;
+    return 0;
+}
+
 /*  Unpack R from a job-info.update-watch response and update the
  *  shell's internal info->R and info->rcalc. If a response can't be
  *  unpacked or rcalc_create_json() fails, just ignore this response
  *  and let caller decide if the error is fatal.
+ *  Return 1 if R is unchanged, e.g. for the first response when R was
+ *  passed in with the launch.
  */
 static int resource_watch_update (struct shell_info *info)
 {
     int rc = -1;
     flux_future_t *f = info->R_watch_future;
     json_t *R = NULL;
-    rcalc_t *rcalc = NULL;
 
     if (flux_rpc_get_unpack (f, "{s:o}", "R", &R) < 0) {
         shell_log_errno ("error getting R from job-info watch response");
         goto out;
     }
-    if (!(rcalc = rcalc_create_json (R))) {
-        shell_log_error ("error decoding R");
+    if (info->R && json_equal (R, info->R)) {
+        rc = 1;
         goto out;
     }
-    /*  Swap previous and updated R, rcalc:
-     */
-    json_decref (info->R);
-    info->R = json_incref (R);
-    rcalc_destroy (info->rcalc);
-    info->rcalc = rcalc;
+    if (shell_info_set_R (info, R) < 0)
+        goto out;
     rc = 0;
 out:
     flux_future_reset (f);
@@ -104,7 +126,7 @@ static void R_update_cb (flux_future_t *f, void *arg)
 {
     flux_shell_t *shell = arg;
 
-    if (resource_watch_update (shell->info) < 0)
+    if (resource_watch_update (shell->info) != 0)
         return;
 
     /*  Destroy cached shell "info" JSON object otherwise plugins will
@@ -119,18 +141,66 @@ static void R_update_cb (flux_future_t *f, void *arg)
     (void) flux_shell_plugstack_call (shell, "shell.resource-update", NULL);
 }
 
-/*  Fetch jobinfo (jobspec, R) from job-info service if not provided on
- *   command line, and parse.
+/*  Get J and R from the blob stored by job-exec (see job-exec/exec.c).
+ *  Return 0 on success, -1 on failure.  Since the caller falls back to
+ *  job-info, a failed load is only logged at debug level.
+ */
+static int jobinfo_blob_get (flux_future_t *f,
+                             struct shell_info *info,
+                             char **jobspec)
+{
+    const void *buf;
+    int len;
+    json_t *o = NULL;
+    json_t *R;
+    const char *J;
+    json_error_t error;
+    int rc = -1;
+
+    if (content_load_get (f, &buf, &len) < 0) {
+        shell_debug ("error loading job info: %s",
+                     future_strerror (f, errno));
+        return -1;
+    }
+    if (!(o = json_loadb (buf, len, 0, &error))
+        || json_unpack_ex (o, &error, 0, "{s:s s:o}", "J", &J, "R", &R) < 0) {
+        shell_log_error ("error decoding job info: %s", error.text);
+        goto out;
+    }
+    if (unwrap_jobspec (J, jobspec) < 0)
+        goto out;
+    if (shell_info_set_R (info, R) < 0) {
+        free (*jobspec);
+        *jobspec = NULL;
+        goto out;
+    }
+    shell_debug ("loaded J and R from content blob");
+    rc = 0;
+out:
+    json_decref (o);
+    return rc;
+}
+
+/*  Fetch jobinfo (jobspec, R) and parse.  If job-exec passed J and R
+ *   with the launch, load them from the content cache, otherwise fetch
+ *   them from the job-info service.  In either case, watch R for updates.
  */
 static int shell_init_jobinfo (flux_shell_t *shell, struct shell_info *info)
 {
     int rc = -1;
     flux_future_t *f_info = NULL;
     flux_future_t *f_hwloc = NULL;
+    flux_future_t *f_blob = NULL;
+    const char *blobref = getenv ("FLUX_JOB_INFO_BLOBREF");
     const char *xml;
     char *jobspec = NULL;
     json_error_t error;
 
+    if (blobref && !(f_blob = content_load_byblobref (shell->h, blobref, 0)))
+        shell_debug ("error requesting job info %s: %s",
+                     blobref,
+                     strerror (errno));
+
     /*  fetch hwloc topology from resource module to avoid having to
      *  load from scratch here. The topology XML is then cached for
      *  future shell plugin use.
@@ -154,9 +224,9 @@ static int shell_init_jobinfo (flux_shell_t *shell, struct shell_info *info)
                                                 "flags", 0)))
         goto out;
 
-    /*  fetch jobspec (via J) for this job
+    /*  fetch jobspec (via J) for this job, unless it was passed in
      */
-    if (!(f_info = lookup_jobspec (shell->h, shell->jobid)))
+    if (!f_blob && !(f_info = lookup_jobspec (shell->h, shell->jobid)))
         goto out;
 
     if (flux_rpc_get (f_hwloc, &xml) < 0
@@ -167,7 +237,12 @@ static int shell_init_jobinfo (flux_shell_t *shell, struct shell_info *info)
             goto out;
         }
     }
-    if (lookup_jobspec_get (f_info, &jobspec) < 0) {
+    if (f_blob && jobinfo_blob_get (f_blob, info, &jobspec) < 0) {
+        shell_debug ("falling back to job-info for J and R");
+        if (!(f_info = lookup_jobspec (shell->h, shell->jobid)))
+            goto out;
+    }
+    if (f_info && lookup_jobspec_get (f_info, &jobspec) < 0) {
         shell_log_error ("error fetching jobspec");
         goto out;
     }
@@ -177,9 +252,10 @@ static int shell_init_jobinfo (flux_shell_t *shell, struct shell_info *info)
     }
 
     /*  Synchronously get initial version of R from first job-info
-     *  watch response:
+     *  watch response, unless R was passed in.  Otherwise, the first
+     *  response is handled by R_update_cb() and ignored if R is unchanged.
      */
-    if (resource_watch_update (info) < 0)
+    if (!info->R && resource_watch_update (info) < 0)
         goto out;
 
     /*  Register callback for future R updates:
@@ -196,6 +272,7 @@ out:
     free (jobspec);
     flux_future_destroy (f_hwloc);
     flux_future_destroy (f_info);
+    flux_future_destroy (f_blob);
     return rc;
 }
 
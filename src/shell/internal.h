@@ -11,6 +11,8 @@
 #ifndef _SHELL_INTERNAL_H
 #define _SHELL_INTERNAL_H
 
+#include <time.h>
+#include <jansson.h>
 #include <flux/core.h>
 #include <flux/optparse.h>
 #include <flux/shell.h>
@@ -41,6 +43,7 @@ struct flux_shell {
     struct mustache_renderer *mr;
 
     struct plugstack *plugstack;
+    struct rccache *rccache;
     struct shell_eventlogger *ev;
 
     zhashx_t *completion_refs;
@@ -50,6 +53,9 @@ struct flux_shell {
     int verbose;
     int nosetpgrp;
 
+    struct timespec init_mark;  /* time of last init phase mark */
+    json_t *init_timing;        /* init phase durations for shell.init */
+
     struct aux_item *aux;
 };
 
@@ -291,6 +291,12 @@ void flux_shell_fatal (const char *component,
      */
     flux_shell_killall (shell, SIGKILL);
 
+    /*  Commit events appended without waiting (e.g. shell.init) so
+     *   that they are not lost when the shell exits below.
+     */
+    if (shell && shell->ev)
+        (void)shell_eventlogger_flush (shell->ev);
+
     if (shell)
         flux_shell_raise ("exec", 0, "%s", buf);
 
@@ -36,6 +36,15 @@
  *   synchronously waited for to complete.
  * - The number of in-flight write requests on each shell is limited to
  *   shell_output_hwm, to avoid matchtag exhaustion, etc. for chatty tasks.
+ * - Follower shells batch output from their tasks and send it to the
+ *   leader in a single "batch" write request once shell_output_batch_max
+ *   entries or shell_output_batch_bytes of data are pending, or after
+ *   output.rpc-batch-timeout seconds, whichever comes first.
+ * - Output of leader shell tasks to a file is written directly to the
+ *   file descriptor, without first being encoded as an RFC 24 event.
+ * - With output.storage=blob, KVS output entries are stored in compressed
+ *   chunks by the output chunk writer (see output_chunk.c), and only a
+ *   "chunk" index event per chunk is appended to the output eventlog.
  */
 #define FLUX_SHELL_PLUGIN_NAME "output"
 
@@ -56,6 +65,7 @@
 #include "src/common/libutil/parse_size.h"
 #include "ccan/str/str.h"
 
+#include "output_chunk.h"
 #include "task.h"
 #include "svc.h"
 #include "internal.h"
@@ -67,6 +77,9 @@
 #define OUTPUT_LIMIT_MAX        1073741824
 /* 104857600 = 100M */
 #define OUTPUT_LIMIT_WARNING    104857600
+#define OUTPUT_CHUNK_SIZE       "1M"
+/* 67108864 = 64M */
+#define OUTPUT_CHUNK_SIZE_MAX   67108864
 
 enum {
     FLUX_OUTPUT_TYPE_TERM = 1,
@@ -90,10 +103,15 @@ struct shell_output {
     const char *kvs_limit_string;
     size_t kvs_limit_bytes;
     struct eventlogger *ev;
+    struct output_chunk_writer *chunks;
     double batch_timeout;
     int refcount;
     struct idset *active_shells;
     zlist_t *pending_writes;
+    json_t *batch;
+    size_t batch_bytes;
+    double rpc_batch_timeout;
+    flux_watcher_t *batch_timer;
     json_t *output;
     bool stopped;
     int stdout_type;
@@ -109,6 +127,8 @@ struct shell_output {
 
 static const int shell_output_lwm = 100;
 static const int shell_output_hwm = 1000;
+static const int shell_output_batch_max = 256;
+static const size_t shell_output_batch_bytes = 262144;
 
 /* Pause/resume output for all tasks.
  */
@@ -371,7 +391,14 @@ static int shell_output_kvs (struct shell_output *out)
         if (entry_output_is_kvs (out, entry, &is_stdout, &len, &eof)) {
             bool truncate = check_kvs_output_limit (out, is_stdout, len);
             if (!truncate || eof) {
-                if (eventlogger_append_entry (out->ev, 0, "output", entry) < 0)
+                if (out->chunks) {
+                    if (output_chunk_writer_append (out->chunks, entry) < 0)
+                        return shell_log_errno ("output_chunk_writer_append");
+                }
+                else if (eventlogger_append_entry (out->ev,
+                                                   0,
+                                                   "output",
+                                                   entry) < 0)
                     return shell_log_errno ("eventlogger_append");
             }
         }
@@ -403,6 +430,36 @@ static int shell_output_label (struct shell_output_type_file *ofp,
     return 0;
 }
 
+/*  Return the output type for stream, and if ofpp is non-NULL, set it
+ *   to the file output settings for stream.
+ */
+static int shell_output_stream_type (struct shell_output *out,
+                                     const char *stream,
+                                     struct shell_output_type_file **ofpp)
+{
+    if (streq (stream, "stdout")) {
+        if (ofpp)
+            *ofpp = &out->stdout_file;
+        return out->stdout_type;
+    }
+    if (ofpp)
+        *ofpp = &out->stderr_file;
+    return out->stderr_type;
+}
+
+static int shell_output_file_write (struct shell_output_type_file *ofp,
+                                    const char *rank,
+                                    const void *data,
+                                    int len)
+{
+    if (ofp->label
+        && shell_output_label (ofp, rank) < 0)
+        return -1;
+    if (shell_output_write_fd (ofp->fdp->fd, data, len) < 0)
+        return -1;
+    return 0;
+}
+
 static int shell_output_data (struct shell_output *out, json_t *context)
 {
     struct shell_output_type_file *ofp;
@@ -417,19 +474,9 @@ static int shell_output_data (struct shell_output *out, json_t *context)
         shell_log_errno ("iodecode");
         return -1;
     }
-    if (streq (stream, "stdout")) {
-        output_type = out->stdout_type;
-        ofp = &out->stdout_file;
-    }
-    else {
-        output_type = out->stderr_type;
-        ofp = &out->stderr_file;
-    }
+    output_type = shell_output_stream_type (out, stream, &ofp);
     if ((output_type == FLUX_OUTPUT_TYPE_FILE) && len > 0) {
-        if (ofp->label
-            && shell_output_label (ofp, rank) < 0)
-            goto out;
-        if (shell_output_write_fd (ofp->fdp->fd, data, len) < 0)
+        if (shell_output_file_write (ofp, rank, data, len) < 0)
             goto out;
     }
     rc = 0;
@@ -560,6 +607,8 @@ static void shell_output_decref (struct shell_output *out,
             || (out->stderr_type == FLUX_OUTPUT_TYPE_KVS))) {
             if (eventlogger_flush (out->ev) < 0)
                 shell_log_errno ("eventlogger_flush");
+            if (out->chunks && output_chunk_writer_flush (out->chunks) < 0)
+                shell_log_errno ("output_chunk_writer_flush");
         }
     }
 }
@@ -573,25 +622,26 @@ static void shell_output_decref_shell_rank (struct shell_output *out,
         shell_output_decref (out, mh);
 }
 
-static int shell_output_write_leader (struct shell_output *out,
-                                      const char *type,
-                                      int shell_rank,
-                                      json_t *o,
-                                      flux_msg_handler_t *mh) // may be NULL
+static int shell_output_append_leader (struct shell_output *out,
+                                       const char *type,
+                                       json_t *o)
 {
     json_t *entry;
 
-    if (streq (type, "eof")) {
-        shell_output_decref_shell_rank (out, shell_rank, mh);
-        return 0;
-    }
     if (!(entry = eventlog_entry_pack (0., type, "O", o))) // increfs 'o'
-        goto error;
+        return -1;
     if (json_array_append_new (out->output, entry) < 0) {
         json_decref (entry);
         errno = ENOMEM;
-        goto error;
+        return -1;
     }
+    return 0;
+}
+
+/*  Dispose of all output entries accumulated on the leader.
+ */
+static int shell_output_flush_leader (struct shell_output *out)
+{
     /* Error failing to commit is a fatal error.  Should be cleaner in
      * future. Issue #2378 */
     if ((out->stdout_type == FLUX_OUTPUT_TYPE_TERM
@@ -611,11 +661,64 @@ static int shell_output_write_leader (struct shell_output *out,
     }
     if (json_array_clear (out->output) < 0) {
         shell_log_error ("json_array_clear failed");
-        goto error;
+        return -1;
     }
     return 0;
-error:
-    return -1;
+}
+
+static int shell_output_write_leader (struct shell_output *out,
+                                      const char *type,
+                                      int shell_rank,
+                                      json_t *o,
+                                      flux_msg_handler_t *mh) // may be NULL
+{
+    if (streq (type, "eof")) {
+        shell_output_decref_shell_rank (out, shell_rank, mh);
+        return 0;
+    }
+    if (shell_output_append_leader (out, type, o) < 0)
+        return -1;
+    return shell_output_flush_leader (out);
+}
+
+/*  Append a batch of output entries from a follower shell, then dispose
+ *   of them all at once, so that KVS output of the batch is added to a
+ *   single eventlogger batch.
+ */
+static int shell_output_write_leader_batch (struct shell_output *out,
+                                            int shell_rank,
+                                            json_t *o,
+                                            flux_msg_handler_t *mh)
+{
+    json_t *entries;
+    json_t *entry;
+    size_t index;
+
+    if (json_unpack (o, "{s:o}", "entries", &entries) < 0
+        || !json_is_array (entries)) {
+        errno = EPROTO;
+        return -1;
+    }
+    json_array_foreach (entries, index, entry) {
+        const char *type;
+        json_t *context;
+
+        if (json_unpack (entry,
+                         "{s:s s:o}",
+                         "name", &type,
+                         "context", &context) < 0) {
+            errno = EPROTO;
+            return -1;
+        }
+        if (streq (type, "eof")) {
+            if (shell_output_flush_leader (out) < 0)
+                return -1;
+            shell_output_decref_shell_rank (out, shell_rank, mh);
+        }
+        else if (shell_output_append_leader (out, type, context) < 0)
+            return -1;
+    }
+    return shell_output_flush_leader (out);
 }
 
 /* Convert 'iodecode' object to an valid RFC 24 data event.
@@ -638,7 +741,11 @@ static void shell_output_write_cb (flux_t *h,
                              "shell_rank", &shell_rank,
                              "context", &o) < 0)
         goto error;
-    if (shell_output_write_leader (out, type, shell_rank, o, mh) < 0)
+    if (streq (type, "batch")) {
+        if (shell_output_write_leader_batch (out, shell_rank, o, mh) < 0)
+            goto error;
+    }
+    else if (shell_output_write_leader (out, type, shell_rank, o, mh) < 0)
         goto error;
     if (flux_respond (out->shell->h, msg, NULL) < 0)
         shell_log_errno ("flux_respond");
@@ -661,40 +768,92 @@ static void shell_output_write_completion (flux_future_t *f, void *arg)
         shell_output_control (out, false);
 }
 
-static int shell_output_write_type (struct shell_output *out,
-                                    char *type,
-                                    json_t *context)
+/*  Send all batched output entries of a follower shell to the leader.
+ */
+static int shell_output_batch_flush (struct shell_output *out)
 {
     flux_future_t *f = NULL;
-    int shell_rank = out->shell->info->shell_rank;
 
-    if (shell_rank == 0) {
-        if (shell_output_write_leader (out, type, 0, context, NULL) < 0)
-            shell_log_errno ("shell_output_write_leader");
-    }
-    else {
-        if (!(f = flux_shell_rpc_pack (out->shell,
-                                       "write",
-                                        0,
-                                        0,
-                                        "{s:s s:i s:O}",
-                                        "name", type,
-                                        "shell_rank", shell_rank,
-                                        "context", context)))
-            goto error;
-        if (flux_future_then (f, -1, shell_output_write_completion, out) < 0)
-            goto error;
-        if (zlist_append (out->pending_writes, f) < 0)
-            shell_log_error ("zlist_append failed");
-        if (zlist_size (out->pending_writes) >= shell_output_hwm)
-            shell_output_control (out, true);
-    }
+    flux_watcher_stop (out->batch_timer);
+    if (!out->batch || json_array_size (out->batch) == 0)
+        return 0;
+    if (!(f = flux_shell_rpc_pack (out->shell,
+                                   "write",
+                                    0,
+                                    0,
+                                    "{s:s s:i s:{s:O}}",
+                                    "name", "batch",
+                                    "shell_rank", out->shell->info->shell_rank,
+                                    "context",
+                                      "entries", out->batch)))
+        goto error;
+    json_array_clear (out->batch);
+    out->batch_bytes = 0;
+    if (flux_future_then (f, -1, shell_output_write_completion, out) < 0)
+        goto error;
+    if (zlist_append (out->pending_writes, f) < 0)
+        shell_log_error ("zlist_append failed");
+    if (zlist_size (out->pending_writes) >= shell_output_hwm)
+        shell_output_control (out, true);
     return 0;
 error:
     flux_future_destroy (f);
     return -1;
 }
 
+static void batch_timer_cb (flux_reactor_t *r,
+                            flux_watcher_t *w,
+                            int revents,
+                            void *arg)
+{
+    struct shell_output *out = arg;
+    if (shell_output_batch_flush (out) < 0)
+        shell_log_errno ("shell_output_batch_flush");
+}
+
+static int shell_output_batch_append (struct shell_output *out,
+                                      const char *type,
+                                      json_t *context,
+                                      size_t len)
+{
+    json_t *entry;
+
+    if (!(entry = json_pack ("{s:s s:O}",
+                             "name", type,
+                             "context", context))
+        || json_array_append_new (out->batch, entry) < 0) {
+        json_decref (entry);
+        errno = ENOMEM;
+        return -1;
+    }
+    out->batch_bytes += len;
+    if (json_array_size (out->batch) >= shell_output_batch_max
+        || out->batch_bytes >= shell_output_batch_bytes
+        || out->rpc_batch_timeout <= 0.)
+        return shell_output_batch_flush (out);
+    if (json_array_size (out->batch) == 1) {
+        flux_timer_watcher_reset (out->batch_timer,
+                                  out->rpc_batch_timeout,
+                                  0.);
+        flux_watcher_start (out->batch_timer);
+    }
+    return 0;
+}
+
+static int shell_output_write_type (struct shell_output *out,
+                                    char *type,
+                                    json_t *context,
+                                    size_t len)
+{
+    if (out->shell->info->shell_rank == 0) {
+        if (shell_output_write_leader (out, type, 0, context, NULL) < 0)
+            shell_log_errno ("shell_output_write_leader");
+    }
+    else if (shell_output_batch_append (out, type, context, len) < 0)
+        return -1;
+    return 0;
+}
+
 static int shell_output_write (struct shell_output *out,
                                int rank,
                                const char *stream,
@@ -705,15 +864,28 @@ static int shell_output_write (struct shell_output *out,
     int rc;
     json_t *o = NULL;
     char rankstr[13];
+    struct shell_output_type_file *ofp;
 
     /* integer %d guaranteed to fit in 13 bytes
      */
     (void) snprintf (rankstr, sizeof (rankstr), "%d", rank);
+
+    /* Leader shell tasks writing to a file: skip the RFC 24 encoding
+     *  and write data directly to the output file.  Entries are not
+     *  retained on the leader, so this does not reorder output.
+     */
+    if (out->shell->info->shell_rank == 0
+        && shell_output_stream_type (out, stream, &ofp)
+           == FLUX_OUTPUT_TYPE_FILE) {
+        if (len > 0 && shell_output_file_write (ofp, rankstr, data, len) < 0)
+            return -1;
+        return 0;
+    }
     if (!(o = ioencode (stream, rankstr, data, len, eof))) {
         shell_log_errno ("ioencode");
         return -1;
     }
-    rc = shell_output_write_type (out, "data", o);
+    rc = shell_output_write_type (out, "data", o, len);
     json_decref (o);
     return rc;
 }
@@ -754,9 +926,12 @@ void shell_output_destroy (struct shell_output *out)
         flux_future_t *f = NULL;
 
         if (shell_rank != 0) {
-            /* Nonzero shell rank: send EOF to leader shell to notify
-             *  that no more messages will be sent to shell.write
+            /* Nonzero shell rank: send any batched output, then send
+             *  EOF to leader shell to notify that no more messages will
+             *  be sent to shell.write
              */
+            if (shell_output_batch_flush (out) < 0)
+                shell_log_errno ("shell_output_batch_flush");
             if (!(f = flux_shell_rpc_pack (out->shell,
                                            "write",
                                             0,
@@ -779,6 +954,8 @@ void shell_output_destroy (struct shell_output *out)
             }
             zlist_destroy (&out->pending_writes);
         }
+        flux_watcher_destroy (out->batch_timer);
+        json_decref (out->batch);
         if (out->output && json_array_size (out->output) > 0) { // leader only
             if ((out->stdout_type == FLUX_OUTPUT_TYPE_TERM)
                 || (out->stderr_type == FLUX_OUTPUT_TYPE_TERM)) {
@@ -796,6 +973,7 @@ void shell_output_destroy (struct shell_output *out)
                     shell_log_errno ("shell_output_file");
             }
         }
+        output_chunk_writer_destroy (out->chunks);
         json_decref (out->output);
         shell_output_type_file_cleanup (&out->stdout_file);
         shell_output_type_file_cleanup (&out->stderr_file);
@@ -1153,6 +1331,84 @@ static int output_eventlogger_start (struct shell_output *out)
     return 0;
 }
 
+/*  Set up blob storage of KVS output if output.storage=blob.
+ */
+static int output_storage_start (struct shell_output *out)
+{
+    const char *storage = "eventlog";
+    json_t *val = NULL;
+    uint64_t chunk_size;
+
+    if (flux_shell_getopt_unpack (out->shell,
+                                  "output",
+                                  "{s?s s?o}",
+                                  "storage", &storage,
+                                  "chunk-size", &val) < 0)
+        return shell_log_errno ("invalid output.storage option");
+    if (streq (storage, "eventlog"))
+        return 0;
+    if (!streq (storage, "blob"))
+        return shell_log_errn (EINVAL,
+                               "invalid output.storage=%s",
+                               storage);
+    if (out->stdout_type != FLUX_OUTPUT_TYPE_KVS
+        && out->stderr_type != FLUX_OUTPUT_TYPE_KVS)
+        return 0;
+    /*  Guests cannot store content blobs, and could not read them back.
+     */
+    if (out->shell->broker_owner != getuid ()) {
+        shell_warn ("output.storage=blob requires a single-user instance,"
+                    " using eventlog");
+        return 0;
+    }
+    if (val && json_is_integer (val))
+        chunk_size = json_integer_value (val);
+    else if (val && json_is_string (val)) {
+        if (parse_size (json_string_value (val), &chunk_size) < 0)
+            chunk_size = 0;
+    }
+    else if (val || parse_size (OUTPUT_CHUNK_SIZE, &chunk_size) < 0)
+        chunk_size = 0;
+    if (chunk_size == 0 || chunk_size > OUTPUT_CHUNK_SIZE_MAX)
+        return shell_log_errn (EINVAL, "invalid output.chunk-size");
+
+    shell_debug ("output storage = blob, chunk size = %s",
+                 encode_size (chunk_size));
+
+    if (!(out->chunks = output_chunk_writer_create (out->shell,
+                                                    chunk_size,
+                                                    out->batch_timeout)))
+        return shell_log_errno ("output_chunk_writer_create");
+    return 0;
+}
+
+static int output_batch_start (struct shell_output *out)
+{
+    flux_t *h = flux_shell_get_flux (out->shell);
+
+    out->rpc_batch_timeout = 0.01;
+
+    if (flux_shell_getopt_unpack (out->shell,
+                                  "output",
+                                  "{s?F}",
+                                  "rpc-batch-timeout",
+                                  &out->rpc_batch_timeout) < 0)
+        return shell_log_errno ("invalid output.rpc-batch-timeout option");
+
+    if (!(out->batch = json_array ())) {
+        errno = ENOMEM;
+        return -1;
+    }
+    out->batch_timer = flux_timer_watcher_create (flux_get_reactor (h),
+                                                  out->rpc_batch_timeout,
+                                                  0.,
+                                                  batch_timer_cb,
+                                                  out);
+    if (!out->batch_timer)
+        return shell_log_errno ("flux_timer_watcher_create");
+    return 0;
+}
+
 static int log_output (flux_plugin_t *p,
                        const char *topic,
                        flux_plugin_arg_t *args,
@@ -1169,7 +1425,7 @@ static int log_output (flux_plugin_t *p,
     if (level > FLUX_SHELL_NOTICE + out->shell->verbose)
         return 0;
     if (flux_plugin_arg_unpack (args, FLUX_PLUGIN_ARG_IN, "o", &context) < 0
-        || shell_output_write_type (out, "log", context) < 0) {
+        || shell_output_write_type (out, "log", context, 0) < 0) {
         rc = -1;
     }
     return rc;
@@ -1270,7 +1526,11 @@ struct shell_output *shell_output_create (flux_shell_t *shell)
 
     if (!(out->pending_writes = zlist_new ()))
         goto error;
-    if (shell->info->shell_rank == 0) {
+    if (shell->info->shell_rank != 0) {
+        if (output_batch_start (out) < 0)
+            goto error;
+    }
+    else {
         int ntasks = out->shell->info->rankinfo.ntasks;
         if (output_type_requires_service (out->stdout_type)
             || output_type_requires_service (out->stderr_type)) {
@@ -1325,6 +1585,8 @@ struct shell_output *shell_output_create (flux_shell_t *shell)
         }
         if (output_eventlogger_start (out) < 0)
             goto error;
+        if (output_storage_start (out) < 0)
+            goto error;
         if (shell_output_header (out) < 0)
             goto error;
     }
@@ -0,0 +1,378 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* output chunk writer
+ *
+ * Used by the output plugin when output.storage=blob.  Output eventlog
+ * entries are appended to an in-memory chunk in RFC 18 eventlog format.
+ * When a chunk is full, or output.batch-timeout expires, the chunk is
+ * compressed with LZ4 and stored with content.store.  Once the store
+ * completes, a single KVS transaction links the blob into the guest
+ * namespace and appends a "chunk" index event to the output eventlog.
+ *
+ * Chunks are processed strictly in order, one at a time, so that the
+ * index events appear in the output eventlog in the order the output
+ * was produced.  A shell completion reference is held while a chunk is
+ * in progress.
+ */
+#define FLUX_SHELL_PLUGIN_NAME "output"
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <lz4.h>
+#include <jansson.h>
+#include <flux/core.h>
+#include <flux/shell.h>
+
+#include "src/common/libczmqcontainers/czmq_containers.h"
+#include "src/common/libeventlog/eventlog.h"
+#include "src/common/libkvs/treeobj.h"
+#include "src/common/libcontent/content.h"
+#include "src/common/libutil/errno_safe.h"
+
+#include "output_chunk.h"
+
+struct chunk {
+    int seq;
+    char *data;                 /* compressed chunk */
+    int len;
+    size_t size;                /* uncompressed size */
+    int entries;
+};
+
+struct output_chunk_writer {
+    flux_shell_t *shell;
+    flux_t *h;
+    const char *hashtype;
+    size_t chunk_size;
+    double timeout;
+    flux_watcher_t *timer;
+
+    /* current chunk */
+    char *buf;
+    size_t len;
+    size_t bufsize;
+    int entries;
+
+    int seq;
+    zlist_t *queue;             /* chunks to store, head is in progress */
+    flux_future_t *store_f;
+    flux_future_t *commit_f;
+};
+
+static void chunk_destroy (struct chunk *c)
+{
+    if (c) {
+        int saved_errno = errno;
+        free (c->data);
+        free (c);
+        errno = saved_errno;
+    }
+}
+
+static void chunk_store_continuation (flux_future_t *f, void *arg);
+static void chunk_commit_continuation (flux_future_t *f, void *arg);
+
+static int chunk_start (struct output_chunk_writer *ocw, struct chunk *c)
+{
+    if (!(ocw->store_f = content_store (ocw->h, c->data, c->len, 0))
+        || flux_future_then (ocw->store_f,
+                             -1.,
+                             chunk_store_continuation,
+                             ocw) < 0) {
+        ERRNO_SAFE_WRAP (flux_future_destroy, ocw->store_f);
+        ocw->store_f = NULL;
+        return -1;
+    }
+    flux_shell_add_completion_ref (ocw->shell, "output.chunk");
+    return 0;
+}
+
+/*  Start the chunk at the head of the queue if no chunk is in progress.
+ *   Chunks that cannot be started are dropped.
+ */
+static void chunk_next (struct output_chunk_writer *ocw)
+{
+    struct chunk *c;
+
+    if (ocw->store_f || ocw->commit_f)
+        return;
+    while ((c = zlist_first (ocw->queue))) {
+        if (chunk_start (ocw, c) == 0)
+            return;
+        shell_log_errno ("failed to store output chunk %d", c->seq);
+        zlist_remove (ocw->queue, c);
+        chunk_destroy (c);
+    }
+}
+
+/*  The chunk at the head of the queue is done (or failed), move on.
+ */
+static void chunk_finish (struct output_chunk_writer *ocw)
+{
+    chunk_destroy (zlist_pop (ocw->queue));
+    flux_shell_remove_completion_ref (ocw->shell, "output.chunk");
+    chunk_next (ocw);
+}
+
+static int chunk_commit (struct output_chunk_writer *ocw,
+                         struct chunk *c,
+                         flux_future_t *f)
+{
+    const char *blobref;
+    char key[64];
+    json_t *valref = NULL;
+    char *s = NULL;
+    json_t *entry = NULL;
+    char *entrystr = NULL;
+    flux_kvs_txn_t *txn = NULL;
+    int rc = -1;
+
+    (void) snprintf (key, sizeof (key), "output-chunks.%d", c->seq);
+    if (content_store_get_blobref (f, ocw->hashtype, &blobref) < 0
+        || !(valref = treeobj_create_valref (blobref))
+        || !(s = treeobj_encode (valref))
+        || !(entry = eventlog_entry_pack (0.,
+                                          "chunk",
+                                          "{s:i s:s s:s s:I s:i}",
+                                          "seq", c->seq,
+                                          "blobref", blobref,
+                                          "encoding", "lz4",
+                                          "size", (json_int_t) c->size,
+                                          "entries", c->entries))
+        || !(entrystr = eventlog_entry_encode (entry))
+        || !(txn = flux_kvs_txn_create ())
+        || flux_kvs_txn_put_treeobj (txn, 0, key, s) < 0
+        || flux_kvs_txn_put (txn, FLUX_KVS_APPEND, "output", entrystr) < 0
+        || !(ocw->commit_f = flux_kvs_commit (ocw->h, NULL, 0, txn))
+        || flux_future_then (ocw->commit_f,
+                             -1.,
+                             chunk_commit_continuation,
+                             ocw) < 0) {
+        ERRNO_SAFE_WRAP (flux_future_destroy, ocw->commit_f);
+        ocw->commit_f = NULL;
+        goto out;
+    }
+    rc = 0;
+out:
+    ERRNO_SAFE_WRAP (json_decref, valref);
+    ERRNO_SAFE_WRAP (free, s);
+    ERRNO_SAFE_WRAP (json_decref, entry);
+    ERRNO_SAFE_WRAP (free, entrystr);
+    ERRNO_SAFE_WRAP (flux_kvs_txn_destroy, txn);
+    return rc;
+}
+
+static void chunk_store_continuation (flux_future_t *f, void *arg)
+{
+    struct output_chunk_writer *ocw = arg;
+    struct chunk *c = zlist_first (ocw->queue);
+
+    ocw->store_f = NULL;
+    if (chunk_commit (ocw, c, f) < 0) {
+        shell_log_errno ("failed to store output chunk %d", c->seq);
+        chunk_finish (ocw);
+    }
+    flux_future_destroy (f);
+}
+
+static void chunk_commit_continuation (flux_future_t *f, void *arg)
+{
+    struct output_chunk_writer *ocw = arg;
+    struct chunk *c = zlist_first (ocw->queue);
+
+    if (flux_future_get (f, NULL) < 0)
+        shell_log_errno ("failed to commit output chunk %d", c->seq);
+    flux_future_destroy (f);
+    ocw->commit_f = NULL;
+    chunk_finish (ocw);
+}
+
+int output_chunk_writer_flush (struct output_chunk_writer *ocw)
+{
+    struct chunk *c;
+    int bound;
+
+    if (!ocw) {
+        errno = EINVAL;
+        return -1;
+    }
+    flux_watcher_stop (ocw->timer);
+    if (ocw->len == 0)
+        return 0;
+    if (ocw->len > LZ4_MAX_INPUT_SIZE) {
+        errno = EOVERFLOW;
+        goto error;
+    }
+    bound = LZ4_compressBound (ocw->len);
+    if (!(c = calloc (1, sizeof (*c)))
+        || !(c->data = malloc (bound))) {
+        chunk_destroy (c);
+        errno = ENOMEM;
+        goto error;
+    }
+    if ((c->len = LZ4_compress_default (ocw->buf,
+                                        c->data,
+                                        ocw->len,
+                                        bound)) <= 0) {
+        chunk_destroy (c);
+        errno = EINVAL;
+        goto error;
+    }
+    c->seq = ocw->seq++;
+    c->size = ocw->len;
+    c->entries = ocw->entries;
+    ocw->len = 0;
+    ocw->entries = 0;
+    if (zlist_append (ocw->queue, c) < 0) {
+        chunk_destroy (c);
+        errno = ENOMEM;
+        return -1;
+    }
+    chunk_next (ocw);
+    return 0;
+error:
+    /* Drop the current chunk so later output is not lost with it */
+    ocw->len = 0;
+    ocw->entries = 0;
+    return -1;
+}
+
+static void timer_cb (flux_reactor_t *r,
+                      flux_watcher_t *w,
+                      int revents,
+                      void *arg)
+{
+    struct output_chunk_writer *ocw = arg;
+    if (output_chunk_writer_flush (ocw) < 0)
+        shell_log_errno ("output_chunk_writer_flush");
+}
+
+int output_chunk_writer_append (struct output_chunk_writer *ocw,
+                                json_t *entry)
+{
+    char *s;
+    size_t n;
+
+    if (!ocw || !entry) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!(s = eventlog_entry_encode (entry)))
+        return -1;
+    n = strlen (s);
+    if (ocw->len + n > ocw->bufsize) {
+        size_t size = ocw->bufsize ? ocw->bufsize : 4096;
+        char *buf;
+        while (size < ocw->len + n)
+            size *= 2;
+        if (!(buf = realloc (ocw->buf, size))) {
+            free (s);
+            errno = ENOMEM;
+            return -1;
+        }
+        ocw->buf = buf;
+        ocw->bufsize = size;
+    }
+    memcpy (ocw->buf + ocw->len, s, n);
+    ocw->len += n;
+    ocw->entries++;
+    free (s);
+
+    if (ocw->len >= ocw->chunk_size)
+        return output_chunk_writer_flush (ocw);
+    if (ocw->entries == 1) {
+        flux_timer_watcher_reset (ocw->timer, ocw->timeout, 0.);
+        flux_watcher_start (ocw->timer);
+    }
+    return 0;
+}
+
+void output_chunk_writer_destroy (struct output_chunk_writer *ocw)
+{
+    if (ocw) {
+        int saved_errno = errno;
+
+        if (ocw->queue) {
+            if (output_chunk_writer_flush (ocw) < 0)
+                shell_log_errno ("output_chunk_writer_flush");
+
+            /*  Synchronously complete remaining chunks.  Continuations
+             *   are called directly, and start the next chunk if any.
+             */
+            while (zlist_size (ocw->queue) > 0) {
+                flux_future_t *f;
+                if ((f = ocw->store_f)) {
+                    if (flux_future_wait_for (f, -1.) < 0)
+                        break;
+                    chunk_store_continuation (f, ocw);
+                }
+                else if ((f = ocw->commit_f)) {
+                    if (flux_future_wait_for (f, -1.) < 0)
+                        break;
+                    chunk_commit_continuation (f, ocw);
+                }
+                else
+                    break;
+            }
+            flux_future_destroy (ocw->store_f);
+            flux_future_destroy (ocw->commit_f);
+            while (zlist_size (ocw->queue) > 0)
+                chunk_destroy (zlist_pop (ocw->queue));
+            zlist_destroy (&ocw->queue);
+        }
+        flux_watcher_destroy (ocw->timer);
+        free (ocw->buf);
+        free (ocw);
+        errno = saved_errno;
+    }
+}
+
+struct output_chunk_writer *output_chunk_writer_create (flux_shell_t *shell,
+                                                        size_t chunk_size,
+                                                        double timeout)
+{
+    struct output_chunk_writer *ocw;
+    flux_t *h = flux_shell_get_flux (shell);
+
+    if (!h || chunk_size == 0 || chunk_size > LZ4_MAX_INPUT_SIZE) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(ocw = calloc (1, sizeof (*ocw))))
+        return NULL;
+    ocw->shell = shell;
+    ocw->h = h;
+    ocw->chunk_size = chunk_size;
+    ocw->timeout = timeout;
+    if (!(ocw->hashtype = flux_attr_get (h, "content.hash")))
+        goto error;
+    if (!(ocw->queue = zlist_new ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (!(ocw->timer = flux_timer_watcher_create (flux_get_reactor (h),
+                                                  timeout,
+                                                  0.,
+                                                  timer_cb,
+                                                  ocw)))
+        goto error;
+    return ocw;
+error:
+    output_chunk_writer_destroy (ocw);
+    return NULL;
+}
+
+/* vi: ts=4 sw=4 expandtab
+ */
@@ -0,0 +1,54 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef SHELL_OUTPUT_CHUNK_H
+#define SHELL_OUTPUT_CHUNK_H
+
+#include <jansson.h>
+#include <flux/shell.h>
+
+/*  Output chunk writer: accumulate RFC 24 output eventlog entries into
+ *   LZ4 compressed chunks that are stored as content blobs.  Each chunk
+ *   is referenced from the job's guest KVS namespace at
+ *   "output-chunks.<seq>", and indexed by a "chunk" event in the "output"
+ *   eventlog with context:
+ *
+ *    seq:i, blobref:s, encoding:"lz4", size:I, entries:i
+ *
+ *   where size is the uncompressed size of the chunk, which contains
+ *   the original entries in RFC 18 eventlog format.
+ */
+struct output_chunk_writer;
+
+/*  Create a chunk writer.  A chunk is stored once it reaches 'chunk_size'
+ *   bytes, or 'timeout' seconds after its first entry was added.
+ */
+struct output_chunk_writer *output_chunk_writer_create (flux_shell_t *shell,
+                                                        size_t chunk_size,
+                                                        double timeout);
+
+/*  Store any partial chunk and synchronously wait for all chunks to be
+ *   committed to the KVS, then free the writer.
+ */
+void output_chunk_writer_destroy (struct output_chunk_writer *ocw);
+
+/*  Add an eventlog entry to the current chunk.
+ */
+int output_chunk_writer_append (struct output_chunk_writer *ocw,
+                                json_t *entry);
+
+/*  Store the current chunk now, if it has any entries.
+ */
+int output_chunk_writer_flush (struct output_chunk_writer *ocw);
+
+#endif /* !SHELL_OUTPUT_CHUNK_H */
+
+/* vi: ts=4 sw=4 expandtab
+ */
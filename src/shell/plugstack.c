@@ -38,6 +38,8 @@ struct plugstack {
     zhashx_t *aux;      /* aux items to propagate to loaded plugins        */
     zlistx_t *plugins;  /* Ordered list of loaded plugins                  */
     zhashx_t *names;    /* Hash for lookup of plugins by name              */
+    plugstack_glob_f glob_fn; /* If set, used in place of glob(3)          */
+    void *glob_arg;
 };
 
 void plugstack_unload_name (struct plugstack *st, const char *name)
@@ -227,6 +229,33 @@ static int load_from_glob (struct plugstack *st, glob_t *gl, const char *conf)
     return n;
 }
 
+int plugstack_set_glob (struct plugstack *st, plugstack_glob_f fn, void *arg)
+{
+    if (!st) {
+        errno = EINVAL;
+        return -1;
+    }
+    st->glob_fn = fn;
+    st->glob_arg = arg;
+    return 0;
+}
+
+static int load_from_pathv (struct plugstack *st,
+                            char **pathv,
+                            const char *conf)
+{
+    int n = 0;
+    int rc = 0;
+    for (int i = 0; pathv[i] != NULL; i++) {
+        if (rc == 0 && load_plugin (st, pathv[i], conf) < 0)
+            rc = -1;
+        free (pathv[i]);
+        n++;
+    }
+    free (pathv);
+    return rc < 0 ? -1 : n;
+}
+
 static int plugstack_glob (struct plugstack *st,
                            const char *pattern,
                            const char *conf)
@@ -234,6 +263,18 @@ static int plugstack_glob (struct plugstack *st,
     glob_t gl;
     int rc = -1;
 
+    if (st->glob_fn) {
+        char **pathv;
+        if ((*st->glob_fn) (pattern, &pathv, st->glob_arg) < 0) {
+            if (errno == ENOMEM) {
+                shell_log_error ("glob: Out of memory");
+                return -1;
+            }
+            return 0;
+        }
+        return load_from_pathv (st, pathv, conf);
+    }
+
     rc = glob (pattern, GLOB_TILDE_CHECK, NULL, &gl);
     switch (rc) {
         case 0:
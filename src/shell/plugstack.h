@@ -36,6 +36,17 @@ int plugstack_set_searchpath (struct plugstack *st, const char *searchpath);
  */
 const char *plugstack_get_searchpath (struct plugstack *st);
 
+/*  Set an alternate glob(3) implementation for plugstack_load().
+ *  The callback sets 'pathv' to a NULL terminated array of matches, which
+ *   plugstack frees with free(3), and returns the number of matches,
+ *   or -1 with errno set on error.
+ */
+typedef int (*plugstack_glob_f) (const char *pattern,
+                                 char ***pathv,
+                                 void *arg);
+
+int plugstack_set_glob (struct plugstack *st, plugstack_glob_f fn, void *arg);
+
 /*  Load all plugins matching glob pattern in all directories in
  *   searchpatch inst the plugin stack 'st', providing optional
  *   load configuration conf (a JSON encoded string).
@@ -80,10 +80,13 @@
 struct shell_pmi {
     flux_shell_t *shell;
     struct pmi_simple_server *server;
-    json_t *global; // already exchanged
+    json_t *global; // already exchanged (lazy: keys homed on this shell)
     json_t *pending;// pending to be exchanged
     json_t *locals;  // never exchanged
+    json_t *cache;  // lazy: keys fetched from other shells
     struct pmi_exchange *exchange;
+    int puts_outstanding;   // lazy: pending pmi-kvs-put RPCs
+    int puts_error;         // lazy: a pmi-kvs-put RPC failed
 };
 
 /* pmi_simple_ops->warn() signature */
@@ -338,6 +341,296 @@ static int exchange_kvs_put (void *arg,
     return put_dict (pmi->pending, key, val);
 }
 
+/**
+ ** ops for on-demand (direct modex) lookup of PMI KVS keys
+ ** This is used if pmi.kvs=lazy option is provided.
+ **
+ ** Each key has a "home" shell selected by hashing the key name.
+ ** At PMI_Barrier, each shell sends its pending keys to their home shells,
+ ** then enters a pmi_exchange() with an empty dict, which serves only to
+ ** synchronize.  A kvs_get that misses locally is fetched from the key's
+ ** home shell and cached.  Thus each shell holds only the keys homed on it
+ ** plus the keys its tasks actually read, instead of every key in the job.
+ **/
+
+static int lazy_home (struct shell_pmi *pmi, const char *key)
+{
+    uint32_t hash = 2166136261U; // FNV-1a
+
+    while (*key) {
+        hash ^= (unsigned char)*key++;
+        hash *= 16777619U;
+    }
+    return hash % pmi->shell->info->shell_size;
+}
+
+static void lazy_exchange_cb (struct pmi_exchange *pex, void *arg)
+{
+    struct shell_pmi *pmi = arg;
+    int rc = 0;
+
+    if (pmi_exchange_has_error (pex)) {
+        shell_warn ("exchange failed");
+        rc = -1;
+    }
+    pmi_simple_server_barrier_complete (pmi->server, rc);
+}
+
+static void lazy_barrier_sync (struct shell_pmi *pmi)
+{
+    json_t *empty;
+    int rc = -1;
+
+    json_object_clear (pmi->pending);
+    if (pmi->puts_error) {
+        pmi->puts_error = 0;
+        goto error;
+    }
+    if (!(empty = json_object ()))
+        goto error;
+    rc = pmi_exchange (pmi->exchange, empty, lazy_exchange_cb, pmi);
+    json_decref (empty);
+    if (rc < 0)
+        shell_warn ("pmi_exchange %s", flux_strerror (errno));
+    else
+        return;
+error:
+    pmi_simple_server_barrier_complete (pmi->server, -1);
+}
+
+static void lazy_put_continuation (flux_future_t *f, void *arg)
+{
+    struct shell_pmi *pmi = arg;
+
+    if (flux_rpc_get (f, NULL) < 0) {
+        shell_warn ("pmi-kvs-put: %s", future_strerror (f, errno));
+        pmi->puts_error = 1;
+    }
+    flux_future_destroy (f);
+    if (--pmi->puts_outstanding == 0)
+        lazy_barrier_sync (pmi);
+}
+
+/* Sort pending keys by home shell: keys homed here are stored directly,
+ * others are sent to their home shell, one RPC per home shell.
+ */
+static int lazy_put_pending (struct shell_pmi *pmi)
+{
+    int size = pmi->shell->info->shell_size;
+    int myrank = pmi->shell->info->shell_rank;
+    json_t **dicts;
+    const char *key;
+    json_t *val;
+    int rc = -1;
+
+    if (!(dicts = calloc (size, sizeof (dicts[0]))))
+        return -1;
+    json_object_foreach (pmi->pending, key, val) {
+        int home = lazy_home (pmi, key);
+        json_t *dict = home == myrank ? pmi->global : dicts[home];
+
+        if (!dict && !(dict = dicts[home] = json_object ()))
+            goto nomem;
+        if (json_object_set (dict, key, val) < 0)
+            goto nomem;
+    }
+    for (int i = 0; i < size; i++) {
+        flux_future_t *f;
+
+        if (!dicts[i])
+            continue;
+        if (!(f = flux_shell_rpc_pack (pmi->shell,
+                                       "pmi-kvs-put",
+                                       i,
+                                       0,
+                                       "{s:O}",
+                                       "dict", dicts[i]))
+            || flux_future_then (f, -1, lazy_put_continuation, pmi) < 0) {
+            flux_future_destroy (f);
+            goto out;
+        }
+        pmi->puts_outstanding++;
+    }
+    rc = 0;
+out:
+    for (int i = 0; i < size; i++)
+        json_decref (dicts[i]);
+    free (dicts);
+    return rc;
+nomem:
+    errno = ENOMEM;
+    goto out;
+}
+
+/* pmi_simple_ops->barrier_enter() signature */
+static int lazy_barrier_enter (void *arg)
+{
+    struct shell_pmi *pmi = arg;
+
+    if (pmi->shell->info->shell_size == 1) {
+        pmi_simple_server_barrier_complete (pmi->server, 0);
+        return 0;
+    }
+    if (pmi->puts_outstanding > 0) {
+        shell_warn ("pmi barrier entered with puts in progress");
+        return -1; // PMI_FAIL
+    }
+    if (lazy_put_pending (pmi) < 0) {
+        shell_warn ("pmi-kvs-put %s", flux_strerror (errno));
+        /* Complete the barrier after any RPCs already sent finish,
+         * so their continuations do not fire after the barrier.
+         */
+        if (pmi->puts_outstanding == 0)
+            return -1; // PMI_FAIL
+        pmi->puts_error = 1;
+        return 0;
+    }
+    if (pmi->puts_outstanding == 0)
+        lazy_barrier_sync (pmi);
+    return 0;
+}
+
+static void lazy_get_continuation (flux_future_t *f, void *arg)
+{
+    struct shell_pmi *pmi = arg;
+    void *cli = flux_future_aux_get (f, "pmi_cli");
+    const char *key = flux_future_aux_get (f, "pmi_key");
+    const char *val = NULL;
+
+    if (flux_rpc_get_unpack (f, "{s:s}", "value", &val) == 0) {
+        if (put_dict (pmi->cache, key, val) < 0)
+            shell_warn ("failed to cache pmi key %s", key);
+    }
+    else if (errno != ENOENT)
+        shell_warn ("pmi-kvs-get %s: %s", key, future_strerror (f, errno));
+    pmi_simple_server_kvs_get_complete (pmi->server, cli, val);
+    flux_future_destroy (f);
+}
+
+static int lazy_lookup (struct shell_pmi *pmi,
+                        int home,
+                        const char *key,
+                        void *cli)
+{
+    flux_future_t *f;
+    char *cpy = NULL;
+
+    if (!(f = flux_shell_rpc_pack (pmi->shell,
+                                   "pmi-kvs-get",
+                                   home,
+                                   0,
+                                   "{s:s}",
+                                   "key", key)))
+        return -1;
+    if (!(cpy = strdup (key))
+        || flux_future_aux_set (f, "pmi_key", cpy, free) < 0)
+        goto error;
+    cpy = NULL;
+    if (flux_future_aux_set (f, "pmi_cli", cli, NULL) < 0
+        || flux_future_then (f, -1, lazy_get_continuation, pmi) < 0)
+        goto error;
+    return 0;
+error:
+    ERRNO_SAFE_WRAP (free, cpy);
+    flux_future_destroy (f);
+    return -1;
+}
+
+/* pmi_simple_ops->kvs_get() signature */
+static int lazy_kvs_get (void *arg,
+                         void *cli,
+                         const char *kvsname,
+                         const char *key)
+{
+    struct shell_pmi *pmi = arg;
+    json_t *o;
+    int home;
+
+    if ((o = json_object_get (pmi->locals, key))
+        || (o = json_object_get (pmi->pending, key))
+        || (o = json_object_get (pmi->global, key))
+        || (o = json_object_get (pmi->cache, key))) {
+        const char *val = json_string_value (o);
+        pmi_simple_server_kvs_get_complete (pmi->server, cli, val);
+        return 0;
+    }
+    home = lazy_home (pmi, key);
+    if (home != pmi->shell->info->shell_rank) {
+        if (lazy_lookup (pmi, home, key, cli) == 0)
+            return 0; // response deferred
+    }
+    return -1; // PMI_ERR_INVALID_KEY
+}
+
+/* Another shell is storing keys homed on this shell.
+ */
+static void lazy_put_cb (flux_t *h,
+                         flux_msg_handler_t *mh,
+                         const flux_msg_t *msg,
+                         void *arg)
+{
+    struct shell_pmi *pmi = arg;
+    json_t *dict;
+
+    if (flux_request_unpack (msg, NULL, "{s:o}", "dict", &dict) < 0)
+        goto error;
+    if (json_object_update (pmi->global, dict) < 0) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (flux_respond (h, msg, NULL) < 0)
+        shell_warn ("error responding to pmi-kvs-put request");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        shell_warn ("error responding to pmi-kvs-put request");
+}
+
+/* Another shell is fetching a key homed on this shell.
+ */
+static void lazy_get_cb (flux_t *h,
+                         flux_msg_handler_t *mh,
+                         const flux_msg_t *msg,
+                         void *arg)
+{
+    struct shell_pmi *pmi = arg;
+    const char *key;
+    json_t *o;
+
+    if (flux_request_unpack (msg, NULL, "{s:s}", "key", &key) < 0)
+        goto error;
+    if (!(o = json_object_get (pmi->global, key))) {
+        errno = ENOENT;
+        goto error;
+    }
+    if (flux_respond_pack (h, msg, "{s:O}", "value", o) < 0)
+        shell_warn ("error responding to pmi-kvs-get request");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        shell_warn ("error responding to pmi-kvs-get request");
+}
+
+static int lazy_init (struct shell_pmi *pmi,
+                      int exchange_k,
+                      int exchange_flags)
+{
+    if (!(pmi->exchange = pmi_exchange_create (pmi->shell,
+                                               exchange_k,
+                                               exchange_flags)))
+        return -1;
+    if (flux_shell_service_register (pmi->shell,
+                                     "pmi-kvs-put",
+                                     lazy_put_cb,
+                                     pmi) < 0
+        || flux_shell_service_register (pmi->shell,
+                                        "pmi-kvs-get",
+                                        lazy_get_cb,
+                                        pmi) < 0)
+        return -1;
+    return 0;
+}
+
 /**
  ** end of KVS implementations
  **/
@@ -487,6 +780,7 @@ static void pmi_destroy (struct shell_pmi *pmi)
         json_decref (pmi->global);
         json_decref (pmi->pending);
         json_decref (pmi->locals);
+        json_decref (pmi->cache);
         free (pmi);
         errno = saved_errno;
     }
@@ -501,24 +795,49 @@ static struct pmi_simple_ops shell_pmi_ops = {
 
 static int parse_args (json_t *config,
                        int *exchange_k,
+                       int *exchange_flags,
                        const char **kvs,
                        int *nomap)
 {
     json_error_t error;
+    const char *tree = NULL;
+    const char *encoding = NULL;
 
     if (config) {
         if (json_unpack_ex (config,
                             &error,
                             0,
-                            "{s?s s?{s?i !} s?i !}",
+                            "{s?s s?{s?i s?s s?s !} s?i !}",
                             "kvs", kvs,
                             "exchange",
                               "k", exchange_k,
+                              "tree", &tree,
+                              "encoding", &encoding,
                             "nomap", nomap) < 0) {
             shell_log_error ("option error: %s", error.text);
             return -1;
         }
     }
+    /* Follow the broker topology by default, unless a k-ary tree fanout
+     * was explicitly requested.
+     */
+    if (!tree)
+        tree = *exchange_k > 0 ? "kary" : "topology";
+    if (streq (tree, "topology"))
+        *exchange_flags |= PMI_EXCHANGE_TOPO;
+    else if (!streq (tree, "kary")) {
+        shell_log_error ("option error: unknown exchange tree %s", tree);
+        return -1;
+    }
+    if (encoding) {
+        if (streq (encoding, "binary"))
+            *exchange_flags |= PMI_EXCHANGE_BINARY;
+        else if (!streq (encoding, "json")) {
+            shell_log_error ("option error: unknown exchange encoding %s",
+                             encoding);
+            return -1;
+        }
+    }
     return 0;
 }
 
@@ -530,13 +849,14 @@ static struct shell_pmi *pmi_create (flux_shell_t *shell, json_t *config)
     char kvsname[32];
     const char *kvs = "exchange";
     int exchange_k = 0; // 0=use default tree fanout
+    int exchange_flags = 0;
     int nomap = 0;      // avoid generation of PMI_process_mapping
 
     if (!(pmi = calloc (1, sizeof (*pmi))))
         return NULL;
     pmi->shell = shell;
 
-    if (parse_args (config, &exchange_k, &kvs, &nomap) < 0)
+    if (parse_args (config, &exchange_k, &exchange_flags, &kvs, &nomap) < 0)
         goto error;
     if (streq (kvs, "native")) {
         shell_pmi_ops.kvs_put = native_kvs_put;
@@ -549,7 +869,17 @@ static struct shell_pmi *pmi_create (flux_shell_t *shell, json_t *config)
         shell_pmi_ops.kvs_put = exchange_kvs_put;
         shell_pmi_ops.kvs_get = exchange_kvs_get;
         shell_pmi_ops.barrier_enter = exchange_barrier_enter;
-        if (!(pmi->exchange = pmi_exchange_create (shell, exchange_k)))
+        if (!(pmi->exchange = pmi_exchange_create (shell,
+                                                   exchange_k,
+                                                   exchange_flags)))
+            goto error;
+    }
+    else if (streq (kvs, "lazy")) {
+        /* N.B. the lazy kvs_put op is the same as exchange */
+        shell_pmi_ops.kvs_put = exchange_kvs_put;
+        shell_pmi_ops.kvs_get = lazy_kvs_get;
+        shell_pmi_ops.barrier_enter = lazy_barrier_enter;
+        if (lazy_init (pmi, exchange_k, exchange_flags) < 0)
             goto error;
     }
     else {
@@ -578,7 +908,8 @@ static struct shell_pmi *pmi_create (flux_shell_t *shell, json_t *config)
         goto error;
     if (!(pmi->global = json_object ())
         || !(pmi->pending = json_object ())
-        || !(pmi->locals = json_object ())) {
+        || !(pmi->locals = json_object ())
+        || !(pmi->cache = json_object ())) {
         errno = ENOMEM;
         goto error;
     }
@@ -23,9 +23,24 @@
  * Broadcast fans out at each tree level, reducing the number of messages
  * that have to be sent by rank 0.
  *
- * N.B. This binary tree is created from thin air for algorithmic purposes.
+ * By default, the tree follows the broker overlay topology (tbon.topo):
+ * each shell's parent is the shell on its nearest broker ancestor that
+ * is part of the job, or shell 0 if there is none.  Gather and broadcast
+ * messages between tree peers thus travel over direct overlay links
+ * where possible.  If the broker topology cannot be computed locally
+ * (e.g. tbon.topo=custom), or if PMI_EXCHANGE_TOPO is not set, a k-ary
+ * tree is computed across shell ranks instead.
+ *
+ * N.B. The k-ary tree is created from thin air for algorithmic purposes.
  * Nodes that are peers in the ersatz tree may actually be multiple hops
  * apart on the Flux tree based overlay network at the broker level.
+ *
+ * If PMI_EXCHANGE_BINARY is set, the dictionary is sent between shells
+ * as a packed sequence of NUL terminated key, value pairs instead of a
+ * JSON object.  Interior tree nodes then merge child contributions by
+ * appending buffers rather than decoding and re-encoding JSON at every
+ * hop, and the result is decoded into a json_t dictionary only once per
+ * shell, when the exchange completes.
  */
 #define FLUX_SHELL_PLUGIN_NAME "pmi-simple"
 
@@ -33,21 +48,32 @@
 #include "config.h"
 #endif
 #include <stdlib.h>
+#include <string.h>
 #include <jansson.h>
 #include <flux/core.h>
 #include <flux/shell.h>
 
 #include "src/common/libutil/kary.h"
+#include "ccan/str/str.h"
 
 #include "info.h"
 #include "internal.h"
+#include "svc.h"
 
 #include "pmi_exchange.h"
 
 #define DEFAULT_TREE_K 2
 
+enum {
+    BROKER_TOPO_KARY,
+    BROKER_TOPO_BINOMIAL,
+};
+
 struct session {
     json_t *dict;               // container for gathered dictionary
+    char *buf;                  // gathered dictionary (binary encoding)
+    size_t buflen;
+    size_t bufsize;
     pmi_exchange_f cb;          // callback for exchange completion
     void *cb_arg;
 
@@ -63,6 +89,7 @@ struct pmi_exchange {
     flux_shell_t *shell;
     int size;
     int rank;
+    int flags;
     uint32_t parent_rank;
     int child_count;
 
@@ -83,6 +110,7 @@ static void session_destroy (struct session *ses)
         }
         flux_future_destroy (ses->f);
         json_decref (ses->dict);
+        free (ses->buf);
         free (ses);
         errno = saved_errno;
     }
@@ -106,10 +134,124 @@ nomem:
     return NULL;
 }
 
-static void session_process (struct session *ses)
+/* Append raw binary-encoded dict 'data' to the session buffer.
+ */
+static int session_append (struct session *ses, const void *data, size_t len)
+{
+    if (ses->buflen + len > ses->bufsize) {
+        size_t size = ses->bufsize ? ses->bufsize : 4096;
+        char *buf;
+
+        while (size < ses->buflen + len)
+            size *= 2;
+        if (!(buf = realloc (ses->buf, size))) {
+            errno = ENOMEM;
+            return -1;
+        }
+        ses->buf = buf;
+        ses->bufsize = size;
+    }
+    memcpy (ses->buf + ses->buflen, data, len);
+    ses->buflen += len;
+    return 0;
+}
+
+/* Append json dict 'dict' to the session buffer in binary encoding:
+ * a sequence of "key\0value\0" pairs.
+ */
+static int session_append_dict (struct session *ses, json_t *dict)
+{
+    const char *key;
+    json_t *val;
+
+    json_object_foreach (dict, key, val) {
+        const char *s = json_string_value (val);
+
+        if (!s) {
+            errno = EINVAL;
+            return -1;
+        }
+        if (session_append (ses, key, strlen (key) + 1) < 0
+            || session_append (ses, s, strlen (s) + 1) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+/* Validate binary encoded dict 'data' of length 'len'.
+ */
+static int binary_dict_check (const char *data, size_t len)
+{
+    int count = 0;
+
+    if (len > 0 && data[len - 1] != '\0')
+        goto inval;
+    for (size_t i = 0; i < len; i++) {
+        if (data[i] == '\0')
+            count++;
+    }
+    if (count % 2 != 0)
+        goto inval;
+    return 0;
+inval:
+    errno = EPROTO;
+    return -1;
+}
+
+/* Decode the session buffer into the session json dict.
+ */
+static int session_decode (struct session *ses)
+{
+    const char *p = ses->buf;
+    const char *end = ses->buf + ses->buflen;
+
+    while (p < end) {
+        const char *key = p;
+        const char *val = key + strlen (key) + 1;
+        json_t *o;
+
+        if (!(o = json_string (val))
+            || json_object_set_new (ses->dict, key, o) < 0) {
+            json_decref (o);
+            errno = ENOMEM;
+            return -1;
+        }
+        p = val + strlen (val) + 1;
+    }
+    return 0;
+}
+
+static flux_future_t *session_send (struct session *ses)
 {
     struct pmi_exchange *pex = ses->pex;
+
+    if ((pex->flags & PMI_EXCHANGE_BINARY))
+        return shell_svc_raw (pex->shell->svc,
+                              "pmi-exchange",
+                              pex->parent_rank,
+                              0,
+                              ses->buf,
+                              ses->buflen);
+    return flux_shell_rpc_pack (pex->shell,
+                                "pmi-exchange",
+                                pex->parent_rank,
+                                0,
+                                "O",
+                                ses->dict);
+}
+
+static int session_respond (struct session *ses, const flux_msg_t *msg)
+{
     flux_t *h = ses->pex->shell->h;
+
+    if ((ses->pex->flags & PMI_EXCHANGE_BINARY))
+        return flux_respond_raw (h, msg, ses->buf, ses->buflen);
+    return flux_respond_pack (h, msg, "O", ses->dict);
+}
+
+static void session_process (struct session *ses)
+{
+    struct pmi_exchange *pex = ses->pex;
     const flux_msg_t *msg;
 
     if (ses->has_error)
@@ -125,12 +267,7 @@ static void session_process (struct session *ses)
     if (pex->rank > 0 && !ses->f) {
         flux_future_t *f;
 
-        if (!(f = flux_shell_rpc_pack (pex->shell,
-                                       "pmi-exchange",
-                                       pex->parent_rank,
-                                       0,
-                                       "O",
-                                       ses->dict))
+        if (!(f = session_send (ses))
                 || flux_future_then (f,
                                      -1,
                                      exchange_response_completion,
@@ -151,7 +288,7 @@ static void session_process (struct session *ses)
     /* Send exchange response(s), if needed.
      */
     while ((msg = zlist_pop (ses->requests))) {
-        if (flux_respond_pack (h, msg, "O", ses->dict) < 0) {
+        if (session_respond (ses, msg) < 0) {
             shell_warn ("error responding to pmi-exchange request");
             flux_msg_decref (msg);
             ses->has_error = 1;
@@ -159,6 +296,10 @@ static void session_process (struct session *ses)
         }
         flux_msg_decref (msg);
     }
+    if ((pex->flags & PMI_EXCHANGE_BINARY) && session_decode (ses) < 0) {
+        shell_warn ("error decoding pmi-exchange dict");
+        ses->has_error = 1;
+    }
 done:
     ses->cb (pex, ses->cb_arg);
     session_destroy (ses);
@@ -172,6 +313,27 @@ static void exchange_response_completion (flux_future_t *f, void *arg)
     struct pmi_exchange *pex = arg;
     json_t *dict;
 
+    if ((pex->flags & PMI_EXCHANGE_BINARY)) {
+        const void *data;
+        int len;
+
+        /* The parent's response is the complete dict, which is a
+         * superset of what was gathered here, so replace it.
+         */
+        if (flux_rpc_get_raw (f, &data, &len) < 0
+            || binary_dict_check (data, len) < 0) {
+            shell_warn ("pmi-exchange request: %s",
+                        future_strerror (f, errno));
+            pex->session->has_error = 1;
+            goto done;
+        }
+        pex->session->buflen = 0;
+        if (session_append (pex->session, data, len) < 0) {
+            shell_warn ("pmi-exchange response handling failed to update dict");
+            pex->session->has_error = 1;
+        }
+        goto done;
+    }
     if (flux_rpc_get_unpack (f, "o", &dict) < 0) {
         shell_warn ("pmi-exchange request: %s", future_strerror (f, errno));
         pex->session->has_error = 1;
@@ -194,10 +356,20 @@ static void exchange_request_cb (flux_t *h,
                                  void *arg)
 {
     struct pmi_exchange *pex = arg;
-    json_t *dict;
+    json_t *dict = NULL;
+    const void *data = NULL;
+    int len = 0;
     const char *errstr = NULL;
 
-    if (flux_request_unpack (msg, NULL, "o", &dict) < 0)
+    if ((pex->flags & PMI_EXCHANGE_BINARY)) {
+        if (flux_request_decode_raw (msg, NULL, &data, &len) < 0)
+            goto error;
+        if (binary_dict_check (data, len) < 0) {
+            errstr = "pmi-exchange request contains malformed dict";
+            goto error;
+        }
+    }
+    else if (flux_request_unpack (msg, NULL, "o", &dict) < 0)
         goto error;
     if (!pex->session) {
         if (!(pex->session = session_create (pex)))
@@ -208,7 +380,13 @@ static void exchange_request_cb (flux_t *h,
         errno = EINPROGRESS;
         goto error;
     }
-    if (json_object_update (pex->session->dict, dict) < 0) {
+    if (dict) {
+        if (json_object_update (pex->session->dict, dict) < 0) {
+            errstr = "pmi-exchange request failed to update dict";
+            goto nomem;
+        }
+    }
+    else if (session_append (pex->session, data, len) < 0) {
         errstr = "pmi-exchange request failed to update dict";
         goto nomem;
     }
@@ -246,7 +424,11 @@ int pmi_exchange (struct pmi_exchange *pex,
     pex->session->cb = cb;
     pex->session->cb_arg = arg;
     pex->session->local = 1;
-    if (json_object_update (pex->session->dict, dict) < 0) {
+    if ((pex->flags & PMI_EXCHANGE_BINARY)) {
+        if (session_append_dict (pex->session, dict) < 0)
+            return -1;
+    }
+    else if (json_object_update (pex->session->dict, dict) < 0) {
         errno = ENOMEM;
         return -1;
     }
@@ -269,12 +451,149 @@ static int child_count (int k, int rank, int size)
     return count;
 }
 
-struct pmi_exchange *pmi_exchange_create (flux_shell_t *shell, int k)
+/* Parse broker topology URI, filling in the tree type and fanout.
+ * Only topologies that can be computed from the instance size are
+ * supported.  Return -1 if 'uri' is not supported.
+ */
+static int broker_topo_parse (const char *uri, int *type, int *k)
+{
+    if (strstarts (uri, "kary:")) {
+        char *endptr;
+        long val;
+
+        errno = 0;
+        val = strtol (uri + 5, &endptr, 10);
+        if (errno != 0 || *endptr != '\0' || endptr == uri + 5 || val < 0)
+            return -1;
+        *type = BROKER_TOPO_KARY;
+        *k = val;
+        return 0;
+    }
+    if (streq (uri, "binomial")) {
+        *type = BROKER_TOPO_BINOMIAL;
+        *k = 0;
+        return 0;
+    }
+    return -1;
+}
+
+/* Return the broker parent of broker 'rank', or -1 if 'rank' is the root.
+ * This must agree with the broker topology plugins in broker/topology.c.
+ */
+static int broker_parentof (int type, int k, int rank)
+{
+    if (rank == 0)
+        return -1;
+    if (type == BROKER_TOPO_BINOMIAL)
+        return rank & (rank - 1); // clear lowest set bit
+    if (k == 0)
+        return 0; // flat
+    return kary_parentof (k, rank);
+}
+
+struct rankpair {
+    int broker_rank;
+    int shell_rank;
+};
+
+static int rankpair_cmp (const void *a, const void *b)
+{
+    const struct rankpair *p1 = a;
+    const struct rankpair *p2 = b;
+    return p1->broker_rank - p2->broker_rank;
+}
+
+/* Return the shell rank that is the topology tree parent of shell 'rank'.
+ */
+static int topo_parentof (struct rankpair *map,
+                          int size,
+                          int type,
+                          int k,
+                          int broker_rank)
+{
+    struct rankpair key;
+    struct rankpair *p;
+
+    key.broker_rank = broker_rank;
+    while ((key.broker_rank = broker_parentof (type,
+                                               k,
+                                               key.broker_rank)) >= 0) {
+        if ((p = bsearch (&key, map, size, sizeof (map[0]), rankpair_cmp)))
+            return p->shell_rank;
+    }
+    return 0;
+}
+
+/* Set parent_rank and child_count from the broker overlay topology.
+ * Return -1 if the topology cannot be determined here.
+ */
+static int tree_init_topology (struct pmi_exchange *pex)
+{
+    flux_shell_t *shell = pex->shell;
+    const char *uri;
+    struct rankpair *map;
+    int type, k;
+    int my_broker_rank = -1;
+
+    if (!(uri = flux_attr_get (shell->h, "tbon.topo"))
+        || broker_topo_parse (uri, &type, &k) < 0)
+        return -1;
+    if (!(map = calloc (pex->size, sizeof (map[0]))))
+        return -1;
+    for (int i = 0; i < pex->size; i++) {
+        if ((map[i].broker_rank = shell_svc_broker_rank (shell->svc, i)) < 0)
+            goto error;
+        map[i].shell_rank = i;
+        if (i == pex->rank)
+            my_broker_rank = map[i].broker_rank;
+    }
+    qsort (map, pex->size, sizeof (map[0]), rankpair_cmp);
+
+    /* Since broker parents always have lower ranks than their children in
+     * the supported topologies, shell 0 is the root of the induced tree.
+     */
+    pex->parent_rank = pex->rank > 0
+                       ? topo_parentof (map, pex->size, type, k, my_broker_rank)
+                       : KARY_NONE;
+    pex->child_count = 0;
+    for (int i = 0; i < pex->size; i++) {
+        if (map[i].shell_rank != 0
+            && map[i].shell_rank != pex->rank
+            && topo_parentof (map,
+                              pex->size,
+                              type,
+                              k,
+                              map[i].broker_rank) == pex->rank)
+            pex->child_count++;
+    }
+    free (map);
+    if (pex->rank == 0)
+        shell_debug ("using broker topology %s", uri);
+    return 0;
+error:
+    free (map);
+    return -1;
+}
+
+struct pmi_exchange *pmi_exchange_create (flux_shell_t *shell,
+                                          int k,
+                                          int flags)
 {
     struct pmi_exchange *pex;
 
     if (!(pex = calloc (1, sizeof (*pex))))
         return NULL;
+    pex->shell = shell;
+    pex->size = shell->info->shell_size;
+    pex->rank = shell->info->shell_rank;
+    pex->flags = flags;
+
+    if ((flags & PMI_EXCHANGE_TOPO)) {
+        if (tree_init_topology (pex) == 0)
+            goto done;
+        if (pex->rank == 0)
+            shell_debug ("broker topology unavailable, using k-ary tree");
+    }
     if (k <= 0)
         k = DEFAULT_TREE_K;
     else if (k > shell->info->shell_size) {
@@ -286,12 +605,9 @@ struct pmi_exchange *pmi_exchange_create (flux_shell_t *shell, int k)
         if (shell->info->shell_rank == 0)
             shell_warn ("using k=%d", k);
     }
-    pex->shell = shell;
-    pex->size = shell->info->shell_size;
-    pex->rank = shell->info->shell_rank;
     pex->parent_rank = kary_parentof (k, pex->rank);
     pex->child_count = child_count (k, pex->rank, pex->size);
-
+done:
     if (flux_shell_service_register (shell,
                                      "pmi-exchange",
                                      exchange_request_cb,
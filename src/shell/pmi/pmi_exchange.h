@@ -11,10 +11,18 @@
 #ifndef SHELL_PMI_EXCHANGE_H
 #define SHELL_PMI_EXCHANGE_H
 
+enum {
+    PMI_EXCHANGE_TOPO = 1,      // follow broker overlay topology if possible
+    PMI_EXCHANGE_BINARY = 2,    // use compact binary dict encoding on the wire
+};
+
 /* Create handle for performing multiple sequential exchanges.
- * 'k' is the tree fanout (k=0 selects internal default).
+ * 'k' is the k-ary tree fanout (k=0 selects internal default), used unless
+ * PMI_EXCHANGE_TOPO is set in 'flags' and the broker topology is available.
  */
-struct pmi_exchange *pmi_exchange_create (flux_shell_t *shell, int k);
+struct pmi_exchange *pmi_exchange_create (flux_shell_t *shell,
+                                          int k,
+                                          int flags);
 void pmi_exchange_destroy (struct pmi_exchange *pex);
 
 typedef void (*pmi_exchange_f)(struct pmi_exchange *pex, void *arg);
@@ -17,7 +17,7 @@
 #include "config.h"
 #endif
 #include <libgen.h>
-#include <glob.h>
+#include <errno.h>
 #include <lua.h>
 #include <lauxlib.h>
 #include <lualib.h>
@@ -30,6 +30,7 @@
 #include "ccan/str/str.h"
 #include "internal.h"
 #include "info.h"
+#include "rccache.h"
 
 /*  Lua plugin helper types:
  */
@@ -340,7 +341,7 @@ static int shell_run_rcfile (flux_shell_t *shell,
 
     /*  Compile rcfile onto stack
      */
-    if (luaL_loadfile (L, rcfile) != 0) {
+    if (rccache_loadfile (shell->rccache, L, rcfile) != 0) {
         shell_log_error ("%s: %s", rcfile, lua_tostring (L, -1));
         return -1;
     }
@@ -357,36 +358,29 @@ static int shell_run_rcfile (flux_shell_t *shell,
  */
 static int l_source_rcfiles (lua_State *L)
 {
-    size_t i;
-    int rc;
-    glob_t gl;
+    char **pathv;
+    int n;
     const char *pattern = lua_tostring (L, -1);
 
-    /* XXX: using GLOB_TILDE GNU extension for now
-     */
-    if ((rc = glob (pattern, GLOB_TILDE_CHECK, NULL, &gl)) != 0) {
-        globfree (&gl);
-        if (rc == GLOB_NOMATCH) {
-            if (!isa_pattern (pattern))
-                return luaL_error (L, "source %s: No such file or directory",
-                                      pattern);
-            else
-                return 0;
-        }
-        else if (rc == GLOB_NOSPACE)
+    if ((n = rccache_glob (rc_shell->rccache, pattern, &pathv)) < 0) {
+        if (errno == ENOMEM)
             return luaL_error (L, "Out of memory");
-        else if (rc == GLOB_ABORTED)
-            return luaL_error (L, "glob: failed to read %s", pattern);
-        else
-            return luaL_error (L, "glob: unknown rc = %d", rc);
-    }
-
-    for (i = 0; i < gl.gl_pathc; i++) {
-        rc = shell_run_rcfile (rc_shell, L, gl.gl_pathv[i]);
-        if (rc < 0)
-            return luaL_error (L, "source %s failed", gl.gl_pathv[i]);
+        return luaL_error (L, "glob: failed to read %s", pattern);
+    }
+    if (n == 0 && !isa_pattern (pattern)) {
+        rccache_pathv_free (pathv);
+        return luaL_error (L, "source %s: No such file or directory", pattern);
+    }
+    for (int i = 0; i < n; i++) {
+        if (shell_run_rcfile (rc_shell, L, pathv[i]) < 0) {
+            luaL_where (L, 1);
+            lua_pushfstring (L, "source %s failed", pathv[i]);
+            lua_concat (L, 2);
+            rccache_pathv_free (pathv);
+            return lua_error (L);
+        }
     }
-    globfree (&gl);
+    rccache_pathv_free (pathv);
     return 0;
 }
 
@@ -0,0 +1,483 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+#define FLUX_SHELL_PLUGIN_NAME NULL
+
+/* Cache of initrc glob results and Lua bytecode in the broker rundir.
+ *
+ * Cache files are replaced atomically with rename(2), so concurrent
+ * shells see either the old or new version of a file.  An entry is not
+ * recorded if its file or directory was modified within the last
+ * second, since another change in the same timestamp tick would go
+ * undetected.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <limits.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <glob.h>
+#include <time.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <lua.h>
+#include <lauxlib.h>
+#include <jansson.h>
+#include <flux/core.h>
+#include <flux/shell.h>
+
+#include "src/common/libutil/blobref.h"
+#include "src/common/libutil/read_all.h"
+#include "src/common/libutil/errno_safe.h"
+
+#include "internal.h"
+#include "rccache.h"
+
+#define MANIFEST_NAME "manifest.json"
+#define LUAC_MAGIC "flux-shell-luac-1"
+
+struct rccache {
+    char *dir;
+    uid_t owner;
+    bool writable;
+    json_t *manifest;
+};
+
+struct buffer {
+    char *data;
+    size_t len;
+};
+
+/* Return true if a file owned by the instance owner and not writable
+ * by anyone else is described by 'sb'.
+ */
+static bool is_trusted (struct rccache *c, struct stat *sb)
+{
+    return (sb->st_uid == c->owner
+            && !(sb->st_mode & (S_IWGRP | S_IWOTH)));
+}
+
+/* Return true if 'ts' is too recent to be used to detect changes.
+ */
+static bool is_racy (struct timespec *ts)
+{
+    return ts->tv_sec >= time (NULL) - 1;
+}
+
+static int isa_pattern (const char *str)
+{
+    return (strchr (str, '*') || strchr (str, '?') || strchr (str, '['));
+}
+
+/* Read cache file 'name' if it is a trusted regular file.
+ * Returns the NUL terminated contents or NULL.
+ */
+static char *read_cache_file (struct rccache *c, const char *name, int *lenp)
+{
+    char path[PATH_MAX + 1];
+    struct stat sb;
+    void *buf = NULL;
+    ssize_t len;
+    int fd;
+
+    if (snprintf (path, sizeof (path), "%s/%s", c->dir, name) >= sizeof (path)
+        || (fd = open (path, O_RDONLY | O_CLOEXEC)) < 0)
+        return NULL;
+    if (fstat (fd, &sb) < 0
+        || !S_ISREG (sb.st_mode)
+        || !is_trusted (c, &sb)
+        || (len = read_all (fd, &buf)) < 0) {
+        close (fd);
+        return NULL;
+    }
+    close (fd);
+    *lenp = len;
+    return buf;
+}
+
+/* Atomically replace cache file 'name' with the concatenation of
+ * 'hdr' and 'data'.  Errors are not fatal to the shell, so just log them.
+ */
+static void write_cache_file (struct rccache *c,
+                              const char *name,
+                              const char *hdr,
+                              const void *data,
+                              size_t len)
+{
+    char tmp[PATH_MAX + 1];
+    char path[PATH_MAX + 1];
+    int fd;
+
+    if (snprintf (tmp, sizeof (tmp), "%s/.%s.XXXXXX", c->dir, name)
+            >= sizeof (tmp)
+        || snprintf (path, sizeof (path), "%s/%s", c->dir, name)
+            >= sizeof (path))
+        return;
+    if ((fd = mkstemp (tmp)) < 0) {
+        shell_debug ("rccache: %s: %s", tmp, strerror (errno));
+        return;
+    }
+    if (fchmod (fd, 0644) < 0
+        || write_all (fd, hdr, strlen (hdr)) < 0
+        || write_all (fd, data, len) < 0) {
+        ERRNO_SAFE_WRAP (close, fd);
+        goto error;
+    }
+    if (close (fd) < 0 || rename (tmp, path) < 0)
+        goto error;
+    return;
+error:
+    shell_debug ("rccache: error writing %s: %s", path, strerror (errno));
+    (void)unlink (tmp);
+}
+
+static void rccache_load_manifest (struct rccache *c)
+{
+    char *buf;
+    int len;
+    json_t *o = NULL;
+
+    if ((buf = read_cache_file (c, MANIFEST_NAME, &len))) {
+        o = json_loadb (buf, len, 0, NULL);
+        free (buf);
+    }
+    if (!o || json_unpack (o, "{s:{}}", "globs") < 0) {
+        json_decref (o);
+        o = json_pack ("{s:i s:{}}", "version", 1, "globs");
+    }
+    c->manifest = o;
+}
+
+void rccache_destroy (struct rccache *c)
+{
+    if (c) {
+        int saved_errno = errno;
+        json_decref (c->manifest);
+        free (c->dir);
+        free (c);
+        errno = saved_errno;
+    }
+}
+
+struct rccache *rccache_create (flux_shell_t *shell)
+{
+    struct rccache *c;
+    const char *rundir;
+    struct stat sb;
+
+    if (!shell->h || !(rundir = flux_attr_get (shell->h, "rundir")))
+        return NULL;
+    if (!(c = calloc (1, sizeof (*c))))
+        return NULL;
+    c->owner = shell->broker_owner;
+    c->writable = (getuid () == c->owner);
+    if (asprintf (&c->dir, "%s/shell-cache", rundir) < 0)
+        goto error;
+    if (c->writable && mkdir (c->dir, 0755) < 0 && errno != EEXIST) {
+        shell_debug ("rccache: mkdir %s: %s", c->dir, strerror (errno));
+        goto error;
+    }
+    if (stat (c->dir, &sb) < 0
+        || !S_ISDIR (sb.st_mode)
+        || !is_trusted (c, &sb)) {
+        shell_debug ("rccache: %s is missing or not trusted", c->dir);
+        goto error;
+    }
+    rccache_load_manifest (c);
+    if (!c->manifest)
+        goto error;
+    shell_debug ("rccache: using %s%s",
+                 c->dir,
+                 c->writable ? "" : " (read-only)");
+    return c;
+error:
+    rccache_destroy (c);
+    return NULL;
+}
+
+void rccache_pathv_free (char **pathv)
+{
+    if (pathv) {
+        int saved_errno = errno;
+        for (int i = 0; pathv[i] != NULL; i++)
+            free (pathv[i]);
+        free (pathv);
+        errno = saved_errno;
+    }
+}
+
+/* Copy 'count' paths from 'paths' (a json array if 'gl' is NULL)
+ * into a new NULL terminated array.
+ */
+static char **pathv_create (glob_t *gl, json_t *paths, size_t count)
+{
+    char **pathv;
+
+    if (!(pathv = calloc (count + 1, sizeof (*pathv))))
+        return NULL;
+    for (size_t i = 0; i < count; i++) {
+        const char *s = gl ? gl->gl_pathv[i]
+                           : json_string_value (json_array_get (paths, i));
+        if (!s || !(pathv[i] = strdup (s))) {
+            rccache_pathv_free (pathv);
+            errno = ENOMEM;
+            return NULL;
+        }
+    }
+    return pathv;
+}
+
+static int do_glob (const char *pattern, char ***pathvp)
+{
+    glob_t gl;
+    char **pathv = NULL;
+    int count = 0;
+
+    switch (glob (pattern, GLOB_TILDE_CHECK, NULL, &gl)) {
+        case 0:
+            pathv = pathv_create (&gl, NULL, gl.gl_pathc);
+            count = gl.gl_pathc;
+            break;
+        case GLOB_NOMATCH:
+            pathv = pathv_create (NULL, NULL, 0);
+            break;
+        case GLOB_NOSPACE:
+            errno = ENOMEM;
+            break;
+        default:
+            errno = EIO;
+            break;
+    }
+    globfree (&gl);
+    if (!pathv)
+        return -1;
+    *pathvp = pathv;
+    return count;
+}
+
+/* Get the directory part of an absolute 'pattern', if only its last
+ * component is a glob, and the directory mtime.
+ */
+static int pattern_dir_mtime (const char *pattern, struct timespec *mtime)
+{
+    char dir[PATH_MAX + 1];
+    const char *p;
+    struct stat sb;
+
+    if (pattern[0] != '/'
+        || !(p = strrchr (pattern, '/'))
+        || !isa_pattern (p + 1)
+        || p - pattern >= sizeof (dir))
+        return -1;
+    memcpy (dir, pattern, p - pattern);
+    dir[p - pattern] = '\0';
+    if (isa_pattern (dir) || stat (dir[0] ? dir : "/", &sb) < 0)
+        return -1;
+    *mtime = sb.st_mtim;
+    return 0;
+}
+
+static bool mtime_match (json_t *o, struct timespec *ts)
+{
+    json_int_t sec, nsec;
+
+    if (json_unpack (o, "[II]", &sec, &nsec) < 0)
+        return false;
+    return sec == ts->tv_sec && nsec == ts->tv_nsec;
+}
+
+static void manifest_update (struct rccache *c,
+                             const char *pattern,
+                             struct timespec *mtime,
+                             char **pathv)
+{
+    json_t *globs = json_object_get (c->manifest, "globs");
+    json_t *paths;
+    json_t *entry;
+    char *s;
+
+    if (!(paths = json_array ()))
+        return;
+    for (int i = 0; pathv[i] != NULL; i++) {
+        if (json_array_append_new (paths, json_string (pathv[i])) < 0) {
+            json_decref (paths);
+            return;
+        }
+    }
+    if (!(entry = json_pack ("{s:[II] s:o}",
+                             "mtime",
+                               (json_int_t)mtime->tv_sec,
+                               (json_int_t)mtime->tv_nsec,
+                             "paths", paths))
+        || json_object_set_new (globs, pattern, entry) < 0)
+        return;
+    if ((s = json_dumps (c->manifest, JSON_COMPACT))) {
+        write_cache_file (c, MANIFEST_NAME, "", s, strlen (s));
+        free (s);
+    }
+}
+
+int rccache_glob (struct rccache *c, const char *pattern, char ***pathvp)
+{
+    struct timespec mtime;
+    struct timespec mtime2;
+    json_t *entry;
+    json_t *paths;
+    char **pathv;
+    int n;
+
+    if (!pattern || !pathvp) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!c || pattern_dir_mtime (pattern, &mtime) < 0)
+        return do_glob (pattern, pathvp);
+
+    if ((entry = json_object_get (json_object_get (c->manifest, "globs"),
+                                  pattern))
+        && mtime_match (json_object_get (entry, "mtime"), &mtime)
+        && (paths = json_object_get (entry, "paths"))
+        && json_is_array (paths)) {
+        if (!(pathv = pathv_create (NULL, paths, json_array_size (paths))))
+            return -1;
+        shell_trace ("rccache: %s: using cached manifest", pattern);
+        *pathvp = pathv;
+        return json_array_size (paths);
+    }
+    if ((n = do_glob (pattern, &pathv)) < 0)
+        return -1;
+    if (c->writable
+        && !is_racy (&mtime)
+        && pattern_dir_mtime (pattern, &mtime2) == 0
+        && mtime.tv_sec == mtime2.tv_sec
+        && mtime.tv_nsec == mtime2.tv_nsec)
+        manifest_update (c, pattern, &mtime, pathv);
+    *pathvp = pathv;
+    return n;
+}
+
+static int luac_writer (lua_State *L, const void *p, size_t sz, void *ud)
+{
+    struct buffer *b = ud;
+    char *data;
+
+    if (!(data = realloc (b->data, b->len + sz)))
+        return 1;
+    memcpy (data + b->len, p, sz);
+    b->data = data;
+    b->len += sz;
+    return 0;
+}
+
+static int luac_header (char *buf,
+                        size_t size,
+                        const char *path,
+                        struct stat *sb)
+{
+    if (snprintf (buf,
+                  size,
+                  "%s %jd %ld %jd %ju\n%s\n",
+                  LUAC_MAGIC,
+                  (intmax_t)sb->st_mtim.tv_sec,
+                  sb->st_mtim.tv_nsec,
+                  (intmax_t)sb->st_size,
+                  (uintmax_t)sb->st_ino,
+                  path) >= size) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+    return 0;
+}
+
+/* Load cached bytecode for 'path' if its header matches 'hdr'.
+ */
+static int luac_load (struct rccache *c,
+                      lua_State *L,
+                      const char *name,
+                      const char *path,
+                      const char *hdr)
+{
+    char chunkname[PATH_MAX + 2];
+    char *buf;
+    int len;
+    int hdrlen = strlen (hdr);
+    int rc = -1;
+
+    if (!(buf = read_cache_file (c, name, &len)))
+        return -1;
+    if (len > hdrlen && strncmp (buf, hdr, hdrlen) == 0) {
+        (void)snprintf (chunkname, sizeof (chunkname), "@%s", path);
+        if (luaL_loadbuffer (L, buf + hdrlen, len - hdrlen, chunkname) == 0)
+            rc = 0;
+        else
+            lua_pop (L, 1);
+    }
+    free (buf);
+    return rc;
+}
+
+static void luac_store (struct rccache *c,
+                        lua_State *L,
+                        const char *name,
+                        const char *hdr)
+{
+    struct buffer b = { 0 };
+    int rc;
+
+#if LUA_VERSION_NUM >= 503
+    rc = lua_dump (L, luac_writer, &b, 0);
+#else
+    rc = lua_dump (L, luac_writer, &b);
+#endif
+    if (rc == 0 && b.len > 0)
+        write_cache_file (c, name, hdr, b.data, b.len);
+    free (b.data);
+}
+
+int rccache_loadfile (struct rccache *c, lua_State *L, const char *path)
+{
+    char hdr[PATH_MAX + 128];
+    char name[BLOBREF_MAX_STRING_SIZE + 8];
+    struct stat sb;
+    int rc;
+
+    if (!c
+        || path[0] != '/'
+        || stat (path, &sb) < 0
+        || !S_ISREG (sb.st_mode)
+        || luac_header (hdr, sizeof (hdr), path, &sb) < 0
+        || blobref_hash ("sha1",
+                         path,
+                         strlen (path),
+                         name,
+                         sizeof (name) - 8) < 0)
+        return luaL_loadfile (L, path);
+    strcat (name, ".luac");
+
+    if (luac_load (c, L, name, path, hdr) == 0) {
+        shell_trace ("rccache: %s: using cached bytecode", path);
+        return 0;
+    }
+    if ((rc = luaL_loadfile (L, path)) != 0)
+        return rc;
+    if (c->writable && !is_racy (&sb.st_mtim))
+        luac_store (c, L, name, hdr);
+    return 0;
+}
+
+/* vi: ts=4 sw=4 expandtab
+ */
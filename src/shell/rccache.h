@@ -0,0 +1,54 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _SHELL_RCCACHE_H
+#define _SHELL_RCCACHE_H
+
+#include <lua.h>
+#include <flux/shell.h>
+
+/* The rc cache lets job shells skip the directory scans and Lua parsing
+ * done by the initrc.  It lives in ${rundir}/shell-cache and holds:
+ *  - manifest.json: results of plugin and rc file globs, keyed by
+ *    pattern and validated against the directory mtime
+ *  - precompiled Lua bytecode for rc files, validated against the
+ *    source file mtime, size, and inode
+ * Only shells running as the instance owner write the cache.  Other
+ * shells read it only if the directory and files are owned by the
+ * instance owner and not writable by anyone else.
+ */
+struct rccache;
+
+/* Returns NULL if there is no usable cache.  The rccache_glob() and
+ * rccache_loadfile() functions accept a NULL cache and fall back to
+ * glob(3) and luaL_loadfile().
+ */
+struct rccache *rccache_create (flux_shell_t *shell);
+void rccache_destroy (struct rccache *c);
+
+/* Expand glob 'pattern' with glob(3) GLOB_TILDE_CHECK semantics.
+ * Set 'pathv' to a NULL terminated array of sorted matches, to be freed
+ * with rccache_pathv_free(), and return the number of matches.
+ * Return -1 with errno set on error (ENOMEM, or EIO if a directory
+ * could not be read).
+ */
+int rccache_glob (struct rccache *c, const char *pattern, char ***pathv);
+void rccache_pathv_free (char **pathv);
+
+/* Load the Lua chunk in 'path' onto the stack as luaL_loadfile() does,
+ * using cached bytecode if it is current.  Only absolute paths are
+ * cached.  Returns a Lua status code.
+ */
+int rccache_loadfile (struct rccache *c, lua_State *L, const char *path);
+
+#endif /* !_SHELL_RCCACHE_H */
+
+/* vi: ts=4 sw=4 expandtab
+ */
@@ -31,6 +31,7 @@
 #include "src/common/libutil/log.h"
 #include "src/common/libutil/errno_safe.h"
 #include "src/common/libutil/fdutils.h"
+#include "src/common/libutil/monotime.h"
 #include "src/common/libtaskmap/taskmap_private.h"
 #include "ccan/str/str.h"
 
@@ -40,8 +41,10 @@
 #include "svc.h"
 #include "task.h"
 #include "rc.h"
+#include "rccache.h"
 #include "log.h"
 #include "mustache.h"
+#include "zygote.h"
 
 static char *shell_name = "flux-shell";
 static const char *shell_usage = "[OPTIONS] JOBID";
@@ -49,6 +52,8 @@ static const char *shell_usage = "[OPTIONS] JOBID";
 static struct optparse_option shell_opts[] =  {
     { .name = "reconnect", .has_arg = 0,
       .usage = "Attempt to reconnect if broker connection is lost" },
+    { .name = "zygote", .has_arg = 0,
+      .usage = "Fork a job shell for each job requested on stdin" },
     OPTPARSE_TABLE_END
 };
 
@@ -190,6 +195,17 @@ static void shell_parse_cmdline (flux_shell_t *shell, int argc, char *argv[])
     if ((optindex = optparse_parse_args (p, argc, argv)) < 0)
         exit (1);
 
+    /* In zygote mode, jobids are read from stdin.
+     */
+    if (optparse_hasopt (p, "zygote")) {
+        if (optindex != argc) {
+            optparse_print_usage (p);
+            exit (1);
+        }
+        shell->p = p;
+        return;
+    }
+
     /* Parse required positional argument.
      */
     if (optindex != argc - 1) {
@@ -970,6 +986,7 @@ static void shell_finalize (flux_shell_t *shell)
      */
     shell->plugstack = NULL;
     plugstack_destroy (plugstack);
+    rccache_destroy (shell->rccache);
 
     mustache_renderer_destroy (shell->mr);
     shell_eventlogger_destroy (shell->ev);
@@ -982,6 +999,7 @@ static void shell_finalize (flux_shell_t *shell)
     optparse_destroy (shell->p);
 
     zhashx_destroy (&shell->completion_refs);
+    json_decref (shell->init_timing);
 }
 
 static void item_free (void **item)
@@ -1150,6 +1168,10 @@ static void shell_initialize (flux_shell_t *shell)
 
     memset (shell, 0, sizeof (struct flux_shell));
 
+    monotime (&shell->init_mark);
+    if (!(shell->init_timing = json_object ()))
+        shell_die (1, "out of memory");
+
     if (gethostname (shell->hostname, sizeof (shell->hostname)) < 0)
         shell_die_errno (1, "gethostname");
 
@@ -1334,6 +1356,11 @@ static int load_initrc (flux_shell_t *shell, const char *default_rcfile)
     return 0;
 }
 
+static int rccache_glob_cb (const char *pattern, char ***pathv, void *arg)
+{
+    return rccache_glob (arg, pattern, pathv);
+}
+
 static int shell_initrc (flux_shell_t *shell)
 {
     const char *default_rcfile = shell_conf_get ("shell_initrc");
@@ -1341,6 +1368,12 @@ static int shell_initrc (flux_shell_t *shell)
 
     if ((result = flux_attr_get (shell->h, "conf.shell_pluginpath")))
         plugstack_set_searchpath (shell->plugstack, result);
+
+    /*  Plugin globs and rc files are served from the cache in the broker
+     *   rundir when possible.  The shell runs without it if unavailable.
+     */
+    if ((shell->rccache = rccache_create (shell)))
+        plugstack_set_glob (shell->plugstack, rccache_glob_cb, shell->rccache);
     if ((result = flux_attr_get (shell->h, "conf.shell_initrc")))
         default_rcfile = result;
 
@@ -1538,6 +1571,22 @@ static void shell_log_info (flux_shell_t *shell)
     }
 }
 
+/*  Record the time since the previous mark as the duration of init
+ *   phase 'name'.  The leader shell reports its breakdown in the context
+ *   of the shell.init event, so the cost of each phase of shell startup
+ *   is visible in the exec eventlog.
+ */
+static void shell_init_mark (flux_shell_t *shell, const char *name)
+{
+    json_t *o = json_real (monotime_since (shell->init_mark) / 1000.);
+
+    if (!o || json_object_set_new (shell->init_timing, name, o) < 0) {
+        json_decref (o);
+        shell_log_error ("failed to record %s init timing", name);
+    }
+    monotime (&shell->init_mark);
+}
+
 /*  Add default event context for standard shell emitted events -
  *   shell.init and shell.start.
  */
@@ -1618,9 +1667,15 @@ int main (int argc, char *argv[])
     shell_log_init (&shell, shell_name);
 
     shell_initialize (&shell);
+    shell_init_mark (&shell, "builtins");
 
     shell_parse_cmdline (&shell, argc, argv);
 
+    /* In zygote mode, only shells forked for a job return here.
+     */
+    if (optparse_hasopt (shell.p, "zygote") && shell_zygote (&shell) < 0)
+        shell_die_errno (1, "shell_zygote");
+
     /* Get reactor capable of monitoring subprocesses.
      */
     if (!(shell.r = flux_reactor_create (FLUX_REACTOR_SIGCHLD)))
@@ -1636,6 +1691,7 @@ int main (int argc, char *argv[])
     /* Subscribe to shell-<id>.* events. (no-op on loopback connector)
      */
     shell_events_subscribe (&shell);
+    shell_init_mark (&shell, "connect");
 
     /* Populate 'struct shell_info' for general use by shell components.
      * Fetches missing info from shell handle if set.
@@ -1664,14 +1720,17 @@ int main (int argc, char *argv[])
      */
     if (!(shell.svc = shell_svc_create (&shell)))
         shell_die (1, "shell_svc_create");
+    shell_init_mark (&shell, "info");
 
     /* Change working directory and Load shell initrc
      */
     if (shell_initrc (&shell) < 0)
         shell_die_errno (1, "shell_initrc");
+    shell_init_mark (&shell, "initrc");
 
     if (shell_taskmap (&shell) < 0)
         shell_die (1, "shell_taskmap");
+    shell_init_mark (&shell, "taskmap");
 
     /* Register the default components of the shell.init eventlog event
      * context. This includes the current taskmap, which may have been
@@ -1685,6 +1744,7 @@ int main (int argc, char *argv[])
      */
     if (shell_init (&shell) < 0)
         shell_die_errno (1, "shell_init");
+    shell_init_mark (&shell, "init");
 
     /* Now that verbosity, task mapping, etc. may have changed, log
      * basic shell info.
@@ -1695,11 +1755,21 @@ int main (int argc, char *argv[])
      */
     if (shell_barrier (&shell, "init") < 0)
         shell_die_errno (1, "shell_barrier");
+    shell_init_mark (&shell, "barrier");
 
-    /*  Emit an event after barrier completion from rank 0
+    /*  Emit an event after barrier completion from rank 0.
+     *  shell.init is not waited on, so that it can be committed to the
+     *   exec.eventlog together with shell.start for short lived shells.
      */
     if (shell.info->shell_rank == 0
-        && shell_eventlogger_emit_event (shell.ev, "shell.init") < 0)
+        && (flux_shell_add_event_context (&shell,
+                                          "shell.init",
+                                          0,
+                                          "{s:O}",
+                                          "timing",
+                                          shell.init_timing) < 0
+            || shell_eventlogger_emit_event_nowait (shell.ev,
+                                                    "shell.init") < 0))
             shell_die_errno (1, "failed to emit event shell.init");
 
     /* Call shell.post-init plugins.
@@ -33,6 +33,19 @@ flux_future_t *shell_svc_vpack (struct shell_svc *svc,
                                 const  char *fmt,
                                 va_list ap);
 
+/* Send an RPC to a shell 'method' by shell rank with a raw payload.
+ */
+flux_future_t *shell_svc_raw (struct shell_svc *svc,
+                              const char *method,
+                              int shell_rank,
+                              int flags,
+                              const void *data,
+                              int len);
+
+/* Return the broker rank hosting 'shell_rank', or -1 with errno set.
+ */
+int shell_svc_broker_rank (struct shell_svc *svc, int shell_rank);
+
 /* Register a message handler for 'method'.
  * The message handler is destroyed when shell->h is destroyed.
  */
@@ -39,11 +39,18 @@ char *taskmap_hostlist (int ntasks,
                         flux_error_t *errp)
 {
     struct taskmap *map = NULL;
+    struct hostlist_index *idx = NULL;
     char *result = NULL;
     const char *host = NULL;
 
-    if (!(map = taskmap_create ()))
+    /*  Index the job nodelist once so each task placement is a hash
+     *  lookup instead of a scan of the nodelist.
+     */
+    if (!(map = taskmap_create ())
+        || !(idx = hostlist_index_create (nodelist))) {
+        errprintf (errp, "failed to index job nodelist: %s", strerror (errno));
         goto error;
+    }
 
     /* Loop through hostlist hl until all tasks have been assigned to hosts
      */
@@ -51,7 +58,7 @@ char *taskmap_hostlist (int ntasks,
         int rank;
         if (host == NULL)
             host = hostlist_first (hl);
-        if ((rank = hostlist_find (nodelist, host)) < 0) {
+        if ((rank = hostlist_index_find (idx, host)) < 0) {
             errprintf (errp, "host %s not found in job nodelist", host);
             goto error;
         }
@@ -66,6 +73,7 @@ char *taskmap_hostlist (int ntasks,
     }
     result = taskmap_encode (map, TASKMAP_ENCODE_WRAPPED);
 error:
+    hostlist_index_destroy (idx);
     taskmap_destroy (map);
     return result;
 }
@@ -0,0 +1,640 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* job shell zygote
+ *
+ * When run as "flux-shell --zygote", the job shell performs its job
+ *  independent initialization once (exec, dynamic linking, builtin
+ *  plugins, and loading of the shell plugins found in the plugin
+ *  searchpath), then reads requests from stdin, one JSON object per line:
+ *
+ *  {"type":"run", "id":I, "env":{}}     - fork a shell for job id with
+ *                                         the given environment additions
+ *  {"type":"kill", "id":I, "signal":i}  - send signal to shell for job id
+ *
+ * and reports on stdout, also one JSON object per line:
+ *
+ *  {"type":"start", "id":I, "pid":i}    - shell for job id was forked
+ *  {"type":"output", "id":I, "data":s}  - a line of stderr from the shell
+ *                                         for job id
+ *  {"type":"exit", "id":I, "status":i}  - shell for job id exited with
+ *                                         wait status
+ *  {"type":"error", "id":I, "errnum":i} - shell for job id not started
+ *
+ * Each forked shell's stderr is a pipe to the zygote, so that its output
+ *  can be attributed to the job.  All stderr of a shell is sent before
+ *  its "exit" response.
+ *
+ * Forked shells return from shell_zygote() and continue as a normal job
+ *  shell.  Preloaded plugins are already mapped and relocated, so the
+ *  shell initrc only increments their reference counts.  Each shell still
+ *  opens its own broker connection, since a connection cannot be shared
+ *  across fork(2).
+ *
+ * The zygote exits once stdin is closed and all of its shells have exited.
+ *  Shells are not placed in a new process group, so they are terminated
+ *  along with the zygote if its process group is signaled.  If the zygote
+ *  itself dies, its shells receive SIGTERM, which they forward to their
+ *  tasks.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/prctl.h>
+#include <unistd.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <glob.h>
+#include <dlfcn.h>
+#include <signal.h>
+#include <jansson.h>
+#include <flux/core.h>
+
+#include "src/common/libczmqcontainers/czmq_containers.h"
+#include "src/common/libutil/fdutils.h"
+#include "src/common/libutil/monotime.h"
+#include "ccan/str/str.h"
+
+#include "internal.h"
+#include "log.h"
+#include "zygote.h"
+
+struct zygote_shell {
+    flux_jobid_t id;
+    pid_t pid;
+    int errfd;                  /* read end of shell stderr, or -1 */
+    char errbuf[4096];          /* partial line of stderr */
+    size_t errlen;
+};
+
+struct zygote {
+    zlistx_t *shells;
+    zlist_t *dsos;
+    char *buf;
+    size_t bufsize;
+    size_t buflen;
+    bool eof;
+    struct pollfd *fds;
+    size_t fds_size;
+};
+
+static int sigchld_fd[2] = { -1, -1 };
+
+static void sigchld_handler (int signum)
+{
+    int saved_errno = errno;
+    ssize_t n = write (sigchld_fd[1], "", 1);
+    (void) n; // if the pipe is full, a wakeup is already pending
+    errno = saved_errno;
+}
+
+static void zygote_shell_destroy (void **item)
+{
+    if (item) {
+        struct zygote_shell *zs = *item;
+        if (zs && zs->errfd >= 0)
+            close (zs->errfd);
+        free (zs);
+        *item = NULL;
+    }
+}
+
+static struct zygote_shell *zygote_shell_find (struct zygote *z,
+                                               flux_jobid_t id)
+{
+    struct zygote_shell *zs = zlistx_first (z->shells);
+    while (zs) {
+        if (zs->id == id)
+            return zs;
+        zs = zlistx_next (z->shells);
+    }
+    return NULL;
+}
+
+static void zygote_respond (const char *fmt, ...)
+{
+    va_list ap;
+    json_t *o;
+    char *s = NULL;
+
+    va_start (ap, fmt);
+    o = json_vpack_ex (NULL, 0, fmt, ap);
+    va_end (ap);
+    if (!o
+        || !(s = json_dumps (o, JSON_COMPACT))
+        || dprintf (STDOUT_FILENO, "%s\n", s) < 0)
+        shell_log_errno ("zygote: failed to write response");
+    free (s);
+    json_decref (o);
+}
+
+/*  Send 'len' bytes of stderr from the shell 'zs' as an "output" response.
+ *   Output that is not valid UTF-8 cannot be encoded in JSON, so in that
+ *   case bytes outside of ASCII are replaced with '?'.
+ */
+static void zygote_shell_output (struct zygote_shell *zs,
+                                 const char *data,
+                                 size_t len)
+{
+    json_t *o;
+
+    if (!(o = json_stringn (data, len))) {
+        char *cpy;
+        if (!(cpy = malloc (len)))
+            return;
+        for (size_t i = 0; i < len; i++)
+            cpy[i] = (unsigned char) data[i] < 0x80 ? data[i] : '?';
+        o = json_stringn (cpy, len);
+        free (cpy);
+        if (!o)
+            return;
+    }
+    zygote_respond ("{s:s s:I s:o}",
+                    "type", "output",
+                    "id", (json_int_t) zs->id,
+                    "data", o);
+}
+
+/*  Read available stderr from the shell 'zs' and send complete lines.
+ *   A line longer than the buffer is sent in pieces.  On EOF or error,
+ *   send any partial line, close the pipe and return -1.
+ */
+static int zygote_shell_read (struct zygote_shell *zs)
+{
+    ssize_t n;
+
+    while ((n = read (zs->errfd,
+                      zs->errbuf + zs->errlen,
+                      sizeof (zs->errbuf) - zs->errlen)) > 0) {
+        char *line = zs->errbuf;
+        char *nl;
+
+        zs->errlen += n;
+        while ((nl = memchr (line, '\n', zs->errbuf + zs->errlen - line))) {
+            zygote_shell_output (zs, line, nl - line + 1);
+            line = nl + 1;
+        }
+        zs->errlen -= line - zs->errbuf;
+        memmove (zs->errbuf, line, zs->errlen);
+        if (zs->errlen == sizeof (zs->errbuf)) {
+            zygote_shell_output (zs, zs->errbuf, zs->errlen);
+            zs->errlen = 0;
+        }
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EINTR))
+        return 0;
+    if (zs->errlen > 0) {
+        zygote_shell_output (zs, zs->errbuf, zs->errlen);
+        zs->errlen = 0;
+    }
+    close (zs->errfd);
+    zs->errfd = -1;
+    return -1;
+}
+
+/*  Get the shell plugin searchpath from the broker if it is set there,
+ *   as in shell_initrc(), so the zygote preloads the same plugins that
+ *   the default initrc will load.
+ */
+static char *zygote_pluginpath (flux_shell_t *shell)
+{
+    flux_t *h;
+    const char *path;
+    char *result = NULL;
+
+    if ((h = flux_open (NULL, 0))) {
+        if ((path = flux_attr_get (h, "conf.shell_pluginpath")))
+            result = strdup (path);
+        flux_close (h);
+    }
+    if (!result && (path = plugstack_get_searchpath (shell->plugstack)))
+        result = strdup (path);
+    return result;
+}
+
+/*  dlopen(3) every *.so in the plugin searchpath and keep it open.
+ *   Failures are not fatal here: the forked shell reports them if the
+ *   plugin is actually loaded.
+ */
+static void zygote_preload (struct zygote *z, flux_shell_t *shell)
+{
+    char *path;
+    char *dir;
+    char *sp;
+    char *cpy;
+
+    if (!(path = zygote_pluginpath (shell)))
+        return;
+    cpy = path;
+    while ((dir = strtok_r (cpy, ":", &sp))) {
+        char pattern[PATH_MAX];
+        glob_t gl;
+
+        cpy = NULL;
+        if (snprintf (pattern,
+                      sizeof (pattern),
+                      "%s/*.so",
+                      dir) >= sizeof (pattern))
+            continue;
+        if (glob (pattern, 0, NULL, &gl) != 0)
+            continue;
+        for (size_t i = 0; i < gl.gl_pathc; i++) {
+            void *dso;
+            if (!(dso = dlopen (gl.gl_pathv[i], RTLD_LAZY | RTLD_LOCAL))) {
+                shell_debug ("zygote: %s", dlerror ());
+                continue;
+            }
+            if (zlist_append (z->dsos, dso) < 0)
+                dlclose (dso);
+        }
+        globfree (&gl);
+    }
+    free (path);
+}
+
+static void zygote_destroy (struct zygote *z)
+{
+    if (z) {
+        int saved_errno = errno;
+        zlistx_destroy (&z->shells);
+        zlist_destroy (&z->dsos);
+        free (z->buf);
+        free (z->fds);
+        free (z);
+        errno = saved_errno;
+    }
+}
+
+static struct zygote *zygote_create (void)
+{
+    struct zygote *z;
+
+    if (!(z = calloc (1, sizeof (*z)))
+        || !(z->shells = zlistx_new ())
+        || !(z->dsos = zlist_new ()))
+        goto error;
+    zlistx_set_destructor (z->shells, zygote_shell_destroy);
+    return z;
+error:
+    zygote_destroy (z);
+    errno = ENOMEM;
+    return NULL;
+}
+
+/*  Child side of fork(2): undo zygote setup and apply job environment.
+ *   Preloaded plugin handles are intentionally left open.
+ */
+static int zygote_child (struct zygote *z,
+                         flux_shell_t *shell,
+                         flux_jobid_t id,
+                         json_t *env,
+                         pid_t zygote_pid,
+                         int errfd)
+{
+    struct zygote_shell *zs;
+    const char *name;
+    json_t *val;
+    int fd;
+
+    signal (SIGCHLD, SIG_DFL);
+    close (sigchld_fd[0]);
+    close (sigchld_fd[1]);
+
+    /*  Terminate this shell (and through it, its tasks) if the zygote
+     *   dies, since the job can no longer be monitored.
+     */
+    if (prctl (PR_SET_PDEATHSIG, SIGTERM) < 0
+        || getppid () != zygote_pid)
+        return -1;
+
+    /*  Stderr of this shell goes to its own pipe.  Close the pipes of
+     *   the other shells.
+     */
+    if (dup2 (errfd, STDERR_FILENO) < 0)
+        return -1;
+    if (errfd != STDERR_FILENO)
+        close (errfd);
+    zs = zlistx_first (z->shells);
+    while (zs) {
+        if (zs->errfd >= 0) {
+            close (zs->errfd);
+            zs->errfd = -1;
+        }
+        zs = zlistx_next (z->shells);
+    }
+
+    /*  Requests and responses are for the zygote only.  A forked shell
+     *   is always the only shell in its job, so it needs no protocol fds.
+     */
+    if ((fd = open ("/dev/null", O_RDWR)) < 0
+        || dup2 (fd, STDIN_FILENO) < 0
+        || dup2 (fd, STDOUT_FILENO) < 0)
+        return -1;
+    if (fd > STDOUT_FILENO)
+        close (fd);
+
+    json_object_foreach (env, name, val) {
+        const char *s = json_string_value (val);
+        if (s && setenv (name, s, 1) < 0)
+            return -1;
+    }
+    shell->jobid = id;
+
+    /*  Time spent in the zygote is not part of this shell's startup.
+     */
+    (void) json_object_del (shell->init_timing, "builtins");
+    monotime (&shell->init_mark);
+
+    zlist_destroy (&z->dsos);
+    zygote_destroy (z);
+    return 0;
+}
+
+/*  Handle one request.  Returns 1 in a forked shell, 0 in the zygote.
+ */
+static int zygote_request (struct zygote *z,
+                           flux_shell_t *shell,
+                           const char *line)
+{
+    json_t *o;
+    json_error_t error;
+    const char *type;
+    json_int_t id;
+    json_t *env = NULL;
+    int signum = 0;
+    struct zygote_shell *zs;
+    int rc = 0;
+
+    if (!(o = json_loads (line, 0, &error))
+        || json_unpack_ex (o,
+                           &error,
+                           0,
+                           "{s:s s:I s?o s?i}",
+                           "type", &type,
+                           "id", &id,
+                           "env", &env,
+                           "signal", &signum) < 0) {
+        shell_log_error ("zygote: invalid request: %s", error.text);
+        goto out;
+    }
+    if (streq (type, "kill")) {
+        if ((zs = zygote_shell_find (z, id))
+            && kill (zs->pid, signum) < 0)
+            shell_log_errno ("zygote: kill %ju", (uintmax_t) id);
+    }
+    else if (streq (type, "run")) {
+        pid_t zygote_pid = getpid ();
+        pid_t pid = -1;
+        int errpipe[2] = { -1, -1 };
+
+        if (zygote_shell_find (z, id)
+            || (env && !json_is_object (env))) {
+            zygote_respond ("{s:s s:I s:i}",
+                            "type", "error",
+                            "id", id,
+                            "errnum", EINVAL);
+            goto out;
+        }
+        if (!(zs = calloc (1, sizeof (*zs)))
+            || pipe (errpipe) < 0
+            || fd_set_cloexec (errpipe[0]) < 0
+            || fd_set_nonblocking (errpipe[0]) < 0
+            || (pid = fork ()) < 0) {
+            int saved_errno = errno;
+            zygote_respond ("{s:s s:I s:i}",
+                            "type", "error",
+                            "id", id,
+                            "errnum", saved_errno);
+            if (errpipe[0] >= 0) {
+                close (errpipe[0]);
+                close (errpipe[1]);
+            }
+            free (zs);
+            goto out;
+        }
+        if (pid == 0) {
+            free (zs);
+            close (errpipe[0]);
+            if (zygote_child (z,
+                              shell,
+                              id,
+                              env,
+                              zygote_pid,
+                              errpipe[1]) < 0)
+                shell_die_errno (1, "zygote: failed to initialize shell");
+            rc = 1;
+            goto out;
+        }
+        close (errpipe[1]);
+        zs->id = id;
+        zs->pid = pid;
+        zs->errfd = errpipe[0];
+        if (!zlistx_add_end (z->shells, zs)) {
+            shell_log_error ("zygote: out of memory");
+            close (zs->errfd);
+            free (zs);
+        }
+        zygote_respond ("{s:s s:I s:i}",
+                        "type", "start",
+                        "id", id,
+                        "pid", pid);
+    }
+    else
+        shell_log_error ("zygote: unknown request type %s", type);
+out:
+    json_decref (o);
+    return rc;
+}
+
+/*  Read available data from stdin and handle each complete line.
+ *   Returns 1 in a forked shell, 0 in the zygote, -1 on error.
+ */
+static int zygote_read (struct zygote *z, flux_shell_t *shell)
+{
+    char *line;
+    char *nl;
+    ssize_t n;
+
+    if (z->bufsize - z->buflen < 4096) {
+        size_t size = z->bufsize + 65536;
+        char *buf;
+        if (!(buf = realloc (z->buf, size)))
+            return -1;
+        z->buf = buf;
+        z->bufsize = size;
+    }
+    if ((n = read (STDIN_FILENO,
+                   z->buf + z->buflen,
+                   z->bufsize - z->buflen - 1)) < 0) {
+        if (errno == EINTR || errno == EAGAIN)
+            return 0;
+        return -1;
+    }
+    if (n == 0) {
+        z->eof = true;
+        return 0;
+    }
+    z->buflen += n;
+    z->buf[z->buflen] = '\0';
+
+    line = z->buf;
+    while ((nl = strchr (line, '\n'))) {
+        *nl = '\0';
+        if (strlen (line) > 0 && zygote_request (z, shell, line) == 1)
+            return 1;
+        line = nl + 1;
+    }
+    z->buflen -= line - z->buf;
+    memmove (z->buf, line, z->buflen);
+    return 0;
+}
+
+static void zygote_reap (struct zygote *z)
+{
+    char c;
+    pid_t pid;
+    int status;
+
+    while (read (sigchld_fd[0], &c, 1) == 1)
+        ;
+    while ((pid = waitpid (-1, &status, WNOHANG)) > 0) {
+        struct zygote_shell *zs = zlistx_first (z->shells);
+        while (zs) {
+            if (zs->pid == pid) {
+                /*  Send remaining stderr before the exit status.  Since
+                 *   the shell has exited, do not wait for EOF, which may
+                 *   be held off by a process that inherited its stderr.
+                 */
+                if (zs->errfd >= 0 && zygote_shell_read (zs) == 0) {
+                    if (zs->errlen > 0)
+                        zygote_shell_output (zs, zs->errbuf, zs->errlen);
+                    close (zs->errfd);
+                    zs->errfd = -1;
+                }
+                zygote_respond ("{s:s s:I s:i}",
+                                "type", "exit",
+                                "id", zs->id,
+                                "status", status);
+                zlistx_delete (z->shells, zlistx_cursor (z->shells));
+                break;
+            }
+            zs = zlistx_next (z->shells);
+        }
+    }
+}
+
+/*  Set up z->fds for poll(2): the SIGCHLD pipe, stdin (unless EOF was
+ *   reached), and the stderr pipe of each shell, in list order.
+ */
+static int zygote_pollfds (struct zygote *z, nfds_t *nfds)
+{
+    size_t size = zlistx_size (z->shells) + 2;
+    struct zygote_shell *zs;
+    nfds_t n = 0;
+
+    if (size > z->fds_size) {
+        struct pollfd *fds;
+        if (!(fds = realloc (z->fds, size * sizeof (*fds))))
+            return -1;
+        z->fds = fds;
+        z->fds_size = size;
+    }
+    z->fds[n++] = (struct pollfd){ .fd = sigchld_fd[0], .events = POLLIN };
+    z->fds[n++] = (struct pollfd){
+        .fd = z->eof ? -1 : STDIN_FILENO,
+        .events = POLLIN,
+    };
+    zs = zlistx_first (z->shells);
+    while (zs) {
+        z->fds[n++] = (struct pollfd){ .fd = zs->errfd, .events = POLLIN };
+        zs = zlistx_next (z->shells);
+    }
+    *nfds = n;
+    return 0;
+}
+
+/*  Forward stderr of shells whose pipes are ready.  The shell list must
+ *   not have changed since zygote_pollfds().
+ */
+static void zygote_shells_read (struct zygote *z, nfds_t nfds)
+{
+    struct zygote_shell *zs = zlistx_first (z->shells);
+    nfds_t i = 2;
+
+    while (zs && i < nfds) {
+        if (zs->errfd >= 0 && z->fds[i].revents)
+            (void) zygote_shell_read (zs);
+        zs = zlistx_next (z->shells);
+        i++;
+    }
+}
+
+int shell_zygote (flux_shell_t *shell)
+{
+    struct zygote *z;
+    struct sigaction sa;
+
+    if (!(z = zygote_create ()))
+        return -1;
+    if (pipe (sigchld_fd) < 0
+        || fd_set_nonblocking (sigchld_fd[0]) < 0
+        || fd_set_nonblocking (sigchld_fd[1]) < 0
+        || fd_set_cloexec (sigchld_fd[0]) < 0
+        || fd_set_cloexec (sigchld_fd[1]) < 0)
+        goto error;
+
+    memset (&sa, 0, sizeof (sa));
+    sa.sa_handler = sigchld_handler;
+    sa.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+    sigemptyset (&sa.sa_mask);
+    if (sigaction (SIGCHLD, &sa, NULL) < 0)
+        goto error;
+
+    zygote_preload (z, shell);
+    shell_debug ("zygote: preloaded %zu plugins", zlist_size (z->dsos));
+
+    while (!z->eof || zlistx_size (z->shells) > 0) {
+        nfds_t nfds;
+
+        if (zygote_pollfds (z, &nfds) < 0)
+            goto error;
+        if (poll (z->fds, nfds, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            goto error;
+        }
+        /*  Forward shell stderr first, while z->fds matches the shell
+         *   list, then handle new requests, then exited shells.
+         */
+        zygote_shells_read (z, nfds);
+        if (z->fds[1].revents) {
+            int rc = zygote_read (z, shell);
+            if (rc < 0)
+                goto error;
+            if (rc == 1)
+                return 0;
+        }
+        if (z->fds[0].revents)
+            zygote_reap (z);
+    }
+    zygote_destroy (z);
+    exit (0);
+error:
+    zygote_destroy (z);
+    return -1;
+}
+
+/* vi: ts=4 sw=4 expandtab
+ */
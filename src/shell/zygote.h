@@ -0,0 +1,28 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef SHELL_ZYGOTE_H
+#define SHELL_ZYGOTE_H
+
+#include "internal.h"
+
+/*  Run the job shell as a zygote: preload shell plugins, then fork a
+ *   shell for each job requested on stdin.  Returns 0 only in a forked
+ *   shell, with shell->jobid set and the job environment applied.
+ *   The zygote itself exits from this function once stdin is closed
+ *   and all of its shells have exited.  Returns -1 if the zygote could
+ *   not be initialized.
+ */
+int shell_zygote (flux_shell_t *shell);
+
+#endif /* !SHELL_ZYGOTE_H */
+
+/* vi: ts=4 sw=4 expandtab
+ */
@@ -0,0 +1,55 @@
+###############################################################
+# Copyright 2026 Lawrence Livermore National Security, LLC
+# (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+#
+# This file is part of the Flux resource manager framework.
+# For details, see https://github.com/flux-framework.
+#
+# SPDX-License-Identifier: LGPL-3.0
+###############################################################
+
+# Usage: flux python list-stream.py [--chunk-size=N] [--page-size=N]
+#
+#  List all job ids with job-list.list, one per line.  With --chunk-size,
+#  use a streaming request.  With --page-size, fetch the list in pages
+#  of N jobs, using the cursor from each page to request the next one.
+#
+
+import argparse
+
+import flux
+from flux.job.list import job_list
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--chunk-size", type=int, default=0)
+parser.add_argument("--page-size", type=int, default=0)
+args = parser.parse_args()
+
+h = flux.Flux()
+userid = flux.constants.FLUX_USERID_UNKNOWN
+
+if args.page_size:
+    cursor = {}
+    while True:
+        rpc = job_list(
+            h,
+            max_entries=args.page_size,
+            attrs=[],
+            userid=userid,
+            chunk_size=args.chunk_size,
+            cursor=cursor,
+        )
+        jobs = rpc.get_jobs()
+        for job in jobs:
+            print(job["id"])
+        if len(jobs) < args.page_size:
+            break
+        cursor = rpc.cursor
+else:
+    rpc = job_list(
+        h, max_entries=0, attrs=[], userid=userid, chunk_size=args.chunk_size
+    )
+    for job in rpc.get_jobs():
+        print(job["id"])
+
+# vim: tabstop=4 shiftwidth=4 expandtab
@@ -0,0 +1,77 @@
+###############################################################
+# Copyright 2026 Lawrence Livermore National Security, LLC
+# (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+#
+# This file is part of the Flux resource manager framework.
+# For details, see https://github.com/flux-framework.
+#
+# SPDX-License-Identifier: LGPL-3.0
+###############################################################
+
+# Usage: flux python watch.py [--constraint=JSON] [--since=T] [--submit]
+#                             [--purge]
+#
+#  Send a job-list.watch request and print "snapshot N" for each
+#  snapshot response of N jobs, then "sync".  With --submit, submit a
+#  job after "sync" and print "TYPE STATE" for each response naming
+#  it, until it is reported inactive or removed.  With --purge, purge
+#  the job once it is inactive and wait for it to be removed.
+#
+
+import argparse
+import json
+
+import flux
+import flux.constants
+from flux.job import JobspecV1, submit
+from flux.job.info import statetostr
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--constraint", type=json.loads, default=None)
+parser.add_argument("--since", type=float, default=0.0)
+parser.add_argument("--submit", action="store_true")
+parser.add_argument("--purge", action="store_true")
+args = parser.parse_args()
+
+h = flux.Flux()
+payload = {"attrs": ["state"], "since": args.since}
+if args.constraint is not None:
+    payload["constraint"] = args.constraint
+
+f = h.rpc("job-list.watch", payload, flags=flux.constants.FLUX_RPC_STREAMING)
+jobid = None
+try:
+    while True:
+        resp = f.get()
+        f.reset()
+        if resp["type"] == "snapshot":
+            print(f"snapshot {len(resp['jobs'])}")
+        elif resp["type"] == "sync":
+            print("sync")
+            if not args.submit:
+                break
+            jobid = submit(h, JobspecV1.from_command(["true"]))
+        else:
+            done = False
+            for job in resp["jobs"]:
+                if job["id"] != jobid:
+                    continue
+                if resp["type"] == "remove":
+                    print("remove")
+                    done = True
+                    continue
+                state = job["state"]
+                print(f"{resp['type']} {statetostr(state, 'S')}")
+                if state == flux.constants.FLUX_JOB_STATE_INACTIVE:
+                    if args.purge:
+                        h.rpc(
+                            "job-manager.purge-id", {"id": jobid, "force": 1}
+                        ).get()
+                    else:
+                        done = True
+            if done:
+                break
+except OSError as exc:
+    print(f"errno {exc.errno}: {exc.strerror}")
+
+# vim: tabstop=4 shiftwidth=4 expandtab
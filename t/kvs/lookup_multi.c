@@ -0,0 +1,106 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* lookup_multi - look up several keys with flux_kvs_lookup_multi()
+ *
+ * Prints "key=value" or "key: error" for each key, sorted by key
+ * since responses arrive in completion order.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <libgen.h>
+#include <stdlib.h>
+#include <string.h>
+#include <flux/core.h>
+
+#include "src/common/libutil/log.h"
+
+static void usage (void)
+{
+    fprintf (stderr, "Usage: lookup_multi [--at=treeobj] key [key...]\n");
+    exit (1);
+}
+
+static int cmpstr (const void *a, const void *b)
+{
+    return strcmp (*(char **)a, *(char **)b);
+}
+
+int main (int argc, char *argv[])
+{
+    flux_t *h;
+    flux_future_t *f;
+    const char *treeobj = NULL;
+    const char **keys;
+    char **lines;
+    int nkeys;
+    int count = 0;
+    int argi = 1;
+
+    log_init (basename (argv[0]));
+
+    if (argc > 1 && !strncmp (argv[1], "--at=", 5)) {
+        treeobj = argv[1] + 5;
+        argi++;
+    }
+    if ((nkeys = argc - argi) < 1)
+        usage ();
+    keys = (const char **)&argv[argi];
+    if (!(lines = calloc (nkeys, sizeof (lines[0]))))
+        log_err_exit ("calloc");
+
+    if (!(h = flux_open (NULL, 0)))
+        log_err_exit ("flux_open");
+    if (!(f = flux_kvs_lookup_multi (h, NULL, 0, treeobj, keys, nkeys)))
+        log_err_exit ("flux_kvs_lookup_multi");
+    for (;;) {
+        const char *value;
+        const char *key;
+        char *line;
+        int rc;
+
+        rc = flux_kvs_lookup_get (f, &value);
+        if (rc < 0 && errno == ENODATA) {
+            if (flux_kvs_lookup_get_key (f) != NULL || errno != ENODATA)
+                log_msg_exit ("get_key did not fail with ENODATA at end");
+            break;
+        }
+        if (!(key = flux_kvs_lookup_get_key (f)))
+            log_err_exit ("flux_kvs_lookup_get_key");
+        if (count == nkeys)
+            log_msg_exit ("received more responses than keys");
+        if (rc < 0)
+            rc = asprintf (&line, "%s: %s", key, flux_strerror (errno));
+        else
+            rc = asprintf (&line, "%s=%s", key, value ? value : "");
+        if (rc < 0)
+            log_err_exit ("asprintf");
+        lines[count++] = line;
+        flux_future_reset (f);
+    }
+    if (count != nkeys)
+        log_msg_exit ("received %d responses for %d keys", count, nkeys);
+    qsort (lines, count, sizeof (lines[0]), cmpstr);
+    for (int i = 0; i < count; i++) {
+        printf ("%s\n", lines[i]);
+        free (lines[i]);
+    }
+    free (lines);
+    flux_future_destroy (f);
+    flux_close (h);
+    log_fini ();
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -332,6 +332,56 @@ class TestJob(unittest.TestCase):
         ).get_jobinfos():
             self.assertEqual(job.name, "sleep")
 
+    def test_21_list_aggregate(self):
+        inactive = self.getJobs(
+            flux.job.job_list(
+                self.fh, 0, ["nnodes"], states=flux.constants.FLUX_JOB_STATE_INACTIVE
+            )
+        )
+        rpc = flux.job.job_list_aggregate(self.fh, "state", sums=["nnodes"])
+        groups = rpc.get_groups()
+        group = next(
+            g for g in groups if g["value"] == flux.constants.FLUX_JOB_STATE_INACTIVE
+        )
+        self.assertEqual(group["count"], len(inactive))
+        self.assertEqual(
+            group["sum"]["nnodes"], sum(job.get("nnodes", 0) for job in inactive)
+        )
+
+    def test_22_list_aggregate_invalid(self):
+        with self.assertRaises(OSError):
+            flux.job.job_list_aggregate(self.fh, "foo").get_groups()
+        with self.assertRaises(OSError):
+            flux.job.job_list_aggregate(self.fh, "state", sums=["name"]).get_groups()
+
+    def test_23_list_stream_fallback(self):
+        # A job-list without streaming support answers a streaming
+        # request with a single response that has no cursor.
+        server = flux.Flux()
+        server.service_register("fakelist").get()
+
+        def list_cb(h, t, msg, arg):
+            h.respond(msg, {"jobs": [{"id": 1}, {"id": 2}]})
+            h.reactor_stop()
+
+        w = server.msg_watcher_create(
+            list_cb, flux.constants.FLUX_MSGTYPE_REQUEST, "fakelist.list"
+        )
+        w.start()
+        rpc = flux.job.list.JobListRPC(
+            self.fh,
+            "fakelist.list",
+            {"max_entries": 0, "chunk_size": 1},
+            flags=flux.constants.FLUX_RPC_STREAMING,
+        )
+        server.reactor_run()
+        jobs = rpc.get_jobs()
+        self.assertEqual([job["id"] for job in jobs], [1, 2])
+        self.assertIsNone(rpc.cursor)
+        w.stop()
+        w.destroy()
+        server.service_unregister("fakelist").get()
+
 
 if __name__ == "__main__":
     from subflux import rerun_under_flux
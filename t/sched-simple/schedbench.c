@@ -0,0 +1,559 @@
+/************************************************************\
+ * Copyright 2026 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* schedbench - replay a job trace through librlist in virtual time
+ *
+ * Build an rlist of N synthetic nodes, then feed a job trace through
+ * the same alloc/free cycle used by sched-simple: jobs are queued in
+ * priority order, the head of the queue is allocated with rlist_alloc()
+ * until ENOSPC (head-of-line blocking), and allocations are encoded to
+ * R, decoded again and released with rlist_free() when their duration
+ * expires in virtual time.
+ *
+ * Trace lines (or stdin with --trace=-) have the form
+ *
+ *   NNODES NSLOTS SLOT_SIZE DURATION [CONSTRAINT]
+ *
+ * where CONSTRAINT is an optional RFC 31 constraint JSON object.
+ * Blank lines and lines starting with '#' are ignored.  Without
+ * --trace, a pseudo-random trace of --jobs=N jobs is generated.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <jansson.h>
+#include <flux/core.h>
+#include <flux/idset.h>
+#include <flux/optparse.h>
+
+#include "src/common/libczmqcontainers/czmq_containers.h"
+#include "src/common/libutil/log.h"
+#include "src/common/libutil/monotime.h"
+#include "src/common/librlist/rlist.h"
+#include "ccan/str/str.h"
+
+struct simjob {
+    unsigned int id;
+    int nnodes;
+    int nslots;
+    int slot_size;
+    double duration;
+    json_t *constraints;
+
+    double t_end;
+    json_t *R;
+};
+
+struct sim {
+    struct rlist *rl;
+    const char *alloc_mode;
+    int queue_depth;
+
+    zlistx_t *trace;    /* jobs not yet submitted, in order */
+    zlistx_t *queue;    /* pending alloc requests */
+    zlistx_t *running;  /* allocated jobs sorted by t_end */
+
+    double now;
+    double busy_core_seconds;
+    int total_cores;
+
+    int nallocs;
+    int ndenied;
+    double *latency;    /* per-alloc wall clock latency (ms) */
+    int nlatency;
+    double t_alloc;     /* total wall clock ms in alloc path */
+    double t_free;      /* total wall clock ms in free path */
+};
+
+static struct optparse_option opts[] =  {
+    { .name = "nodes", .key = 'N', .has_arg = 1, .arginfo = "N",
+      .usage = "Number of synthetic nodes (default 128)",
+    },
+    { .name = "cores", .key = 'c', .has_arg = 1, .arginfo = "N",
+      .usage = "Cores per node (default 32)",
+    },
+    { .name = "gpus", .key = 'g', .has_arg = 1, .arginfo = "N",
+      .usage = "GPUs per node (default 0)",
+    },
+    { .name = "property", .key = 'p', .has_arg = 1, .arginfo = "NAME[@RANKS]",
+      .flags = OPTPARSE_OPT_AUTOSPLIT,
+      .usage = "Assign property NAME to RANKS (default all ranks)",
+    },
+    { .name = "mode", .key = 'm', .has_arg = 1, .arginfo = "MODE",
+      .usage = "rlist_alloc(3) mode (worst-fit, best-fit, first-fit)",
+    },
+    { .name = "queue-depth", .key = 'q', .has_arg = 1, .arginfo = "N",
+      .usage = "Max pending alloc requests, as with sched-simple"
+               " alloc-limit (default 8, 0=unlimited)",
+    },
+    { .name = "trace", .key = 't', .has_arg = 1, .arginfo = "FILE",
+      .usage = "Read job trace from FILE ('-' for stdin)",
+    },
+    { .name = "jobs", .key = 'j', .has_arg = 1, .arginfo = "N",
+      .usage = "Generate a random trace of N jobs (default 10000)",
+    },
+    { .name = "seed", .key = 's', .has_arg = 1, .arginfo = "N",
+      .usage = "Seed for random trace generation (default 1)",
+    },
+    { .name = "json", .key = 'J', .has_arg = 0,
+      .usage = "Emit results as a JSON object",
+    },
+    OPTPARSE_TABLE_END
+};
+
+static void simjob_destroy (struct simjob *job)
+{
+    if (job) {
+        json_decref (job->constraints);
+        json_decref (job->R);
+        free (job);
+    }
+}
+
+static void simjob_destructor (void **item)
+{
+    if (item) {
+        simjob_destroy (*item);
+        *item = NULL;
+    }
+}
+
+static int simjob_end_cmp (const void *a, const void *b)
+{
+    const struct simjob *j1 = a;
+    const struct simjob *j2 = b;
+    if (j1->t_end == j2->t_end)
+        return j1->id < j2->id ? -1 : j1->id > j2->id;
+    return j1->t_end < j2->t_end ? -1 : 1;
+}
+
+static struct simjob *simjob_create (unsigned int id,
+                                     int nnodes,
+                                     int nslots,
+                                     int slot_size,
+                                     double duration)
+{
+    struct simjob *job;
+
+    if (!(job = calloc (1, sizeof (*job))))
+        log_err_exit ("out of memory");
+    job->id = id;
+    job->nnodes = nnodes;
+    job->nslots = nslots;
+    job->slot_size = slot_size;
+    job->duration = duration;
+    return job;
+}
+
+static void trace_append (struct sim *sim, struct simjob *job)
+{
+    if (!zlistx_add_end (sim->trace, job))
+        log_msg_exit ("out of memory");
+}
+
+static void trace_read (struct sim *sim, const char *path)
+{
+    FILE *fp = stdin;
+    char *line = NULL;
+    size_t size = 0;
+    int lineno = 0;
+    unsigned int id = 0;
+
+    if (!streq (path, "-") && !(fp = fopen (path, "r")))
+        log_err_exit ("%s", path);
+
+    while (getline (&line, &size, fp) > 0) {
+        struct simjob *job;
+        int nnodes, nslots, slot_size, n;
+        double duration;
+        char *p = line;
+
+        lineno++;
+        while (*p == ' ' || *p == '\t')
+            p++;
+        if (*p == '#' || *p == '\n' || *p == '\0')
+            continue;
+        if (sscanf (p,
+                    "%d %d %d %lf %n",
+                    &nnodes,
+                    &nslots,
+                    &slot_size,
+                    &duration,
+                    &n) != 4)
+            log_msg_exit ("%s:%d: failed to parse job", path, lineno);
+        job = simjob_create (id++, nnodes, nslots, slot_size, duration);
+        p += n;
+        if (*p != '\0' && *p != '\n') {
+            json_error_t error;
+            if (!(job->constraints = json_loads (p, 0, &error)))
+                log_msg_exit ("%s:%d: constraint: %s",
+                              path,
+                              lineno,
+                              error.text);
+        }
+        trace_append (sim, job);
+    }
+    free (line);
+    if (fp != stdin)
+        fclose (fp);
+}
+
+static void trace_generate (struct sim *sim,
+                            int njobs,
+                            int nnodes,
+                            int cores,
+                            unsigned int seed)
+{
+    int maxnodes = nnodes > 16 ? nnodes / 8 : nnodes;
+
+    for (int i = 0; i < njobs; i++) {
+        struct simjob *job;
+        int nn = 0;
+        int nslots;
+        double duration = 1. + rand_r (&seed) % 600;
+
+        /*  Mix of node-exclusive and core-slot jobs, with core-slot
+         *   jobs skewed toward small sizes as in typical workloads.
+         */
+        if (rand_r (&seed) % 4 == 0) {
+            nn = 1 + rand_r (&seed) % maxnodes;
+            nslots = nn;
+            job = simjob_create (i, nn, nslots, cores, duration);
+        }
+        else {
+            nslots = 1 + rand_r (&seed) % cores;
+            if (rand_r (&seed) % 8 == 0)
+                nslots *= 1 + rand_r (&seed) % maxnodes;
+            job = simjob_create (i, 0, nslots, 1, duration);
+        }
+        trace_append (sim, job);
+    }
+}
+
+static struct rlist *rlist_synthetic (int nnodes,
+                                      int cores,
+                                      int gpus,
+                                      optparse_t *p)
+{
+    struct rlist *rl;
+    char coreids[64];
+    char gpuids[64];
+    const char *arg;
+    flux_error_t error;
+
+    if (nnodes <= 0 || cores <= 0 || gpus < 0)
+        log_msg_exit ("invalid nodes, cores, or gpus value");
+    snprintf (coreids, sizeof (coreids), "0-%d", cores - 1);
+    snprintf (gpuids, sizeof (gpuids), "0-%d", gpus - 1);
+
+    if (!(rl = rlist_create ()))
+        log_err_exit ("rlist_create");
+    for (int i = 0; i < nnodes; i++) {
+        char host[64];
+        snprintf (host, sizeof (host), "node%d", i);
+        if (rlist_append_rank_cores (rl, host, i, coreids) < 0)
+            log_err_exit ("rlist_append_rank_cores %s", host);
+        if (gpus > 0 && rlist_rank_add_child (rl, i, "gpu", gpuids) < 0)
+            log_err_exit ("rlist_rank_add_child %s", host);
+    }
+
+    optparse_getopt_iterator_reset (p, "property");
+    while ((arg = optparse_getopt_next (p, "property"))) {
+        char *name;
+        char *targets;
+        char all[64];
+
+        if (!(name = strdup (arg)))
+            log_msg_exit ("out of memory");
+        if ((targets = strchr (name, '@')))
+            *targets++ = '\0';
+        else {
+            snprintf (all, sizeof (all), "0-%d", nnodes - 1);
+            targets = all;
+        }
+        if (rlist_add_property (rl, &error, name, targets) < 0)
+            log_msg_exit ("property %s: %s", arg, error.text);
+        free (name);
+    }
+    return rl;
+}
+
+static void sim_release (struct sim *sim, struct simjob *job)
+{
+    struct timespec t0;
+    struct rlist *alloc;
+    json_error_t error;
+
+    /*  Mirror sched-simple try_free(): R is decoded from JSON on
+     *   every sched.free request.
+     */
+    monotime (&t0);
+    if (!(alloc = rlist_from_json (job->R, &error)))
+        log_msg_exit ("job %u: unable to parse R: %s", job->id, error.text);
+    if (rlist_free (sim->rl, alloc) < 0)
+        log_err_exit ("job %u: rlist_free", job->id);
+    rlist_destroy (alloc);
+    sim->t_free += monotime_since (t0);
+}
+
+/*  Advance virtual time to the next job completion and release
+ *   all jobs that end at that time.  Returns -1 if nothing is running.
+ */
+static int sim_advance (struct sim *sim)
+{
+    struct simjob *job;
+    double t;
+
+    if (!(job = zlistx_first (sim->running)))
+        return -1;
+    t = job->t_end;
+    while (job && job->t_end == t) {
+        sim_release (sim, job);
+        zlistx_delete (sim->running, zlistx_cursor (sim->running));
+        job = zlistx_first (sim->running);
+    }
+    sim->now = t;
+    return 0;
+}
+
+/*  Move jobs from trace into the sched queue up to the queue depth,
+ *   like the job-manager does in sched-simple "limited" mode.
+ */
+static void sim_submit (struct sim *sim)
+{
+    struct simjob *job;
+
+    while ((sim->queue_depth == 0
+            || zlistx_size (sim->queue) < sim->queue_depth)
+           && (job = zlistx_first (sim->trace))) {
+        zlistx_detach_cur (sim->trace);
+        if (!zlistx_add_end (sim->queue, job))
+            log_msg_exit ("out of memory");
+    }
+}
+
+/*  Attempt to allocate the job at the head of the queue.
+ *   Returns -1 with errno == ENOSPC if the queue is blocked.
+ */
+static int sim_try_alloc (struct sim *sim)
+{
+    struct simjob *job;
+    struct rlist *alloc;
+    struct timespec t0;
+    flux_error_t error;
+    double t;
+    struct rlist_alloc_info ai = { .mode = sim->alloc_mode };
+
+    if (!(job = zlistx_first (sim->queue))) {
+        errno = ENOENT;
+        return -1;
+    }
+    ai.nnodes = job->nnodes;
+    ai.nslots = job->nslots;
+    ai.slot_size = job->slot_size;
+    ai.exclusive = job->nnodes > 0;
+    ai.constraints = job->constraints;
+
+    monotime (&t0);
+    errno = 0;
+    if ((alloc = rlist_alloc (sim->rl, &ai, &error))) {
+        alloc->starttime = sim->now;
+        alloc->expiration = sim->now + job->duration;
+        job->R = rlist_to_R (alloc);
+    }
+    t = monotime_since (t0);
+    sim->t_alloc += t;
+
+    if (!alloc) {
+        if (errno == ENOSPC)
+            return -1;
+        sim->ndenied++;
+        zlistx_delete (sim->queue, zlistx_cursor (sim->queue));
+        return 0;
+    }
+    if (!job->R)
+        log_msg_exit ("job %u: rlist_to_R failed", job->id);
+
+    sim->latency[sim->nlatency++] = t;
+    sim->nallocs++;
+    sim->busy_core_seconds += rlist_count (alloc, "core") * job->duration;
+    rlist_destroy (alloc);
+
+    zlistx_detach_cur (sim->queue);
+    job->t_end = sim->now + job->duration;
+    if (!zlistx_insert (sim->running, job, false))
+        log_msg_exit ("out of memory");
+    return 0;
+}
+
+static void sim_run (struct sim *sim)
+{
+    for (;;) {
+        sim_submit (sim);
+        if (sim_try_alloc (sim) == 0)
+            continue;
+        if (errno == ENOSPC) {
+            /*  Nothing left to free: head of queue can never run */
+            if (sim_advance (sim) < 0) {
+                sim->ndenied++;
+                zlistx_delete (sim->queue, zlistx_cursor (sim->queue));
+            }
+            continue;
+        }
+        /*  Queue is empty: drain remaining running jobs */
+        while (sim_advance (sim) == 0)
+            ;
+        break;
+    }
+}
+
+static int double_cmp (const void *a, const void *b)
+{
+    double x = *(const double *) a;
+    double y = *(const double *) b;
+    return x < y ? -1 : x > y;
+}
+
+static double percentile (double *v, int n, double pct)
+{
+    int i;
+    if (n == 0)
+        return 0.;
+    i = (int) (pct / 100. * (n - 1) + 0.5);
+    return v[i];
+}
+
+static void sim_report (struct sim *sim, int nnodes, double wall, bool json)
+{
+    double p50, p99, max, rate, util;
+
+    qsort (sim->latency, sim->nlatency, sizeof (double), double_cmp);
+    p50 = percentile (sim->latency, sim->nlatency, 50.);
+    p99 = percentile (sim->latency, sim->nlatency, 99.);
+    max = sim->nlatency ? sim->latency[sim->nlatency - 1] : 0.;
+    rate = sim->t_alloc > 0. ? sim->nallocs / (sim->t_alloc / 1000.) : 0.;
+    util = sim->now > 0. ?
+           sim->busy_core_seconds / (sim->total_cores * sim->now) : 0.;
+
+    if (json) {
+        json_t *o;
+        char *s;
+        if (!(o = json_pack ("{s:i s:i s:i s:i s:f s:f s:f s:f s:f s:f"
+                             " s:f s:f}",
+                             "nodes", nnodes,
+                             "cores", sim->total_cores,
+                             "allocated", sim->nallocs,
+                             "denied", sim->ndenied,
+                             "makespan", sim->now,
+                             "wall", wall,
+                             "allocs_per_sec", rate,
+                             "alloc_p50_ms", p50,
+                             "alloc_p99_ms", p99,
+                             "alloc_max_ms", max,
+                             "free_ms", sim->t_free,
+                             "utilization", util))
+            || !(s = json_dumps (o, JSON_COMPACT)))
+            log_msg_exit ("failed to encode results");
+        printf ("%s\n", s);
+        free (s);
+        json_decref (o);
+        return;
+    }
+    printf ("nodes=%d cores=%d\n", nnodes, sim->total_cores);
+    printf ("allocated=%d denied=%d\n", sim->nallocs, sim->ndenied);
+    printf ("makespan=%.1fs wall=%.3fs\n", sim->now, wall);
+    printf ("allocs/sec=%.1f\n", rate);
+    printf ("alloc latency: p50=%.3fms p99=%.3fms max=%.3fms\n",
+            p50,
+            p99,
+            max);
+    printf ("free total=%.3fms\n", sim->t_free);
+    printf ("utilization=%.2f%%\n", util * 100.);
+}
+
+int main (int argc, char *argv[])
+{
+    optparse_t *p;
+    struct sim sim;
+    int nnodes, cores, gpus;
+    int optindex;
+    struct timespec t0;
+
+    log_init ("schedbench");
+
+    if (!(p = optparse_create ("schedbench"))
+        || optparse_add_option_table (p, opts) != OPTPARSE_SUCCESS)
+        log_msg_exit ("failed to create option parser");
+    if ((optindex = optparse_parse_args (p, argc, argv)) < 0)
+        exit (1);
+    if (optindex != argc) {
+        optparse_print_usage (p);
+        exit (1);
+    }
+
+    memset (&sim, 0, sizeof (sim));
+    nnodes = optparse_get_int (p, "nodes", 128);
+    cores = optparse_get_int (p, "cores", 32);
+    gpus = optparse_get_int (p, "gpus", 0);
+    sim.alloc_mode = optparse_get_str (p, "mode", NULL);
+    sim.queue_depth = optparse_get_int (p, "queue-depth", 8);
+    if (sim.queue_depth < 0)
+        log_msg_exit ("queue-depth must be >= 0");
+
+    if (!(sim.trace = zlistx_new ())
+        || !(sim.queue = zlistx_new ())
+        || !(sim.running = zlistx_new ()))
+        log_msg_exit ("out of memory");
+    zlistx_set_destructor (sim.trace, simjob_destructor);
+    zlistx_set_destructor (sim.queue, simjob_destructor);
+    zlistx_set_destructor (sim.running, simjob_destructor);
+    zlistx_set_comparator (sim.running, simjob_end_cmp);
+
+    sim.rl = rlist_synthetic (nnodes, cores, gpus, p);
+    sim.total_cores = rlist_count (sim.rl, "core");
+
+    if (optparse_hasopt (p, "trace"))
+        trace_read (&sim, optparse_get_str (p, "trace", NULL));
+    else
+        trace_generate (&sim,
+                        optparse_get_int (p, "jobs", 10000),
+                        nnodes,
+                        cores,
+                        optparse_get_int (p, "seed", 1));
+
+    if (!(sim.latency = calloc (zlistx_size (sim.trace) + 1,
+                                sizeof (double))))
+        log_msg_exit ("out of memory");
+
+    monotime (&t0);
+    sim_run (&sim);
+    sim_report (&sim,
+                nnodes,
+                monotime_since (t0) / 1000.,
+                optparse_hasopt (p, "json"));
+
+    free (sim.latency);
+    zlistx_destroy (&sim.trace);
+    zlistx_destroy (&sim.queue);
+    zlistx_destroy (&sim.running);
+    rlist_destroy (sim.rl);
+    optparse_destroy (p);
+    log_fini ();
+    return 0;
+}
+
+/* vi: ts=4 sw=4 expandtab
+ */
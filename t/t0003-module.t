@@ -107,6 +107,64 @@ test_expect_success 'module: load fails on invalid module' '
 	test_must_fail flux module load nosuchmodule 2>load.err &&
 	grep "module not found" load.err
 '
+test_expect_success 'module: load-bulk loads modules with dependencies' '
+	cat >bulk.in <<-EOT &&
+	# comment
+	$testmod --name=bulk1
+
+	$testmod --name=bulk2 --after=bulk1
+	$testmod --name=bulk3 --after=bulk1,bulk2
+	EOT
+	flux module load-bulk -v bulk.in >bulk.out &&
+	test_debug "cat bulk.out" &&
+	grep "^bulk1: started" bulk.out &&
+	grep "^bulk2: started" bulk.out &&
+	grep "^bulk3: started" bulk.out &&
+	test $(module_getinfo bulk3) = "bulk3"
+'
+test_expect_success 'module: load-bulk dependency may be already loaded' '
+	echo "$testmod --name=bulk4 --after=bulk3" | flux module load-bulk &&
+	flux module list | grep bulk4
+'
+test_expect_success 'module: unload bulk loaded modules' '
+	for name in bulk1 bulk2 bulk3 bulk4; do \
+		flux module remove $name || return 1; \
+	done
+'
+test_expect_success 'module: load-bulk with empty input does nothing' '
+	flux module load-bulk </dev/null
+'
+test_expect_success 'module: load-bulk fails on unknown dependency' '
+	echo "$testmod --after=nosuchmod" >bulk-nodep.in &&
+	test_must_fail flux module load-bulk bulk-nodep.in 2>bulk-nodep.err &&
+	grep "unknown dependency nosuchmod" bulk-nodep.err
+'
+test_expect_success 'module: load-bulk fails on dependency cycle' '
+	cat >bulk-cycle.in <<-EOT &&
+	$testmod --name=cyc1 --after=cyc2
+	$testmod --name=cyc2 --after=cyc1
+	EOT
+	test_must_fail flux module load-bulk bulk-cycle.in 2>bulk-cycle.err &&
+	grep "cycle" bulk-cycle.err
+'
+test_expect_success 'module: load-bulk fails on duplicate module' '
+	cat >bulk-dup.in <<-EOT &&
+	$testmod --name=dup
+	$testmod --name=dup
+	EOT
+	test_must_fail flux module load-bulk bulk-dup.in 2>bulk-dup.err &&
+	grep "more than once" bulk-dup.err
+'
+test_expect_success 'module: load-bulk returns initialization error' '
+	cat >bulk-fail.in <<-EOT &&
+	$testmod --name=fail1 --init-failure
+	$testmod --name=fail2 --after=fail1
+	EOT
+	test_must_fail flux module load-bulk bulk-fail.in 2>bulk-fail.err &&
+	grep "fail1" bulk-fail.err &&
+	flux module list >bulk-fail.list &&
+	test_must_fail grep fail2 bulk-fail.list
+'
 
 test_expect_success 'module: remove fails on invalid module' '
 	test_must_fail flux module remove nosuchmodule 2>nosuch.err &&
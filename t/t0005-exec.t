@@ -282,4 +282,19 @@ test_expect_success 'dbus environment variable is not overwritten if set' '
 	test_cmp dbus.exp dbus.out
 '
 
+test_expect_success 'output is unchanged with rexec output batching disabled' '
+	seq 1 1000 >seq.exp &&
+	flux start -Sbroker.rexec-batch-size=0 \
+		flux exec -r 0 seq 1 1000 >seq_nobatch.out &&
+	test_cmp seq.exp seq_nobatch.out
+'
+test_expect_success 'output order is preserved with long rexec batch timeout' '
+	flux start -Sbroker.rexec-batch-timeout=10s \
+		flux exec -r 0 seq 1 1000 >seq_batch.out &&
+	test_cmp seq.exp seq_batch.out
+'
+test_expect_success 'broker fails with invalid broker.rexec-batch-size' '
+	test_must_fail flux start -Sbroker.rexec-batch-size=foo true
+'
+
 test_done
@@ -0,0 +1,118 @@
+#!/bin/sh
+#
+
+test_description='Test rexec tree-exec launch over a multi-level TBON
+
+Launch processes with a single rexec.tree-exec request using the
+bulk-exec test driver.  With tbon.topo=kary:2, rank 1 routes to
+ranks 3-4 and rank 2 routes to ranks 5-6.
+'
+
+. `dirname $0`/sharness.sh
+SIZE=7
+test_under_flux ${SIZE} minimal -o,-Stbon.topo=kary:2
+
+TEST_SUBPROCESS_DIR=${FLUX_BUILD_DIR}/src/common/libsubprocess
+bulk_exec="${TEST_SUBPROCESS_DIR}/bulk-exec --tree"
+rexec_script="flux python ${SHARNESS_TEST_SRCDIR}/scripts/rexec.py"
+waitfile=${SHARNESS_TEST_SRCDIR}/scripts/waitfile.lua
+
+wait_rexec_process_count () {
+	expected=$1
+	rank=$2
+	i=0
+	$rexec_script ps --rank $rank > output &&
+	count=`cat output | wc -l` &&
+	while [ "${count}" != "${expected}" ] && [ $i -lt 30 ]
+	do
+	    sleep 1
+	    $rexec_script ps --rank $rank > output &&
+	    count=`cat output | wc -l` &&
+	    i=$((i + 1))
+	done
+	if [ "$i" -eq "30" ]
+	then
+	    return 1
+	fi
+	return 0;
+}
+
+test_expect_success 'tree-exec launches on all ranks' '
+	run_timeout 30 $bulk_exec flux getattr rank > all.out 2>all.err &&
+	test_debug "cat all.out all.err" &&
+	for rank in $(seq 0 $((SIZE-1))); do
+		grep "^${rank}: ${rank}$" all.out || return 1
+	done &&
+	test $(wc -l < all.out) -eq ${SIZE} &&
+	grep complete all.err
+'
+test_expect_success 'tree-exec routes through a rank with no local process' '
+	run_timeout 30 $bulk_exec -r 3-4 flux getattr rank > sub.out &&
+	test_debug "cat sub.out" &&
+	cat >sub.exp <<-EOF &&
+	3: 3
+	4: 4
+	EOF
+	sort sub.out > sub.sorted &&
+	test_cmp sub.exp sub.sorted
+'
+test_expect_success 'tree-exec relays launch failure from below mid-tree rank' '
+	run_timeout 30 $bulk_exec -r 1,3-4 /nonexistent/cmd 2>fail.err &&
+	test_debug "cat fail.err" &&
+	grep "1: Failed: .*No such file or directory" fail.err &&
+	grep "3: Failed: .*No such file or directory" fail.err &&
+	grep "4: Failed: .*No such file or directory" fail.err &&
+	grep complete fail.err
+'
+test_expect_success 'tree-exec fails missing ranks and ends the stream' '
+	run_timeout 30 $bulk_exec -r 7-8 /bin/true 2>missing.err &&
+	test_debug "cat missing.err" &&
+	grep "7: Failed: .*$(strerror_symbol EHOSTUNREACH)" missing.err &&
+	grep "8: Failed: .*$(strerror_symbol EHOSTUNREACH)" missing.err &&
+	grep complete missing.err
+'
+test_expect_success 'tree-exec fails missing ranks and kills the others' '
+	run_timeout 30 $bulk_exec -r 3-4,7 sleep 300 2>missing2.err &&
+	test_debug "cat missing2.err" &&
+	grep "7: Failed: .*$(strerror_symbol EHOSTUNREACH)" missing2.err &&
+	grep complete missing2.err &&
+	wait_rexec_process_count 0 3 &&
+	wait_rexec_process_count 0 4
+'
+test_expect_success 'tree-exec stdin write reaches every rank' '
+	run_timeout 30 $bulk_exec --stdin=hello cat > stdin.out &&
+	test_debug "cat stdin.out" &&
+	test $(grep -c ": hello$" stdin.out) -eq ${SIZE} &&
+	grep "^6: hello$" stdin.out
+'
+test_expect_success 'tree-exec signal is delivered to processes on all ranks' '
+	cat >test_signal.sh <<-EOF &&
+	#!/bin/bash
+	$bulk_exec sleep 300 2>signal.err &
+	$waitfile -t 20 -p started signal.err &&
+	kill -INT %1 &&
+	wait %1
+	EOF
+	chmod +x test_signal.sh &&
+	run_timeout 30 ./test_signal.sh &&
+	test_debug "cat signal.err" &&
+	grep "sending signal 2" signal.err &&
+	grep complete signal.err &&
+	for rank in $(seq 0 $((SIZE-1))); do
+		wait_rexec_process_count 0 $rank || return 1
+	done
+'
+test_expect_success NO_CHAIN_LINT 'tree-exec disconnect kills processes below mid-tree ranks' '
+	$bulk_exec -r 3-6 sleep 300 2>disconnect.err &
+	pid=$! &&
+	$waitfile -t 20 -p started disconnect.err &&
+	wait_rexec_process_count 1 3 &&
+	wait_rexec_process_count 1 6 &&
+	kill -TERM $pid &&
+	wait_rexec_process_count 0 3 &&
+	wait_rexec_process_count 0 4 &&
+	wait_rexec_process_count 0 5 &&
+	wait_rexec_process_count 0 6
+'
+
+test_done
@@ -522,6 +522,45 @@ test_expect_success 'kvs: test invalid lookup rpc' '
 	grep "flux_future_get: Protocol error" lookup_invalid_output
 '
 
+#
+# test multi-key lookup rpc
+#
+
+test_expect_success 'kvs: lookup-multi works' '
+	flux kvs put multi.a=1 multi.b=2 multi.dir.c=3 &&
+	${FLUX_BUILD_DIR}/t/kvs/lookup_multi \
+		multi.dir.c multi.a multi.b multi.missing >lookup_multi.out &&
+	cat >lookup_multi.exp <<-EOT &&
+	multi.a=1
+	multi.b=2
+	multi.dir.c=3
+	multi.missing: No such file or directory
+	EOT
+	test_cmp lookup_multi.exp lookup_multi.out
+'
+test_expect_success 'kvs: lookup-multi works on rank 1' '
+	flux exec -n -r 1 sh -c "${FLUX_BUILD_DIR}/t/kvs/lookup_multi \
+		multi.dir.c multi.a multi.b multi.missing" >lookup_multi1.out &&
+	test_cmp lookup_multi.exp lookup_multi1.out
+'
+test_expect_success 'kvs: lookup-multi resolves all keys against one root' '
+	ROOTREF=$(flux kvs get --treeobj .) &&
+	flux kvs put multi.a=changed &&
+	${FLUX_BUILD_DIR}/t/kvs/lookup_multi --at=${ROOTREF} \
+		multi.a multi.b >lookup_multi_at.out &&
+	cat >lookup_multi_at.exp <<-EOT &&
+	multi.a=1
+	multi.b=2
+	EOT
+	test_cmp lookup_multi_at.exp lookup_multi_at.out
+'
+test_expect_success 'kvs: lookup-multi reports per-key errors' '
+	${FLUX_BUILD_DIR}/t/kvs/lookup_multi multi.a.x multi.dir \
+		>lookup_multi_err.out &&
+	grep "^multi.a.x: " lookup_multi_err.out &&
+	grep "^multi.dir: Is a directory" lookup_multi_err.out
+'
+
 #
 # ensure pending requests are the expected number
 #
@@ -362,6 +362,69 @@ test_expect_success 'job-info lookup stats works' '
 	flux module stats --parse lookups job-info
 '
 
+test_expect_success 'repeated lookup of inactive job is served from cache' '
+	jobid=$(submit_job) &&
+	flux job info $jobid jobspec >cache1.out &&
+	hits=$(flux module stats --parse lookup_cache.hits job-info) &&
+	flux job info $jobid jobspec >cache2.out &&
+	test_cmp cache1.out cache2.out &&
+	test $(flux module stats --parse lookup_cache.hits job-info) \
+		-eq $((hits+1))
+'
+
+test_expect_success 'job looked up while active is cached once inactive' '
+	jobid=$(flux job submit sleeplong.json) &&
+	fj_wait_event $jobid start >/dev/null &&
+	flux job info --base $jobid R >/dev/null &&
+	flux cancel $jobid &&
+	fj_wait_event $jobid clean >/dev/null &&
+	flux job info --base $jobid R >cache_r1.out &&
+	hits=$(flux module stats --parse lookup_cache.hits job-info) &&
+	flux job info --base $jobid R >cache_r2.out &&
+	test_cmp cache_r1.out cache_r2.out &&
+	test $(flux module stats --parse lookup_cache.hits job-info) \
+		-eq $((hits+1))
+'
+
+test_expect_success 'keys are added to the lookup cache independently' '
+	jobid=$(submit_job) &&
+	flux job info --base $jobid R >/dev/null &&
+	flux job info --base $jobid jobspec >/dev/null &&
+	hits=$(flux module stats --parse lookup_cache.hits job-info) &&
+	flux job info --base $jobid jobspec >/dev/null &&
+	flux job info --base $jobid R >/dev/null &&
+	test $(flux module stats --parse lookup_cache.hits job-info) \
+		-eq $((hits+2))
+'
+
+test_expect_success 'lookup cache reports size in bytes' '
+	test $(flux module stats --parse lookup_cache.bytes job-info) -gt 0
+'
+
+test_expect_success 'lookup cache keeps current and original values apart' '
+	jobid=$(submit_job) &&
+	flux job info --base $jobid jobspec >cache_orig1.out &&
+	flux job info $jobid jobspec >cache_cur1.out &&
+	flux job info --base $jobid jobspec >cache_orig2.out &&
+	flux job info $jobid jobspec >cache_cur2.out &&
+	test_cmp cache_orig1.out cache_orig2.out &&
+	test_cmp cache_cur1.out cache_cur2.out
+'
+
+test_expect_success 'lookup cache entries are removed when jobs are purged' '
+	test $(flux module stats --parse lookup_cache.size job-info) -gt 0 &&
+	flux job purge --force --num-limit=0 &&
+	i=0 &&
+	while [ $(flux module stats --parse lookup_cache.size job-info) -ne 0 ] \
+		&& [ $i -lt 50 ]
+	do
+		sleep 0.1
+		i=$((i + 1))
+	done &&
+	test $(flux module stats --parse lookup_cache.size job-info) -eq 0 &&
+	test $(flux module stats --parse lookup_cache.bytes job-info) -eq 0
+'
+
 test_expect_success 'lookup request with empty payload fails with EPROTO(71)' '
 	${RPC} job-info.lookup 71 </dev/null
 '
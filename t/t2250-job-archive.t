@@ -275,6 +275,71 @@ test_expect_success 'job-archive: all jobs stored' '
         test $count -eq 8
 '
 
+test_expect_success 'job-archive: module stats show all jobs committed' '
+        flux module stats job-archive \
+            | $jq -e ".since > 0 and .queued == 0 and .lookups == 0"
+'
+
+test_expect_success 'job-archive: falls back to polling without job-list' '
+        flux module remove job-list &&
+        i=0 &&
+        while ! flux dmesg | grep -q "job-list.watch unsupported" \
+               && [ $i -lt 50 ]
+        do
+                sleep 0.1
+                i=$((i + 1))
+        done &&
+        test $i -lt 50
+'
+
+test_expect_success 'job-archive: retries job-list.watch after fallback' '
+        flux module load job-list &&
+        jobid=`flux submit hostname` &&
+        fj_wait_event $jobid clean &&
+        wait_jobid_state $jobid inactive &&
+        wait_db $jobid ${ARCHIVEDB} &&
+        flux dmesg | grep "job-list.watch is now supported" &&
+        count=`db_count_entries ${ARCHIVEDB}` &&
+        test $count -eq 9
+'
+
+test_expect_success 'job-archive: set debug flag to fail commits' '
+        flux module debug --setbit 0x1 job-archive
+'
+
+test_expect_success 'job-archive: jobs are not stored while commits fail' '
+        jobid=`flux submit hostname` &&
+        echo $jobid > rollback.id &&
+        fj_wait_event $jobid clean &&
+        wait_jobid_state $jobid inactive &&
+        i=0 &&
+        while ! flux dmesg | grep -q "failed to archive .* will retry" \
+               && [ $i -lt 50 ]
+        do
+                sleep 0.1
+                i=$((i + 1))
+        done &&
+        test $i -lt 50 &&
+        count=`db_count_entries ${ARCHIVEDB}` &&
+        test $count -eq 9
+'
+
+test_expect_success 'job-archive: clear debug flag' '
+        flux module debug --clearbit 0x1 job-archive
+'
+
+test_expect_success 'job-archive: rolled back job is stored on retry' '
+        jobid=`flux submit hostname` &&
+        fj_wait_event $jobid clean &&
+        wait_jobid_state $jobid inactive &&
+        wait_db $jobid ${ARCHIVEDB} &&
+        wait_db $(cat rollback.id) ${ARCHIVEDB} &&
+        db_check_entries $(cat rollback.id) ${ARCHIVEDB} &&
+        db_check_values_run $(cat rollback.id) ${ARCHIVEDB} &&
+        count=`db_count_entries ${ARCHIVEDB}` &&
+        test $count -eq 11
+'
+
 # we don't check values in module stats b/c it can be racy w/ polling
 test_expect_success 'job-archive: get module stats' '
         flux module stats job-archive
@@ -291,7 +356,7 @@ test_expect_success 'job-archive: unload module' '
 
 test_expect_success 'job-archive: db exists after module unloaded' '
         count=`db_count_entries ${ARCHIVEDB}` &&
-        test $count -eq 8
+        test $count -eq 11
 '
 
 test_expect_success 'job-archive: setup config file without dbpath' '
@@ -11,6 +11,8 @@ test_under_flux 4 job
 
 RPC=${FLUX_BUILD_DIR}/t/request/rpc
 listRPC="flux python ${SHARNESS_TEST_SRCDIR}/job-list/list-rpc.py"
+listSTREAM="flux python ${SHARNESS_TEST_SRCDIR}/job-list/list-stream.py"
+listWATCH="flux python ${SHARNESS_TEST_SRCDIR}/job-list/watch.py"
 JOB_CONV="flux python ${FLUX_SOURCE_DIR}/t/job-manager/job-conv.py"
 runpty="${SHARNESS_TEST_SRCDIR}/scripts/runpty.py"
 
@@ -2777,6 +2779,166 @@ test_expect_success 'remove queues' '
 	flux config load < /dev/null
 '
 
+#
+# streaming and cursor tests
+#
+
+test_expect_success 'submit jobs for streaming and cursor tests' '
+	flux submit --cc=1-6 --quiet --wait hostname &&
+	flux submit --urgency=hold hostname | flux job id > held.id &&
+	wait_jobid_state $(cat held.id) sched &&
+	for id in $(flux jobs -n -a --filter=inactive -o "{id}"); do
+		wait_jobid_state $id inactive || return 1
+	done
+'
+test_expect_success 'job-list.list cursor on pending job includes inactive jobs' '
+	$jq -j -c -n "{max_entries:0, attrs:[], \
+		constraint:{states:[\"inactive\"]}}" \
+	  | $RPC job-list.list | $jq ".jobs[].id" > inactive.expected &&
+	test $(wc -l < inactive.expected) -gt 4 &&
+	$jq -j -c -n "{max_entries:0, attrs:[], \
+		cursor:{id:$(cat held.id), t_inactive:0}}" \
+	  | $RPC job-list.list | $jq ".jobs[].id" > pending_cursor.out &&
+	test_cmp inactive.expected pending_cursor.out
+'
+test_expect_success 'job-list.list cursor on job that became inactive works' '
+	flux cancel $(cat held.id) &&
+	wait_jobid_state $(cat held.id) inactive &&
+	$jq -j -c -n "{max_entries:0, attrs:[], \
+		cursor:{id:$(cat held.id), t_inactive:0}}" \
+	  | $RPC job-list.list | $jq ".jobs[].id" > inactive_cursor.out &&
+	test_cmp inactive.expected inactive_cursor.out
+'
+test_expect_success 'job-list.list streaming returns all jobs in order' '
+	$listSTREAM > list_nostream.out &&
+	test $(wc -l < list_nostream.out) -gt 4 &&
+	$listSTREAM --chunk-size=3 > list_stream.out &&
+	test_cmp list_nostream.out list_stream.out
+'
+test_expect_success 'job-list.list paged with cursor returns all jobs in order' '
+	$listSTREAM --page-size=4 > list_paged.out &&
+	test_cmp list_nostream.out list_paged.out
+'
+test_expect_success 'job-list.list streaming paged with cursor works' '
+	$listSTREAM --chunk-size=2 --page-size=5 > list_stream_paged.out &&
+	test_cmp list_nostream.out list_stream_paged.out
+'
+test_expect_success 'job-list.list cursor past last job returns no jobs' '
+	last=$(tail -1 list_nostream.out) &&
+	t_inactive=$(flux job list-ids $last | $jq .t_inactive) &&
+	$jq -j -c -n "{max_entries:0, attrs:[], \
+		cursor:{id:$last, t_inactive:$t_inactive}}" \
+	  | $RPC job-list.list | $jq -e ".jobs == []"
+'
+
+#
+# watch tests
+#
+
+test_expect_success 'job-list.watch sends snapshot of all jobs then sync' '
+	$listWATCH > watch_all.out &&
+	total=$(wc -l < list_nostream.out) &&
+	count=$(awk "/^snapshot/ {n += \$2} END {print n+0}" watch_all.out) &&
+	test $count -eq $total &&
+	tail -1 watch_all.out | grep ^sync
+'
+test_expect_success 'job-list.watch snapshot respects constraint and since' '
+	$listWATCH --constraint="{\"states\":[\"running\"]}" \
+		> watch_running.out &&
+	echo sync >watch_running.expected &&
+	test_cmp watch_running.expected watch_running.out &&
+	since=$(flux job list --states=inactive | head -1 | $jq .t_inactive) &&
+	$listWATCH --since=$since \
+		--constraint="{\"states\":[\"inactive\"]}" \
+		> watch_since.out &&
+	test_cmp watch_running.expected watch_since.out
+'
+test_expect_success 'job-list.watch sends add then update deltas for new job' '
+	$listWATCH --submit | grep -v ^snapshot > watch_submit.out &&
+	sed -n 2p watch_submit.out | grep "^add " &&
+	tail -1 watch_submit.out | grep "^update I$"
+'
+test_expect_success 'job-list.watch only sends jobs matching constraint' '
+	$listWATCH --submit --constraint="{\"states\":[\"inactive\"]}" \
+		| grep -v ^snapshot > watch_submit_inactive.out &&
+	cat <<-EOF >watch_submit_inactive.expected &&
+	sync
+	add I
+	EOF
+	test_cmp watch_submit_inactive.expected watch_submit_inactive.out
+'
+test_expect_success 'job-list.watch removes job that stops matching' '
+	$listWATCH --submit \
+		--constraint="{\"not\":[{\"states\":[\"inactive\"]}]}" \
+		| grep -v ^snapshot > watch_submit_active.out &&
+	sed -n 2p watch_submit_active.out | grep "^add " &&
+	tail -1 watch_submit_active.out | grep "^remove$"
+'
+test_expect_success 'job-list.watch removes inactive job when purged' '
+	$listWATCH --submit --purge --constraint="{\"states\":[\"inactive\"]}" \
+		| grep -v ^snapshot > watch_purge.out &&
+	cat <<-EOF >watch_purge.expected &&
+	sync
+	add I
+	remove
+	EOF
+	test_cmp watch_purge.expected watch_purge.out
+'
+
+#
+# aggregate tests
+#
+
+test_expect_success 'job-list.aggregate counts all jobs by state' '
+	$jq -j -c -n "{max_entries:0, attrs:[]}" \
+	  | $RPC job-list.list | $jq ".jobs | length" > agg_total.exp &&
+	$jq -j -c -n "{group_by:\"state\"}" \
+	  | $RPC job-list.aggregate > agg_state.out &&
+	$jq "[.groups[].count] | add" agg_state.out > agg_total.out &&
+	test_cmp agg_total.exp agg_total.out
+'
+test_expect_success 'job-list.aggregate group counts match job-list.list' '
+	$jq -j -c -n "{max_entries:0, attrs:[], \
+		constraint:{states:[\"inactive\"]}}" \
+	  | $RPC job-list.list | $jq ".jobs | length" > agg_inactive.exp &&
+	$jq ".groups[] | select(.value == 64) | .count" agg_state.out \
+		> agg_inactive.out &&
+	test_cmp agg_inactive.exp agg_inactive.out
+'
+test_expect_success 'job-list.aggregate sums attributes within constraint' '
+	$jq -j -c -n "{max_entries:0, attrs:[\"nnodes\"], \
+		constraint:{results:[\"completed\"]}}" \
+	  | $RPC job-list.list \
+	  | $jq "[.jobs[] | .nnodes // 0] | add // 0" > agg_nnodes.exp &&
+	$jq -j -c -n "{group_by:\"result\", sum:[\"nnodes\", \"runtime\"], \
+		constraint:{results:[\"completed\"]}}" \
+	  | $RPC job-list.aggregate > agg_result.out &&
+	$jq -e ".groups | length == 1" agg_result.out &&
+	$jq ".groups[0].sum.nnodes" agg_result.out > agg_nnodes.out &&
+	test_cmp agg_nnodes.exp agg_nnodes.out &&
+	$jq -e ".groups[0].sum.runtime > 0" agg_result.out
+'
+test_expect_success 'job-list.aggregate ignores unset values of pending job' '
+	jobid=`flux submit --urgency=hold --job-name=aggpending hostname` &&
+	flux cancel $jobid &&
+	flux job wait-event $jobid clean &&
+	wait_jobid_state $jobid inactive &&
+	$jq -j -c -n "{group_by:\"result\", \
+		sum:[\"nnodes\", \"ncores\", \"ntasks\", \"duration\"], \
+		constraint:{name:[\"aggpending\"]}}" \
+	  | $RPC job-list.aggregate > agg_pending.out &&
+	$jq -e ".groups | length == 1" agg_pending.out &&
+	$jq -e ".groups[0].count == 1" agg_pending.out &&
+	$jq -e ".groups[0].sum.nnodes == 0" agg_pending.out &&
+	$jq -e ".groups[0].sum | map(. >= 0) | all" agg_pending.out
+'
+test_expect_success 'job-list.aggregate reports null group for unset value' '
+	$jq -j -c -n "{group_by:\"exception_type\"}" \
+	  | $RPC job-list.aggregate > agg_exception.out &&
+	$jq -e ".groups | map(select(.value == null)) | length == 1" \
+		agg_exception.out
+'
+
 #
 # corner case tests
 #
@@ -2811,6 +2973,42 @@ test_expect_success 'list request with invalid input fails with EINVAL(22) (attr
 	EOF
 	test_cmp ${name}.expected ${name}.out
 '
+test_expect_success 'list request with invalid input fails with EPROTO(71) (chunk_size < 1)' '
+	name="chunk-size-invalid" &&
+	$jq -j -c -n  "{max_entries:5, attrs:[], chunk_size:0}" \
+	  | $listRPC > ${name}.out &&
+	cat <<-EOF >${name}.expected &&
+	errno 71: invalid payload: chunk_size must be > 0
+	EOF
+	test_cmp ${name}.expected ${name}.out
+'
+test_expect_success 'list request with invalid input fails with EPROTO(71) (cursor invalid)' '
+	name="cursor-invalid" &&
+	$jq -j -c -n  "{max_entries:5, attrs:[], cursor:{foo:1}}" \
+	  | $listRPC > ${name}.out &&
+	cat <<-EOF >${name}.expected &&
+	errno 71: invalid payload: cursor object invalid
+	EOF
+	test_cmp ${name}.expected ${name}.out
+'
+test_expect_success 'watch request without streaming flag fails with EPROTO(71)' '
+	$jq -j -c -n  "{attrs:[]}" | ${RPC} job-list.watch 71
+'
+test_expect_success 'watch request with invalid constraint fails' '
+	$listWATCH --constraint="{\"foo\":[]}" > watch_bad_constraint.out &&
+	grep "errno 71: invalid payload: constraint object invalid" \
+		watch_bad_constraint.out
+'
+test_expect_success 'aggregate request without group_by fails with EPROTO(71)' '
+	$jq -j -c -n  "{}" | ${RPC} job-list.aggregate 71
+'
+test_expect_success 'aggregate request with invalid group_by fails with EPROTO(71)' '
+	$jq -j -c -n  "{group_by:\"foo\"}" | ${RPC} job-list.aggregate 71
+'
+test_expect_success 'aggregate request with invalid sum fails with EPROTO(71)' '
+	$jq -j -c -n  "{group_by:\"state\", sum:[\"name\"]}" \
+	  | ${RPC} job-list.aggregate 71
+'
 test_expect_success 'list-id request with empty payload fails with EPROTO(71)' '
 	${RPC} job-list.list-id 71 </dev/null
 '
@@ -0,0 +1,66 @@
+#!/bin/sh
+
+test_description='Test schedbench scheduler simulator harness'
+
+. `dirname $0`/sharness.sh
+
+schedbench=${FLUX_BUILD_DIR}/t/sched-simple/schedbench
+
+test_expect_success 'schedbench: runs a generated trace' '
+	$schedbench -N 16 -c 4 --jobs=200 >out.$test_count &&
+	cat out.$test_count &&
+	grep "allocated=200 denied=0" out.$test_count &&
+	grep "allocs/sec=" out.$test_count &&
+	grep "p99=" out.$test_count
+'
+test_expect_success 'schedbench: generated trace is reproducible' '
+	$schedbench -N 16 -c 4 --jobs=200 --seed=42 --json \
+		| jq .makespan >m1 &&
+	$schedbench -N 16 -c 4 --jobs=200 --seed=42 --json \
+		| jq .makespan >m2 &&
+	test_cmp m1 m2
+'
+test_expect_success 'schedbench: replays a trace file in virtual time' '
+	cat >trace1 <<-EOF &&
+	# nnodes nslots slot_size duration
+	2 2 4 10
+	0 4 1 5
+	0 4 1 5
+	2 2 4 10
+	EOF
+	$schedbench -N 2 -c 4 --trace=trace1 --json >out.json &&
+	jq -e ".allocated == 4" out.json &&
+	jq -e ".makespan == 25" out.json &&
+	jq -e ".utilization == 1" out.json
+'
+test_expect_success 'schedbench: trace can be read from stdin' '
+	$schedbench -N 2 -c 4 --trace=- --json <trace1 >out2.json &&
+	jq -e ".allocated == 4" out2.json
+'
+test_expect_success 'schedbench: unsatisfiable jobs are denied' '
+	cat >trace2 <<-EOF &&
+	4 4 4 10
+	0 1 1 10
+	EOF
+	$schedbench -N 2 -c 4 --trace=trace2 --json >out3.json &&
+	jq -e ".allocated == 1 and .denied == 1" out3.json
+'
+test_expect_success 'schedbench: constraints and properties are supported' '
+	cat >trace3 <<-EOF &&
+	1 1 4 10 {"properties":["foo"]}
+	1 1 4 10 {"properties":["foo"]}
+	EOF
+	$schedbench -N 4 -c 4 --property=foo@0 --trace=trace3 --json \
+		>out4.json &&
+	jq -e ".makespan == 20" out4.json
+'
+test_expect_success 'schedbench: gpus may be added to nodes' '
+	$schedbench -N 4 -c 4 -g 2 --jobs=20 --json >out5.json &&
+	jq -e ".allocated == 20" out5.json
+'
+test_expect_success 'schedbench: bad trace line is an error' '
+	echo "1 2 x" >trace4 &&
+	test_must_fail $schedbench --trace=trace4 2>err &&
+	grep "failed to parse job" err
+'
+test_done
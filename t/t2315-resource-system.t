@@ -262,4 +262,45 @@ test_expect_success 'resource.scheduling key amends [resource.config]' '
 	jq -e < ${name}/R.json ".scheduling.foo == true"
 '
 
+test_expect_success 'hwloc topology is cached in statedir' '
+	name=topo-cache &&
+	mkdir -p ${name}/state &&
+	flux start -s 1 -Sstatedir=$(pwd)/${name}/state \
+		flux kvs get resource.R > ${name}/R1.json &&
+	jq -e .fingerprint ${name}/state/hwloc-topology.json &&
+	jq -e .xml ${name}/state/hwloc-topology.json
+'
+test_expect_success 'cached hwloc topology is used on restart' '
+	name=topo-cache &&
+	flux start -s 1 -Sstatedir=$(pwd)/${name}/state \
+		sh -c "flux dmesg >${name}/dmesg && flux kvs get resource.R" \
+		> ${name}/R2.json &&
+	grep "loaded hwloc XML from" ${name}/dmesg &&
+	jq -S .execution.R_lite ${name}/R1.json >${name}/R1.lite &&
+	jq -S .execution.R_lite ${name}/R2.json >${name}/R2.lite &&
+	test_cmp ${name}/R1.lite ${name}/R2.lite
+'
+test_expect_success 'cache with mismatched fingerprint is ignored' '
+	name=topo-cache &&
+	jq ".fingerprint.pci = -42" ${name}/state/hwloc-topology.json \
+		>${name}/modified.json &&
+	mv ${name}/modified.json ${name}/state/hwloc-topology.json &&
+	flux start -s 1 -Sstatedir=$(pwd)/${name}/state \
+		sh -c "flux dmesg >${name}/dmesg2" &&
+	test_must_fail grep "loaded hwloc XML from" ${name}/dmesg2 &&
+	test_must_fail jq -e ".fingerprint.pci == -42" \
+		${name}/state/hwloc-topology.json
+'
+test_expect_success 'resource.topo-cache = false disables the cache' '
+	name=topo-cache &&
+	cat >${name}/resource.toml <<-EOF &&
+	[resource]
+	topo-cache = false
+	EOF
+	flux start -s 1 -Sstatedir=$(pwd)/${name}/state \
+		-o,--config-path=$(pwd)/${name}/resource.toml \
+		sh -c "flux dmesg >${name}/dmesg3" &&
+	test_must_fail grep "loaded hwloc XML from" ${name}/dmesg3
+'
+
 test_done
@@ -357,4 +357,169 @@ test_expect_success 'job-exec: bad sdexec properties leads to error on via confi
 	grep "exec.sdexec-properties.MemoryHigh is not a string" reload9B.err &&
 	rm -f ${FLUX_CONF_DIR}/exec.toml
 '
+test_expect_success 'job-exec: tree-launch can be enabled in config' '
+	name=tree-launch &&
+	cat <<-EOF > ${name}.toml &&
+	[exec]
+	tree-launch = true
+	EOF
+	flux start -o,--config-path=${name}.toml -s4 \
+		sh -c "flux module stats -p bulk-exec.config.tree_launch job-exec \
+		       && flux run -N4 -n4 --label-io flux getattr rank" \
+		> ${name}.out 2>&1 &&
+	test_debug "cat ${name}.out" &&
+	head -1 ${name}.out | grep "^1$" &&
+	grep "^3: 3$" ${name}.out &&
+	test $(grep -c "^[0-3]: " ${name}.out) -eq 4
+'
+test_expect_success 'job-exec: bad tree-launch value causes module failure' '
+	name=bad-tree-launch &&
+	cat <<-EOF > ${name}.toml &&
+	[exec]
+	tree-launch = "yes"
+	EOF
+	test_must_fail flux start -o,--config-path=${name}.toml -s1 \
+		flux dmesg > ${name}.log 2>&1 &&
+	grep "error reading config value exec.tree-launch" ${name}.log
+'
+test_expect_success 'job-exec: shell-zygote runs single node jobs' '
+	name=shell-zygote &&
+	cat <<-EOF > ${name}.toml &&
+	[exec]
+	shell-zygote = true
+	EOF
+	cat <<-EOF > ${name}.sh &&
+	#!/bin/sh
+	flux module stats -p bulk-exec.config.shell_zygote job-exec
+	flux run -n1 echo one
+	flux run -n1 echo two
+	flux run -N2 -n2 --label-io flux getattr rank
+	flux run -n1 sh -c "exit 3"
+	echo rc=\$?
+	flux dmesg | grep "zygote rank"
+	EOF
+	chmod +x ${name}.sh &&
+	flux start -o,--config-path=${name}.toml -s2 ./${name}.sh \
+		> ${name}.out 2>&1 &&
+	test_debug "cat ${name}.out" &&
+	head -1 ${name}.out | grep "^1$" &&
+	grep "^one$" ${name}.out &&
+	grep "^two$" ${name}.out &&
+	grep "^1: 1$" ${name}.out &&
+	grep "^rc=3$" ${name}.out &&
+	test $(grep -c "started shell pid" ${name}.out) -eq 3
+'
+test_expect_success 'job-exec: shell-zygote logs shell stderr to job eventlog' '
+	name=shell-zygote-stderr &&
+	cat <<-EOF > ${name}.lua &&
+	io.stderr:write ("zygote-stderr-test\n")
+	EOF
+	cat <<-EOF > ${name}.sh &&
+	#!/bin/sh
+	flux run -n1 -o initrc=$(pwd)/${name}.lua true 2>&1
+	flux job eventlog -p exec \$(flux job last)
+	flux dmesg | grep "zygote rank"
+	EOF
+	chmod +x ${name}.sh &&
+	flux start -o,--config-path=shell-zygote.toml -s1 ./${name}.sh \
+		> ${name}.out 2>&1 &&
+	test_debug "cat ${name}.out" &&
+	grep "flux-shell\[0\]: stderr: zygote-stderr-test" ${name}.out &&
+	grep "^.* log .*zygote-stderr-test" ${name}.out &&
+	test_must_fail grep "zygote rank 0: zygote-stderr-test" ${name}.out
+'
+test_expect_success 'job-exec: shell-zygote jobs can be canceled or time out' '
+	name=shell-zygote-kill &&
+	cat <<-EOF > ${name}.sh &&
+	#!/bin/sh
+	id=\$(flux submit sleep 300)
+	flux job wait-event -t 30 \$id start &&
+	flux cancel \$id &&
+	flux job wait-event -t 30 \$id clean &&
+	echo cancel=\$(flux jobs -no {result} \$id)
+	id=\$(flux submit -t 1s sleep 300)
+	flux job wait-event -t 30 \$id clean &&
+	echo timeout=\$(flux jobs -no {result} \$id)
+	flux run -n1 echo still-works
+	EOF
+	chmod +x ${name}.sh &&
+	flux start -o,--config-path=shell-zygote.toml -s1 ./${name}.sh \
+		> ${name}.out 2>&1 &&
+	test_debug "cat ${name}.out" &&
+	grep "^cancel=CANCELED$" ${name}.out &&
+	grep "^timeout=TIMEOUT$" ${name}.out &&
+	grep "^still-works$" ${name}.out
+'
+#  After the zygote is killed, the next job starts a new zygote.  The job
+#   canceled right after submission is usually still queued waiting for
+#   that zygote to start, but the test passes whichever path it takes.
+test_expect_success 'job-exec: shell-zygote death fails its jobs' '
+	name=shell-zygote-death &&
+	cat <<-EOF > ${name}.sh &&
+	#!/bin/sh
+	id=\$(flux submit sh -c "echo \\\$PPID > ${name}.pid; sleep 300")
+	i=0
+	while ! test -s ${name}.pid && test \$i -lt 300; do
+		sleep 0.1
+		i=\$((i + 1))
+	done
+	shellpid=\$(cat ${name}.pid)
+	zpid=\$(sed -n "s/^PPid:[[:space:]]*//p" /proc/\$shellpid/status)
+	kill -9 \$zpid
+	flux job wait-event -t 30 \$id clean &&
+	echo died=\$(flux jobs -no {result} \$id)
+	flux job eventlog \$id | grep "job shell zygote"
+	i=0
+	while kill -0 \$shellpid 2>/dev/null && test \$i -lt 300; do
+		sleep 0.1
+		i=\$((i + 1))
+	done
+	kill -0 \$shellpid 2>/dev/null || echo orphan-shell-exited
+	id=\$(flux submit sleep 300)
+	flux cancel \$id &&
+	flux job wait-event -t 30 \$id clean &&
+	echo queued=\$(flux jobs -no {result} \$id)
+	flux run -n1 echo new-zygote-works
+	flux dmesg | grep "started shell pid"
+	EOF
+	chmod +x ${name}.sh &&
+	flux start -o,--config-path=shell-zygote.toml -s1 ./${name}.sh \
+		> ${name}.out 2>&1 &&
+	test_debug "cat ${name}.out" &&
+	grep "^died=FAILED$" ${name}.out &&
+	grep "job shell zygote.*exited" ${name}.out &&
+	grep "^orphan-shell-exited$" ${name}.out &&
+	grep "^queued=CANCELED$" ${name}.out &&
+	grep "^new-zygote-works$" ${name}.out
+'
+test_expect_success 'job-exec: bad shell-zygote value causes module failure' '
+	name=bad-shell-zygote &&
+	cat <<-EOF > ${name}.toml &&
+	[exec]
+	shell-zygote = "yes"
+	EOF
+	test_must_fail flux start -o,--config-path=${name}.toml -s1 \
+		flux dmesg > ${name}.log 2>&1 &&
+	grep "error reading config value exec.shell-zygote" ${name}.log
+'
+test_expect_success 'job-exec: can specify eventlog-batch-timeout on cmdline' '
+	flux module reload job-exec eventlog-batch-timeout=50ms &&
+	flux module stats -p eventlog.batch-timeout job-exec > ebto.out &&
+	test_debug "cat ebto.out" &&
+	jq -e ". == 0.05" < ebto.out
+'
+test_expect_success 'job-exec: bad eventlog-batch-timeout causes module failure' '
+	test_expect_code 1 \
+		flux module reload job-exec eventlog-batch-timeout=1f &&
+	flux dmesg | grep "invalid eventlog-batch-timeout: 1f"
+'
+test_expect_success 'job-exec: eventlog stats report batching ratio' '
+	flux module reload -f job-exec &&
+	flux run true &&
+	flux module stats -p eventlog job-exec > evstats.json &&
+	test_debug "cat evstats.json" &&
+	jq -e ".entries > 0 and .commits > 0" < evstats.json &&
+	jq -e ".commits <= .entries" < evstats.json &&
+	jq -e ".[\"batch-ratio\"] == (.entries / .commits)" < evstats.json
+'
 test_done
@@ -264,4 +264,59 @@ test_expect_success 'attach: EPERM generates sensible error' '
 	test_debug "cat eperm.err" &&
 	grep -i "not your job" eperm.err
 '
+test_expect_success 'attach: output.storage=blob output can be attached' '
+	id=$(flux submit -N4 -n8 -o output.storage=blob -o output.chunk-size=4k \
+		seq 1 2000) &&
+	run_timeout 30 flux job attach -l $id > blob.out &&
+	test $(wc -l < blob.out) -eq 16000 &&
+	for i in 0 1 2 3 4 5 6 7; do
+		grep "^$i: " blob.out | sed "s/^$i: //" > blob.$i &&
+		seq 1 2000 | test_cmp - blob.$i || return 1
+	done
+'
+test_expect_success 'attach: output.storage=blob uses chunk index events' '
+	id=$(flux job last) &&
+	flux job eventlog -p guest.output $id > blob.eventlog &&
+	test_debug "cat blob.eventlog" &&
+	grep -q "chunk" blob.eventlog &&
+	test_must_fail grep -q " data " blob.eventlog
+'
+test_expect_success 'attach: --read-only works with output.storage=blob' '
+	id=$(flux job last) &&
+	run_timeout 30 flux job attach --read-only $id > blob-ro.out &&
+	test $(wc -l < blob-ro.out) -eq 16000
+'
+test_expect_success 'flux watch works with output.storage=blob' '
+	id=$(flux job last) &&
+	run_timeout 30 flux watch $id > blob-watch.out &&
+	test $(wc -l < blob-watch.out) -eq 16000
+'
+test_expect_success 'flux submit --watch works with output.storage=blob' '
+	run_timeout 30 flux submit --watch -n2 -o output.storage=blob \
+		-o output.chunk-size=4k seq 1 2000 > blob-submit.out &&
+	test $(wc -l < blob-submit.out) -eq 4000 &&
+	test $(grep -c "^2000$" blob-submit.out) -eq 2
+'
+test_expect_success 'python job_output() works with output.storage=blob' '
+	id=$(flux job last) &&
+	cat <<-EOF >job_output.py &&
+	import sys
+	import flux
+	from flux.job.output import job_output
+	nowait = len(sys.argv) > 2
+	output = job_output(flux.Flux(), sys.argv[1], nowait=nowait)
+	sys.stdout.write(output.stdout)
+	EOF
+	flux python job_output.py $id > blob-pyout.out &&
+	test $(wc -l < blob-pyout.out) -eq 4000 &&
+	flux python job_output.py $id nowait > blob-pyout-nowait.out &&
+	test_cmp blob-pyout.out blob-pyout-nowait.out
+'
+test_expect_success 'attach: invalid output.storage is rejected' '
+	test_must_fail flux run -o output.storage=foo true
+'
+test_expect_success 'attach: invalid output.chunk-size is rejected' '
+	test_must_fail flux run -o output.storage=blob -o output.chunk-size=1G \
+		true
+'
 test_done
@@ -394,4 +394,24 @@ test_expect_success 'job-shell: shell inherits FLUX_F58_FORCE_ASCII from job' '
 		id=$(flux submit --wait --output={{id}}.out hostname) &&
 	test -f ${id}.out
 '
+test_expect_success 'job-shell: loads J and R from content blob' '
+	flux run -o verbose hostname 2>blob.err &&
+	grep "loaded J and R from content blob" blob.err
+'
+test_expect_success 'job-shell: quietly falls back to job-info if blob is missing' '
+	cat <<-EOF >shell-badblob.sh &&
+	#!/bin/sh
+	export FLUX_JOB_INFO_BLOBREF=sha1-0000000000000000000000000000000000000000
+	exec ${FLUX_BUILD_DIR}/src/shell/flux-shell "\$@"
+	EOF
+	chmod +x shell-badblob.sh &&
+	flux run --setattr=system.exec.job_shell=$(pwd)/shell-badblob.sh \
+		-n2 -N2 hostname >badblob.out 2>badblob.err &&
+	test_must_be_empty badblob.err &&
+	test $(wc -l < badblob.out) -eq 2 &&
+	flux run --setattr=system.exec.job_shell=$(pwd)/shell-badblob.sh \
+		-o verbose hostname 2>badblob-verbose.err &&
+	grep "falling back to job-info for J and R" badblob-verbose.err &&
+	test_must_fail grep "loaded J and R" badblob-verbose.err
+'
 test_done
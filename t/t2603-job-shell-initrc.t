@@ -280,6 +280,25 @@ test_expect_success 'flux-shell: initrc: shell.die function works' '
 		> ${name}.log 2>&1 &&
 	grep "FATAL: test: shell.die" ${name}.log
 '
+test_expect_success 'flux-shell: initrc: shell.init is logged if post-init fails' '
+	name=post-init-die &&
+	cat >${name}.lua <<-EOF &&
+	plugin.register {
+	  name = "post-init-die",
+	  handlers = {
+	    { topic = "shell.post-init",
+	      fn = function (topic) shell.die ("test: post-init failed") end
+	    }
+	  }
+	}
+	EOF
+	test_must_fail_or_be_terminated \
+		flux run -o initrc=${name}.lua true > ${name}.log 2>&1 &&
+	grep "FATAL: test: post-init failed" ${name}.log &&
+	flux job eventlog -p exec $(flux job last) > ${name}.eventlog &&
+	test_debug "cat ${name}.eventlog" &&
+	grep shell.init ${name}.eventlog
+'
 test_expect_success MULTICORE 'flux-shell: initrc: shell.rankinfo reports broker_rank' '
 	name=shell.rankinfo.broker_rank &&
 	cat >${name}.lua <<-EOF &&
@@ -300,5 +319,66 @@ test_expect_success MULTICORE 'flux-shell: initrc: shell.rankinfo reports broker
 	flux run -N2 -n3 --requires=rank:1,3 \
 	    -o verbose -o initrc=${name}.lua true
 '
+test_expect_success 'flux-shell: initrc: shell populates rc cache in rundir' '
+	cachedir=$(flux getattr rundir)/shell-cache &&
+	flux run --requires=rank:0 true &&
+	test -f ${cachedir}/manifest.json &&
+	ls ${cachedir}/*.luac
+'
+test_expect_success 'flux-shell: initrc: shell uses cached manifest and bytecode' '
+	flux run --requires=rank:0 -o verbose=2 true >rccache.out 2>&1 &&
+	test_debug "cat rccache.out" &&
+	grep "rccache: .*: using cached manifest" rccache.out &&
+	grep "rccache: .*initrc.lua: using cached bytecode" rccache.out
+'
+test_expect_success 'flux-shell: initrc: cached userrc is reloaded when changed' '
+	cat >cached-userrc.lua <<-EOF &&
+	shell.log ("userrc v1")
+	EOF
+	touch -d "1 minute ago" cached-userrc.lua &&
+	flux run --requires=rank:0 -o userrc=$(pwd)/cached-userrc.lua \
+		true >userrc1.out 2>&1 &&
+	flux run --requires=rank:0 -o verbose=2 \
+		-o userrc=$(pwd)/cached-userrc.lua \
+		true >userrc2.out 2>&1 &&
+	test_debug "cat userrc2.out" &&
+	grep "cached-userrc.lua: using cached bytecode" userrc2.out &&
+	grep "userrc v1" userrc2.out &&
+	cat >cached-userrc.lua <<-EOF &&
+	shell.log ("userrc version 2")
+	EOF
+	flux run --requires=rank:0 -o verbose=2 \
+		-o userrc=$(pwd)/cached-userrc.lua \
+		true >userrc3.out 2>&1 &&
+	test_debug "cat userrc3.out" &&
+	grep "userrc version 2" userrc3.out &&
+	test_must_fail grep "cached-userrc.lua: using cached" userrc3.out
+'
+test_expect_success 'flux-shell: initrc: cached source() glob sees new files' '
+	mkdir rc.d &&
+	cat >rc.d/a.lua <<-EOF &&
+	shell.log ("sourced a.lua")
+	EOF
+	cat >source-dir.lua <<-EOF &&
+	source ("$(pwd)/rc.d/*.lua")
+	EOF
+	touch -d "1 minute ago" rc.d &&
+	flux run --requires=rank:0 -o userrc=$(pwd)/source-dir.lua \
+		true >source1.out 2>&1 &&
+	flux run --requires=rank:0 -o verbose=2 \
+		-o userrc=$(pwd)/source-dir.lua \
+		true >source2.out 2>&1 &&
+	test_debug "cat source2.out" &&
+	grep "rc.d/\*.lua: using cached manifest" source2.out &&
+	grep "sourced a.lua" source2.out &&
+	cat >rc.d/b.lua <<-EOF &&
+	shell.log ("sourced b.lua")
+	EOF
+	flux run --requires=rank:0 -o userrc=$(pwd)/source-dir.lua \
+		true >source3.out 2>&1 &&
+	test_debug "cat source3.out" &&
+	grep "sourced a.lua" source3.out &&
+	grep "sourced b.lua" source3.out
+'
 flux job info $(flux job last) R
 test_done
@@ -403,4 +403,28 @@ test_expect_success 'job-shell: invalid output.mode emits warning' '
 	test_debug "cat inval.out" &&
 	grep "ignoring invalid output.mode=foo" inval.err
 '
+test_expect_success 'job-shell: batched output from all shells is complete (kvs)' '
+	flux run -N4 -n8 --label-io seq 1 1000 > batch-kvs.out &&
+	test $(wc -l < batch-kvs.out) -eq 8000 &&
+	for i in 0 1 2 3 4 5 6 7; do
+		grep "^$i: " batch-kvs.out | sed "s/^$i: //" > batch-kvs.$i &&
+		seq 1 1000 | test_cmp - batch-kvs.$i || return 1
+	done
+'
+test_expect_success 'job-shell: batched output from all shells is complete (file)' '
+	flux run -N4 -n8 --label-io --output=batch-file.out seq 1 1000 &&
+	test $(wc -l < batch-file.out) -eq 8000 &&
+	for i in 0 1 2 3 4 5 6 7; do
+		grep "^$i: " batch-file.out | sed "s/^$i: //" > batch-file.$i &&
+		seq 1 1000 | test_cmp - batch-file.$i || return 1
+	done
+'
+test_expect_success 'job-shell: output.rpc-batch-timeout=0 disables batching' '
+	flux run -N4 -n4 -o output.rpc-batch-timeout=0 --label-io \
+		seq 1 100 > nobatch.out &&
+	test $(wc -l < nobatch.out) -eq 400
+'
+test_expect_success 'job-shell: invalid output.rpc-batch-timeout is rejected' '
+	test_must_fail flux run -N2 -o output.rpc-batch-timeout=foo true
+'
 test_done
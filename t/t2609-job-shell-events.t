@@ -29,6 +29,15 @@ test_expect_success 'flux-shell: 2N: init and start shell events are emitted' '
 	flux job wait-event -vt 5 -p exec \
 		${id} shell.start
 '
+test_expect_success 'flux-shell: shell.init includes init phase timing' '
+	id=$(flux submit -n1 -N1 /bin/true) &&
+	flux job wait-event -t 5 -p exec -f json ${id} shell.init \
+		>shell-init.json &&
+	for phase in builtins connect info initrc taskmap init barrier; do \
+		jq -e ".context.timing.${phase} >= 0" shell-init.json \
+			|| return 1; \
+	done
+'
 test_expect_success 'flux-shell: plugin can add event context' '
 	cat >test-event.lua <<-EOT &&
 	plugin.searchpath = "${INITRC_PLUGINPATH}"
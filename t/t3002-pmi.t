@@ -109,6 +109,33 @@ test_expect_success 'kvstest works with -o pmi-simple.exchange.k=SIZE+1' '
 	grep "using k=${SIZE}" kvstest_kp1.err
 '
 
+test_expect_success 'flux run -o pmi-simple.exchange.tree=foo fails' '
+	test_must_fail flux run -o pmi-simple.exchange.tree=foo /bin/true
+'
+test_expect_success 'flux run -o pmi-simple.exchange.encoding=foo fails' '
+	test_must_fail flux run -o pmi-simple.exchange.encoding=foo /bin/true
+'
+test_expect_success 'kvstest works with -o pmi-simple.exchange.tree=topology' '
+	flux run -n${SIZE} -N${SIZE} -o verbose=2 \
+		-o pmi-simple.exchange.tree=topology \
+		${kvstest} 2>kvstest_topo.err &&
+	grep "using broker topology" kvstest_topo.err
+'
+test_expect_success 'kvstest works with -o pmi-simple.exchange.tree=kary' '
+	flux run -n${SIZE} -N${SIZE} -o pmi-simple.exchange.tree=kary ${kvstest}
+'
+test_expect_success 'kvstest works with topology tree on a subset of nodes' '
+	flux run -n2 -N2 --requires=rank:1,3 \
+		-o pmi-simple.exchange.tree=topology ${kvstest}
+'
+test_expect_success 'kvstest works with -o pmi-simple.exchange.encoding=binary' '
+	flux run -n${SIZE} -N${SIZE} -o pmi-simple.exchange.encoding=binary \
+		${kvstest}
+'
+test_expect_success 'kvstest works with binary encoding and k=1' '
+	flux run -n${SIZE} -N${SIZE} -o pmi-simple.exchange.encoding=binary \
+		-o pmi-simple.exchange.k=1 ${kvstest}
+'
 test_expect_success 'kvstest fails with -o pmi-simple.kvs=unknown' '
 	test_must_fail flux run -o pmi-simple.kvs=unknown ${kvstest}
 '
@@ -117,6 +144,20 @@ test_expect_success 'kvstest works with -o pmi-simple.kvs=native' '
 	flux run -n${SIZE} -N${SIZE} -o pmi-simple.kvs=native ${kvstest}
 '
 
+test_expect_success 'kvstest works with -o pmi-simple.kvs=lazy' '
+	flux run -n${SIZE} -N${SIZE} -o pmi-simple.kvs=lazy ${kvstest}
+'
+test_expect_success 'kvstest works with -o pmi-simple.kvs=lazy and 2 tasks/node' '
+	flux run -n$((${SIZE}*2)) -N${SIZE} -o pmi-simple.kvs=lazy ${kvstest}
+'
+test_expect_success 'kvstest works with lazy kvs and binary exchange' '
+	flux run -n${SIZE} -N${SIZE} -o pmi-simple.kvs=lazy \
+		-o pmi-simple.exchange.encoding=binary ${kvstest}
+'
+test_expect_success 'pmi_info works with -o pmi-simple.kvs=lazy' '
+	flux run -n${SIZE} -N${SIZE} -o pmi-simple.kvs=lazy ${pmi_info}
+'
+
 test_expect_success 'kvstest -N8 works' '
 	flux run -n${SIZE} -N${SIZE} ${kvstest} -N8
 '